@@ -0,0 +1,81 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Counts heap allocations by replacing the global operator new and delete with malloc/free based ones,
+// for benchmarks that want to show some code doesn't allocate. Only covers operator new, which is what
+// the containers and strings use.
+//
+// The replacements are for the whole program, so include this in exactly one .cpp of a program that
+// is meant to count, and in nothing that ships.
+
+#include <stdlib.h>
+#include <new>
+#include <atomic>
+
+// Kept out of line, so the compiler doesn't see our free() on what it thinks came from the real
+// operator new, and warn about a mismatch (-Wmismatched-new-delete)
+#ifdef _MSC_VER
+#define ALLOC_COUNT_NOINLINE __declspec(noinline)
+#else
+#define ALLOC_COUNT_NOINLINE __attribute__((noinline))
+#endif
+
+static std::atomic<size_t> g_allocCount( 0 );     // on all threads
+static thread_local size_t t_allocCount = 0;      // on this one
+
+ALLOC_COUNT_NOINLINE void* operator new( size_t size )
+{
+    g_allocCount++;
+    t_allocCount++;
+    if( void* p = malloc( size ? size : 1 ) )
+        return p;
+    throw std::bad_alloc();
+}
+
+ALLOC_COUNT_NOINLINE void* operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+ALLOC_COUNT_NOINLINE void operator delete( void* p ) noexcept
+{
+    free( p );
+}
+
+ALLOC_COUNT_NOINLINE void operator delete[]( void* p ) noexcept
+{
+    free( p );
+}
+
+ALLOC_COUNT_NOINLINE void operator delete( void* p, size_t ) noexcept
+{
+    free( p );
+}
+
+ALLOC_COUNT_NOINLINE void operator delete[]( void* p, size_t ) noexcept
+{
+    free( p );
+}
@@ -0,0 +1,344 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "Bench.h"
+#include "iracing.h"
+#include "Config.h"
+#include "FuelCalculator.h"
+#include "OverlayRelative.h"
+#include "OverlayStandings.h"
+#include "irsdk/irsdk_ibt.h"
+
+// Count the heap allocations of the thread running the benchmark. Replacing operator new affects the
+// whole program, so that's only done in a build for benchmarking, with IRON_BENCH_ALLOCS defined.
+// Otherwise no allocations are reported.
+#ifdef IRON_BENCH_ALLOCS
+#include "AllocCount.h"
+static const bool CountAllocs = true;
+#else
+static const size_t t_allocCount = 0;
+static const bool CountAllocs = false;
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+enum Stage { STAGE_Tick, STAGE_ConfigChange, STAGE_Relative, STAGE_Standings, STAGE_LapDeltas, STAGE_Fuel, STAGE_COUNT };
+static const char* const StageNames[] = { "ir_tick", "ir_handleConfigChange", "relative", "standings sort", "lap deltas", "fuel calculator" };
+
+struct StageTimes
+{
+    std::vector<long long>  ns;
+    std::vector<int>        allocs;
+};
+
+class StageTimer
+{
+    public:
+
+        StageTimer( StageTimes& times )
+            : m_times( times )
+            , m_allocs( t_allocCount )
+            , m_start( Clock::now() )
+        {}
+
+        ~StageTimer()
+        {
+            const Clock::time_point end = Clock::now();
+            m_times.ns.push_back( std::chrono::duration_cast<std::chrono::nanoseconds>( end - m_start ).count() );
+            m_times.allocs.push_back( (int)(t_allocCount - m_allocs) );
+        }
+
+    private:
+
+        StageTimes&         m_times;
+        size_t              m_allocs;
+        Clock::time_point   m_start;
+};
+
+static void hashValue( unsigned& hash, const void* data, int len )
+{
+    hash = MurmurHash2( data, len, hash );
+}
+
+template<typename T>
+static void hashValue( unsigned& hash, const T& value )
+{
+    hashValue( hash, &value, (int)sizeof(value) );
+}
+
+static void printStage( const char* name, StageTimes& t )
+{
+    const int n = (int)t.ns.size();
+    if( !n )
+        return;
+
+    long long allocs = 0;
+    int maxAllocs = 0;
+    for( int a : t.allocs )
+    {
+        allocs += a;
+        maxAllocs = std::max( maxAllocs, a );
+    }
+
+    std::sort( t.ns.begin(), t.ns.end() );
+    printf( "%-22s p50 %8lld ns   p99 %8lld ns   max %9lld ns", name, t.ns[n/2], t.ns[std::min(n-1, n*99/100)], t.ns[n-1] );
+    if( CountAllocs )
+        printf( "   allocs/tick %6.2f (max %d)", (double)allocs / n, maxAllocs );
+    printf( "\n" );
+}
+
+// A gap to the car ahead, waiting for the car to get to where that one was
+struct GapCheck
+{
+    bool    active = false;
+    float   targetPct = 0;
+    double  startTime = 0;
+    float   learned = 0;    // from the position to time tables
+    float   est = 0;        // from the sim's EstTime
+};
+
+static bool onRacingLine( int carIdx )
+{
+    return ir_carIdx.lapDistPct[carIdx] >= 0 && !ir_carIdx.onPitRoad[carIdx] &&
+        ir_carIdx.trackSurface[carIdx] == irsdk_OnTrack && !ir_session.cars[carIdx].isPaceCar;
+}
+
+static float forwardDist( float from, float to )
+{
+    float d = to - from;
+    return d < 0 ? d + 1.0f : d;
+}
+
+int runBench( const char* ibtPath, int maxTicks )
+{
+    if( !irsdk_ibtOpen( ibtPath ) )
+    {
+        printf( "Can't benchmark %s, not a telemetry file\n", ibtPath );
+        return 1;
+    }
+
+    const int recordCount = irsdk_ibtGetRecordCount();
+    if( maxTicks <= 0 || maxTicks > recordCount )
+        maxTicks = recordCount;
+
+    // Read every record exactly once, on this thread, and parse the session strings along with them
+    irsdk_ibtSetSpeed( 0 );
+    ir_setSynchronousSessionParsing( true );
+    ir_setFuelStore( nullptr );     // don't go by, or change, what earlier sessions used
+    ir_setStrategySimulation( false );  // its worker threads would only get in the way of the timings
+    irsdkClient::instance().setCopySubscribedOnly( true );
+
+    // The overlays are never enabled, so they don't get a window or anything else graphical
+    OverlayRelative  relative;
+    OverlayStandings standings;
+    FuelCalculator   fuel( "OverlayDDU" );
+
+    StageTimes times[STAGE_COUNT];
+    for( StageTimes& t : times )
+    {
+        t.ns.reserve( maxTicks );
+        t.allocs.reserve( maxTicks );
+    }
+
+    unsigned    hash = 0;
+    int         ticks = 0;
+    int         connectedTicks = 0;
+
+    // To check the sector timing against: the lap times the sim came up with
+    float       simLastLap[IR_MAX_CARS] = {};
+    int         lapsTimedSeen[IR_MAX_CARS] = {};
+    int         lapsCompared = 0;
+    double      lapDiffSum = 0;
+    double      lapDiffMax = 0;
+
+    // To check the gaps against: how long the cars actually took to get to where the car ahead was
+    GapCheck    gapChecks[IR_MAX_CARS];
+    float       gapPrevPct[IR_MAX_CARS] = {};
+    double      gapPrevTime = -1;
+    int         gapsCompared = 0;
+    double      learnedErrSum = 0, learnedErrMax = 0;
+    double      estErrSum = 0, estErrMax = 0;
+
+    printf( "Benchmarking %s, %d of %d records\n\n", ibtPath, maxTicks, recordCount );
+
+    while( ticks < maxTicks && irsdk_ibtGetRecord() < recordCount - 1 )
+    {
+        ConnectionStatus status;
+        {
+            StageTimer t( times[STAGE_Tick] );
+            status = ir_tick();
+        }
+        ticks++;
+
+        // The first tick or so only connects
+        if( status == ConnectionStatus::DISCONNECTED )
+            continue;
+        connectedTicks++;
+
+        {
+            StageTimer t( times[STAGE_ConfigChange] );
+            ir_handleConfigChange();
+        }
+
+        int selfIdx;
+        float fuelPerLap;
+        {
+            StageTimer t( times[STAGE_Relative] );
+            selfIdx = relative.updateRelatives();
+        }
+        {
+            StageTimer t( times[STAGE_Standings] );
+            standings.updateStandings();
+        }
+        {
+            StageTimer t( times[STAGE_LapDeltas] );
+            standings.updateLapDeltas();
+        }
+        {
+            StageTimer t( times[STAGE_Fuel] );
+            fuelPerLap = fuel.getConservativePerLap();
+        }
+
+        // Fold in what the stages came up with, so runs can be compared without reading through it all
+        hashValue( hash, selfIdx );
+        for( const OverlayRelative::CarInfo& ci : relative.getRelatives() )
+        {
+            hashValue( hash, ci.carIdx );
+            hashValue( hash, ci.delta );
+            hashValue( hash, ci.lapDelta );
+        }
+        for( const OverlayStandings::CarInfo& ci : standings.getStandings() )
+        {
+            hashValue( hash, ci.carIdx );
+            hashValue( hash, ci.position );
+            hashValue( hash, ci.lapDelta );
+        }
+        hashValue( hash, fuelPerLap );
+
+        // The sim reports a lap a little after the line, by which time it's been timed here too
+        for( int i=0; i<IR_MAX_CARS; ++i )
+        {
+            const float sim = ir_carIdx.lastLapTime[i];
+            if( sim == simLastLap[i] )
+                continue;
+            simLastLap[i] = sim;
+
+            if( sim > 0 && ir_sectors.lapsTimed[i] != lapsTimedSeen[i] )
+            {
+                const double diff = fabs( ir_sectors.lastLap[i] - sim );
+                lapsCompared++;
+                lapDiffSum += diff;
+                lapDiffMax = std::max( lapDiffMax, diff );
+                hashValue( hash, ir_sectors.lastLap[i] );
+            }
+            lapsTimedSeen[i] = ir_sectors.lapsTimed[i];
+        }
+
+        // Gaps only mean something at race pace, and are checked once the car behind gets there
+        const double now = ir_SessionTime.getDouble();
+        const bool   green = !ir_race.isPreStart && !(ir_SessionFlags.getInt() & (irsdk_caution | irsdk_cautionWaving | irsdk_checkered));
+        for( int i=0; i<IR_MAX_CARS; ++i )
+        {
+            GapCheck& gc = gapChecks[i];
+            const float pct = ir_carIdx.lapDistPct[i];
+            const float moved = forwardDist( gapPrevPct[i], pct );
+            if( gc.active )
+            {
+                if( !green || !onRacingLine( i ) || gapPrevTime < 0 || moved >= 0.5f || now - gc.startTime > 120 )
+                {
+                    gc.active = false;
+                }
+                else if( moved > 0 && forwardDist( gapPrevPct[i], gc.targetPct ) <= moved )
+                {
+                    const double at = gapPrevTime + (now - gapPrevTime) * forwardDist( gapPrevPct[i], gc.targetPct ) / moved;
+                    const double actual = at - gc.startTime;
+                    const double learnedErr = fabs( gc.learned - actual );
+                    const double estErr = fabs( gc.est - actual );
+                    gapsCompared++;
+                    learnedErrSum += learnedErr;
+                    learnedErrMax = std::max( learnedErrMax, learnedErr );
+                    estErrSum += estErr;
+                    estErrMax = std::max( estErrMax, estErr );
+                    gc.active = false;
+                }
+            }
+            gapPrevPct[i] = pct;
+        }
+        gapPrevTime = now;
+
+        if( green && connectedTicks % 60 == 0 )
+        {
+            for( int i=0; i<IR_MAX_CARS; ++i )
+            {
+                if( gapChecks[i].active || !onRacingLine( i ) )
+                    continue;
+
+                int ahead = -1;
+                for( int j=0; j<IR_MAX_CARS; ++j )
+                    if( j != i && onRacingLine( j ) && forwardDist( ir_carIdx.lapDistPct[i], ir_carIdx.lapDistPct[j] ) < 0.5f &&
+                        (ahead < 0 || forwardDist( ir_carIdx.lapDistPct[i], ir_carIdx.lapDistPct[j] ) <
+                                      forwardDist( ir_carIdx.lapDistPct[i], ir_carIdx.lapDistPct[ahead] )) )
+                        ahead = j;
+
+                const float learned = ahead >= 0 ? ir_getTimeBehind( i, ahead ) : -1;
+                if( learned <= 0 )
+                    continue;
+
+                // The way the relative used to work it out
+                const float L = ir_race.estimatedLaptime;
+                float est = ir_carIdx.estTime[ahead] - ir_carIdx.estTime[i];
+                if( fabsf( ir_carIdx.lapDistPct[ahead] - ir_carIdx.lapDistPct[i] ) > 0.5f )
+                    est += est < 0 ? L : -L;
+
+                GapCheck& gc = gapChecks[i];
+                gc.active = true;
+                gc.targetPct = ir_carIdx.lapDistPct[ahead];
+                gc.startTime = now;
+                gc.learned = learned;
+                gc.est = est;
+            }
+        }
+    }
+
+    irsdk_ibtClose();
+
+    printf( "%d ticks, %d connected, %d session string updates\n\n", ticks, connectedTicks, ir_sessionParseStats.updates );
+    for( int i=0; i<STAGE_COUNT; ++i )
+        printStage( StageNames[i], times[i] );
+    printf( "\nlap times: %d compared with the sim's, off by %.1f ms on average, %.1f ms at most\n",
+        lapsCompared, lapsCompared ? lapDiffSum / lapsCompared * 1000 : 0.0, lapDiffMax * 1000 );
+    printf( "gaps: %d compared with the time taken, learned tables off by %.3f s on average, %.3f s at most,\n"
+            "      EstTime off by %.3f s on average, %.3f s at most\n",
+        gapsCompared, gapsCompared ? learnedErrSum / gapsCompared : 0.0, learnedErrMax,
+        gapsCompared ? estErrSum / gapsCompared : 0.0, estErrMax );
+    printf( "checksum %08x\n", hash );
+
+    return 0;
+}
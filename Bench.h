@@ -0,0 +1,39 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+// Headless, deterministic benchmark of everything iRon does per tick, minus the drawing.
+//
+// Plays back a .ibt file as fast as it can be read, one record per tick, and runs ir_tick(),
+// ir_handleConfigChange() and the data model parts of the overlays (relative ordering, standings
+// sort, lap deltas, fuel calculator) on every record. No windows are created.
+// Session strings are parsed synchronously, so every run over the same file does the exact same
+// work. Prints p50/p99/max time per stage, and heap allocations too in a build with IRON_BENCH_ALLOCS
+// defined (msbuild iron.vcxproj /p:IronBenchAllocs=true), plus a checksum of the results to compare
+// runs of different builds by. The lap times from the sector timing are checked against the ones the
+// sim recorded, and the gaps to the car ahead against how long the car behind actually took to get there.
+//
+// Returns the process exit code.
+int runBench( const char* ibtPath, int maxTicks );
@@ -0,0 +1,64 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <string>
+#include "iracing.h"
+#include "Config.h"
+
+//
+// The DDU and Ray overlays' view of the fuel use ir_tick() keeps in ir_fuel, with the overlay's own
+// fuel_estimate_* settings. Both overlays go by the same laps.
+//
+class FuelCalculator
+{
+    public:
+
+        // The fuel_estimate_* settings are read from the given config section
+        explicit FuelCalculator( const std::string& component )
+            : m_component( component )
+        {}
+
+        // Average of the last fuel_estimate_avg_green_laps green laps, outliers left out. Before the first
+        // green lap, what this car used at this track last time, or where the current lap is heading.
+        // 0 if there's none of that.
+        float getAvgPerLap() const
+        {
+            return ir_getFuelPerLap( g_cfg.getInt( m_component, "fuel_estimate_avg_green_laps", 4 ) );
+        }
+
+        // Average use padded by fuel_estimate_factor, for estimates that had better not come up short
+        float getConservativePerLap() const
+        {
+            return getAvgPerLap() * g_cfg.getFloat( m_component, "fuel_estimate_factor", 1.1f );
+        }
+
+        // Whether the lap we're on will count towards the average
+        bool isValidFuelLap() const { return ir_fuel.lapCounts && ir_fuel.lapType == FuelLapType::GREEN; }
+
+    private:
+
+        std::string         m_component;
+};
@@ -26,8 +26,8 @@ SOFTWARE.
 
 #include <vector>
 #include <algorithm>
-#include <deque>
 #include "Overlay.h"
+#include "FuelCalculator.h"
 #include "iracing.h"
 #include "Config.h"
 #include "OverlayDebug.h"
@@ -191,11 +191,6 @@ class OverlayDDU : public Overlay
             }
         }
 
-        virtual void onSessionChanged()
-        {
-            m_isValidFuelLap = false;  // avoid confusing the fuel calculator logic with session changes
-        }
-
         virtual void onUpdate()
         {
             const float  fontSize           = g_cfg.getFloat( m_name, "font_size", DefaultFontSize );
@@ -212,21 +207,13 @@ class OverlayDDU : public Overlay
 
             const DWORD tickCount = GetTickCount();
 
-            // Figure out who's P1
-            int p1carIdx = -1;
-            for( int i=0; i<IR_MAX_CARS; ++i )
-            {
-                if( ir_getPosition(i) == 1 ) {
-                    p1carIdx = i;
-                    break;
-                }
-            }
+            const int p1carIdx = ir_race.leaderIdx;
 
             // General lap info
             const bool   sessionIsTimeLimited  = ir_SessionLapsTotal.getInt() == 32767 && ir_SessionTimeRemain.getDouble()<48.0*3600.0;  // most robust way I could find to figure out whether this is a time-limited session (info in session string is often misleading)
             const double remainingSessionTime  = sessionIsTimeLimited ? ir_SessionTimeRemain.getDouble() : -1;
             const int    remainingLaps         = sessionIsTimeLimited ? int(0.5+remainingSessionTime/ir_estimateLaptime()) : (ir_SessionLapsRemainEx.getInt() != 32767 ? ir_SessionLapsRemainEx.getInt() : -1);
-            const int    currentLap            = ir_isPreStart() ? 0 : std::max(0,ir_CarIdxLap.getInt(carIdx));
+            const int    currentLap            = ir_isPreStart() ? 0 : (carIdx < 0 ? 0 : std::max(0,ir_carIdx.lap[carIdx]));
             const bool   lapCountUpdated       = currentLap != m_prevCurrentLap;
             m_prevCurrentLap = currentLap;
             if( lapCountUpdated )
@@ -351,7 +338,7 @@ class OverlayDDU : public Overlay
 
             // Lap Delta
             {
-                const int lapDelta = ir_getLapDeltaToLeader( ir_session.driverCarIdx, p1carIdx );
+                const int lapDelta = carIdx >= 0 ? ir_race.lapDeltaToLeader[carIdx] : 0;
                 if( lapDelta )
                 {
                     swprintf( s, _countof(s), L"%d", lapDelta );
@@ -361,25 +348,8 @@ class OverlayDDU : public Overlay
 
             // Best time
             {
-                // Figure out if we have the fastest lap across all cars
-                bool haveFastestLap = false;
-                {
-                    int fastestLapCarIdx = -1;
-                    float fastest = FLT_MAX;
-                    for( int i=0; i<IR_MAX_CARS; ++i )
-                    {
-                        const Car& car = ir_session.cars[i];
-                        if( car.isPaceCar || car.isSpectator || car.userName.empty() )
-                            continue;
-
-                        const float best = ir_CarIdxBestLapTime.getFloat(i);
-                        if( best > 0 && best < fastest ) {
-                            fastest = best;
-                            fastestLapCarIdx = i;
-                        }
-                    }
-                    haveFastestLap = fastestLapCarIdx == ir_session.driverCarIdx;
-                }
+                // Do we have the fastest lap across all cars?
+                const bool haveFastestLap = carIdx >= 0 && ir_race.fastestLapIdx == carIdx;
 
                 const float t = ir_LapBestLapTime.getFloat();
                 if( t > 0 )
@@ -417,7 +387,7 @@ class OverlayDDU : public Overlay
             {                
                 if( p1carIdx >= 0 )
                 {
-                    const float t = ir_CarIdxLastLapTime.getFloat( p1carIdx );
+                    const float t = ir_carIdx.lastLapTime[p1carIdx];
                     if( t > 0 )
                     {
                         std::string str = formatLaptime( t );
@@ -451,41 +421,14 @@ class OverlayDDU : public Overlay
                 m_text.render( m_renderTarget.Get(), L"Fin+", m_textFormatSmall.Get(), m_boxFuel.x0+xoff, m_boxFuel.x1, m_boxFuel.y0+m_boxFuel.h*8.7f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING );
                 m_text.render( m_renderTarget.Get(), L"Add", m_textFormatSmall.Get(), m_boxFuel.x0+xoff, m_boxFuel.x1, m_boxFuel.y0+m_boxFuel.h*10.5f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING );
 
-                const float estimateFactor = g_cfg.getFloat( m_name, "fuel_estimate_factor", 1.1f );
                 const float remainingFuel  = ir_FuelLevel.getFloat();
 
-                // Update average fuel consumption tracking. Ignore laps that weren't entirely under green or where we pitted.
-                float avgPerLap = 0;
-                {
-                    if( lapCountUpdated )
-                    {
-                        const float usedLastLap = std::max( 0.0f, m_lapStartRemainingFuel - remainingFuel );
-                        m_lapStartRemainingFuel = remainingFuel;
-
-                        if( m_isValidFuelLap )
-                            m_fuelUsedLastLaps.push_back( usedLastLap );
-
-                        const int numLapsToAvg = g_cfg.getInt( m_name, "fuel_estimate_avg_green_laps", 4 );
-                        while( m_fuelUsedLastLaps.size() > numLapsToAvg )
-                            m_fuelUsedLastLaps.pop_front();
-
-                        m_isValidFuelLap = true;
-                    }
-                    if( (ir_SessionFlags.getInt() & (irsdk_yellow|irsdk_yellowWaving|irsdk_red|irsdk_checkered|irsdk_crossed|irsdk_oneLapToGreen|irsdk_caution|irsdk_cautionWaving|irsdk_disqualify|irsdk_repair)) || ir_CarIdxOnPitRoad.getBool(carIdx) )
-                        m_isValidFuelLap = false;
-                    
-                    for( float v : m_fuelUsedLastLaps ) {
-                        avgPerLap += v;
-                        dbg("%f",v);
-                    }
-                    if( !m_fuelUsedLastLaps.empty() )
-                        avgPerLap /= (float)m_fuelUsedLastLaps.size();
-
-                    dbg( "valid fuel lap: %d", (int)m_isValidFuelLap );
-                }
+                // Average fuel consumption, from the laps that were entirely under green and where we didn't pit
+                const float avgPerLap = m_fuel.getAvgPerLap();
+                dbg( "valid fuel lap: %d", (int)m_fuel.isValidFuelLap() );
 
                 // Est Laps
-                const float perLapConsEst = avgPerLap * estimateFactor;  // conservative estimate of per-lap use for further calculations
+                const float perLapConsEst = m_fuel.getConservativePerLap();  // conservative estimate of per-lap use for further calculations
                 if( perLapConsEst > 0 )
                 {
                     const float estLaps = remainingFuel / perLapConsEst;
@@ -513,10 +456,12 @@ class OverlayDDU : public Overlay
                     m_text.render( m_renderTarget.Get(), s, m_textFormat.Get(), m_boxFuel.x0, m_boxFuel.x1-xoff, m_boxFuel.y0+m_boxFuel.h*6.9f/12.0f, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_TRAILING );
                 }
 
-                // To Finish
-                if( remainingLaps >= 0 && perLapConsEst > 0 )
+                // To Finish. With a pit strategy, what to add at the next stop, which may not be the last one.
+                const StrategyResult& strat = ir_strategy;
+                dbg( "strategy: %d stops, window %d-%d, add %.1f, save to %.2f, %d runs in %.1f ms", strat.stops, strat.windowOpen, strat.windowClose, strat.fuelToAdd, strat.saveTarget, strat.simulations, strat.roundMs );
+                if( strat.valid || (remainingLaps >= 0 && perLapConsEst > 0) )
                 {
-                    float toFinish = std::max( 0.0f, remainingLaps * perLapConsEst - remainingFuel );
+                    float toFinish = strat.valid ? strat.fuelToAdd : std::max( 0.0f, remainingLaps * perLapConsEst - remainingFuel );
 
                     if( toFinish > ir_PitSvFuel.getFloat() || (toFinish>0 && !ir_dpFuelFill.getFloat()) )
                         m_brush->SetColor( warnCol );
@@ -780,8 +725,6 @@ class OverlayDDU : public Overlay
 
         float               m_prevBestLapTime = 0;
 
-        float               m_lapStartRemainingFuel = 0;
-        std::deque<float>   m_fuelUsedLastLaps;
-        bool                m_isValidFuelLap = false;
+        FuelCalculator      m_fuel{ m_name };
 };
 
@@ -94,61 +94,46 @@ protected:
 			m_columns.add((int)Columns::IRATING, computeTextExtent(L"999.9k", m_dwriteFactory.Get(), m_textFormatSmall2.Get()).x, fontSize / 8);
 	}
 
-	virtual void onUpdate()
+public:
+
+	struct CarInfo {
+		int     carIdx = 0;
+		float   delta = 0;
+		int     lapDelta = 0;
+		int     pitAge = 0;
+	};
+
+	// Fill in the cars a relative delta makes sense for, sorted by delta, and return where our own car
+	// ended up in that list (-1 if it isn't there). Doesn't touch anything graphical, so it can run without a window.
+	int updateRelatives()
 	{
-		struct CarInfo {
-			int     carIdx = 0;
-			float   delta = 0;
-			int     lapDelta = 0;
-			int     pitAge = 0;
-		};
-		std::vector<CarInfo> relatives;
-		relatives.reserve(IR_MAX_CARS);
+		std::vector<CarInfo>& relatives = m_relatives;
+		relatives.clear();
+
+		const CarIdxSnapshot& cs = ir_carIdx;
+		const RaceState& rs = ir_race;
+		const int   selfIdx = ir_session.driverCarIdx;
+		const bool  haveSelf = selfIdx >= 0 && selfIdx < IR_MAX_CARS;
+		const bool  showPaceCar = rs.isPreStart || (ir_SessionFlags.getInt() & (irsdk_caution | irsdk_cautionWaving));
 
 		// Populate cars with the ones for which a relative/delta comparison is valid
 		for (int i = 0; i < IR_MAX_CARS; ++i)
 		{
 			const Car& car = ir_session.cars[i];
 
-			const int lapcountS = ir_CarIdxLap.getInt(ir_session.driverCarIdx);
-			const int lapcountC = ir_CarIdxLap.getInt(i);
+			const int lapcountC = cs.lap[i];
 
 			if (lapcountC >= 0 && !car.isSpectator && car.carNumber >= 0)
 			{
 				// Add the pace car only under yellow or initial pace lap
-				if (car.isPaceCar && !(ir_SessionFlags.getInt() & (irsdk_caution | irsdk_cautionWaving)) && !ir_isPreStart())
+				if (car.isPaceCar && !showPaceCar)
 					continue;
 
 				// If the other car is up to half a lap in front, we consider the delta 'ahead', otherwise 'behind'.
+				// The lap delta comes with the race state, worked out the same way.
 
-				float delta = 0;
-				int   lapDelta = lapcountC - lapcountS;
-
-				const float L = ir_estimateLaptime();
-				const float C = ir_CarIdxEstTime.getFloat(i);
-				const float S = ir_CarIdxEstTime.getFloat(ir_session.driverCarIdx);
-
-				// Does the delta between us and the other car span across the start/finish line?
-				const bool wrap = fabsf(ir_CarIdxLapDistPct.getFloat(i) - ir_CarIdxLapDistPct.getFloat(ir_session.driverCarIdx)) > 0.5f;
-
-				if (wrap)
-				{
-					delta = S > C ? (C - S) + L : (C - S) - L;
-					lapDelta += S > C ? -1 : 1;
-				}
-				else
-				{
-					delta = C - S;
-				}
-
-				// Assume no lap delta when not in a race, because we don't want to show drivers as lapped/lapping there.
-				// Also reset it during initial pacing, since iRacing for some reason starts counting
-				// during the pace lap but then resets the counter a couple seconds in, confusing the logic.
-				// And consider the pace car in the same lap as us, too.
-				if (ir_session.sessionType != SessionType::RACE || ir_isPreStart() || car.isPaceCar)
-				{
-					lapDelta = 0;
-				}
+				const float delta = haveSelf ? ir_getGap(i, selfIdx) : 0;
+				const int lapDelta = rs.lapDeltaToSelf[i];
 
 				CarInfo ci;
 				ci.carIdx = i;
@@ -164,7 +149,7 @@ protected:
 				ci.carIdx = i;
 				ci.delta = delta;
 				ci.lapDelta = lapDelta;
-				ci.pitAge = ir_CarIdxLap.getInt(i) - car.lastLapInPits;
+				ci.pitAge = cs.lap[i] - car.lastLapInPits;
 #endif
 				relatives.push_back(ci);
 			}
@@ -189,6 +174,22 @@ protected:
 		}
 #endif
 
+		return selfCarInfoIdx;
+	}
+
+	const std::vector<CarInfo>& getRelatives() const { return m_relatives; }
+
+protected:
+
+	virtual void onUpdate()
+	{
+		const int selfCarInfoIdx = updateRelatives();
+		const std::vector<CarInfo>& relatives = m_relatives;
+
+		const CarIdxSnapshot& cs = ir_carIdx;
+		const int   selfIdx = ir_session.driverCarIdx;
+		const float lapDistPctS = selfIdx >= 0 && selfIdx < IR_MAX_CARS ? cs.lapDistPct[selfIdx] : 0;
+
 		// Something's wrong if we didn't find our driver. Bail.
 		if (selfCarInfoIdx < 0)
 			return;
@@ -244,8 +245,8 @@ protected:
 
 #ifdef _DEBUG
 			Car car;
-			car.userName = "Player Name";
-			car.carNumberStr = std::to_string(i + 100);
+			strcpy(car.userName, "Player Name");
+			snprintf(car.carNumberStr, sizeof(car.carNumberStr), "%d", i + 100);
 			car.licenseChar = 'B';
 			car.racePosition = cnt;
 
@@ -269,7 +270,7 @@ protected:
 
 			if (car.isSelf)
 				col = selfCol;
-			else if (ir_CarIdxOnPitRoad.getBool(ci.carIdx))
+			else if (cs.onPitRoad[ci.carIdx])
 				col.a *= 0.5f;
 
 			wchar_t s[512];
@@ -282,14 +283,14 @@ protected:
 			// Position
 #ifdef _DEBUG
 #else
-			if (ir_getPosition(ci.carIdx) > 0)
+			if (ir_race.position[ci.carIdx] > 0)
 #endif
 			{
 				clm = m_columns.get((int)Columns::POSITION);
 #ifdef _DEBUG
 				swprintf(s, _countof(s), L"%d", ci.carIdx);
 #else
-				swprintf(s, _countof(s), L"%d", ir_getPosition(ci.carIdx));
+				swprintf(s, _countof(s), L"%d", ir_race.position[ci.carIdx]);
 #endif
 				m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y - 1, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_CENTER);
 			}
@@ -297,7 +298,7 @@ protected:
 			// Car number
 			{
 				clm = m_columns.get((int)Columns::CAR_NUMBER);
-				swprintf(s, _countof(s), L"#%S", car.carNumberStr.c_str());
+				swprintf(s, _countof(s), L"#%S", car.carNumberStr);
 				r = { xoff + clm->textL, y - lineHeight / 2, xoff + clm->textR, y + lineHeight / 2 };
 				rr.rect = { r.left, r.top + 1, r.right, r.bottom - 1 };
 				//rr.radiusX = 3;
@@ -312,7 +313,7 @@ protected:
 			// Name
 			{
 				clm = m_columns.get((int)Columns::NAME);
-				swprintf(s, _countof(s), L"%S", car.userName.c_str());
+				swprintf(s, _countof(s), L"%S", car.userName);
 				m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y - 1, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING);
 			}
 
@@ -327,12 +328,12 @@ protected:
 			}
 
 			// Pit age
-			if ((clm = m_columns.get((int)Columns::PIT)) && !ir_isPreStart() && (ci.pitAge >= 0 || ir_CarIdxOnPitRoad.getBool(ci.carIdx)))
+			if ((clm = m_columns.get((int)Columns::PIT)) && !ir_race.isPreStart && (ci.pitAge >= 0 || cs.onPitRoad[ci.carIdx]))
 			{
 				r = { xoff + clm->textL, y - lineHeight / 2 + 2, xoff + clm->textR, y + lineHeight / 2 - 2 };
 				m_brush->SetColor(pitCol);
 				//m_renderTarget->DrawRectangle(&r, m_brush.Get());
-				if (ir_CarIdxOnPitRoad.getBool(ci.carIdx)) {
+				if (cs.onPitRoad[ci.carIdx]) {
 					swprintf(s, _countof(s), L"PIT");
 					m_renderTarget->FillRectangle(&r, m_brush.Get());
 					m_brush->SetColor(float4(0, 0, 0, 1));
@@ -435,9 +436,9 @@ protected:
 					if (phase == 5 && !car.isSelf)
 						continue;
 
-					float e = ir_CarIdxLapDistPct.getFloat(ci.carIdx);
+					float e = cs.lapDistPct[ci.carIdx];
 
-					const float eself = ir_CarIdxLapDistPct.getFloat(ir_session.driverCarIdx);
+					const float eself = lapDistPctS;
 
 					if (minimapIsRelative)
 					{
@@ -450,7 +451,7 @@ protected:
 					e = e * w + x;
 
 					float4 col = baseCol;
-					if (!car.isSelf && ir_CarIdxOnPitRoad.getBool(ci.carIdx))
+					if (!car.isSelf && cs.onPitRoad[ci.carIdx])
 						col.a *= 0.5f;
 
 					const float dx = 2;
@@ -472,4 +473,6 @@ protected:
 
 	ColumnLayout m_columns;
 	TextCache    m_text;
+
+	std::vector<CarInfo> m_relatives;
 };
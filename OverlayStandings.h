@@ -85,52 +85,57 @@ protected:
 		//m_columns.add((int)Columns::DELTA, computeTextExtent(L"9999.9999", m_dwriteFactory.Get(), m_textFormat.Get()).x, fontSize / 2);
 	}
 
-	virtual void onUpdate()
+public:
+
+	struct CarInfo {
+		int     carIdx = 0;
+		int     lapCount = 0;
+		float   pctAroundLap = 0;
+		int     lapDelta = 0;
+		float   delta = 0;
+		int     position = 0;
+		float   best = 0;
+		float   last = 0;
+		bool    hasFastestLap = false;
+		int     pitAge = 0;
+	};
+
+	// Fill in the standings, sorted by position. Doesn't touch anything graphical, so it can run without a window.
+	void updateStandings()
 	{
-		struct CarInfo {
-			int     carIdx = 0;
-			int     lapCount = 0;
-			float   pctAroundLap = 0;
-			int     lapDelta = 0;
-			float   delta = 0;
-			int     position = 0;
-			float   best = 0;
-			float   last = 0;
-			bool    hasFastestLap = false;
-			int     pitAge = 0;
-		};
-		std::vector<CarInfo> carInfo;
-		carInfo.reserve(IR_MAX_CARS);
+		std::vector<CarInfo>& carInfo = m_carInfo;
+		carInfo.clear();
 
 		// Init array
-		float fastestLapTime = FLT_MAX;
-		int fastestLapIdx = -1;
+		const RaceState& rs = ir_race;
 		for (int i = 0; i < IR_MAX_CARS; ++i)
 		{
 			const Car& car = ir_session.cars[i];
 
-			if (car.isPaceCar || car.isSpectator || car.userName.empty())
+			if (car.isPaceCar || car.isSpectator || !car.userName[0])
 				continue;
 
 			CarInfo ci;
 			ci.carIdx = i;
-			ci.lapCount = std::max(ir_CarIdxLap.getInt(i), ir_CarIdxLapCompleted.getInt(i));
-			ci.position = ir_getPosition(i);
-			ci.pctAroundLap = ir_CarIdxLapDistPct.getFloat(i);
-			ci.delta = ir_session.sessionType != SessionType::RACE ? 0 : -ir_CarIdxF2Time.getFloat(i);
-			ci.last = ir_CarIdxLastLapTime.getFloat(i);
-			ci.pitAge = ir_CarIdxLap.getInt(i) - car.lastLapInPits;
+			ci.lapCount = std::max(ir_carIdx.lap[i], ir_carIdx.lapCompleted[i]);
+			ci.position = rs.position[i];
+			ci.pctAroundLap = ir_carIdx.lapDistPct[i];
+			ci.delta = ir_session.sessionType != SessionType::RACE ? 0 : -ir_carIdx.f2Time[i];
 
-			ci.best = ir_CarIdxBestLapTime.getFloat(i);
-			if (ir_session.sessionType == SessionType::RACE && ir_SessionState.getInt() <= irsdk_StateWarmup || ir_session.sessionType == SessionType::QUALIFY && ci.best <= 0)
-				ci.best = car.qualTime;
+			// On the lead lap, how long the car takes to get to where the leader is
+			if (ir_session.sessionType == SessionType::RACE && !rs.isPreStart && rs.leaderIdx >= 0 && rs.lapDeltaToLeader[i] == 0)
+			{
+				const float behind = ir_getTimeBehind(i, rs.leaderIdx);
+				if (behind >= 0)
+					ci.delta = -behind;
+			}
+			ci.last = ir_carIdx.lastLapTime[i];
+			ci.pitAge = ir_carIdx.lap[i] - car.lastLapInPits;
 
-			carInfo.push_back(ci);
+			ci.best = rs.bestLapTime[i];
+			ci.hasFastestLap = i == rs.fastestLapIdx;
 
-			if (ci.best > 0 && ci.best < fastestLapTime) {
-				fastestLapTime = ci.best;
-				fastestLapIdx = (int)carInfo.size() - 1;
-			}
+			carInfo.push_back(ci);
 		}
 
 #ifdef _DEBUG
@@ -146,17 +151,9 @@ protected:
 			ci.best = 80.0f + i;
 
 			carInfo.push_back(ci);
-
-			if (ci.best > 0 && ci.best < fastestLapTime) {
-				fastestLapTime = ci.best;
-				fastestLapIdx = (int)carInfo.size() - 1;
-			}
 		}
 #endif
 
-		if (fastestLapIdx >= 0)
-			carInfo[fastestLapIdx].hasFastestLap = true;
-
 		// Sort by position
 		std::sort(carInfo.begin(), carInfo.end(),
 			[](const CarInfo& a, const CarInfo& b) {
@@ -164,14 +161,24 @@ protected:
 				const int bp = b.position <= 0 ? INT_MAX : b.position;
 				return ap < bp;
 			});
+	}
 
-		// Compute lap deltas to leader
-		for (int i = 0; i < (int)carInfo.size(); ++i)
-		{
-			const CarInfo& ciLeader = carInfo[0];
-			CarInfo& ci = carInfo[i];
-			ci.lapDelta = ir_getLapDeltaToLeader(ci.carIdx, ciLeader.carIdx);
-		}
+	// Lap deltas to the leader, for the standings from updateStandings().
+	void updateLapDeltas()
+	{
+		for (CarInfo& ci : m_carInfo)
+			ci.lapDelta = ir_race.lapDeltaToLeader[ci.carIdx];
+	}
+
+	const std::vector<CarInfo>& getStandings() const { return m_carInfo; }
+
+protected:
+
+	virtual void onUpdate()
+	{
+		updateStandings();
+		updateLapDeltas();
+		const std::vector<CarInfo>& carInfo = m_carInfo;
 
 		const float  fontSize = g_cfg.getFloat(m_name, "font_size", DefaultFontSize);
 		const float  lineSpacing = g_cfg.getFloat(m_name, "line_spacing", 8);
@@ -273,8 +280,8 @@ protected:
 
 #ifdef _DEBUG
 			Car car;
-			car.userName = "Racer Guy - " + std::to_string(i + 1);
-			car.carNumberStr = std::to_string(i + 55);
+			snprintf(car.userName, sizeof(car.userName), "Racer Guy - %d", i + 1);
+			snprintf(car.carNumberStr, sizeof(car.carNumberStr), "%d", i + 55);
 			car.licenseChar = 'B';
 			car.licenseSR = 2.5f;
 			car.irating = 1500.0f;
@@ -292,7 +299,7 @@ protected:
 			// Dim color if player is disconnected.
 			// TODO: this isn't 100% accurate, I think, because a car might be "not in world" while the player
 			// is still connected? I haven't been able to find a better way to do this, though.
-			const bool isGone = !car.isSelf && ir_CarIdxTrackSurface.getInt(ci.carIdx) == irsdk_NotInWorld;
+			const bool isGone = !car.isSelf && ir_carIdx.trackSurface[ci.carIdx] == irsdk_NotInWorld;
 			float4 textCol = car.isSelf ? selfCol : (car.isBuddy ? buddyCol : (car.isFlagged ? flaggedCol : otherCarCol));
 			if (isGone)
 				textCol.a *= 0.5f;
@@ -309,7 +316,7 @@ protected:
 			// Car number
 			{
 				clm = m_columns.get((int)Columns::CAR_NUMBER);
-				swprintf(s, _countof(s), L"#%S", car.carNumberStr.c_str());
+				swprintf(s, _countof(s), L"#%S", car.carNumberStr);
 				r = { xoff + clm->textL, y - lineHeight / 2, xoff + clm->textR, y + lineHeight / 2 };
 				rr.rect = { r.left - 2, r.top + 1, r.right + 2, r.bottom - 1 };
 				rr.radiusX = 3;
@@ -324,17 +331,17 @@ protected:
 			{
 				clm = m_columns.get((int)Columns::NAME);
 				m_brush->SetColor(textCol);
-				swprintf(s, _countof(s), L"%S", car.userName.c_str());
+				swprintf(s, _countof(s), L"%S", car.userName);
 				m_text.render(m_renderTarget.Get(), s, m_textFormat.Get(), xoff + clm->textL, xoff + clm->textR, y, m_brush.Get(), DWRITE_TEXT_ALIGNMENT_LEADING);
 			}
 
 			// Pit age
-			if (!ir_isPreStart() && (ci.pitAge >= 0 || ir_CarIdxOnPitRoad.getBool(ci.carIdx)))
+			if (!ir_race.isPreStart && (ci.pitAge >= 0 || ir_carIdx.onPitRoad[ci.carIdx]))
 			{
 				clm = m_columns.get((int)Columns::PIT);
 				swprintf(s, _countof(s), L"%d", ci.pitAge);
 				r = { xoff + clm->textL, y - lineHeight / 2 + 2, xoff + clm->textR, y + lineHeight / 2 - 2 };
-				if (ir_CarIdxOnPitRoad.getBool(ci.carIdx)) {
+				if (ir_carIdx.onPitRoad[ci.carIdx]) {
 					swprintf(s, _countof(s), L"PIT");
 					m_brush->SetColor(pitCol);
 					m_renderTarget->FillRectangle(&r, m_brush.Get());
@@ -447,4 +454,6 @@ protected:
 
 	ColumnLayout m_columns;
 	TextCache    m_text;
+
+	std::vector<CarInfo> m_carInfo;
 };
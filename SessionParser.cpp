@@ -0,0 +1,495 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+#include "SessionParser.h"
+
+// Keys pulled out of every entry of the driver, session and results lists
+enum DriverKey { DRIVER_CarIdx, DRIVER_UserName, DRIVER_CarNumber, DRIVER_CarNumberRaw, DRIVER_LicString, DRIVER_LicColor, DRIVER_IRating,
+                 DRIVER_CarIsPaceCar, DRIVER_IsSpectator, DRIVER_CurDriverIncidentCount, DRIVER_CarClassEstLapTime, DRIVER_CarID, DRIVER_KEY_COUNT };
+static const char* const DriverKeys[] = { "CarIdx", "UserName", "CarNumber", "CarNumberRaw", "LicString", "LicColor", "IRating",
+                                          "CarIsPaceCar", "IsSpectator", "CurDriverIncidentCount", "CarClassEstLapTime", "CarID" };
+static const yamlQuery g_driverQuery( DriverKeys, DRIVER_KEY_COUNT );
+
+enum SessionKey { SESSION_SessionNum, SESSION_SessionName, SESSION_SessionTime, SESSION_SessionLaps, SESSION_ResultsPositions, SESSION_KEY_COUNT };
+static const char* const SessionKeys[] = { "SessionNum", "SessionName", "SessionTime", "SessionLaps", "ResultsPositions" };
+static const yamlQuery g_sessionQuery( SessionKeys, SESSION_KEY_COUNT );
+
+enum ResultKey { RESULT_Position, RESULT_CarIdx, RESULT_FastestTime, RESULT_KEY_COUNT };
+static const char* const ResultKeys[] = { "Position", "CarIdx", "FastestTime" };
+static const yamlQuery g_resultQuery( ResultKeys, RESULT_KEY_COUNT );
+
+static int yamlValueToInt( const yaml_value& v )
+{
+    return v.val ? atoi( v.val ) : 0;
+}
+
+static float yamlValueToFloat( const yaml_value& v )
+{
+    return v.val ? (float)atof( v.val ) : 0;
+}
+
+// Copies a value into a fixed size buffer, stripping quotes. Values that don't fit are cut
+// at a UTF-8 character boundary, so we never end up with half a character at the end.
+template<size_t N>
+static void yamlValueToStr( const yaml_value& v, char (&dest)[N] )
+{
+    const char* s = v.val;
+    int count = v.len;
+
+    dest[0] = 0;
+    if( !s )
+        return;
+
+    // strip leading quotes
+    if( count > 0 && *s == '"' )
+    {
+        s++;
+        count--;
+    }
+
+    // strip trailing quotes
+    if( count > 0 && s[count-1] == '"' )
+        count--;
+
+    if( count > int(N-1) )
+    {
+        count = int(N-1);
+        while( count > 0 && (s[count] & 0xC0) == 0x80 )
+            count--;
+    }
+
+    memcpy( dest, s, count );
+    dest[count] = 0;
+}
+
+static bool parseYamlInt(const yamlDocument& doc, const char *path, int *dest)
+{
+    int count = 0;
+    const char *s = nullptr;
+
+    if( doc.getValue(path, &s, &count) )
+    {
+        *dest = atoi( s );
+        return true;
+    }
+
+    return false;
+}
+
+static bool parseYamlFloat(const yamlDocument& doc, const char *path, float *dest)
+{
+    int count = 0;
+    const char *s = nullptr;
+
+    if( doc.getValue(path, &s, &count) )
+    {
+        (*dest) = (float)atof( s );
+        return true;
+    }
+
+    return false;
+}
+
+template<size_t N>
+static bool parseYamlStr(const yamlDocument& doc, const char *path, char (&dest)[N])
+{
+    yaml_value v = {};
+
+    if( doc.getValue(path, &v.val, &v.len) )
+    {
+        yamlValueToStr( v, dest );
+        return true;
+    }
+
+    return false;
+}
+
+// Top level sections of the session string we track changes for, see SectionKey
+static const char* const SectionKeys[] = { "WeekendInfo", "SessionInfo", "QualifyResultsInfo", "DriverInfo", "SplitTimeInfo", "CarSetup" };
+static const yamlQuery g_sectionQuery( SectionKeys, SECTION_KEY_COUNT );
+
+static void parseDriver( const yaml_value* v, Car& car )
+{
+    yamlValueToStr( v[DRIVER_UserName], car.userName );
+
+    // Remove line breaks in user names if we find any (saw this happen once)
+    for( char* c=car.userName; *c; ++c )
+        *c = (*c=='\n'||*c=='\r') ? ' ' : *c;
+
+    yamlValueToStr( v[DRIVER_CarNumber], car.carNumberStr );
+    car.carNumber = yamlValueToInt( v[DRIVER_CarNumberRaw] );
+
+    yamlValueToStr( v[DRIVER_LicString], car.licenseStr );
+    car.licenseChar = car.licenseStr[0] ? car.licenseStr[0] : 'R';
+    car.licenseSR = car.licenseStr[0] ? (float)atof( car.licenseStr+1 ) : 0;
+
+    yamlValueToStr( v[DRIVER_LicColor], car.licenseColStr );
+    unsigned licColHex = 0;
+    sscanf( car.licenseColStr, "0x%x", &licColHex );
+    car.licenseCol.r = float((licColHex >> 16) & 0xff) / 255.f;
+    car.licenseCol.g = float((licColHex >>  8) & 0xff) / 255.f;
+    car.licenseCol.b = float((licColHex >>  0) & 0xff) / 255.f;
+    car.licenseCol.a = 1;
+
+    car.irating = yamlValueToInt( v[DRIVER_IRating] );
+    car.isPaceCar = yamlValueToInt( v[DRIVER_CarIsPaceCar] );
+    car.isSpectator = yamlValueToInt( v[DRIVER_IsSpectator] );
+    car.incidentCount = yamlValueToInt( v[DRIVER_CurDriverIncidentCount] );
+    car.carClassEstLapTime = yamlValueToFloat( v[DRIVER_CarClassEstLapTime] );
+    car.carId = yamlValueToInt( v[DRIVER_CarID] );
+}
+
+// Returns the number of driver entries that were (re-)parsed or removed.
+static int parseDrivers( const yamlDocument& doc, Session& session, SessionParseState& state )
+{
+    int changed = 0;
+    bool seen[IR_MAX_CARS] = {};
+
+    const int driverList = doc.findNode( "DriverInfo:Drivers:" );
+    for( int entry=doc.getFirstEntry(driverList); entry>=0; entry=doc.getNextEntry(entry) )
+    {
+        yaml_value v[DRIVER_KEY_COUNT];
+        doc.getEntryValues( entry, g_driverQuery, v );
+
+        const int carIdx = yamlValueToInt( v[DRIVER_CarIdx] );
+        if( !v[DRIVER_CarIdx].val || carIdx < 0 || carIdx >= IR_MAX_CARS || !v[DRIVER_UserName].val )
+            continue;
+
+        seen[carIdx] = true;
+
+        const char* span = nullptr;
+        int spanLen = 0;
+        doc.getEntrySpan( entry, &span, &spanLen );
+        const unsigned hash = MurmurHash2( span, spanLen, 0x12341234 );
+
+        if( state.haveDriver[carIdx] && state.driverHash[carIdx] == hash )
+            continue;
+
+        state.haveDriver[carIdx] = true;
+        state.driverHash[carIdx] = hash;
+        parseDriver( v, session.cars[carIdx] );
+        changed++;
+    }
+
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        Car& car = session.cars[carIdx];
+
+        if( !seen[carIdx] && state.haveDriver[carIdx] )
+        {
+            state.haveDriver[carIdx] = false;
+            car = Car();
+            changed++;
+        }
+
+        car.isSelf = int( seen[carIdx] && carIdx==session.driverCarIdx );
+    }
+
+    return changed;
+}
+
+static void parsePositions( const yamlDocument& doc, Session& session )
+{
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        Car& car = session.cars[carIdx];
+        car.practicePosition = 0;
+        car.qualPosition = 0;
+        car.racePosition = 0;
+    }
+
+    // Qualifying results info (positions are 0-based here)
+    const int qualList = doc.findNode( "QualifyResultsInfo:Results:" );
+    for( int entry=doc.getFirstEntry(qualList); entry>=0; entry=doc.getNextEntry(entry) )
+    {
+        yaml_value v[RESULT_KEY_COUNT];
+        doc.getEntryValues( entry, g_resultQuery, v );
+
+        const int pos = yamlValueToInt( v[RESULT_Position] );
+        const int carIdx = yamlValueToInt( v[RESULT_CarIdx] );
+        if( !v[RESULT_Position].val || !v[RESULT_CarIdx].val || pos < 0 || pos >= IR_MAX_CARS || carIdx < 0 || carIdx >= IR_MAX_CARS )
+            continue;
+
+        session.cars[carIdx].qualPosition = pos + 1;
+        if( v[RESULT_FastestTime].val )
+            session.cars[carIdx].qualTime = yamlValueToFloat( v[RESULT_FastestTime] );
+    }
+
+    // Session info (may override qual results from above, but that's ok since hopefully they're the same!)
+    const int sessionList = doc.findNode( "SessionInfo:Sessions:" );
+    for( int entry=doc.getFirstEntry(sessionList); entry>=0; entry=doc.getNextEntry(entry) )
+    {
+        yaml_value v[SESSION_KEY_COUNT];
+        doc.getEntryValues( entry, g_sessionQuery, v );
+
+        if( !v[SESSION_SessionName].val )
+            continue;
+
+        char sessionNameStr[32];
+        yamlValueToStr( v[SESSION_SessionName], sessionNameStr );
+
+        char str[32];
+        yamlValueToStr( v[SESSION_SessionTime], str );
+        session.isUnlimitedTime = int( !strcmp(str,"unlimited") );
+
+        yamlValueToStr( v[SESSION_SessionLaps], str );
+        session.isUnlimitedLaps = int( !strcmp(str,"unlimited") );
+
+        const int resultsList = v[SESSION_ResultsPositions].node;
+        for( int res=doc.getFirstEntry(resultsList); res>=0; res=doc.getNextEntry(res) )
+        {
+            yaml_value rv[RESULT_KEY_COUNT];
+            doc.getEntryValues( res, g_resultQuery, rv );
+
+            const int pos = yamlValueToInt( rv[RESULT_Position] );
+            const int carIdx = yamlValueToInt( rv[RESULT_CarIdx] );
+            if( !rv[RESULT_Position].val || !rv[RESULT_CarIdx].val || pos < 1 || pos > IR_MAX_CARS || carIdx < 0 || carIdx >= IR_MAX_CARS )
+                continue;
+
+            if( !strcmp(sessionNameStr,"PRACTICE") )
+                session.cars[carIdx].practicePosition = pos;
+            else if( !strcmp(sessionNameStr,"QUALIFY") )
+                session.cars[carIdx].qualPosition = pos;
+            else if( !strcmp(sessionNameStr,"RACE") )
+                session.cars[carIdx].racePosition = pos;
+        }
+    }
+}
+
+bool parseSessionStr( const char* sessionYaml, int sessionNum, Session& session, SessionParseState& state, SessionParseStats& stats )
+{
+    state.doc.parse( sessionYaml );
+    const yamlDocument& doc = state.doc;
+
+    bool changed[SECTION_KEY_COUNT] = {};
+    bool present[SECTION_KEY_COUNT] = {};
+    for( int idx=doc.getFirstRoot(); idx>=0; idx=doc.getNode(idx).nextSibling )
+    {
+        const int section = g_sectionQuery.find( doc.getKey(idx), doc.getNode(idx).keyLen );
+        if( section < 0 )
+            continue;
+
+        const char* span = nullptr;
+        int spanLen = 0;
+        doc.getSpan( idx, &span, &spanLen );
+        const unsigned hash = MurmurHash2( span, spanLen, 0x12341234 );
+
+        present[section] = true;
+        changed[section] = !state.haveSection[section] || state.sectionHash[section] != hash;
+        state.sectionHash[section] = hash;
+    }
+
+    int sectionsParsed = 0;
+    for( int section=0; section<SECTION_KEY_COUNT; ++section )
+    {
+        // A section that went away counts as a change, too
+        if( !present[section] && state.haveSection[section] )
+            changed[section] = true;
+        state.haveSection[section] = present[section];
+
+        if( changed[section] )
+            sectionsParsed++;
+    }
+
+    // Weekend info
+    if( changed[SECTION_WeekendInfo] )
+    {
+        parseYamlInt( doc, "WeekendInfo:SubSessionID:", &session.subsessionId );
+        parseYamlInt( doc, "WeekendInfo:TrackID:", &session.trackId );
+        parseYamlInt( doc, "WeekendInfo:WeekendOptions:IsFixedSetup:", &session.isFixedSetup );
+    }
+
+    // Current session type. Depends on the session number from telemetry, so always look it up.
+    {
+        char path[256];
+        char sessionNameStr[32] = "";
+        sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionName:", sessionNum );
+        parseYamlStr( doc, path, sessionNameStr );
+        if( !strcmp(sessionNameStr,"PRACTICE") )
+            session.sessionType = SessionType::PRACTICE;
+        if( !strcmp(sessionNameStr,"QUALIFY") )
+            session.sessionType = SessionType::QUALIFY;
+        else if( !strcmp(sessionNameStr,"RACE") )
+            session.sessionType = SessionType::RACE;
+    }
+
+    // Driver/car info
+    int driversParsed = 0;
+    if( changed[SECTION_DriverInfo] )
+    {
+        parseYamlInt( doc, "DriverInfo:DriverCarIdx:", &session.driverCarIdx );
+        parseYamlFloat( doc, "DriverInfo:DriverCarFuelMaxLtr:", &session.fuelMaxLtr );
+        parseYamlFloat( doc, "DriverInfo:DriverCarFuelKgPerLtr:", &session.fuelKgPerLtr );
+        parseYamlFloat( doc, "DriverInfo:DriverCarIdleRPM:", &session.rpmIdle );
+        parseYamlFloat( doc, "DriverInfo:DriverCarRedLine:", &session.rpmRedline );
+        parseYamlFloat( doc, "DriverInfo:DriverCarSLFirstRPM:", &session.rpmSLFirst );
+        parseYamlFloat( doc, "DriverInfo:DriverCarSLShiftRPM:", &session.rpmSLShift );
+        parseYamlFloat( doc, "DriverInfo:DriverCarSLLastRPM:", &session.rpmSLLast );
+        parseYamlFloat( doc, "DriverInfo:DriverCarSLBlinkRPM:", &session.rpmSLBlink );
+
+        driversParsed = parseDrivers( doc, session, state );
+    }
+
+    // Sector lines
+    if( changed[SECTION_SplitTimeInfo] )
+    {
+        char path[256];
+        session.numSectors = 0;
+        while( session.numSectors < IR_MAX_SECTORS )
+        {
+            sprintf( path, "SplitTimeInfo:Sectors:SectorNum:{%d}SectorStartPct:", session.numSectors );
+            if( !parseYamlFloat( doc, path, &session.sectorStartPct[session.numSectors] ) )
+                break;
+            session.numSectors++;
+        }
+    }
+
+    // Positions come from two sections, and a driver leaving wipes its car, so redo them if any of those changed
+    if( changed[SECTION_DriverInfo] || changed[SECTION_QualifyResultsInfo] || changed[SECTION_SessionInfo] )
+        parsePositions( doc, session );
+
+    // SoF
+    if( driversParsed )
+    {
+        double sof = 0;
+        int cnt = 0;
+        for( int i=0; i<IR_MAX_CARS; ++i )
+        {
+            const Car& car = session.cars[i];
+
+            if( car.isPaceCar || car.isSpectator || !car.userName[0] )
+                continue;
+
+            sof += car.irating;
+            cnt++;
+        }
+        session.sof = cnt ? int(sof / cnt) : 0;
+    }
+
+    stats.updates++;
+    stats.sectionsParsed = sectionsParsed;
+    stats.driversParsed = driversParsed;
+    stats.totalSectionsParsed += sectionsParsed;
+    stats.totalDriversParsed += driversParsed;
+
+    return driversParsed > 0;
+}
+
+// Snapshots are traded between threads by copying, which must never need the heap.
+static_assert( std::is_trivially_copyable<Session>::value, "Session must be trivially copyable" );
+
+SessionParser::SessionParser()
+{
+    m_thread = std::thread( &SessionParser::run, this );
+}
+
+SessionParser::~SessionParser()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_quit = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+}
+
+void SessionParser::request( const char* sessionYaml, int sessionNum, int statusId )
+{
+    // The sim can rewrite the string, or unmap it on a disconnect, any time after we return. The buffers
+    // only ever get swapped around, so once they're big enough this doesn't allocate.
+    m_copy.assign( sessionYaml );
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_reqYaml.swap( m_copy );
+        m_reqSessionNum = sessionNum;
+        m_reqStatusId = statusId;
+        m_reqPending = true;
+    }
+    m_cv.notify_one();
+}
+
+void SessionParser::parseNow( const char* sessionYaml, int sessionNum, int statusId )
+{
+    m_yaml.assign( sessionYaml );
+    parse( sessionNum, statusId );
+}
+
+SessionSnapshot* SessionParser::fetch()
+{
+    if( !(m_middle.load() & FRESH) )
+        return nullptr;
+
+    m_front = m_middle.exchange( m_front ) & ~FRESH;
+    return &m_buffers[m_front];
+}
+
+void SessionParser::run()
+{
+    while( true )
+    {
+        int sessionNum = 0;
+        int statusId = 0;
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_cv.wait( lock, [this]{ return m_reqPending || m_quit; } );
+            if( m_quit )
+                return;
+            m_yaml.swap( m_reqYaml );
+            sessionNum = m_reqSessionNum;
+            statusId = m_reqStatusId;
+            m_reqPending = false;
+        }
+
+        parse( sessionNum, statusId );
+    }
+}
+
+void SessionParser::parse( int sessionNum, int statusId )
+{
+#ifdef _DEBUG
+    //printf("%s\n", m_yaml.c_str());
+    FILE* fp = fopen("sessionYaml.txt","ab");
+    fprintf(fp,"\n\n==== NEW SESSION STRING ======================================\n");
+    fprintf(fp,"%s",m_yaml.c_str());
+    fclose(fp);
+#endif
+    // Forget everything we know about the previous string on a new connection
+    if( statusId != m_state.statusId )
+    {
+        m_state = SessionParseState();
+        m_state.statusId = statusId;
+        m_session = Session();
+    }
+
+    parseSessionStr( m_yaml.c_str(), sessionNum, m_session, m_state, m_stats );
+
+    SessionSnapshot& back = m_buffers[m_back];
+    back.session = m_session;
+    back.stats = m_stats;
+    m_back = m_middle.exchange( m_back | FRESH ) & ~FRESH;
+}
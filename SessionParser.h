@@ -0,0 +1,193 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "irsdk/yaml_parser.h"
+#include "base.h"
+
+// The session data that comes out of the sim's session string, and the parser that keeps it up to date.
+// Doesn't depend on Windows or the sim, so the tools can share it.
+
+#define IR_MAX_CARS 64
+#define IR_MAX_SECTORS 32
+
+enum class SessionType
+{
+    UNKNOWN = 0,
+    PRACTICE,
+    QUALIFY,
+    RACE
+};
+static const char* const SessionTypeStr[] = {"UNKNOWN","PRACTICE","QUALIFY","RACE"};
+
+// Text fields are stored inline, so a Car (and a whole Session) can be copied without touching the heap.
+// Values that don't fit are truncated.
+struct Car
+{    
+    char            userName[64] = "";
+    int             carNumber = 0;
+    char            carNumberStr[8] = "";
+    char            licenseStr[16] = "";
+    char            licenseChar = 'R';
+    float           licenseSR = 0;
+    char            licenseColStr[16] = "";
+    float4          licenseCol = float4(0,0,0,1);
+    int             irating = 0;
+    int             isSelf = 0;
+    int             isPaceCar = 0;
+    int             isSpectator = 0;
+    int             isBuddy = 0;
+    int             isFlagged = 0;
+    int             incidentCount = 0;
+    float           carClassEstLapTime = 0;
+    int             practicePosition = 0;
+    int             qualPosition = 0;
+    float           qualTime = 0;
+    int             racePosition = 0;
+    int             lastLapInPits = 0;
+    int             carId = 0;
+};
+
+struct Session
+{
+    SessionType     sessionType = SessionType::UNKNOWN;
+    Car             cars[IR_MAX_CARS];
+    int             driverCarIdx = -1;
+    int             sof = 0;
+    int             subsessionId = 0;
+    int             trackId = 0;
+    int             isFixedSetup = 0;
+    int             isUnlimitedTime = 0;
+    int             isUnlimitedLaps = 0;
+    float           fuelMaxLtr = 0;
+    float           fuelKgPerLtr = 0.75f;
+    float           rpmIdle = 0;
+    float           rpmRedline = 0;
+    float           rpmSLFirst = 0;
+    float           rpmSLShift = 0;
+    float           rpmSLLast = 0;
+    float           rpmSLBlink = 0;
+    int             numSectors = 0;                         // as the track splits the lap, 0 if it doesn't say
+    float           sectorStartPct[IR_MAX_SECTORS] = {};
+};
+
+// How much work the last session string updates caused. Only the top level sections
+// and driver entries whose text changed get reparsed.
+struct SessionParseStats
+{
+    int             updates = 0;
+    int             sectionsParsed = 0;         // in the last update
+    int             driversParsed = 0;          // in the last update, including drivers that left
+    int             totalSectionsParsed = 0;
+    int             totalDriversParsed = 0;
+};
+
+// Top level sections of the session string we track changes for
+enum SectionKey { SECTION_WeekendInfo, SECTION_SessionInfo, SECTION_QualifyResultsInfo, SECTION_DriverInfo, SECTION_SplitTimeInfo, SECTION_CarSetup, SECTION_KEY_COUNT };
+
+// What we remember about the last session string, so we only need to reparse the parts that changed.
+struct SessionParseState
+{
+    yamlDocument doc;   // tokenized session string, so the many lookups below don't each rescan the whole string
+    int         statusId = -1;
+    unsigned    sectionHash[SECTION_KEY_COUNT] = {};
+    bool        haveSection[SECTION_KEY_COUNT] = {};
+    unsigned    driverHash[IR_MAX_CARS] = {};
+    bool        haveDriver[IR_MAX_CARS] = {};
+};
+
+// Bring 'session' up to date with a new session string, only reparsing the top level sections
+// and driver entries whose contents changed since the last call with the same 'state'.
+// Returns true if the driver list changed.
+bool parseSessionStr( const char* sessionYaml, int sessionNum, Session& session, SessionParseState& state, SessionParseStats& stats );
+
+// A fully parsed session, as handed from the parser thread to the main thread.
+struct SessionSnapshot
+{
+    Session             session;
+    SessionParseStats   stats;
+};
+
+//
+// Parses session strings on a worker thread, so that a big update doesn't stall the frame.
+//
+// Finished sessions are passed to the main thread through a triple buffer: the worker always
+// has a buffer to write into, the main thread always has one to read from, and the third one
+// is traded between them with an atomic exchange. Neither side ever waits for the other.
+//
+class SessionParser
+{
+    public:
+
+        SessionParser();
+        ~SessionParser();
+
+        // Queue a session string for parsing. The string is copied before this returns, so it only has to be
+        // valid for the call. Supersedes any request not yet picked up.
+        void request( const char* sessionYaml, int sessionNum, int statusId );
+
+        // Parse a session string right here on the calling thread instead, and publish it like the worker would.
+        // Don't mix with request(), the worker and this share the parse state.
+        void parseNow( const char* sessionYaml, int sessionNum, int statusId );
+
+        // Returns the newest finished snapshot, or nullptr if nothing new was published since the last call.
+        // The snapshot stays owned by the main thread until the next call.
+        SessionSnapshot* fetch();
+
+    private:
+
+        void run();
+        void parse( int sessionNum, int statusId );
+
+        static const int        FRESH = 0x4;    // set in m_middle when it holds a snapshot the main thread hasn't seen
+
+        SessionSnapshot         m_buffers[3];
+        int                     m_back = 0;     // worker thread only
+        int                     m_front = 1;    // main thread only
+        std::atomic<int>        m_middle{2};
+
+        // parse state, only touched by whichever thread does the parsing
+        std::string             m_yaml;         // the string being parsed
+        Session                 m_session;
+        SessionParseState       m_state;
+        SessionParseStats       m_stats;
+
+        std::string             m_copy;         // calling thread only, swapped into m_reqYaml
+
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;
+        std::string             m_reqYaml;
+        int                     m_reqSessionNum = 0;
+        int                     m_reqStatusId = 0;
+        bool                    m_reqPending = false;
+        bool                    m_quit = false;
+
+        std::thread             m_thread;
+};
@@ -0,0 +1,435 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <math.h>
+#include <algorithm>
+#include "Strategy.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const int MaxStops = 4;
+static const int RunsPerBatch = 32;
+static const int MaxRunsPerPlan = 4096;
+static const int GreenBins = 256;
+
+struct StrategyPlan
+{
+    int     stops = 0;
+    int     stopLap[MaxStops] = {};     // laps from now, pitting at the end of each
+    bool    tires = false;
+};
+
+struct StrategyPlanStats
+{
+    int     runs = 0;
+    int     dry = 0;
+    double  timeSum = 0;                // of the runs that made it to the finish
+    int     stopped = 0;                // runs that made it to the first stop
+    double  firstAddSum = 0;
+    int     greenHist[GreenBins] = {};  // green lap equivalents to the finish, relative to lapsToGo
+};
+
+// xorshift64*. Every plan gets the same seeds, so they all race through the same cautions and are
+// told apart by the plan and not by luck.
+struct StrategyRng
+{
+    unsigned long long s;
+    double             spare = 0;
+    bool               haveSpare = false;
+
+    explicit StrategyRng( unsigned long long seed ) : s( seed * 0x9E3779B97F4A7C15ull + 1 ) {}
+
+    double uniform()
+    {
+        s ^= s >> 12;
+        s ^= s << 25;
+        s ^= s >> 27;
+        return ((s * 0x2545F4914F6CDD1Dull) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Box-Muller, which makes two at a time
+    double normal()
+    {
+        if( haveSpare )
+        {
+            haveSpare = false;
+            return spare;
+        }
+
+        const double r = sqrt( -2 * log( std::max( uniform(), 1e-12 ) ) );
+        const double a = 6.283185307179586 * uniform();
+        spare = r * sin( a );
+        haveSpare = true;
+        return r * cos( a );
+    }
+};
+
+// Fuel to leave the pits with for a stint, with a margin for the spread in use
+static float fuelForStint( const StrategyInputs& in, int laps )
+{
+    return laps * in.fuelPerLap + 3 * in.fuelPerLapSpread * sqrtf( (float)laps );
+}
+
+// One run from here to the finish with the given plan
+static void simulate( const StrategyInputs& in, const StrategyPlan& plan, StrategyRng& rng, StrategyPlanStats& stats )
+{
+    double fuel = in.fuelLevel;
+    double tread = in.tireTread;
+    double t = 0;
+    double green = 0;
+    int    caution = 0;
+    int    nextStop = 0;
+    bool   dry = false;
+
+    for( int lap=0; lap<in.lapsToGo; ++lap )
+    {
+        const double part = lap == 0 ? 1 - in.lapPct : 1;
+
+        if( !caution && rng.uniform() < in.cautionChance * part )
+            caution = in.cautionLaps;
+        const bool underCaution = caution > 0;
+
+        const double factor = underCaution ? in.cautionFuelFactor : 1.0;
+        fuel -= part * factor * std::max( 0.0, in.fuelPerLap + in.fuelPerLapSpread * rng.normal() );
+        green += part * factor;
+        if( fuel < 0 )
+            dry = true;
+
+        if( underCaution )
+        {
+            t += part * in.lapTime * 1.6;
+            tread -= part * in.treadPerLap * 0.3;
+        }
+        else
+        {
+            const double worn = 1 - std::max( 0.0, tread );
+            t += part * (in.lapTime * (1 + 0.004 * rng.normal()) + in.wornTireLoss * worn * worn);
+            tread -= part * in.treadPerLap;
+        }
+
+        if( nextStop < plan.stops && plan.stopLap[nextStop] == lap && lap < in.lapsToGo - 1 && !dry )
+        {
+            const int   stintEnd = nextStop + 1 < plan.stops ? plan.stopLap[nextStop+1] : in.lapsToGo - 1;
+            const float need = fuelForStint( in, stintEnd - lap );
+            const double add = std::max( 0.0, std::min( (double)need, (double)in.tankSize ) - fuel );
+
+            // the field is slow under caution, so the pit lane costs less
+            t += (underCaution ? 0.5 : 1.0) * in.pitLaneLoss + std::max( add / in.fuelFillRate, plan.tires ? (double)in.tireChangeTime : 0.0 );
+            fuel += add;
+            if( plan.tires )
+                tread = 1;
+
+            if( nextStop == 0 )
+            {
+                stats.stopped++;
+                stats.firstAddSum += add;
+            }
+            nextStop++;
+        }
+
+        if( caution )
+            caution--;
+    }
+
+    stats.runs++;
+    if( dry )
+        stats.dry++;
+    else
+        stats.timeSum += t;
+
+    const int bin = (int)(green / std::max( 1, in.lapsToGo ) * (GreenBins - 1) + 0.5);
+    stats.greenHist[std::min( std::max( bin, 0 ), GreenBins - 1 )]++;
+}
+
+static void makePlans( const StrategyInputs& in, std::vector<StrategyPlan>& plans )
+{
+    plans.clear();
+
+    const float need = (in.lapsToGo - in.lapPct) * in.fuelPerLap;
+    const int   minStops = need <= in.fuelLevel ? 0 : (int)ceilf( (need - in.fuelLevel) / in.tankSize );
+
+    // the last lap we can get to the pits at the end of on the fuel we have
+    const int lastFirstStop = std::min( in.lapsToGo - 2, (int)floorf( in.fuelLevel / in.fuelPerLap - (1 - in.lapPct) ) );
+
+    for( int stops=minStops; stops<=std::min( minStops+1, MaxStops ); ++stops )
+    {
+        if( stops == 0 )
+        {
+            plans.push_back( StrategyPlan() );
+            continue;
+        }
+
+        for( int first=0; first<=lastFirstStop; ++first )
+        {
+            // the rest of the race split evenly between the stints after the first stop
+            const int rest = in.lapsToGo - 1 - first;
+            if( fuelForStint( in, (rest + stops - 1) / stops ) > in.tankSize )
+                continue;
+
+            StrategyPlan plan;
+            plan.stops = stops;
+            for( int i=0; i<stops; ++i )
+                plan.stopLap[i] = first + rest * i / stops;
+
+            plans.push_back( plan );
+            if( in.treadPerLap > 0 )
+            {
+                plan.tires = true;
+                plans.push_back( plan );
+            }
+        }
+    }
+}
+
+static StrategyResult evaluate( const StrategyInputs& in, const std::vector<StrategyPlan>& plans, const std::vector<StrategyPlanStats>& workerStats, int numWorkers )
+{
+    const int numPlans = (int)plans.size();
+    std::vector<StrategyPlanStats> stats( numPlans );
+    for( int w=0; w<numWorkers; ++w )
+    {
+        for( int p=0; p<numPlans; ++p )
+        {
+            const StrategyPlanStats& src = workerStats[w * numPlans + p];
+            StrategyPlanStats& dst = stats[p];
+            dst.runs += src.runs;
+            dst.dry += src.dry;
+            dst.timeSum += src.timeSum;
+            dst.stopped += src.stopped;
+            dst.firstAddSum += src.firstAddSum;
+            for( int i=0; i<GreenBins; ++i )
+                dst.greenHist[i] += src.greenHist[i];
+        }
+    }
+
+    StrategyResult res;
+    for( const StrategyPlanStats& s : stats )
+        res.simulations += s.runs;
+
+    // Least likely to run dry first, then fastest
+    double minDry = 1;
+    for( const StrategyPlanStats& s : stats )
+        if( s.runs )
+            minDry = std::min( minDry, (double)s.dry / s.runs );
+
+    auto eligible = [&]( const StrategyPlanStats& s ) { return s.runs && s.runs > s.dry && (double)s.dry / s.runs <= minDry + 0.01; };
+    auto meanTime = [&]( const StrategyPlanStats& s ) { return s.timeSum / (s.runs - s.dry); };
+
+    int best = -1;
+    for( int p=0; p<numPlans; ++p )
+        if( eligible( stats[p] ) && (best < 0 || meanTime( stats[p] ) < meanTime( stats[best] )) )
+            best = p;
+    if( best < 0 )
+        return res;
+
+    const StrategyPlan& bp = plans[best];
+    const StrategyPlanStats& bs = stats[best];
+    res.valid = true;
+    res.stops = bp.stops;
+    res.changeTires = bp.tires;
+    res.dryChance = (float)bs.dry / bs.runs;
+    res.fuelToAdd = bs.stopped ? (float)(bs.firstAddSum / bs.stopped) : 0;
+
+    // The window: first stops of the same kind of plan that are as good, give or take a second
+    for( int p=0; p<numPlans; ++p )
+    {
+        const StrategyPlan& plan = plans[p];
+        if( !bp.stops || plan.stops != bp.stops || plan.tires != bp.tires || !eligible( stats[p] ) || meanTime( stats[p] ) > meanTime( bs ) + 1.0 )
+            continue;
+        res.windowOpen = res.windowOpen < 0 ? plan.stopLap[0] : std::min( res.windowOpen, plan.stopLap[0] );
+        res.windowClose = std::max( res.windowClose, plan.stopLap[0] );
+    }
+
+    // Saving enough to make do with a stop less, filling up at the ones left, in 9 out of 10 runs
+    if( bp.stops > 0 )
+    {
+        int greenHist[GreenBins] = {};
+        int runs = 0;
+        for( const StrategyPlanStats& s : stats )
+        {
+            for( int i=0; i<GreenBins; ++i )
+                greenHist[i] += s.greenHist[i];
+            runs += s.runs;
+        }
+
+        int bin = GreenBins - 1;
+        for( int n=0; bin>0; --bin )
+            if( (n += greenHist[bin]) >= runs / 10 )
+                break;
+
+        const float greenLaps = (float)bin / (GreenBins - 1) * in.lapsToGo;
+        const float target = (in.fuelLevel + (bp.stops - 1) * in.tankSize) / std::max( 0.1f, greenLaps );
+        if( target < in.fuelPerLap && target >= 0.85f * in.fuelPerLap )
+            res.saveTarget = target;
+    }
+
+    return res;
+}
+
+StrategyEngine::StrategyEngine( int numThreads )
+{
+    if( numThreads <= 0 )
+        numThreads = std::min( 4, std::max( 1, (int)std::thread::hardware_concurrency() - 1 ) );
+
+    m_numWorkers = numThreads;
+    m_threads.emplace_back( &StrategyEngine::run, this );
+    for( int i=0; i<numThreads; ++i )
+        m_threads.emplace_back( &StrategyEngine::work, this, i );
+}
+
+StrategyEngine::~StrategyEngine()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_quit = true;
+    }
+    m_cv.notify_all();
+    for( std::thread& t : m_threads )
+        t.join();
+}
+
+void StrategyEngine::request( const StrategyInputs& in )
+{
+    {
+        std::lock_guard<std::mutex> lock( m_mutex );
+        m_request = in;
+        m_requestPending = true;
+    }
+    m_cv.notify_all();
+}
+
+bool StrategyEngine::fetch( StrategyResult& out )
+{
+    // never wait on a round being published, there'll be another one
+    std::unique_lock<std::mutex> lock( m_mutex, std::try_to_lock );
+    if( !lock.owns_lock() || !m_resultFresh )
+        return false;
+
+    out = m_result;
+    m_resultFresh = false;
+    return true;
+}
+
+void StrategyEngine::run()
+{
+    while( true )
+    {
+        StrategyInputs in;
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_cv.wait( lock, [this]{ return m_requestPending || m_quit; } );
+            if( m_quit )
+                return;
+            in = m_request;
+            m_requestPending = false;
+        }
+
+        runRound( in );
+    }
+}
+
+void StrategyEngine::runRound( const StrategyInputs& in )
+{
+    const Clock::time_point start = Clock::now();
+
+    StrategyResult res;
+    if( in.lapsToGo > 0 && in.fuelPerLap > 0 && in.lapTime > 0 && in.tankSize > 0 && in.fuelFillRate > 0 )
+    {
+        std::vector<StrategyPlan> plans;
+        makePlans( in, plans );
+
+        if( !plans.empty() )
+        {
+            std::vector<StrategyPlanStats> stats( m_numWorkers * plans.size() );
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+
+                // the workers may have quit while we were making the plans, nobody would finish the round
+                if( m_quit )
+                    return;
+
+                m_roundInputs = &in;
+                m_roundPlans = &plans;
+                m_roundStats = &stats;
+                m_roundDeadline = start + std::chrono::milliseconds( in.budgetMs );
+                m_nextBatch = 0;
+                m_numBatches = (int)plans.size() * (MaxRunsPerPlan / RunsPerBatch);
+                m_workersBusy = m_numWorkers;
+                m_roundId++;
+            }
+            m_cv.notify_all();
+
+            // the workers give up at the deadline, so this doesn't take much longer than the budget
+            {
+                std::unique_lock<std::mutex> lock( m_mutex );
+                m_doneCv.wait( lock, [this]{ return m_workersBusy == 0; } );
+            }
+
+            res = evaluate( in, plans, stats, m_numWorkers );
+        }
+    }
+    res.roundMs = std::chrono::duration<float,std::milli>( Clock::now() - start ).count();
+
+    std::lock_guard<std::mutex> lock( m_mutex );
+    m_result = res;
+    m_resultFresh = true;
+}
+
+void StrategyEngine::work( int worker )
+{
+    int roundSeen = 0;
+    while( true )
+    {
+        {
+            std::unique_lock<std::mutex> lock( m_mutex );
+            m_cv.wait( lock, [&]{ return m_roundId != roundSeen || m_quit; } );
+
+            // a round that was started gets finished, the coordinating thread waits for it
+            if( m_roundId == roundSeen )
+                return;
+            roundSeen = m_roundId;
+        }
+
+        // Batches go round robin over the plans, so they all get about as many runs when the time is up
+        const StrategyInputs& in = *m_roundInputs;
+        const std::vector<StrategyPlan>& plans = *m_roundPlans;
+        const int numPlans = (int)plans.size();
+        StrategyPlanStats* stats = &(*m_roundStats)[worker * numPlans];
+
+        while( Clock::now() < m_roundDeadline )
+        {
+            const int batch = m_nextBatch++;
+            if( batch >= m_numBatches )
+                break;
+
+            const int plan = batch % numPlans;
+            StrategyRng rng( (unsigned long long)roundSeen << 32 | (unsigned)(batch / numPlans) );
+            for( int i=0; i<RunsPerBatch; ++i )
+                simulate( in, plans[plan], rng, stats[plan] );
+        }
+
+        std::lock_guard<std::mutex> lock( m_mutex );
+        if( --m_workersBusy == 0 )
+            m_doneCv.notify_one();
+    }
+}
@@ -0,0 +1,122 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+// Pit strategy for the rest of the race, from thousands of simulated runs to the finish with random fuel use,
+// lap times and cautions. Every plan (number of stops, the lap of the first one, tires or not) gets the same
+// share of the runs a round manages within its time budget.
+
+struct StrategyInputs
+{
+    int     lapsToGo = 0;               // including the one we're on
+    float   lapPct = 0;                 // how far into the current lap we are
+    float   lapTime = 0;                // s, green lap
+    float   fuelLevel = 0;              // l
+    float   tankSize = 0;               // l
+    float   fuelPerLap = 0;             // l, green lap
+    float   fuelPerLapSpread = 0;       // l, standard deviation of a green lap's use
+    float   cautionFuelFactor = 0.4f;   // use of a caution lap relative to a green one
+    float   tireTread = 1;              // least tread left on any tire, 0-1
+    float   treadPerLap = 0;            // tread lost per green lap
+    float   wornTireLoss = 3;           // s per lap on tires with no tread left
+    float   pitLaneLoss = 25;           // s, driving through the pit lane instead of past it
+    float   fuelFillRate = 2.5f;        // l/s
+    float   tireChangeTime = 20;        // s, at the same time as the fuel goes in
+    float   cautionChance = 0.02f;      // of a caution starting on any lap
+    int     cautionLaps = 3;
+    int     budgetMs = 20;              // per round
+};
+
+struct StrategyResult
+{
+    bool    valid = false;
+    int     simulations = 0;            // in the round this came from
+    float   roundMs = 0;
+    int     stops = 0;                  // in the best plan
+    bool    changeTires = false;        // at the next stop
+    int     windowOpen = -1;            // first and last lap from now (0 is this one) the next stop can be made on
+    int     windowClose = -1;           // without losing more than a second on average, -1 without a stop
+    float   fuelToAdd = 0;              // l, at the next stop
+    float   saveTarget = 0;             // l per green lap that makes it with a stop less 9 out of 10 times, 0 if out of reach
+    float   dryChance = 0;              // of running out of fuel with the best plan
+};
+
+struct StrategyPlan;
+struct StrategyPlanStats;
+
+// Simulates on a pool of worker threads. request() and fetch() don't wait for them, so they can be called
+// from the render loop.
+class StrategyEngine
+{
+    public:
+
+        // 0 threads for one less than there are cores, at most four
+        explicit StrategyEngine( int numThreads = 0 );
+        ~StrategyEngine();
+
+        // Start a round on these inputs once the current one is done. Supersedes any request not yet picked up.
+        void request( const StrategyInputs& in );
+
+        // Copies the newest finished round into out. False if nothing new was finished since the last call.
+        bool fetch( StrategyResult& out );
+
+    private:
+
+        void run();
+        void work( int worker );
+        void runRound( const StrategyInputs& in );
+
+        std::vector<std::thread>    m_threads;
+        std::mutex                  m_mutex;
+        std::condition_variable     m_cv;
+        std::condition_variable     m_doneCv;
+        bool                        m_quit = false;
+
+        // requests, from the caller to the coordinating thread
+        StrategyInputs              m_request;
+        bool                        m_requestPending = false;
+
+        // the round being simulated, from the coordinating thread to the workers
+        const StrategyInputs*       m_roundInputs = nullptr;
+        const std::vector<StrategyPlan>* m_roundPlans = nullptr;
+        std::vector<StrategyPlanStats>* m_roundStats = nullptr; // per worker and plan
+        std::chrono::steady_clock::time_point m_roundDeadline;
+        std::atomic<int>            m_nextBatch{ 0 };
+        int                         m_numBatches = 0;
+        int                         m_roundId = 0;
+        int                         m_numWorkers = 0;
+        int                         m_workersBusy = 0;
+
+        // finished rounds, from the coordinating thread to the caller
+        StrategyResult              m_result;
+        bool                        m_resultFresh = false;
+};
@@ -22,528 +22,1255 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 SOFTWARE.
 */
 
+#include <math.h>
+#include <float.h>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "iracing.h"
 #include "Config.h"
 
-irsdkCVar ir_SessionTime("SessionTime");    // double[1] Seconds since session start (s)
-irsdkCVar ir_SessionTick("SessionTick");    // int[1] Current update number ()
-irsdkCVar ir_SessionNum("SessionNum");    // int[1] Session number ()
-irsdkCVar ir_SessionState("SessionState");    // int[1] Session state (irsdk_SessionState)
-irsdkCVar ir_SessionUniqueID("SessionUniqueID");    // int[1] Session ID ()
-irsdkCVar ir_SessionFlags("SessionFlags");    // bitfield[1] Session flags (irsdk_Flags)
-irsdkCVar ir_SessionTimeRemain("SessionTimeRemain");    // double[1] Seconds left till session ends (s)
-irsdkCVar ir_SessionLapsRemain("SessionLapsRemain");    // int[1] Old laps left till session ends use SessionLapsRemainEx ()
-irsdkCVar ir_SessionLapsRemainEx("SessionLapsRemainEx");    // int[1] New improved laps left till session ends ()
-irsdkCVar ir_SessionTimeTotal("SessionTimeTotal");    // double[1] Total number of seconds in session (s)
-irsdkCVar ir_SessionLapsTotal("SessionLapsTotal");    // int[1] Total number of laps in session ()
-irsdkCVar ir_SessionTimeOfDay("SessionTimeOfDay");    // float[1] Time of day in seconds (s)
-irsdkCVar ir_RadioTransmitCarIdx("RadioTransmitCarIdx");    // int[1] The car index of the current person speaking on the radio ()
-irsdkCVar ir_RadioTransmitRadioIdx("RadioTransmitRadioIdx");    // int[1] The radio index of the current person speaking on the radio ()
-irsdkCVar ir_RadioTransmitFrequencyIdx("RadioTransmitFrequencyIdx");    // int[1] The frequency index of the current person speaking on the radio ()
-irsdkCVar ir_DisplayUnits("DisplayUnits");    // int[1] Default units for the user interface 0 = english 1 = metric ()
-irsdkCVar ir_DriverMarker("DriverMarker");    // bool[1] Driver activated flag ()
-irsdkCVar ir_PushToPass("PushToPass");    // bool[1] Push to pass button state ()
-irsdkCVar ir_ManualBoost("ManualBoost");    // bool[1] Hybrid manual boost state ()
-irsdkCVar ir_ManualNoBoost("ManualNoBoost");    // bool[1] Hybrid manual no boost state ()
-irsdkCVar ir_IsOnTrack("IsOnTrack");    // bool[1] 1=Car on track physics running with player in car ()
-irsdkCVar ir_IsReplayPlaying("IsReplayPlaying");    // bool[1] 0=replay not playing  1=replay playing ()
-irsdkCVar ir_ReplayFrameNum("ReplayFrameNum");    // int[1] Integer replay frame number (60 per second) ()
-irsdkCVar ir_ReplayFrameNumEnd("ReplayFrameNumEnd");    // int[1] Integer replay frame number from end of tape ()
-irsdkCVar ir_IsDiskLoggingEnabled("IsDiskLoggingEnabled");    // bool[1] 0=disk based telemetry turned off  1=turned on ()
-irsdkCVar ir_IsDiskLoggingActive("IsDiskLoggingActive");    // bool[1] 0=disk based telemetry file not being written  1=being written ()
-irsdkCVar ir_FrameRate("FrameRate");    // float[1] Average frames per second (fps)
-irsdkCVar ir_CpuUsageFG("CpuUsageFG");    // float[1] Percent of available tim fg thread took with a 1 sec avg (%)
-irsdkCVar ir_GpuUsage("GpuUsage");    // float[1] Percent of available tim gpu took with a 1 sec avg (%)
-irsdkCVar ir_ChanAvgLatency("ChanAvgLatency");    // float[1] Communications average latency (s)
-irsdkCVar ir_ChanLatency("ChanLatency");    // float[1] Communications latency (s)
-irsdkCVar ir_ChanQuality("ChanQuality");    // float[1] Communications quality (%)
-irsdkCVar ir_ChanPartnerQuality("ChanPartnerQuality");    // float[1] Partner communications quality (%)
-irsdkCVar ir_CpuUsageBG("CpuUsageBG");    // float[1] Percent of available tim bg thread took with a 1 sec avg (%)
-irsdkCVar ir_ChanClockSkew("ChanClockSkew");    // float[1] Communications server clock skew (s)
-irsdkCVar ir_MemPageFaultSec("MemPageFaultSec");    // float[1] Memory page faults per second ()
-irsdkCVar ir_PlayerCarPosition("PlayerCarPosition");    // int[1] Players position in race ()
-irsdkCVar ir_PlayerCarClassPosition("PlayerCarClassPosition");    // int[1] Players class position in race ()
-irsdkCVar ir_PlayerCarClass("PlayerCarClass");    // int[1] Player car class id ()
-irsdkCVar ir_PlayerTrackSurface("PlayerTrackSurface");    // int[1] Players car track surface type (irsdk_TrkLoc)
-irsdkCVar ir_PlayerTrackSurfaceMaterial("PlayerTrackSurfaceMaterial");    // int[1] Players car track surface material type (irsdk_TrkSurf)
-irsdkCVar ir_PlayerCarIdx("PlayerCarIdx");    // int[1] Players carIdx ()
-irsdkCVar ir_PlayerCarTeamIncidentCount("PlayerCarTeamIncidentCount");    // int[1] Players team incident count for this session ()
-irsdkCVar ir_PlayerCarMyIncidentCount("PlayerCarMyIncidentCount");    // int[1] Players own incident count for this session ()
-irsdkCVar ir_PlayerCarDriverIncidentCount("PlayerCarDriverIncidentCount");    // int[1] Teams current drivers incident count for this session ()
-irsdkCVar ir_PlayerCarWeightPenalty("PlayerCarWeightPenalty");    // float[1] Players weight penalty (kg)
-irsdkCVar ir_PlayerCarPowerAdjust("PlayerCarPowerAdjust");    // float[1] Players power adjust (%)
-irsdkCVar ir_PlayerCarDryTireSetLimit("PlayerCarDryTireSetLimit");    // int[1] Players dry tire set limit ()
-irsdkCVar ir_PlayerCarTowTime("PlayerCarTowTime");    // float[1] Players car is being towed if time is greater than zero (s)
-irsdkCVar ir_PlayerCarInPitStall("PlayerCarInPitStall");    // bool[1] Players car is properly in there pitstall ()
-irsdkCVar ir_PlayerCarPitSvStatus("PlayerCarPitSvStatus");    // int[1] Players car pit service status bits (irsdk_PitSvStatus)
-irsdkCVar ir_PlayerTireCompound("PlayerTireCompound");    // int[1] Players car current tire compound ()
-irsdkCVar ir_PlayerFastRepairsUsed("PlayerFastRepairsUsed");    // int[1] Players car number of fast repairs used ()
-irsdkCVar ir_CarIdxLap("CarIdxLap");    // int[64] Laps started by car index ()
-irsdkCVar ir_CarIdxLapCompleted("CarIdxLapCompleted");    // int[64] Laps completed by car index ()
-irsdkCVar ir_CarIdxLapDistPct("CarIdxLapDistPct");    // float[64] Percentage distance around lap by car index (%)
-irsdkCVar ir_CarIdxTrackSurface("CarIdxTrackSurface");    // int[64] Track surface type by car index (irsdk_TrkLoc)
-irsdkCVar ir_CarIdxTrackSurfaceMaterial("CarIdxTrackSurfaceMaterial");    // int[64] Track surface material type by car index (irsdk_TrkSurf)
-irsdkCVar ir_CarIdxOnPitRoad("CarIdxOnPitRoad");    // bool[64] On pit road between the cones by car index ()
-irsdkCVar ir_CarIdxPosition("CarIdxPosition");    // int[64] Cars position in race by car index ()
-irsdkCVar ir_CarIdxClassPosition("CarIdxClassPosition");    // int[64] Cars class position in race by car index ()
-irsdkCVar ir_CarIdxClass("CarIdxClass");    // int[64] Cars class id by car index ()
-irsdkCVar ir_CarIdxF2Time("CarIdxF2Time");    // float[64] Race time behind leader or fastest lap time otherwise (s)
-irsdkCVar ir_CarIdxEstTime("CarIdxEstTime");    // float[64] Estimated time to reach current location on track (s)
-irsdkCVar ir_CarIdxLastLapTime("CarIdxLastLapTime");    // float[64] Cars last lap time (s)
-irsdkCVar ir_CarIdxBestLapTime("CarIdxBestLapTime");    // float[64] Cars best lap time (s)
-irsdkCVar ir_CarIdxBestLapNum("CarIdxBestLapNum");    // int[64] Cars best lap number ()
-irsdkCVar ir_CarIdxTireCompound("CarIdxTireCompound");    // int[64] Cars current tire compound ()
-irsdkCVar ir_CarIdxQualTireCompound("CarIdxQualTireCompound");    // int[64] Cars Qual tire compound ()
-irsdkCVar ir_CarIdxQualTireCompoundLocked("CarIdxQualTireCompoundLocked");    // bool[64] Cars Qual tire compound is locked-in ()
-irsdkCVar ir_CarIdxFastRepairsUsed("CarIdxFastRepairsUsed");    // int[64] How many fast repairs each car has used ()
-irsdkCVar ir_PaceMode("PaceMode");    // int[1] Are we pacing or not (irsdk_PaceMode)
-irsdkCVar ir_CarIdxPaceLine("CarIdxPaceLine");    // int[64] What line cars are pacing in  or -1 if not pacing ()
-irsdkCVar ir_CarIdxPaceRow("CarIdxPaceRow");    // int[64] What row cars are pacing in  or -1 if not pacing ()
-irsdkCVar ir_CarIdxPaceFlags("CarIdxPaceFlags");    // int[64] Pacing status flags for each car (irsdk_PaceFlags)
-irsdkCVar ir_OnPitRoad("OnPitRoad");    // bool[1] Is the player car on pit road between the cones ()
-irsdkCVar ir_CarIdxSteer("CarIdxSteer");    // float[64] Steering wheel angle by car index (rad)
-irsdkCVar ir_CarIdxRPM("CarIdxRPM");    // float[64] Engine rpm by car index (revs/min)
-irsdkCVar ir_CarIdxGear("CarIdxGear");    // int[64] -1=reverse  0=neutral  1..n=current gear by car index ()
-irsdkCVar ir_SteeringWheelAngle("SteeringWheelAngle");    // float[1] Steering wheel angle (rad)
-irsdkCVar ir_Throttle("Throttle");    // float[1] 0=off throttle to 1=full throttle (%)
-irsdkCVar ir_Brake("Brake");    // float[1] 0=brake released to 1=max pedal force (%)
-irsdkCVar ir_Clutch("Clutch");    // float[1] 0=disengaged to 1=fully engaged (%)
-irsdkCVar ir_Gear("Gear");    // int[1] -1=reverse  0=neutral  1..n=current gear ()
-irsdkCVar ir_RPM("RPM");    // float[1] Engine rpm (revs/min)
-irsdkCVar ir_Lap("Lap");    // int[1] Laps started count ()
-irsdkCVar ir_LapCompleted("LapCompleted");    // int[1] Laps completed count ()
-irsdkCVar ir_LapDist("LapDist");    // float[1] Meters traveled from S/F this lap (m)
-irsdkCVar ir_LapDistPct("LapDistPct");    // float[1] Percentage distance around lap (%)
-irsdkCVar ir_RaceLaps("RaceLaps");    // int[1] Laps completed in race ()
-irsdkCVar ir_LapBestLap("LapBestLap");    // int[1] Players best lap number ()
-irsdkCVar ir_LapBestLapTime("LapBestLapTime");    // float[1] Players best lap time (s)
-irsdkCVar ir_LapLastLapTime("LapLastLapTime");    // float[1] Players last lap time (s)
-irsdkCVar ir_LapCurrentLapTime("LapCurrentLapTime");    // float[1] Estimate of players current lap time as shown in F3 box (s)
-irsdkCVar ir_LapLasNLapSeq("LapLasNLapSeq");    // int[1] Player num consecutive clean laps completed for N average ()
-irsdkCVar ir_LapLastNLapTime("LapLastNLapTime");    // float[1] Player last N average lap time (s)
-irsdkCVar ir_LapBestNLapLap("LapBestNLapLap");    // int[1] Player last lap in best N average lap time ()
-irsdkCVar ir_LapBestNLapTime("LapBestNLapTime");    // float[1] Player best N average lap time (s)
-irsdkCVar ir_LapDeltaToBestLap("LapDeltaToBestLap");    // float[1] Delta time for best lap (s)
-irsdkCVar ir_LapDeltaToBestLap_DD("LapDeltaToBestLap_DD");    // float[1] Rate of change of delta time for best lap (s/s)
-irsdkCVar ir_LapDeltaToBestLap_OK("LapDeltaToBestLap_OK");    // bool[1] Delta time for best lap is valid ()
-irsdkCVar ir_LapDeltaToOptimalLap("LapDeltaToOptimalLap");    // float[1] Delta time for optimal lap (s)
-irsdkCVar ir_LapDeltaToOptimalLap_DD("LapDeltaToOptimalLap_DD");    // float[1] Rate of change of delta time for optimal lap (s/s)
-irsdkCVar ir_LapDeltaToOptimalLap_OK("LapDeltaToOptimalLap_OK");    // bool[1] Delta time for optimal lap is valid ()
-irsdkCVar ir_LapDeltaToSessionBestLap("LapDeltaToSessionBestLap");    // float[1] Delta time for session best lap (s)
-irsdkCVar ir_LapDeltaToSessionBestLap_DD("LapDeltaToSessionBestLap_DD");    // float[1] Rate of change of delta time for session best lap (s/s)
-irsdkCVar ir_LapDeltaToSessionBestLap_OK("LapDeltaToSessionBestLap_OK");    // bool[1] Delta time for session best lap is valid ()
-irsdkCVar ir_LapDeltaToSessionOptimalLap("LapDeltaToSessionOptimalLap");    // float[1] Delta time for session optimal lap (s)
-irsdkCVar ir_LapDeltaToSessionOptimalLap_DD("LapDeltaToSessionOptimalLap_DD");    // float[1] Rate of change of delta time for session optimal lap (s/s)
-irsdkCVar ir_LapDeltaToSessionOptimalLap_OK("LapDeltaToSessionOptimalLap_OK");    // bool[1] Delta time for session optimal lap is valid ()
-irsdkCVar ir_LapDeltaToSessionLastlLap("LapDeltaToSessionLastlLap");    // float[1] Delta time for session last lap (s)
-irsdkCVar ir_LapDeltaToSessionLastlLap_DD("LapDeltaToSessionLastlLap_DD");    // float[1] Rate of change of delta time for session last lap (s/s)
-irsdkCVar ir_LapDeltaToSessionLastlLap_OK("LapDeltaToSessionLastlLap_OK");    // bool[1] Delta time for session last lap is valid ()
-irsdkCVar ir_Speed("Speed");    // float[1] GPS vehicle speed (m/s)
-irsdkCVar ir_Yaw("Yaw");    // float[1] Yaw orientation (rad)
-irsdkCVar ir_YawNorth("YawNorth");    // float[1] Yaw orientation relative to north (rad)
-irsdkCVar ir_Pitch("Pitch");    // float[1] Pitch orientation (rad)
-irsdkCVar ir_Roll("Roll");    // float[1] Roll orientation (rad)
-irsdkCVar ir_EnterExitReset("EnterExitReset");    // int[1] Indicate action the reset key will take 0 enter 1 exit 2 reset ()
-irsdkCVar ir_TrackTemp("TrackTemp");    // float[1] Deprecated  set to TrackTempCrew (C)
-irsdkCVar ir_TrackTempCrew("TrackTempCrew");    // float[1] Temperature of track measured by crew around track (C)
-irsdkCVar ir_AirTemp("AirTemp");    // float[1] Temperature of air at start/finish line (C)
-irsdkCVar ir_WeatherType("WeatherType");    // int[1] Weather type (0=constant  1=dynamic) ()
-irsdkCVar ir_Skies("Skies");    // int[1] Skies (0=clear/1=p cloudy/2=m cloudy/3=overcast) ()
-irsdkCVar ir_AirDensity("AirDensity");    // float[1] Density of air at start/finish line (kg/m^3)
-irsdkCVar ir_AirPressure("AirPressure");    // float[1] Pressure of air at start/finish line (Hg)
-irsdkCVar ir_WindVel("WindVel");    // float[1] Wind velocity at start/finish line (m/s)
-irsdkCVar ir_WindDir("WindDir");    // float[1] Wind direction at start/finish line (rad)
-irsdkCVar ir_RelativeHumidity("RelativeHumidity");    // float[1] Relative Humidity (%)
-irsdkCVar ir_FogLevel("FogLevel");    // float[1] Fog level (%)
-irsdkCVar ir_DCLapStatus("DCLapStatus");    // int[1] Status of driver change lap requirements ()
-irsdkCVar ir_DCDriversSoFar("DCDriversSoFar");    // int[1] Number of team drivers who have run a stint ()
-irsdkCVar ir_OkToReloadTextures("OkToReloadTextures");    // bool[1] True if it is ok to reload car textures at this time ()
-irsdkCVar ir_LoadNumTextures("LoadNumTextures");    // bool[1] True if the car_num texture will be loaded ()
-irsdkCVar ir_CarLeftRight("CarLeftRight");    // bitfield[1] Notify if car is to the left or right of driver (irsdk_CarLeftRight)
-irsdkCVar ir_PitsOpen("PitsOpen");    // bool[1] True if pit stop is allowed for the current player ()
-irsdkCVar ir_VidCapEnabled("VidCapEnabled");    // bool[1] True if video capture system is enabled ()
-irsdkCVar ir_VidCapActive("VidCapActive");    // bool[1] True if video currently being captured ()
-irsdkCVar ir_PitRepairLeft("PitRepairLeft");    // float[1] Time left for mandatory pit repairs if repairs are active (s)
-irsdkCVar ir_PitOptRepairLeft("PitOptRepairLeft");    // float[1] Time left for optional repairs if repairs are active (s)
-irsdkCVar ir_PitstopActive("PitstopActive");    // bool[1] Is the player getting pit stop service ()
-irsdkCVar ir_FastRepairUsed("FastRepairUsed");    // int[1] How many fast repairs used so far ()
-irsdkCVar ir_FastRepairAvailable("FastRepairAvailable");    // int[1] How many fast repairs left  255 is unlimited ()
-irsdkCVar ir_LFTiresUsed("LFTiresUsed");    // int[1] How many left front tires used so far ()
-irsdkCVar ir_RFTiresUsed("RFTiresUsed");    // int[1] How many right front tires used so far ()
-irsdkCVar ir_LRTiresUsed("LRTiresUsed");    // int[1] How many left rear tires used so far ()
-irsdkCVar ir_RRTiresUsed("RRTiresUsed");    // int[1] How many right rear tires used so far ()
-irsdkCVar ir_LeftTireSetsUsed("LeftTireSetsUsed");    // int[1] How many left tire sets used so far ()
-irsdkCVar ir_RightTireSetsUsed("RightTireSetsUsed");    // int[1] How many right tire sets used so far ()
-irsdkCVar ir_FrontTireSetsUsed("FrontTireSetsUsed");    // int[1] How many front tire sets used so far ()
-irsdkCVar ir_RearTireSetsUsed("RearTireSetsUsed");    // int[1] How many rear tire sets used so far ()
-irsdkCVar ir_TireSetsUsed("TireSetsUsed");    // int[1] How many tire sets used so far ()
-irsdkCVar ir_LFTiresAvailable("LFTiresAvailable");    // int[1] How many left front tires are remaining  255 is unlimited ()
-irsdkCVar ir_RFTiresAvailable("RFTiresAvailable");    // int[1] How many right front tires are remaining  255 is unlimited ()
-irsdkCVar ir_LRTiresAvailable("LRTiresAvailable");    // int[1] How many left rear tires are remaining  255 is unlimited ()
-irsdkCVar ir_RRTiresAvailable("RRTiresAvailable");    // int[1] How many right rear tires are remaining  255 is unlimited ()
-irsdkCVar ir_LeftTireSetsAvailable("LeftTireSetsAvailable");    // int[1] How many left tire sets are remaining  255 is unlimited ()
-irsdkCVar ir_RightTireSetsAvailable("RightTireSetsAvailable");    // int[1] How many right tire sets are remaining  255 is unlimited ()
-irsdkCVar ir_FrontTireSetsAvailable("FrontTireSetsAvailable");    // int[1] How many front tire sets are remaining  255 is unlimited ()
-irsdkCVar ir_RearTireSetsAvailable("RearTireSetsAvailable");    // int[1] How many rear tire sets are remaining  255 is unlimited ()
-irsdkCVar ir_TireSetsAvailable("TireSetsAvailable");    // int[1] How many tire sets are remaining  255 is unlimited ()
-irsdkCVar ir_CamCarIdx("CamCarIdx");    // int[1] Active camera's focus car index ()
-irsdkCVar ir_CamCameraNumber("CamCameraNumber");    // int[1] Active camera number ()
-irsdkCVar ir_CamGroupNumber("CamGroupNumber");    // int[1] Active camera group number ()
-irsdkCVar ir_CamCameraState("CamCameraState");    // bitfield[1] State of camera system (irsdk_CameraState)
-irsdkCVar ir_IsOnTrackCar("IsOnTrackCar");    // bool[1] 1=Car on track physics running ()
-irsdkCVar ir_IsInGarage("IsInGarage");    // bool[1] 1=Car in garage physics running ()
-irsdkCVar ir_SteeringWheelPctTorque("SteeringWheelPctTorque");    // float[1] Force feedback % max torque on steering shaft unsigned (%)
-irsdkCVar ir_SteeringWheelPctTorqueSign("SteeringWheelPctTorqueSign");    // float[1] Force feedback % max torque on steering shaft signed (%)
-irsdkCVar ir_SteeringWheelPctTorqueSignStops("SteeringWheelPctTorqueSignStops");    // float[1] Force feedback % max torque on steering shaft signed stops (%)
-irsdkCVar ir_SteeringWheelPctDamper("SteeringWheelPctDamper");    // float[1] Force feedback % max damping (%)
-irsdkCVar ir_SteeringWheelAngleMax("SteeringWheelAngleMax");    // float[1] Steering wheel max angle (rad)
-irsdkCVar ir_SteeringWheelLimiter("SteeringWheelLimiter");    // float[1] Force feedback limiter strength limits impacts and oscillation (%)
-irsdkCVar ir_ShiftIndicatorPct("ShiftIndicatorPct");    // float[1] DEPRECATED use DriverCarSLBlinkRPM instead (%)
-irsdkCVar ir_ShiftPowerPct("ShiftPowerPct");    // float[1] Friction torque applied to gears when shifting or grinding (%)
-irsdkCVar ir_ShiftGrindRPM("ShiftGrindRPM");    // float[1] RPM of shifter grinding noise (RPM)
-irsdkCVar ir_ThrottleRaw("ThrottleRaw");    // float[1] Raw throttle input 0=off throttle to 1=full throttle (%)
-irsdkCVar ir_BrakeRaw("BrakeRaw");    // float[1] Raw brake input 0=brake released to 1=max pedal force (%)
-irsdkCVar ir_HandbrakeRaw("HandbrakeRaw");    // float[1] Raw handbrake input 0=handbrake released to 1=max force (%)
-irsdkCVar ir_SteeringWheelPeakForceNm("SteeringWheelPeakForceNm");    // float[1] Peak torque mapping to direct input units for FFB (N*m)
-irsdkCVar ir_SteeringWheelMaxForceNm("SteeringWheelMaxForceNm");    // float[1] Value of strength or max force slider in Nm for FFB (N*m)
-irsdkCVar ir_SteeringWheelUseLinear("SteeringWheelUseLinear");    // bool[1] True if steering wheel force is using linear mode ()
-irsdkCVar ir_BrakeABSactive("BrakeABSactive");    // bool[1] true if abs is currently reducing brake force pressure ()
-irsdkCVar ir_EngineWarnings("EngineWarnings");    // bitfield[1] Bitfield for warning lights (irsdk_EngineWarnings)
-irsdkCVar ir_FuelLevel("FuelLevel");    // float[1] Liters of fuel remaining (l)
-irsdkCVar ir_FuelLevelPct("FuelLevelPct");    // float[1] Percent fuel remaining (%)
-irsdkCVar ir_PitSvFlags("PitSvFlags");    // bitfield[1] Bitfield of pit service checkboxes (irsdk_PitSvFlags)
-irsdkCVar ir_PitSvLFP("PitSvLFP");    // float[1] Pit service left front tire pressure (kPa)
-irsdkCVar ir_PitSvRFP("PitSvRFP");    // float[1] Pit service right front tire pressure (kPa)
-irsdkCVar ir_PitSvLRP("PitSvLRP");    // float[1] Pit service left rear tire pressure (kPa)
-irsdkCVar ir_PitSvRRP("PitSvRRP");    // float[1] Pit service right rear tire pressure (kPa)
-irsdkCVar ir_PitSvFuel("PitSvFuel");    // float[1] Pit service fuel add amount (l)
-irsdkCVar ir_PitSvTireCompound("PitSvTireCompound");    // int[1] Pit service pending tire compound ()
-irsdkCVar ir_CarIdxP2P_Status("CarIdxP2P_Status");    // bool[64] Push2Pass active or not ()
-irsdkCVar ir_CarIdxP2P_Count("CarIdxP2P_Count");    // int[64] Push2Pass count of usage (or remaining in Race) ()
-irsdkCVar ir_ReplayPlaySpeed("ReplayPlaySpeed");    // int[1] Replay playback speed ()
-irsdkCVar ir_ReplayPlaySlowMotion("ReplayPlaySlowMotion");    // bool[1] 0=not slow motion  1=replay is in slow motion ()
-irsdkCVar ir_ReplaySessionTime("ReplaySessionTime");    // double[1] Seconds since replay session start (s)
-irsdkCVar ir_ReplaySessionNum("ReplaySessionNum");    // int[1] Replay session number ()
-irsdkCVar ir_TireLF_RumblePitch("TireLF_RumblePitch");    // float[1] Players LF Tire Sound rumblestrip pitch (Hz)
-irsdkCVar ir_TireRF_RumblePitch("TireRF_RumblePitch");    // float[1] Players RF Tire Sound rumblestrip pitch (Hz)
-irsdkCVar ir_TireLR_RumblePitch("TireLR_RumblePitch");    // float[1] Players LR Tire Sound rumblestrip pitch (Hz)
-irsdkCVar ir_TireRR_RumblePitch("TireRR_RumblePitch");    // float[1] Players RR Tire Sound rumblestrip pitch (Hz)
-irsdkCVar ir_SteeringWheelTorque_ST("SteeringWheelTorque_ST");    // float[6] Output torque on steering shaft at 360 Hz (N*m)
-irsdkCVar ir_SteeringWheelTorque("SteeringWheelTorque");    // float[1] Output torque on steering shaft (N*m)
-irsdkCVar ir_VelocityZ_ST("VelocityZ_ST");    // float[6] Z velocity (m/s at 360 Hz)
-irsdkCVar ir_VelocityY_ST("VelocityY_ST");    // float[6] Y velocity (m/s at 360 Hz)
-irsdkCVar ir_VelocityX_ST("VelocityX_ST");    // float[6] X velocity (m/s at 360 Hz)
-irsdkCVar ir_VelocityZ("VelocityZ");    // float[1] Z velocity (m/s)
-irsdkCVar ir_VelocityY("VelocityY");    // float[1] Y velocity (m/s)
-irsdkCVar ir_VelocityX("VelocityX");    // float[1] X velocity (m/s)
-irsdkCVar ir_YawRate_ST("YawRate_ST");    // float[6] Yaw rate at 360 Hz (rad/s)
-irsdkCVar ir_PitchRate_ST("PitchRate_ST");    // float[6] Pitch rate at 360 Hz (rad/s)
-irsdkCVar ir_RollRate_ST("RollRate_ST");    // float[6] Roll rate at 360 Hz (rad/s)
-irsdkCVar ir_YawRate("YawRate");    // float[1] Yaw rate (rad/s)
-irsdkCVar ir_PitchRate("PitchRate");    // float[1] Pitch rate (rad/s)
-irsdkCVar ir_RollRate("RollRate");    // float[1] Roll rate (rad/s)
-irsdkCVar ir_VertAccel_ST("VertAccel_ST");    // float[6] Vertical acceleration (including gravity) at 360 Hz (m/s^2)
-irsdkCVar ir_LatAccel_ST("LatAccel_ST");    // float[6] Lateral acceleration (including gravity) at 360 Hz (m/s^2)
-irsdkCVar ir_LongAccel_ST("LongAccel_ST");    // float[6] Longitudinal acceleration (including gravity) at 360 Hz (m/s^2)
-irsdkCVar ir_VertAccel("VertAccel");    // float[1] Vertical acceleration (including gravity) (m/s^2)
-irsdkCVar ir_LatAccel("LatAccel");    // float[1] Lateral acceleration (including gravity) (m/s^2)
-irsdkCVar ir_LongAccel("LongAccel");    // float[1] Longitudinal acceleration (including gravity) (m/s^2)
-irsdkCVar ir_dcStarter("dcStarter");    // bool[1] In car trigger car starter ()
-irsdkCVar ir_dpRTireChange("dpRTireChange");    // float[1] Pitstop right tire change request ()
-irsdkCVar ir_dpLTireChange("dpLTireChange");    // float[1] Pitstop left tire change request ()
-irsdkCVar ir_dpFuelFill("dpFuelFill");    // float[1] Pitstop fuel fill flag ()
-irsdkCVar ir_dpWindshieldTearoff("dpWindshieldTearoff");    // float[1] Pitstop windshield tearoff ()
-irsdkCVar ir_dpFuelAddKg("dpFuelAddKg");    // float[1] Pitstop fuel add ammount (kg)
-irsdkCVar ir_dpFastRepair("dpFastRepair");    // float[1] Pitstop fast repair set ()
-irsdkCVar ir_dcBrakeBias("dcBrakeBias");    // float[1] In car brake bias adjustment ()
-irsdkCVar ir_dpLFTireColdPress("dpLFTireColdPress");    // float[1] Pitstop lf tire cold pressure adjustment (Pa)
-irsdkCVar ir_dpRFTireColdPress("dpRFTireColdPress");    // float[1] Pitstop rf cold tire pressure adjustment (Pa)
-irsdkCVar ir_dpLRTireColdPress("dpLRTireColdPress");    // float[1] Pitstop lr tire cold pressure adjustment (Pa)
-irsdkCVar ir_dpRRTireColdPress("dpRRTireColdPress");    // float[1] Pitstop rr cold tire pressure adjustment (Pa)
-irsdkCVar ir_dpWeightJackerLeft("dpWeightJackerLeft");    // float[1] Pitstop left wedge/weight jacker adjustment ()
-irsdkCVar ir_dpWeightJackerRight("dpWeightJackerRight");    // float[1] Pitstop right wedge/weight jacker adjustment ()
-irsdkCVar ir_WaterTemp("WaterTemp");    // float[1] Engine coolant temp (C)
-irsdkCVar ir_WaterLevel("WaterLevel");    // float[1] Engine coolant level (l)
-irsdkCVar ir_FuelPress("FuelPress");    // float[1] Engine fuel pressure (bar)
-irsdkCVar ir_FuelUsePerHour("FuelUsePerHour");    // float[1] Engine fuel used instantaneous (kg/h)
-irsdkCVar ir_OilTemp("OilTemp");    // float[1] Engine oil temperature (C)
-irsdkCVar ir_OilPress("OilPress");    // float[1] Engine oil pressure (bar)
-irsdkCVar ir_OilLevel("OilLevel");    // float[1] Engine oil level (l)
-irsdkCVar ir_Voltage("Voltage");    // float[1] Engine voltage (V)
-irsdkCVar ir_ManifoldPress("ManifoldPress");    // float[1] Engine manifold pressure (bar)
-irsdkCVar ir_RFcoldPressure("RFcoldPressure");    // float[1] RF tire cold pressure  as set in the garage (kPa)
-irsdkCVar ir_RFtempCL("RFtempCL");    // float[1] RF tire left carcass temperature (C)
-irsdkCVar ir_RFtempCM("RFtempCM");    // float[1] RF tire middle carcass temperature (C)
-irsdkCVar ir_RFtempCR("RFtempCR");    // float[1] RF tire right carcass temperature (C)
-irsdkCVar ir_RFwearL("RFwearL");    // float[1] RF tire left percent tread remaining (%)
-irsdkCVar ir_RFwearM("RFwearM");    // float[1] RF tire middle percent tread remaining (%)
-irsdkCVar ir_RFwearR("RFwearR");    // float[1] RF tire right percent tread remaining (%)
-irsdkCVar ir_LFcoldPressure("LFcoldPressure");    // float[1] LF tire cold pressure  as set in the garage (kPa)
-irsdkCVar ir_LFtempCL("LFtempCL");    // float[1] LF tire left carcass temperature (C)
-irsdkCVar ir_LFtempCM("LFtempCM");    // float[1] LF tire middle carcass temperature (C)
-irsdkCVar ir_LFtempCR("LFtempCR");    // float[1] LF tire right carcass temperature (C)
-irsdkCVar ir_LFwearL("LFwearL");    // float[1] LF tire left percent tread remaining (%)
-irsdkCVar ir_LFwearM("LFwearM");    // float[1] LF tire middle percent tread remaining (%)
-irsdkCVar ir_LFwearR("LFwearR");    // float[1] LF tire right percent tread remaining (%)
-irsdkCVar ir_RRcoldPressure("RRcoldPressure");    // float[1] RR tire cold pressure  as set in the garage (kPa)
-irsdkCVar ir_RRtempCL("RRtempCL");    // float[1] RR tire left carcass temperature (C)
-irsdkCVar ir_RRtempCM("RRtempCM");    // float[1] RR tire middle carcass temperature (C)
-irsdkCVar ir_RRtempCR("RRtempCR");    // float[1] RR tire right carcass temperature (C)
-irsdkCVar ir_RRwearL("RRwearL");    // float[1] RR tire left percent tread remaining (%)
-irsdkCVar ir_RRwearM("RRwearM");    // float[1] RR tire middle percent tread remaining (%)
-irsdkCVar ir_RRwearR("RRwearR");    // float[1] RR tire right percent tread remaining (%)
-irsdkCVar ir_LRcoldPressure("LRcoldPressure");    // float[1] LR tire cold pressure  as set in the garage (kPa)
-irsdkCVar ir_LRtempCL("LRtempCL");    // float[1] LR tire left carcass temperature (C)
-irsdkCVar ir_LRtempCM("LRtempCM");    // float[1] LR tire middle carcass temperature (C)
-irsdkCVar ir_LRtempCR("LRtempCR");    // float[1] LR tire right carcass temperature (C)
-irsdkCVar ir_LRwearL("LRwearL");    // float[1] LR tire left percent tread remaining (%)
-irsdkCVar ir_LRwearM("LRwearM");    // float[1] LR tire middle percent tread remaining (%)
-irsdkCVar ir_LRwearR("LRwearR");    // float[1] LR tire right percent tread remaining (%)
-irsdkCVar ir_RRSHshockDefl("RRSHshockDefl");    // float[1] RRSH shock deflection (m)
-irsdkCVar ir_RRSHshockDefl_ST("RRSHshockDefl_ST");    // float[6] RRSH shock deflection at 360 Hz (m)
-irsdkCVar ir_RRSHshockVel("RRSHshockVel");    // float[1] RRSH shock velocity (m/s)
-irsdkCVar ir_RRSHshockVel_ST("RRSHshockVel_ST");    // float[6] RRSH shock velocity at 360 Hz (m/s)
-irsdkCVar ir_LRSHshockDefl("LRSHshockDefl");    // float[1] LRSH shock deflection (m)
-irsdkCVar ir_LRSHshockDefl_ST("LRSHshockDefl_ST");    // float[6] LRSH shock deflection at 360 Hz (m)
-irsdkCVar ir_LRSHshockVel("LRSHshockVel");    // float[1] LRSH shock velocity (m/s)
-irsdkCVar ir_LRSHshockVel_ST("LRSHshockVel_ST");    // float[6] LRSH shock velocity at 360 Hz (m/s)
-irsdkCVar ir_RFSHshockDefl("RFSHshockDefl");    // float[1] RFSH shock deflection (m)
-irsdkCVar ir_RFSHshockDefl_ST("RFSHshockDefl_ST");    // float[6] RFSH shock deflection at 360 Hz (m)
-irsdkCVar ir_RFSHshockVel("RFSHshockVel");    // float[1] RFSH shock velocity (m/s)
-irsdkCVar ir_RFSHshockVel_ST("RFSHshockVel_ST");    // float[6] RFSH shock velocity at 360 Hz (m/s)
-irsdkCVar ir_LFSHshockDefl("LFSHshockDefl");    // float[1] LFSH shock deflection (m)
-irsdkCVar ir_LFSHshockDefl_ST("LFSHshockDefl_ST");    // float[6] LFSH shock deflection at 360 Hz (m)
-irsdkCVar ir_LFSHshockVel("LFSHshockVel");    // float[1] LFSH shock velocity (m/s)
-irsdkCVar ir_LFSHshockVel_ST("LFSHshockVel_ST");    // float[6] LFSH shock velocity at 360 Hz (m/s)
+irsdkVar<double> ir_SessionTime("SessionTime");    // double[1] Seconds since session start (s)
+irsdkVar<int> ir_SessionTick("SessionTick");    // int[1] Current update number ()
+irsdkVar<int> ir_SessionNum("SessionNum");    // int[1] Session number ()
+irsdkVar<int> ir_SessionState("SessionState");    // int[1] Session state (irsdk_SessionState)
+irsdkVar<int> ir_SessionUniqueID("SessionUniqueID");    // int[1] Session ID ()
+irsdkVar<int> ir_SessionFlags("SessionFlags");    // bitfield[1] Session flags (irsdk_Flags)
+irsdkVar<double> ir_SessionTimeRemain("SessionTimeRemain");    // double[1] Seconds left till session ends (s)
+irsdkVar<int> ir_SessionLapsRemain("SessionLapsRemain");    // int[1] Old laps left till session ends use SessionLapsRemainEx ()
+irsdkVar<int> ir_SessionLapsRemainEx("SessionLapsRemainEx");    // int[1] New improved laps left till session ends ()
+irsdkVar<double> ir_SessionTimeTotal("SessionTimeTotal");    // double[1] Total number of seconds in session (s)
+irsdkVar<int> ir_SessionLapsTotal("SessionLapsTotal");    // int[1] Total number of laps in session ()
+irsdkVar<float> ir_SessionTimeOfDay("SessionTimeOfDay");    // float[1] Time of day in seconds (s)
+irsdkVar<int> ir_RadioTransmitCarIdx("RadioTransmitCarIdx");    // int[1] The car index of the current person speaking on the radio ()
+irsdkVar<int> ir_RadioTransmitRadioIdx("RadioTransmitRadioIdx");    // int[1] The radio index of the current person speaking on the radio ()
+irsdkVar<int> ir_RadioTransmitFrequencyIdx("RadioTransmitFrequencyIdx");    // int[1] The frequency index of the current person speaking on the radio ()
+irsdkVar<int> ir_DisplayUnits("DisplayUnits");    // int[1] Default units for the user interface 0 = english 1 = metric ()
+irsdkVar<bool> ir_DriverMarker("DriverMarker");    // bool[1] Driver activated flag ()
+irsdkVar<bool> ir_PushToPass("PushToPass");    // bool[1] Push to pass button state ()
+irsdkVar<bool> ir_ManualBoost("ManualBoost");    // bool[1] Hybrid manual boost state ()
+irsdkVar<bool> ir_ManualNoBoost("ManualNoBoost");    // bool[1] Hybrid manual no boost state ()
+irsdkVar<bool> ir_IsOnTrack("IsOnTrack");    // bool[1] 1=Car on track physics running with player in car ()
+irsdkVar<bool> ir_IsReplayPlaying("IsReplayPlaying");    // bool[1] 0=replay not playing  1=replay playing ()
+irsdkVar<int> ir_ReplayFrameNum("ReplayFrameNum");    // int[1] Integer replay frame number (60 per second) ()
+irsdkVar<int> ir_ReplayFrameNumEnd("ReplayFrameNumEnd");    // int[1] Integer replay frame number from end of tape ()
+irsdkVar<bool> ir_IsDiskLoggingEnabled("IsDiskLoggingEnabled");    // bool[1] 0=disk based telemetry turned off  1=turned on ()
+irsdkVar<bool> ir_IsDiskLoggingActive("IsDiskLoggingActive");    // bool[1] 0=disk based telemetry file not being written  1=being written ()
+irsdkVar<float> ir_FrameRate("FrameRate");    // float[1] Average frames per second (fps)
+irsdkVar<float> ir_CpuUsageFG("CpuUsageFG");    // float[1] Percent of available tim fg thread took with a 1 sec avg (%)
+irsdkVar<float> ir_GpuUsage("GpuUsage");    // float[1] Percent of available tim gpu took with a 1 sec avg (%)
+irsdkVar<float> ir_ChanAvgLatency("ChanAvgLatency");    // float[1] Communications average latency (s)
+irsdkVar<float> ir_ChanLatency("ChanLatency");    // float[1] Communications latency (s)
+irsdkVar<float> ir_ChanQuality("ChanQuality");    // float[1] Communications quality (%)
+irsdkVar<float> ir_ChanPartnerQuality("ChanPartnerQuality");    // float[1] Partner communications quality (%)
+irsdkVar<float> ir_CpuUsageBG("CpuUsageBG");    // float[1] Percent of available tim bg thread took with a 1 sec avg (%)
+irsdkVar<float> ir_ChanClockSkew("ChanClockSkew");    // float[1] Communications server clock skew (s)
+irsdkVar<float> ir_MemPageFaultSec("MemPageFaultSec");    // float[1] Memory page faults per second ()
+irsdkVar<int> ir_PlayerCarPosition("PlayerCarPosition");    // int[1] Players position in race ()
+irsdkVar<int> ir_PlayerCarClassPosition("PlayerCarClassPosition");    // int[1] Players class position in race ()
+irsdkVar<int> ir_PlayerCarClass("PlayerCarClass");    // int[1] Player car class id ()
+irsdkVar<int> ir_PlayerTrackSurface("PlayerTrackSurface");    // int[1] Players car track surface type (irsdk_TrkLoc)
+irsdkVar<int> ir_PlayerTrackSurfaceMaterial("PlayerTrackSurfaceMaterial");    // int[1] Players car track surface material type (irsdk_TrkSurf)
+irsdkVar<int> ir_PlayerCarIdx("PlayerCarIdx");    // int[1] Players carIdx ()
+irsdkVar<int> ir_PlayerCarTeamIncidentCount("PlayerCarTeamIncidentCount");    // int[1] Players team incident count for this session ()
+irsdkVar<int> ir_PlayerCarMyIncidentCount("PlayerCarMyIncidentCount");    // int[1] Players own incident count for this session ()
+irsdkVar<int> ir_PlayerCarDriverIncidentCount("PlayerCarDriverIncidentCount");    // int[1] Teams current drivers incident count for this session ()
+irsdkVar<float> ir_PlayerCarWeightPenalty("PlayerCarWeightPenalty");    // float[1] Players weight penalty (kg)
+irsdkVar<float> ir_PlayerCarPowerAdjust("PlayerCarPowerAdjust");    // float[1] Players power adjust (%)
+irsdkVar<int> ir_PlayerCarDryTireSetLimit("PlayerCarDryTireSetLimit");    // int[1] Players dry tire set limit ()
+irsdkVar<float> ir_PlayerCarTowTime("PlayerCarTowTime");    // float[1] Players car is being towed if time is greater than zero (s)
+irsdkVar<bool> ir_PlayerCarInPitStall("PlayerCarInPitStall");    // bool[1] Players car is properly in there pitstall ()
+irsdkVar<int> ir_PlayerCarPitSvStatus("PlayerCarPitSvStatus");    // int[1] Players car pit service status bits (irsdk_PitSvStatus)
+irsdkVar<int> ir_PlayerTireCompound("PlayerTireCompound");    // int[1] Players car current tire compound ()
+irsdkVar<int> ir_PlayerFastRepairsUsed("PlayerFastRepairsUsed");    // int[1] Players car number of fast repairs used ()
+irsdkVar<int,64> ir_CarIdxLap("CarIdxLap");    // int[64] Laps started by car index ()
+irsdkVar<int,64> ir_CarIdxLapCompleted("CarIdxLapCompleted");    // int[64] Laps completed by car index ()
+irsdkVar<float,64> ir_CarIdxLapDistPct("CarIdxLapDistPct");    // float[64] Percentage distance around lap by car index (%)
+irsdkVar<int,64> ir_CarIdxTrackSurface("CarIdxTrackSurface");    // int[64] Track surface type by car index (irsdk_TrkLoc)
+irsdkVar<int,64> ir_CarIdxTrackSurfaceMaterial("CarIdxTrackSurfaceMaterial");    // int[64] Track surface material type by car index (irsdk_TrkSurf)
+irsdkVar<bool,64> ir_CarIdxOnPitRoad("CarIdxOnPitRoad");    // bool[64] On pit road between the cones by car index ()
+irsdkVar<int,64> ir_CarIdxPosition("CarIdxPosition");    // int[64] Cars position in race by car index ()
+irsdkVar<int,64> ir_CarIdxClassPosition("CarIdxClassPosition");    // int[64] Cars class position in race by car index ()
+irsdkVar<int,64> ir_CarIdxClass("CarIdxClass");    // int[64] Cars class id by car index ()
+irsdkVar<float,64> ir_CarIdxF2Time("CarIdxF2Time");    // float[64] Race time behind leader or fastest lap time otherwise (s)
+irsdkVar<float,64> ir_CarIdxEstTime("CarIdxEstTime");    // float[64] Estimated time to reach current location on track (s)
+irsdkVar<float,64> ir_CarIdxLastLapTime("CarIdxLastLapTime");    // float[64] Cars last lap time (s)
+irsdkVar<float,64> ir_CarIdxBestLapTime("CarIdxBestLapTime");    // float[64] Cars best lap time (s)
+irsdkVar<int,64> ir_CarIdxBestLapNum("CarIdxBestLapNum");    // int[64] Cars best lap number ()
+irsdkVar<int,64> ir_CarIdxTireCompound("CarIdxTireCompound");    // int[64] Cars current tire compound ()
+irsdkVar<int,64> ir_CarIdxQualTireCompound("CarIdxQualTireCompound");    // int[64] Cars Qual tire compound ()
+irsdkVar<bool,64> ir_CarIdxQualTireCompoundLocked("CarIdxQualTireCompoundLocked");    // bool[64] Cars Qual tire compound is locked-in ()
+irsdkVar<int,64> ir_CarIdxFastRepairsUsed("CarIdxFastRepairsUsed");    // int[64] How many fast repairs each car has used ()
+irsdkVar<int> ir_PaceMode("PaceMode");    // int[1] Are we pacing or not (irsdk_PaceMode)
+irsdkVar<int,64> ir_CarIdxPaceLine("CarIdxPaceLine");    // int[64] What line cars are pacing in  or -1 if not pacing ()
+irsdkVar<int,64> ir_CarIdxPaceRow("CarIdxPaceRow");    // int[64] What row cars are pacing in  or -1 if not pacing ()
+irsdkVar<int,64> ir_CarIdxPaceFlags("CarIdxPaceFlags");    // int[64] Pacing status flags for each car (irsdk_PaceFlags)
+irsdkVar<bool> ir_OnPitRoad("OnPitRoad");    // bool[1] Is the player car on pit road between the cones ()
+irsdkVar<float,64> ir_CarIdxSteer("CarIdxSteer");    // float[64] Steering wheel angle by car index (rad)
+irsdkVar<float,64> ir_CarIdxRPM("CarIdxRPM");    // float[64] Engine rpm by car index (revs/min)
+irsdkVar<int,64> ir_CarIdxGear("CarIdxGear");    // int[64] -1=reverse  0=neutral  1..n=current gear by car index ()
+irsdkVar<float> ir_SteeringWheelAngle("SteeringWheelAngle");    // float[1] Steering wheel angle (rad)
+irsdkVar<float> ir_Throttle("Throttle");    // float[1] 0=off throttle to 1=full throttle (%)
+irsdkVar<float> ir_Brake("Brake");    // float[1] 0=brake released to 1=max pedal force (%)
+irsdkVar<float> ir_Clutch("Clutch");    // float[1] 0=disengaged to 1=fully engaged (%)
+irsdkVar<int> ir_Gear("Gear");    // int[1] -1=reverse  0=neutral  1..n=current gear ()
+irsdkVar<float> ir_RPM("RPM");    // float[1] Engine rpm (revs/min)
+irsdkVar<int> ir_Lap("Lap");    // int[1] Laps started count ()
+irsdkVar<int> ir_LapCompleted("LapCompleted");    // int[1] Laps completed count ()
+irsdkVar<float> ir_LapDist("LapDist");    // float[1] Meters traveled from S/F this lap (m)
+irsdkVar<float> ir_LapDistPct("LapDistPct");    // float[1] Percentage distance around lap (%)
+irsdkVar<int> ir_RaceLaps("RaceLaps");    // int[1] Laps completed in race ()
+irsdkVar<int> ir_LapBestLap("LapBestLap");    // int[1] Players best lap number ()
+irsdkVar<float> ir_LapBestLapTime("LapBestLapTime");    // float[1] Players best lap time (s)
+irsdkVar<float> ir_LapLastLapTime("LapLastLapTime");    // float[1] Players last lap time (s)
+irsdkVar<float> ir_LapCurrentLapTime("LapCurrentLapTime");    // float[1] Estimate of players current lap time as shown in F3 box (s)
+irsdkVar<int> ir_LapLasNLapSeq("LapLasNLapSeq");    // int[1] Player num consecutive clean laps completed for N average ()
+irsdkVar<float> ir_LapLastNLapTime("LapLastNLapTime");    // float[1] Player last N average lap time (s)
+irsdkVar<int> ir_LapBestNLapLap("LapBestNLapLap");    // int[1] Player last lap in best N average lap time ()
+irsdkVar<float> ir_LapBestNLapTime("LapBestNLapTime");    // float[1] Player best N average lap time (s)
+irsdkVar<float> ir_LapDeltaToBestLap("LapDeltaToBestLap");    // float[1] Delta time for best lap (s)
+irsdkVar<float> ir_LapDeltaToBestLap_DD("LapDeltaToBestLap_DD");    // float[1] Rate of change of delta time for best lap (s/s)
+irsdkVar<bool> ir_LapDeltaToBestLap_OK("LapDeltaToBestLap_OK");    // bool[1] Delta time for best lap is valid ()
+irsdkVar<float> ir_LapDeltaToOptimalLap("LapDeltaToOptimalLap");    // float[1] Delta time for optimal lap (s)
+irsdkVar<float> ir_LapDeltaToOptimalLap_DD("LapDeltaToOptimalLap_DD");    // float[1] Rate of change of delta time for optimal lap (s/s)
+irsdkVar<bool> ir_LapDeltaToOptimalLap_OK("LapDeltaToOptimalLap_OK");    // bool[1] Delta time for optimal lap is valid ()
+irsdkVar<float> ir_LapDeltaToSessionBestLap("LapDeltaToSessionBestLap");    // float[1] Delta time for session best lap (s)
+irsdkVar<float> ir_LapDeltaToSessionBestLap_DD("LapDeltaToSessionBestLap_DD");    // float[1] Rate of change of delta time for session best lap (s/s)
+irsdkVar<bool> ir_LapDeltaToSessionBestLap_OK("LapDeltaToSessionBestLap_OK");    // bool[1] Delta time for session best lap is valid ()
+irsdkVar<float> ir_LapDeltaToSessionOptimalLap("LapDeltaToSessionOptimalLap");    // float[1] Delta time for session optimal lap (s)
+irsdkVar<float> ir_LapDeltaToSessionOptimalLap_DD("LapDeltaToSessionOptimalLap_DD");    // float[1] Rate of change of delta time for session optimal lap (s/s)
+irsdkVar<bool> ir_LapDeltaToSessionOptimalLap_OK("LapDeltaToSessionOptimalLap_OK");    // bool[1] Delta time for session optimal lap is valid ()
+irsdkVar<float> ir_LapDeltaToSessionLastlLap("LapDeltaToSessionLastlLap");    // float[1] Delta time for session last lap (s)
+irsdkVar<float> ir_LapDeltaToSessionLastlLap_DD("LapDeltaToSessionLastlLap_DD");    // float[1] Rate of change of delta time for session last lap (s/s)
+irsdkVar<bool> ir_LapDeltaToSessionLastlLap_OK("LapDeltaToSessionLastlLap_OK");    // bool[1] Delta time for session last lap is valid ()
+irsdkVar<float> ir_Speed("Speed");    // float[1] GPS vehicle speed (m/s)
+irsdkVar<float> ir_Yaw("Yaw");    // float[1] Yaw orientation (rad)
+irsdkVar<float> ir_YawNorth("YawNorth");    // float[1] Yaw orientation relative to north (rad)
+irsdkVar<float> ir_Pitch("Pitch");    // float[1] Pitch orientation (rad)
+irsdkVar<float> ir_Roll("Roll");    // float[1] Roll orientation (rad)
+irsdkVar<int> ir_EnterExitReset("EnterExitReset");    // int[1] Indicate action the reset key will take 0 enter 1 exit 2 reset ()
+irsdkVar<float> ir_TrackTemp("TrackTemp");    // float[1] Deprecated  set to TrackTempCrew (C)
+irsdkVar<float> ir_TrackTempCrew("TrackTempCrew");    // float[1] Temperature of track measured by crew around track (C)
+irsdkVar<float> ir_AirTemp("AirTemp");    // float[1] Temperature of air at start/finish line (C)
+irsdkVar<int> ir_WeatherType("WeatherType");    // int[1] Weather type (0=constant  1=dynamic) ()
+irsdkVar<int> ir_Skies("Skies");    // int[1] Skies (0=clear/1=p cloudy/2=m cloudy/3=overcast) ()
+irsdkVar<float> ir_AirDensity("AirDensity");    // float[1] Density of air at start/finish line (kg/m^3)
+irsdkVar<float> ir_AirPressure("AirPressure");    // float[1] Pressure of air at start/finish line (Hg)
+irsdkVar<float> ir_WindVel("WindVel");    // float[1] Wind velocity at start/finish line (m/s)
+irsdkVar<float> ir_WindDir("WindDir");    // float[1] Wind direction at start/finish line (rad)
+irsdkVar<float> ir_RelativeHumidity("RelativeHumidity");    // float[1] Relative Humidity (%)
+irsdkVar<float> ir_FogLevel("FogLevel");    // float[1] Fog level (%)
+irsdkVar<int> ir_DCLapStatus("DCLapStatus");    // int[1] Status of driver change lap requirements ()
+irsdkVar<int> ir_DCDriversSoFar("DCDriversSoFar");    // int[1] Number of team drivers who have run a stint ()
+irsdkVar<bool> ir_OkToReloadTextures("OkToReloadTextures");    // bool[1] True if it is ok to reload car textures at this time ()
+irsdkVar<bool> ir_LoadNumTextures("LoadNumTextures");    // bool[1] True if the car_num texture will be loaded ()
+irsdkVar<int> ir_CarLeftRight("CarLeftRight");    // bitfield[1] Notify if car is to the left or right of driver (irsdk_CarLeftRight)
+irsdkVar<bool> ir_PitsOpen("PitsOpen");    // bool[1] True if pit stop is allowed for the current player ()
+irsdkVar<bool> ir_VidCapEnabled("VidCapEnabled");    // bool[1] True if video capture system is enabled ()
+irsdkVar<bool> ir_VidCapActive("VidCapActive");    // bool[1] True if video currently being captured ()
+irsdkVar<float> ir_PitRepairLeft("PitRepairLeft");    // float[1] Time left for mandatory pit repairs if repairs are active (s)
+irsdkVar<float> ir_PitOptRepairLeft("PitOptRepairLeft");    // float[1] Time left for optional repairs if repairs are active (s)
+irsdkVar<bool> ir_PitstopActive("PitstopActive");    // bool[1] Is the player getting pit stop service ()
+irsdkVar<int> ir_FastRepairUsed("FastRepairUsed");    // int[1] How many fast repairs used so far ()
+irsdkVar<int> ir_FastRepairAvailable("FastRepairAvailable");    // int[1] How many fast repairs left  255 is unlimited ()
+irsdkVar<int> ir_LFTiresUsed("LFTiresUsed");    // int[1] How many left front tires used so far ()
+irsdkVar<int> ir_RFTiresUsed("RFTiresUsed");    // int[1] How many right front tires used so far ()
+irsdkVar<int> ir_LRTiresUsed("LRTiresUsed");    // int[1] How many left rear tires used so far ()
+irsdkVar<int> ir_RRTiresUsed("RRTiresUsed");    // int[1] How many right rear tires used so far ()
+irsdkVar<int> ir_LeftTireSetsUsed("LeftTireSetsUsed");    // int[1] How many left tire sets used so far ()
+irsdkVar<int> ir_RightTireSetsUsed("RightTireSetsUsed");    // int[1] How many right tire sets used so far ()
+irsdkVar<int> ir_FrontTireSetsUsed("FrontTireSetsUsed");    // int[1] How many front tire sets used so far ()
+irsdkVar<int> ir_RearTireSetsUsed("RearTireSetsUsed");    // int[1] How many rear tire sets used so far ()
+irsdkVar<int> ir_TireSetsUsed("TireSetsUsed");    // int[1] How many tire sets used so far ()
+irsdkVar<int> ir_LFTiresAvailable("LFTiresAvailable");    // int[1] How many left front tires are remaining  255 is unlimited ()
+irsdkVar<int> ir_RFTiresAvailable("RFTiresAvailable");    // int[1] How many right front tires are remaining  255 is unlimited ()
+irsdkVar<int> ir_LRTiresAvailable("LRTiresAvailable");    // int[1] How many left rear tires are remaining  255 is unlimited ()
+irsdkVar<int> ir_RRTiresAvailable("RRTiresAvailable");    // int[1] How many right rear tires are remaining  255 is unlimited ()
+irsdkVar<int> ir_LeftTireSetsAvailable("LeftTireSetsAvailable");    // int[1] How many left tire sets are remaining  255 is unlimited ()
+irsdkVar<int> ir_RightTireSetsAvailable("RightTireSetsAvailable");    // int[1] How many right tire sets are remaining  255 is unlimited ()
+irsdkVar<int> ir_FrontTireSetsAvailable("FrontTireSetsAvailable");    // int[1] How many front tire sets are remaining  255 is unlimited ()
+irsdkVar<int> ir_RearTireSetsAvailable("RearTireSetsAvailable");    // int[1] How many rear tire sets are remaining  255 is unlimited ()
+irsdkVar<int> ir_TireSetsAvailable("TireSetsAvailable");    // int[1] How many tire sets are remaining  255 is unlimited ()
+irsdkVar<int> ir_CamCarIdx("CamCarIdx");    // int[1] Active camera's focus car index ()
+irsdkVar<int> ir_CamCameraNumber("CamCameraNumber");    // int[1] Active camera number ()
+irsdkVar<int> ir_CamGroupNumber("CamGroupNumber");    // int[1] Active camera group number ()
+irsdkVar<int> ir_CamCameraState("CamCameraState");    // bitfield[1] State of camera system (irsdk_CameraState)
+irsdkVar<bool> ir_IsOnTrackCar("IsOnTrackCar");    // bool[1] 1=Car on track physics running ()
+irsdkVar<bool> ir_IsInGarage("IsInGarage");    // bool[1] 1=Car in garage physics running ()
+irsdkVar<float> ir_SteeringWheelPctTorque("SteeringWheelPctTorque");    // float[1] Force feedback % max torque on steering shaft unsigned (%)
+irsdkVar<float> ir_SteeringWheelPctTorqueSign("SteeringWheelPctTorqueSign");    // float[1] Force feedback % max torque on steering shaft signed (%)
+irsdkVar<float> ir_SteeringWheelPctTorqueSignStops("SteeringWheelPctTorqueSignStops");    // float[1] Force feedback % max torque on steering shaft signed stops (%)
+irsdkVar<float> ir_SteeringWheelPctDamper("SteeringWheelPctDamper");    // float[1] Force feedback % max damping (%)
+irsdkVar<float> ir_SteeringWheelAngleMax("SteeringWheelAngleMax");    // float[1] Steering wheel max angle (rad)
+irsdkVar<float> ir_SteeringWheelLimiter("SteeringWheelLimiter");    // float[1] Force feedback limiter strength limits impacts and oscillation (%)
+irsdkVar<float> ir_ShiftIndicatorPct("ShiftIndicatorPct");    // float[1] DEPRECATED use DriverCarSLBlinkRPM instead (%)
+irsdkVar<float> ir_ShiftPowerPct("ShiftPowerPct");    // float[1] Friction torque applied to gears when shifting or grinding (%)
+irsdkVar<float> ir_ShiftGrindRPM("ShiftGrindRPM");    // float[1] RPM of shifter grinding noise (RPM)
+irsdkVar<float> ir_ThrottleRaw("ThrottleRaw");    // float[1] Raw throttle input 0=off throttle to 1=full throttle (%)
+irsdkVar<float> ir_BrakeRaw("BrakeRaw");    // float[1] Raw brake input 0=brake released to 1=max pedal force (%)
+irsdkVar<float> ir_HandbrakeRaw("HandbrakeRaw");    // float[1] Raw handbrake input 0=handbrake released to 1=max force (%)
+irsdkVar<float> ir_SteeringWheelPeakForceNm("SteeringWheelPeakForceNm");    // float[1] Peak torque mapping to direct input units for FFB (N*m)
+irsdkVar<float> ir_SteeringWheelMaxForceNm("SteeringWheelMaxForceNm");    // float[1] Value of strength or max force slider in Nm for FFB (N*m)
+irsdkVar<bool> ir_SteeringWheelUseLinear("SteeringWheelUseLinear");    // bool[1] True if steering wheel force is using linear mode ()
+irsdkVar<bool> ir_BrakeABSactive("BrakeABSactive");    // bool[1] true if abs is currently reducing brake force pressure ()
+irsdkVar<int> ir_EngineWarnings("EngineWarnings");    // bitfield[1] Bitfield for warning lights (irsdk_EngineWarnings)
+irsdkVar<float> ir_FuelLevel("FuelLevel");    // float[1] Liters of fuel remaining (l)
+irsdkVar<float> ir_FuelLevelPct("FuelLevelPct");    // float[1] Percent fuel remaining (%)
+irsdkVar<int> ir_PitSvFlags("PitSvFlags");    // bitfield[1] Bitfield of pit service checkboxes (irsdk_PitSvFlags)
+irsdkVar<float> ir_PitSvLFP("PitSvLFP");    // float[1] Pit service left front tire pressure (kPa)
+irsdkVar<float> ir_PitSvRFP("PitSvRFP");    // float[1] Pit service right front tire pressure (kPa)
+irsdkVar<float> ir_PitSvLRP("PitSvLRP");    // float[1] Pit service left rear tire pressure (kPa)
+irsdkVar<float> ir_PitSvRRP("PitSvRRP");    // float[1] Pit service right rear tire pressure (kPa)
+irsdkVar<float> ir_PitSvFuel("PitSvFuel");    // float[1] Pit service fuel add amount (l)
+irsdkVar<int> ir_PitSvTireCompound("PitSvTireCompound");    // int[1] Pit service pending tire compound ()
+irsdkVar<bool,64> ir_CarIdxP2P_Status("CarIdxP2P_Status");    // bool[64] Push2Pass active or not ()
+irsdkVar<int,64> ir_CarIdxP2P_Count("CarIdxP2P_Count");    // int[64] Push2Pass count of usage (or remaining in Race) ()
+irsdkVar<int> ir_ReplayPlaySpeed("ReplayPlaySpeed");    // int[1] Replay playback speed ()
+irsdkVar<bool> ir_ReplayPlaySlowMotion("ReplayPlaySlowMotion");    // bool[1] 0=not slow motion  1=replay is in slow motion ()
+irsdkVar<double> ir_ReplaySessionTime("ReplaySessionTime");    // double[1] Seconds since replay session start (s)
+irsdkVar<int> ir_ReplaySessionNum("ReplaySessionNum");    // int[1] Replay session number ()
+irsdkVar<float> ir_TireLF_RumblePitch("TireLF_RumblePitch");    // float[1] Players LF Tire Sound rumblestrip pitch (Hz)
+irsdkVar<float> ir_TireRF_RumblePitch("TireRF_RumblePitch");    // float[1] Players RF Tire Sound rumblestrip pitch (Hz)
+irsdkVar<float> ir_TireLR_RumblePitch("TireLR_RumblePitch");    // float[1] Players LR Tire Sound rumblestrip pitch (Hz)
+irsdkVar<float> ir_TireRR_RumblePitch("TireRR_RumblePitch");    // float[1] Players RR Tire Sound rumblestrip pitch (Hz)
+irsdkVar<float,6> ir_SteeringWheelTorque_ST("SteeringWheelTorque_ST");    // float[6] Output torque on steering shaft at 360 Hz (N*m)
+irsdkVar<float> ir_SteeringWheelTorque("SteeringWheelTorque");    // float[1] Output torque on steering shaft (N*m)
+irsdkVar<float,6> ir_VelocityZ_ST("VelocityZ_ST");    // float[6] Z velocity (m/s at 360 Hz)
+irsdkVar<float,6> ir_VelocityY_ST("VelocityY_ST");    // float[6] Y velocity (m/s at 360 Hz)
+irsdkVar<float,6> ir_VelocityX_ST("VelocityX_ST");    // float[6] X velocity (m/s at 360 Hz)
+irsdkVar<float> ir_VelocityZ("VelocityZ");    // float[1] Z velocity (m/s)
+irsdkVar<float> ir_VelocityY("VelocityY");    // float[1] Y velocity (m/s)
+irsdkVar<float> ir_VelocityX("VelocityX");    // float[1] X velocity (m/s)
+irsdkVar<float,6> ir_YawRate_ST("YawRate_ST");    // float[6] Yaw rate at 360 Hz (rad/s)
+irsdkVar<float,6> ir_PitchRate_ST("PitchRate_ST");    // float[6] Pitch rate at 360 Hz (rad/s)
+irsdkVar<float,6> ir_RollRate_ST("RollRate_ST");    // float[6] Roll rate at 360 Hz (rad/s)
+irsdkVar<float> ir_YawRate("YawRate");    // float[1] Yaw rate (rad/s)
+irsdkVar<float> ir_PitchRate("PitchRate");    // float[1] Pitch rate (rad/s)
+irsdkVar<float> ir_RollRate("RollRate");    // float[1] Roll rate (rad/s)
+irsdkVar<float,6> ir_VertAccel_ST("VertAccel_ST");    // float[6] Vertical acceleration (including gravity) at 360 Hz (m/s^2)
+irsdkVar<float,6> ir_LatAccel_ST("LatAccel_ST");    // float[6] Lateral acceleration (including gravity) at 360 Hz (m/s^2)
+irsdkVar<float,6> ir_LongAccel_ST("LongAccel_ST");    // float[6] Longitudinal acceleration (including gravity) at 360 Hz (m/s^2)
+irsdkVar<float> ir_VertAccel("VertAccel");    // float[1] Vertical acceleration (including gravity) (m/s^2)
+irsdkVar<float> ir_LatAccel("LatAccel");    // float[1] Lateral acceleration (including gravity) (m/s^2)
+irsdkVar<float> ir_LongAccel("LongAccel");    // float[1] Longitudinal acceleration (including gravity) (m/s^2)
+irsdkVar<bool> ir_dcStarter("dcStarter");    // bool[1] In car trigger car starter ()
+irsdkVar<float> ir_dpRTireChange("dpRTireChange");    // float[1] Pitstop right tire change request ()
+irsdkVar<float> ir_dpLTireChange("dpLTireChange");    // float[1] Pitstop left tire change request ()
+irsdkVar<float> ir_dpFuelFill("dpFuelFill");    // float[1] Pitstop fuel fill flag ()
+irsdkVar<float> ir_dpWindshieldTearoff("dpWindshieldTearoff");    // float[1] Pitstop windshield tearoff ()
+irsdkVar<float> ir_dpFuelAddKg("dpFuelAddKg");    // float[1] Pitstop fuel add ammount (kg)
+irsdkVar<float> ir_dpFastRepair("dpFastRepair");    // float[1] Pitstop fast repair set ()
+irsdkVar<float> ir_dcBrakeBias("dcBrakeBias");    // float[1] In car brake bias adjustment ()
+irsdkVar<float> ir_dpLFTireColdPress("dpLFTireColdPress");    // float[1] Pitstop lf tire cold pressure adjustment (Pa)
+irsdkVar<float> ir_dpRFTireColdPress("dpRFTireColdPress");    // float[1] Pitstop rf cold tire pressure adjustment (Pa)
+irsdkVar<float> ir_dpLRTireColdPress("dpLRTireColdPress");    // float[1] Pitstop lr tire cold pressure adjustment (Pa)
+irsdkVar<float> ir_dpRRTireColdPress("dpRRTireColdPress");    // float[1] Pitstop rr cold tire pressure adjustment (Pa)
+irsdkVar<float> ir_dpWeightJackerLeft("dpWeightJackerLeft");    // float[1] Pitstop left wedge/weight jacker adjustment ()
+irsdkVar<float> ir_dpWeightJackerRight("dpWeightJackerRight");    // float[1] Pitstop right wedge/weight jacker adjustment ()
+irsdkVar<float> ir_WaterTemp("WaterTemp");    // float[1] Engine coolant temp (C)
+irsdkVar<float> ir_WaterLevel("WaterLevel");    // float[1] Engine coolant level (l)
+irsdkVar<float> ir_FuelPress("FuelPress");    // float[1] Engine fuel pressure (bar)
+irsdkVar<float> ir_FuelUsePerHour("FuelUsePerHour");    // float[1] Engine fuel used instantaneous (kg/h)
+irsdkVar<float> ir_OilTemp("OilTemp");    // float[1] Engine oil temperature (C)
+irsdkVar<float> ir_OilPress("OilPress");    // float[1] Engine oil pressure (bar)
+irsdkVar<float> ir_OilLevel("OilLevel");    // float[1] Engine oil level (l)
+irsdkVar<float> ir_Voltage("Voltage");    // float[1] Engine voltage (V)
+irsdkVar<float> ir_ManifoldPress("ManifoldPress");    // float[1] Engine manifold pressure (bar)
+irsdkVar<float> ir_RFcoldPressure("RFcoldPressure");    // float[1] RF tire cold pressure  as set in the garage (kPa)
+irsdkVar<float> ir_RFtempCL("RFtempCL");    // float[1] RF tire left carcass temperature (C)
+irsdkVar<float> ir_RFtempCM("RFtempCM");    // float[1] RF tire middle carcass temperature (C)
+irsdkVar<float> ir_RFtempCR("RFtempCR");    // float[1] RF tire right carcass temperature (C)
+irsdkVar<float> ir_RFwearL("RFwearL");    // float[1] RF tire left percent tread remaining (%)
+irsdkVar<float> ir_RFwearM("RFwearM");    // float[1] RF tire middle percent tread remaining (%)
+irsdkVar<float> ir_RFwearR("RFwearR");    // float[1] RF tire right percent tread remaining (%)
+irsdkVar<float> ir_LFcoldPressure("LFcoldPressure");    // float[1] LF tire cold pressure  as set in the garage (kPa)
+irsdkVar<float> ir_LFtempCL("LFtempCL");    // float[1] LF tire left carcass temperature (C)
+irsdkVar<float> ir_LFtempCM("LFtempCM");    // float[1] LF tire middle carcass temperature (C)
+irsdkVar<float> ir_LFtempCR("LFtempCR");    // float[1] LF tire right carcass temperature (C)
+irsdkVar<float> ir_LFwearL("LFwearL");    // float[1] LF tire left percent tread remaining (%)
+irsdkVar<float> ir_LFwearM("LFwearM");    // float[1] LF tire middle percent tread remaining (%)
+irsdkVar<float> ir_LFwearR("LFwearR");    // float[1] LF tire right percent tread remaining (%)
+irsdkVar<float> ir_RRcoldPressure("RRcoldPressure");    // float[1] RR tire cold pressure  as set in the garage (kPa)
+irsdkVar<float> ir_RRtempCL("RRtempCL");    // float[1] RR tire left carcass temperature (C)
+irsdkVar<float> ir_RRtempCM("RRtempCM");    // float[1] RR tire middle carcass temperature (C)
+irsdkVar<float> ir_RRtempCR("RRtempCR");    // float[1] RR tire right carcass temperature (C)
+irsdkVar<float> ir_RRwearL("RRwearL");    // float[1] RR tire left percent tread remaining (%)
+irsdkVar<float> ir_RRwearM("RRwearM");    // float[1] RR tire middle percent tread remaining (%)
+irsdkVar<float> ir_RRwearR("RRwearR");    // float[1] RR tire right percent tread remaining (%)
+irsdkVar<float> ir_LRcoldPressure("LRcoldPressure");    // float[1] LR tire cold pressure  as set in the garage (kPa)
+irsdkVar<float> ir_LRtempCL("LRtempCL");    // float[1] LR tire left carcass temperature (C)
+irsdkVar<float> ir_LRtempCM("LRtempCM");    // float[1] LR tire middle carcass temperature (C)
+irsdkVar<float> ir_LRtempCR("LRtempCR");    // float[1] LR tire right carcass temperature (C)
+irsdkVar<float> ir_LRwearL("LRwearL");    // float[1] LR tire left percent tread remaining (%)
+irsdkVar<float> ir_LRwearM("LRwearM");    // float[1] LR tire middle percent tread remaining (%)
+irsdkVar<float> ir_LRwearR("LRwearR");    // float[1] LR tire right percent tread remaining (%)
+irsdkVar<float> ir_RRSHshockDefl("RRSHshockDefl");    // float[1] RRSH shock deflection (m)
+irsdkVar<float,6> ir_RRSHshockDefl_ST("RRSHshockDefl_ST");    // float[6] RRSH shock deflection at 360 Hz (m)
+irsdkVar<float> ir_RRSHshockVel("RRSHshockVel");    // float[1] RRSH shock velocity (m/s)
+irsdkVar<float,6> ir_RRSHshockVel_ST("RRSHshockVel_ST");    // float[6] RRSH shock velocity at 360 Hz (m/s)
+irsdkVar<float> ir_LRSHshockDefl("LRSHshockDefl");    // float[1] LRSH shock deflection (m)
+irsdkVar<float,6> ir_LRSHshockDefl_ST("LRSHshockDefl_ST");    // float[6] LRSH shock deflection at 360 Hz (m)
+irsdkVar<float> ir_LRSHshockVel("LRSHshockVel");    // float[1] LRSH shock velocity (m/s)
+irsdkVar<float,6> ir_LRSHshockVel_ST("LRSHshockVel_ST");    // float[6] LRSH shock velocity at 360 Hz (m/s)
+irsdkVar<float> ir_RFSHshockDefl("RFSHshockDefl");    // float[1] RFSH shock deflection (m)
+irsdkVar<float,6> ir_RFSHshockDefl_ST("RFSHshockDefl_ST");    // float[6] RFSH shock deflection at 360 Hz (m)
+irsdkVar<float> ir_RFSHshockVel("RFSHshockVel");    // float[1] RFSH shock velocity (m/s)
+irsdkVar<float,6> ir_RFSHshockVel_ST("RFSHshockVel_ST");    // float[6] RFSH shock velocity at 360 Hz (m/s)
+irsdkVar<float> ir_LFSHshockDefl("LFSHshockDefl");    // float[1] LFSH shock deflection (m)
+irsdkVar<float,6> ir_LFSHshockDefl_ST("LFSHshockDefl_ST");    // float[6] LFSH shock deflection at 360 Hz (m)
+irsdkVar<float> ir_LFSHshockVel("LFSHshockVel");    // float[1] LFSH shock velocity (m/s)
+irsdkVar<float,6> ir_LFSHshockVel_ST("LFSHshockVel_ST");    // float[6] LFSH shock velocity at 360 Hz (m/s)
 
 Session ir_session;
+CarIdxSnapshot ir_carIdx;
+RaceState ir_race;
+SectorTimes ir_sectors;
+FuelState ir_fuel;
+StrategyResult ir_strategy;
 
-static bool parseYamlInt(const char *yamlStr, const char *path, int *dest)
+SessionParseStats ir_sessionParseStats;
+
+static bool g_synchronousSessionParsing = false;
+
+void ir_setSynchronousSessionParsing( bool on )
+{
+    g_synchronousSessionParsing = on;
+}
+
+template<typename T>
+static void copyCarIdxVar( irsdkVar<T,IR_MAX_CARS>& var, T (&dest)[IR_MAX_CARS] )
+{
+    memcpy( dest, var.getArray(), sizeof(dest) );
+}
+
+static void updateCarIdxSnapshot()
+{
+    CarIdxSnapshot& s = ir_carIdx;
+
+    copyCarIdxVar( ir_CarIdxLapDistPct, s.lapDistPct );
+    copyCarIdxVar( ir_CarIdxF2Time, s.f2Time );
+    copyCarIdxVar( ir_CarIdxEstTime, s.estTime );
+    copyCarIdxVar( ir_CarIdxLastLapTime, s.lastLapTime );
+    copyCarIdxVar( ir_CarIdxBestLapTime, s.bestLapTime );
+    copyCarIdxVar( ir_CarIdxSteer, s.steer );
+    copyCarIdxVar( ir_CarIdxRPM, s.rpm );
+
+    copyCarIdxVar( ir_CarIdxLap, s.lap );
+    copyCarIdxVar( ir_CarIdxLapCompleted, s.lapCompleted );
+    copyCarIdxVar( ir_CarIdxTrackSurface, s.trackSurface );
+    copyCarIdxVar( ir_CarIdxTrackSurfaceMaterial, s.trackSurfaceMaterial );
+    copyCarIdxVar( ir_CarIdxPosition, s.position );
+    copyCarIdxVar( ir_CarIdxClassPosition, s.classPosition );
+    copyCarIdxVar( ir_CarIdxClass, s.carClass );
+    copyCarIdxVar( ir_CarIdxBestLapNum, s.bestLapNum );
+    copyCarIdxVar( ir_CarIdxTireCompound, s.tireCompound );
+    copyCarIdxVar( ir_CarIdxQualTireCompound, s.qualTireCompound );
+    copyCarIdxVar( ir_CarIdxFastRepairsUsed, s.fastRepairsUsed );
+    copyCarIdxVar( ir_CarIdxPaceLine, s.paceLine );
+    copyCarIdxVar( ir_CarIdxPaceRow, s.paceRow );
+    copyCarIdxVar( ir_CarIdxPaceFlags, s.paceFlags );
+    copyCarIdxVar( ir_CarIdxGear, s.gear );
+    copyCarIdxVar( ir_CarIdxP2P_Count, s.p2pCount );
+
+    copyCarIdxVar( ir_CarIdxOnPitRoad, s.onPitRoad );
+    copyCarIdxVar( ir_CarIdxQualTireCompoundLocked, s.qualTireCompoundLocked );
+    copyCarIdxVar( ir_CarIdxP2P_Status, s.p2pStatus );
+}
+
+// Try the different sources we have for position data, in descending order of importance
+static int bestKnownPosition( int carIdx )
+{
+    int pos = ir_carIdx.position[carIdx];
+    if( pos > 0 )
+        return pos;
+
+    pos = ir_session.cars[carIdx].racePosition;
+    if( pos > 0 )
+        return pos;
+
+    pos = ir_session.cars[carIdx].qualPosition;
+    if( pos > 0 )
+        return pos;
+
+    pos = ir_session.cars[carIdx].practicePosition;
+    if( pos > 0 )
+        return pos;
+
+    return 0;
+}
+
+static void updateRaceState()
 {
-    int count = 0;
-    const char *s = nullptr;
+    RaceState& rs = ir_race;
+    const CarIdxSnapshot& cs = ir_carIdx;
+    const int  selfIdx = ir_session.driverCarIdx;
+    const bool haveSelf = selfIdx >= 0 && selfIdx < IR_MAX_CARS;
+    const bool isRace = ir_session.sessionType == SessionType::RACE;
+    const int  sessionState = ir_SessionState.getInt();
+    const int  paceMode = ir_PaceMode.getInt();
 
-    if( parseYaml(yamlStr, path, &s, &count) )
+    // To find out whether we're pacing, it isn't enough to check ir_PaceMode, because
+    // iRacing doesn't set it to irsdk_PaceModeNotPacing as one would expect. So in addition we check
+    // the session state, since initial pacing apparently counts as "parade laps".
+    rs.isPreStart = (paceMode == irsdk_PaceModeSingleFileStart || paceMode == irsdk_PaceModeDoubleFileStart) &&
+                    (sessionState == irsdk_StateParadeLaps || sessionState == irsdk_StateWarmup || sessionState == irsdk_StateGetInCar);
+
+    const float ownBest = ir_LapBestLapTime.getFloat();
+    rs.estimatedLaptime = ownBest > 0 ? ownBest : (haveSelf ? ir_session.cars[selfIdx].carClassEstLapTime : 0);
+
+    // Positions, best laps, the leader and the fastest lap in one go. Remember who's where, for the class positions.
+    const bool raceNotStarted = isRace && sessionState <= irsdk_StateWarmup;
+    const bool isQualify = ir_session.sessionType == SessionType::QUALIFY;
+    int byPosition[IR_MAX_CARS+1];
+    for( int pos=0; pos<=IR_MAX_CARS; ++pos )
+        byPosition[pos] = -1;
+    rs.leaderIdx = -1;
+    rs.fastestLapIdx = -1;
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        const Car& car = ir_session.cars[carIdx];
+
+        const int pos = bestKnownPosition( carIdx );
+        rs.position[carIdx] = pos;
+        rs.classPosition[carIdx] = cs.classPosition[carIdx];
+
+        float best = cs.bestLapTime[carIdx];
+        if( raceNotStarted || (isQualify && best <= 0) )
+            best = car.qualTime;
+        rs.bestLapTime[carIdx] = best;
+
+        if( car.isPaceCar || car.isSpectator || !car.userName[0] )
+            continue;
+
+        if( pos > 0 && pos <= IR_MAX_CARS && byPosition[pos] < 0 )
+            byPosition[pos] = carIdx;
+        if( pos > 0 && (rs.leaderIdx < 0 || pos < rs.position[rs.leaderIdx]) )
+            rs.leaderIdx = carIdx;
+        if( best > 0 && (rs.fastestLapIdx < 0 || best < rs.bestLapTime[rs.fastestLapIdx]) )
+            rs.fastestLapIdx = carIdx;
+    }
+
+    // Where the sim doesn't have a class position, count them up in position order
+    int classIds[IR_MAX_CARS];
+    int classCounts[IR_MAX_CARS];
+    int numClasses = 0;
+    for( int pos=1; pos<=IR_MAX_CARS; ++pos )
     {
-        *dest = atoi( s );
-        return true;
+        const int carIdx = byPosition[pos];
+        if( carIdx < 0 )
+            continue;
+
+        int k = 0;
+        while( k < numClasses && classIds[k] != cs.carClass[carIdx] )
+            ++k;
+        if( k == numClasses )
+        {
+            classIds[numClasses] = cs.carClass[carIdx];
+            classCounts[numClasses++] = 0;
+        }
+        ++classCounts[k];
+
+        if( rs.classPosition[carIdx] <= 0 )
+            rs.classPosition[carIdx] = classCounts[k];
     }
 
-    return false;
+    // Lap deltas. Relative to our car, a car up to half a lap in front counts as ahead, otherwise behind.
+    // There are none when not in a race, during initial pacing (iRacing starts counting laps during the pace
+    // lap but then resets the counter a couple seconds in), and for the pace car.
+    const bool lapDeltasValid = isRace && !rs.isPreStart;
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        rs.lapDeltaToLeader[carIdx] = ir_getLapDeltaToLeader( carIdx, rs.leaderIdx );
+        rs.lapDeltaToSelf[carIdx] = 0;
+
+        if( !lapDeltasValid || !haveSelf || ir_session.cars[carIdx].isPaceCar )
+            continue;
+
+        int lapDelta = cs.lap[carIdx] - cs.lap[selfIdx];
+        if( fabsf( cs.lapDistPct[carIdx] - cs.lapDistPct[selfIdx] ) > 0.5f )
+            lapDelta += cs.estTime[selfIdx] > cs.estTime[carIdx] ? -1 : 1;
+        rs.lapDeltaToSelf[carIdx] = lapDelta;
+    }
+}
+
+//
+// Sector timing
+//
+
+// What the timing remembers of a car between ticks
+struct SectorTracker
+{
+    float   prevPct = -1;
+    int     lastLine = -1;          // sector line crossed last, -1 while the chain of crossings is broken
+    double  lastLineTime = 0;
+    bool    pitInSector = false;    // on pit road since lastLine
+    double  lapStartTime = -1;
+    int     sectorsInLap = 0;       // timed in a row since lapStartTime
+    bool    pitInLap = false;
+};
+
+static SectorTracker g_sectorTrackers[IR_MAX_CARS];
+static double        g_sectorPrevTime = -1;
+static int           g_sectorPrevSessionNum = -1;
+static float         g_sectorConfigStartPct[IR_MAX_SECTORS];
+static int           g_sectorConfigNum = 0;     // 0 to use the track's
+
+static void resetSectorCar( int carIdx )
+{
+    SectorTimes& st = ir_sectors;
+
+    g_sectorTrackers[carIdx] = SectorTracker();
+    memset( st.last[carIdx], 0, sizeof(st.last[carIdx]) );
+    memset( st.best[carIdx], 0, sizeof(st.best[carIdx]) );
+    st.lastLap[carIdx] = 0;
+    st.bestLap[carIdx] = 0;
+    st.optimalLap[carIdx] = 0;
 }
 
-static bool parseYamlFloat(const char *yamlStr, const char *path, float *dest)
+static void resetSectorTimes()
 {
-    int count = 0;
-    const char *s = nullptr;
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+        resetSectorCar( carIdx );
+    g_sectorPrevTime = -1;
+}
 
-    if( parseYaml(yamlStr, path, &s, &count) )
+// The configured lines, or else the track's, always starting with the start/finish line and in order
+// around the lap. Timing starts over when they change.
+static void updateSectorLines()
+{
+    SectorTimes& st = ir_sectors;
+    const float* starts = g_sectorConfigNum ? g_sectorConfigStartPct : ir_session.sectorStartPct;
+    const int    numStarts = g_sectorConfigNum ? g_sectorConfigNum : ir_session.numSectors;
+
+    float lines[IR_MAX_SECTORS];
+    int numLines = 1;
+    lines[0] = 0;
+    for( int i=0; i<numStarts; ++i )
     {
-        (*dest) = (float)atof( s );
-        return true;
+        const float pct = starts[i];
+        if( pct > lines[numLines-1] && pct < 1 && numLines < IR_MAX_SECTORS )
+            lines[numLines++] = pct;
     }
 
-    return false;
+    if( numLines == st.numSectors && !memcmp( lines, st.sectorStartPct, numLines * sizeof(float) ) )
+        return;
+
+    st.numSectors = numLines;
+    memset( st.sectorStartPct, 0, sizeof(st.sectorStartPct) );
+    memcpy( st.sectorStartPct, lines, numLines * sizeof(float) );
+    resetSectorTimes();
 }
 
-static bool parseYamlStr(const char *yamlStr, const char *path, std::string& dest)
+static void breakSectorChain( SectorTracker& tr )
 {
-    int count = 0;
-    const char *s = nullptr;
+    tr.lastLine = -1;
+    tr.lapStartTime = -1;
+    tr.sectorsInLap = 0;
+}
+
+// Car carIdx crossed the line that starts sector 'line' at time t
+static void crossSectorLine( int carIdx, int line, double t )
+{
+    SectorTimes& st = ir_sectors;
+    SectorTracker& tr = g_sectorTrackers[carIdx];
+    const int n = st.numSectors;
+
+    // a sector is timed from one line to the next, anything else means some of it went missing
+    if( tr.lastLine >= 0 && line == (tr.lastLine + 1) % n && t > tr.lastLineTime )
+    {
+        const int   sector = tr.lastLine;
+        const float time = (float)(t - tr.lastLineTime);
+        st.last[carIdx][sector] = time;
+        if( !tr.pitInSector && (st.best[carIdx][sector] <= 0 || time < st.best[carIdx][sector]) )
+        {
+            st.best[carIdx][sector] = time;
+
+            float optimal = 0;
+            for( int s=0; s<n && optimal>=0; ++s )
+                optimal = st.best[carIdx][s] > 0 ? optimal + st.best[carIdx][s] : -1;
+            st.optimalLap[carIdx] = optimal > 0 ? optimal : 0;
+        }
+        tr.sectorsInLap++;
+        tr.pitInLap |= tr.pitInSector;
+    }
+    else
+    {
+        breakSectorChain( tr );
+    }
+
+    if( line == 0 )
+    {
+        if( tr.lapStartTime >= 0 && tr.sectorsInLap == n )
+        {
+            const float time = (float)(t - tr.lapStartTime);
+            st.lastLap[carIdx] = time;
+            st.lapsTimed[carIdx]++;
+            if( !tr.pitInLap && (st.bestLap[carIdx] <= 0 || time < st.bestLap[carIdx]) )
+                st.bestLap[carIdx] = time;
+        }
+        tr.lapStartTime = t;
+        tr.sectorsInLap = 0;
+        tr.pitInLap = false;
+    }
+
+    tr.lastLine = line;
+    tr.lastLineTime = t;
+    tr.pitInSector = false;
+}
+
+static void updateSectorTimes()
+{
+    const SectorTimes& st = ir_sectors;
+    const CarIdxSnapshot& cs = ir_carIdx;
+    const double now = ir_SessionTime.getDouble();
+    const int sessionNum = ir_SessionNum.getInt();
+
+    updateSectorLines();
+
+    // new session, or time went backwards, like when jumping around in a replay
+    if( sessionNum != g_sectorPrevSessionNum || now < g_sectorPrevTime )
+    {
+        resetSectorTimes();
+        g_sectorPrevSessionNum = sessionNum;
+    }
 
-    if( parseYaml(yamlStr, path, &s, &count) )
+    // nothing new
+    if( now == g_sectorPrevTime )
+        return;
+
+    // after a gap there's no telling what happened in between
+    const double t0 = g_sectorPrevTime;
+    const bool   contiguous = t0 >= 0 && now - t0 <= 1.0;
+    g_sectorPrevTime = now;
+
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
     {
-        // strip leading quotes
-        if( *s == '"' )
+        SectorTracker& tr = g_sectorTrackers[carIdx];
+        const float p0 = tr.prevPct;
+        const float p1 = cs.lapDistPct[carIdx];
+        tr.prevPct = p1;
+
+        // towed, reset to the pits, or not in the world
+        if( !contiguous || p0 < 0 || p1 < 0 )
         {
-            s++;
-            count--;
+            breakSectorChain( tr );
+            continue;
         }
 
-        dest.assign( s, count );
+        float dist = -1;
+        if( p1 >= p0 && p1 - p0 < 0.5f )
+            dist = p1 - p0;
+        else if( p0 > 0.75f && p1 < 0.25f )
+            dist = 1.0f - p0 + p1;      // over the start/finish line
+        if( dist < 0 )
+        {
+            breakSectorChain( tr );     // jumped
+            continue;
+        }
+
+        // every line in (p0, p1], in the order they're crossed
+        int line = 0;
+        while( line < st.numSectors && st.sectorStartPct[line] <= p0 )
+            ++line;
+        for( int k=0; k<st.numSectors && dist>0; ++k, ++line )
+        {
+            line %= st.numSectors;
+            float along = st.sectorStartPct[line] - p0;
+            if( along <= 0 )
+                along += 1.0f;
+            if( along > dist )
+                break;
 
-        // strip trailing quotes
-        if( !dest.empty() && dest[dest.length()-1]=='"' )
-            dest.pop_back();
+            crossSectorLine( carIdx, line, t0 + along / dist * (now - t0) );
+        }
 
-        return true;
+        tr.pitInSector |= cs.onPitRoad[carIdx];
     }
+}
+
+//
+// Learned lap position to time tables
+//
 
-    return false;
+static const int TimeTableBins = 1000;
+static const int TimeTableClasses = 8;
+
+// How long one car class takes for every bit of the lap at race pace
+struct TimeTable
+{
+    int             classId = -1;               // -1 for a free table
+    int             binsCovered = 0;
+    bool            dirty = false;
+    float           secPerBin[TimeTableBins] = {};
+    unsigned short  samples[TimeTableBins] = {};
+    float           timeAt[TimeTableBins+1] = {};   // from the start/finish line to the start of each bin, smoothed, the last one is the whole lap
+};
+
+static TimeTable g_timeTables[TimeTableClasses];
+static int       g_timeTableTrackId = -1;
+static float     g_timeTablePrevPct[IR_MAX_CARS];
+static double    g_timeTablePrevTime = -1;
+
+static TimeTable* findTimeTable( int classId )
+{
+    for( TimeTable& tt : g_timeTables )
+        if( tt.classId == classId )
+            return &tt;
+    return nullptr;
 }
 
-ConnectionStatus ir_tick()
+static const TimeTable* readyTimeTable( int carIdx )
 {
-    irsdkClient& irsdk = irsdkClient::instance();
+    const TimeTable* tt = findTimeTable( ir_carIdx.carClass[carIdx] );
+    return tt && tt->binsCovered == TimeTableBins ? tt : nullptr;
+}
 
-    irsdk.waitForData(16);
+static float timeTableAt( const TimeTable& tt, float pct )
+{
+    const float x = pct * TimeTableBins;
+    const int   bin = std::min( std::max( (int)x, 0 ), TimeTableBins - 1 );
+    return tt.timeAt[bin] + (x - bin) * (tt.timeAt[bin+1] - tt.timeAt[bin]);
+}
 
-    if( !irsdk.isConnected() )
-        return ConnectionStatus::DISCONNECTED;
+// Seconds from lap position 'from' forward to 'to'
+static float timeTableForward( const TimeTable& tt, float from, float to )
+{
+    float t = timeTableAt( tt, to ) - timeTableAt( tt, from );
+    if( t < 0 )
+        t += tt.timeAt[TimeTableBins];
+    return t;
+}
 
-    if( irsdk.wasSessionStrUpdated() )
+// The time a car took for [p0, p0+dist) at an even pace, going into the bins it covered. Once a bin knows
+// the pace, much slower passes (a spin, a moment, traffic) are left out.
+static void sampleTimeTable( TimeTable& tt, float p0, float dist, double dt )
+{
+    const float binWidth = 1.0f / TimeTableBins;
+    const float secPerBin = (float)(dt / dist) * binWidth;
+    const float rate = 0.1f;
+
+    float pos = p0 * TimeTableBins;
+    float left = dist * TimeTableBins;
+    while( left > 0 )
     {
-        const char* sessionYaml = irsdk.getSessionStr();
-#ifdef _DEBUG
-        //printf("%s\n", sessionYaml);
-        FILE* fp = fopen("sessionYaml.txt","ab");
-        fprintf(fp,"\n\n==== NEW SESSION STRING ======================================\n");
-        fprintf(fp,"%s",sessionYaml);
-        fclose(fp);
-#endif
-        char path[256];
-
-        // Weekend info
-        sprintf( path, "WeekendInfo:SubSessionID:" );
-        parseYamlInt( sessionYaml, path, &ir_session.subsessionId );
-
-        sprintf( path, "WeekendInfo:WeekendOptions:IsFixedSetup:" );
-        parseYamlInt( sessionYaml, path, &ir_session.isFixedSetup );
-
-        // Current session type
-        std::string sessionNameStr;
-        sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionName:", ir_SessionNum.getInt() );
-        parseYamlStr( sessionYaml, path, sessionNameStr );
-        if( sessionNameStr == "PRACTICE" )
-            ir_session.sessionType = SessionType::PRACTICE;
-        if( sessionNameStr == "QUALIFY" )
-            ir_session.sessionType = SessionType::QUALIFY;
-        else if( sessionNameStr == "RACE" )
-            ir_session.sessionType = SessionType::RACE;
-
-        // Driver/car info
-        parseYamlInt( sessionYaml, "DriverInfo:DriverCarIdx:", &ir_session.driverCarIdx );
-        parseYamlFloat( sessionYaml, "DriverInfo:DriverCarFuelMaxLtr:", &ir_session.fuelMaxLtr );
-        parseYamlFloat( sessionYaml, "DriverInfo:DriverCarIdleRPM:", &ir_session.rpmIdle );
-        parseYamlFloat( sessionYaml, "DriverInfo:DriverCarRedLine:", &ir_session.rpmRedline );
-        parseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLFirstRPM:", &ir_session.rpmSLFirst );
-        parseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLShiftRPM:", &ir_session.rpmSLShift );
-        parseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLLastRPM:", &ir_session.rpmSLLast );
-        parseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLBlinkRPM:", &ir_session.rpmSLBlink );
-
-        // Per-Driver info
-        for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+        const int   bin = std::min( (int)pos, TimeTableBins - 1 ) % TimeTableBins;
+        const float covered = std::min( left, (float)(bin + 1) - pos );
+        pos = bin + 1 == TimeTableBins ? 0 : pos + covered;
+        left -= covered;
+        if( covered <= 0 )
+            break;
+
+        unsigned short& n = tt.samples[bin];
+        float& known = tt.secPerBin[bin];
+        if( n == 0 )
         {
-            Car& car = ir_session.cars[carIdx];
+            known = secPerBin;
+            tt.binsCovered++;
+        }
+        else if( n >= 3 && secPerBin > 1.3f * known )
+        {
+            continue;
+        }
+        else
+        {
+            known += rate * covered * (secPerBin - known);
+        }
+        if( n < 0xffff )
+            n++;
+        tt.dirty = true;
+    }
+}
 
-            car.isSelf = int( carIdx==ir_session.driverCarIdx );
+static void rebuildTimeTable( TimeTable& tt )
+{
+    tt.dirty = false;
+    tt.timeAt[0] = 0;
+    for( int bin=0; bin<TimeTableBins; ++bin )
+    {
+        const int prev = (bin + TimeTableBins - 1) % TimeTableBins;
+        const int next = (bin + 1) % TimeTableBins;
+        tt.timeAt[bin+1] = tt.timeAt[bin] + 0.25f * tt.secPerBin[prev] + 0.5f * tt.secPerBin[bin] + 0.25f * tt.secPerBin[next];
+    }
+}
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}UserName:", carIdx );
-            if( !parseYamlStr( sessionYaml, path, car.userName ) )
-            {
-                car = Car();
-                continue;
-            }
+static void updateTimeTables()
+{
+    const CarIdxSnapshot& cs = ir_carIdx;
+    const double now = ir_SessionTime.getDouble();
 
-            // Remove line breaks in user names if we find any (saw this happen once)
-            for( char& c : car.userName )
-                c = (c=='\n'||c=='\r') ? ' ' : c;
+    // learned for this track only
+    if( ir_session.trackId != g_timeTableTrackId )
+    {
+        g_timeTableTrackId = ir_session.trackId;
+        for( TimeTable& tt : g_timeTables )
+            tt = TimeTable();
+        g_timeTablePrevTime = -1;
+    }
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarNumber:", carIdx );
-            parseYamlStr( sessionYaml, path, car.carNumberStr );
+    if( now == g_timeTablePrevTime )
+        return;
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarNumberRaw:", carIdx );
-            parseYamlInt( sessionYaml, path, &car.carNumber );
+    const double dt = now - g_timeTablePrevTime;
+    const bool   contiguous = g_timeTablePrevTime >= 0 && dt > 0 && dt <= 1.0;
+    g_timeTablePrevTime = now;
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}LicString:", carIdx );
-            parseYamlStr( sessionYaml, path, car.licenseStr );
-            car.licenseChar = car.licenseStr.empty() ? 'R' : car.licenseStr[0];
-            const std::string SRstr = car.licenseStr.empty() ? "0" : std::string( car.licenseStr.begin()+1, car.licenseStr.end() );
-            car.licenseSR = (float)atof( SRstr.c_str() );
+    // only race pace counts, not the pace laps, cautions or the cool down lap
+    const bool pacing = ir_race.isPreStart || (ir_SessionFlags.getInt() & (irsdk_caution | irsdk_cautionWaving | irsdk_checkered));
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}LicColor:", carIdx );
-            parseYamlStr( sessionYaml, path, car.licenseColStr );
-            unsigned licColHex = 0;
-            sscanf( car.licenseColStr.c_str(), "0x%x", &licColHex );
-            car.licenseCol.r = float((licColHex >> 16) & 0xff) / 255.f;
-            car.licenseCol.g = float((licColHex >>  8) & 0xff) / 255.f;
-            car.licenseCol.b = float((licColHex >>  0) & 0xff) / 255.f;
-            car.licenseCol.a = 1;
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        const float p0 = g_timeTablePrevPct[carIdx];
+        const float p1 = cs.lapDistPct[carIdx];
+        g_timeTablePrevPct[carIdx] = p1;
+
+        if( !contiguous || pacing || p0 < 0 || p1 < 0 || cs.onPitRoad[carIdx] || cs.trackSurface[carIdx] != irsdk_OnTrack ||
+            ir_session.cars[carIdx].isPaceCar )
+            continue;
+
+        float dist = p1 - p0;
+        if( dist < 0 && p0 > 0.75f && p1 < 0.25f )
+            dist += 1.0f;
+        if( dist <= 0 || dist >= 0.5f )
+            continue;
+
+        TimeTable* tt = findTimeTable( cs.carClass[carIdx] );
+        if( !tt && (tt = findTimeTable( -1 )) != nullptr )
+            tt->classId = cs.carClass[carIdx];
+        if( tt )
+            sampleTimeTable( *tt, p0, dist, dt );
+    }
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}IRating:", carIdx );
-            parseYamlInt( sessionYaml, path, &car.irating );
+    for( TimeTable& tt : g_timeTables )
+        if( tt.dirty && tt.binsCovered == TimeTableBins )
+            rebuildTimeTable( tt );
+}
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarIsPaceCar:", carIdx );
-            parseYamlInt( sessionYaml, path, &car.isPaceCar );
+//
+// Fuel use
+//
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}IsSpectator:", carIdx );
-            parseYamlInt( sessionYaml, path, &car.isSpectator );
+// One line per car and track: car id, track id, liters per green lap, green laps it's from
+struct FuelStoreEntry
+{
+    int     carId = 0;
+    int     trackId = 0;
+    float   perLap = 0;
+    int     laps = 0;
+};
+
+static std::string                  g_fuelStorePath = "fuel.txt";
+static bool                         g_fuelStoreEnabled = true;
+static bool                         g_fuelStoreLoaded = false;
+static std::vector<FuelStoreEntry>  g_fuelStore;
+
+static int      g_fuelCarId = -1;
+static int      g_fuelTrackId = -1;
+static int      g_fuelLap = -1;                 // the player's lap being measured, -1 before the first one
+static float    g_fuelLapStartLevel = 0;
+static bool     g_fuelRefueled = false;
+static float    g_fuelPrevLevel = 0;
+static double   g_fuelPrevTime = -1;
+static int      g_fuelPrevSessionNum = -1;
+
+static void loadFuelStore()
+{
+    g_fuelStoreLoaded = true;
+    g_fuelStore.clear();
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CurDriverIncidentCount:", carIdx );
-            parseYamlInt( sessionYaml, path, &car.incidentCount );
+    std::string txt;
+    if( !g_fuelStoreEnabled || !loadFile( g_fuelStorePath, txt ) )
+        return;
 
-            sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarClassEstLapTime:", carIdx );
-            parseYamlFloat( sessionYaml, path, &car.carClassEstLapTime );
+    const char* p = txt.c_str();
+    while( *p )
+    {
+        FuelStoreEntry e;
+        if( sscanf( p, "%d %d %f %d", &e.carId, &e.trackId, &e.perLap, &e.laps ) == 4 && e.perLap > 0 )
+            g_fuelStore.push_back( e );
+
+        const char* eol = strchr( p, '\n' );
+        if( !eol )
+            break;
+        p = eol + 1;
+    }
+}
 
-            car.practicePosition = 0;
-            car.qualPosition = 0;
-            car.racePosition = 0;
-        }
+// Writes the fuel store on a thread of its own, so the tick that counts a lap never waits on the disk.
+// Only the newest version handed over gets written, older ones still waiting are superseded.
+class FuelStoreWriter
+{
+    public:
 
-        // Qualifying results info
-        for( int pos=0; pos<IR_MAX_CARS; ++pos )
-        {
-            sprintf( path, "QualifyResultsInfo:Results:Position:{%d}CarIdx:", pos );
-            int carIdx = -1;
-            if( parseYamlInt( sessionYaml, path, &carIdx ) ) {
-                ir_session.cars[carIdx].qualPosition = pos + 1;
+        FuelStoreWriter()
+            : m_thread( &FuelStoreWriter::run, this )
+        {}
 
-                sprintf( path, "QualifyResultsInfo:Results:Position:{%d}FastestTime:", pos );
-                parseYamlFloat( sessionYaml, path, &ir_session.cars[carIdx].qualTime );
+        // whatever was handed over last still gets written
+        ~FuelStoreWriter()
+        {
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_quit = true;
             }
+            m_cv.notify_one();
+            m_thread.join();
         }
 
-        // Session info (may override qual results from above, but that's ok since hopefully they're the same!)
-        for( int session=0; ; ++session )
+        // takes the contents of txt
+        void write( const std::string& path, std::string& txt )
         {
-            std::string sessionNameStr;
-            sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionName:", session );
-            if( !parseYamlStr( sessionYaml, path, sessionNameStr ) )
-                break;
-
-            std::string str;
-            sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionTime:", session );
-            parseYamlStr( sessionYaml, path, str );
-            ir_session.isUnlimitedTime = int( str=="unlimited" );
+            {
+                std::lock_guard<std::mutex> lock( m_mutex );
+                m_path = path;
+                m_txt.swap( txt );
+                m_pending = true;
+            }
+            m_cv.notify_one();
+        }
 
-            sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionLaps:", session );
-            parseYamlStr( sessionYaml, path, str );
-            ir_session.isUnlimitedLaps = int( str=="unlimited" );
+    private:
 
-            for( int pos=1; pos<IR_MAX_CARS+1; ++pos )
+        void run()
+        {
+            std::string path;
+            std::string txt;
+            while( true )
             {
-                int carIdx = -1;
-                sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}ResultsPositions:Position:{%d}CarIdx:", session, pos );
-                if( parseYamlInt( sessionYaml, path, &carIdx ) )
                 {
-                    if( sessionNameStr == "PRACTICE" )
-                        ir_session.cars[carIdx].practicePosition = pos;
-                    else if( sessionNameStr == "QUALIFY" )
-                        ir_session.cars[carIdx].qualPosition = pos;
-                    else if( sessionNameStr == "RACE" )
-                        ir_session.cars[carIdx].racePosition = pos;
+                    std::unique_lock<std::mutex> lock( m_mutex );
+                    m_cv.wait( lock, [this]{ return m_pending || m_quit; } );
+                    if( !m_pending )
+                        return;
+                    path = m_path;
+                    txt.swap( m_txt );
+                    m_pending = false;
                 }
+
+                if( !saveFile( path, txt ) )
+                    printf( "Could not save the fuel averages to %s.\n", path.c_str() );
             }
         }
 
-        // SoF
-        double sof = 0;
-        int cnt = 0;
-        for( int i=0; i<IR_MAX_CARS; ++i )
-        {
-            const Car& car = ir_session.cars[i];
+        std::mutex              m_mutex;
+        std::condition_variable m_cv;
+        bool                    m_quit = false;
+        bool                    m_pending = false;
+        std::string             m_path;
+        std::string             m_txt;
+        std::thread             m_thread;   // last, so it starts once the rest is set up
+};
 
-            if( car.isPaceCar || car.isSpectator || car.userName.empty() )
-                continue;
+static void saveFuelStore()
+{
+    if( !g_fuelStoreEnabled )
+        return;
 
-            sof += car.irating;
-            cnt++;
+    std::string txt;
+    for( const FuelStoreEntry& e : g_fuelStore )
+    {
+        char line[64];
+        sprintf( line, "%d %d %.4f %d\n", e.carId, e.trackId, e.perLap, e.laps );
+        txt += line;
+    }
+
+    static FuelStoreWriter writer;
+    writer.write( g_fuelStorePath, txt );
+}
+
+static FuelStoreEntry* findFuelStoreEntry( int carId, int trackId )
+{
+    if( !g_fuelStoreLoaded )
+        loadFuelStore();
+
+    for( FuelStoreEntry& e : g_fuelStore )
+        if( e.carId == carId && e.trackId == trackId )
+            return &e;
+    return nullptr;
+}
+
+static float median( float* v, int n )
+{
+    std::sort( v, v + n );
+    return n % 2 ? v[n/2] : 0.5f * (v[n/2-1] + v[n/2]);
+}
+
+static void putDownFuelLap( FuelLapType type, float used )
+{
+    FuelLaps& laps = ir_fuel.laps[(int)type];
+    if( laps.count == IR_MAX_FUEL_LAPS )
+    {
+        memmove( laps.used, laps.used + 1, (IR_MAX_FUEL_LAPS - 1) * sizeof(float) );
+        laps.count--;
+    }
+    laps.used[laps.count++] = used;
+
+    // Three green laps are enough to go by next time
+    const FuelLaps& green = ir_fuel.laps[(int)FuelLapType::GREEN];
+    if( type != FuelLapType::GREEN || green.count < 3 || !g_fuelStoreEnabled )
+        return;
+
+    FuelStoreEntry* e = findFuelStoreEntry( g_fuelCarId, g_fuelTrackId );
+    if( !e )
+    {
+        g_fuelStore.push_back( FuelStoreEntry() );
+        e = &g_fuelStore.back();
+        e->carId = g_fuelCarId;
+        e->trackId = g_fuelTrackId;
+    }
+    e->perLap = ir_getFuelPerLap( IR_MAX_FUEL_LAPS );
+    e->laps = green.count;
+    saveFuelStore();
+}
+
+static void updateFuel()
+{
+    const int carIdx = ir_session.driverCarIdx;
+    if( carIdx < 0 || carIdx >= IR_MAX_CARS )
+        return;
+
+    // What we learned doesn't apply to another car or track
+    const int carId = ir_session.cars[carIdx].carId;
+    if( carId != g_fuelCarId || ir_session.trackId != g_fuelTrackId )
+    {
+        g_fuelCarId = carId;
+        g_fuelTrackId = ir_session.trackId;
+        ir_fuel = FuelState();
+        g_fuelLap = -1;
+
+        const FuelStoreEntry* e = findFuelStoreEntry( g_fuelCarId, g_fuelTrackId );
+        ir_fuel.storedPerLap = e ? e->perLap : 0;
+    }
+
+    const double now = ir_SessionTime.getDouble();
+    const int    sessionNum = ir_SessionNum.getInt();
+    const float  level = ir_FuelLevel.getFloat();
+    const double dt = now - g_fuelPrevTime;
+
+    // Lost track of the lap if the telemetry skipped, or the session changed and with it the lap counter
+    const bool contiguous = g_fuelPrevTime >= 0 && dt >= 0 && dt <= 1.0 && sessionNum == g_fuelPrevSessionNum;
+    g_fuelPrevTime = now;
+    g_fuelPrevSessionNum = sessionNum;
+    if( !contiguous )
+        ir_fuel.lapCounts = false;
+
+    const int lap = ir_race.isPreStart ? 0 : std::max( 0, ir_carIdx.lap[carIdx] );
+    if( lap != g_fuelLap )
+    {
+        if( ir_fuel.lapCounts && lap == g_fuelLap + 1 )
+            putDownFuelLap( ir_fuel.lapType, g_fuelRefueled ? ir_fuel.lapUsed : std::max( 0.0f, g_fuelLapStartLevel - level ) );
+
+        ir_fuel.lapCounts = contiguous && g_fuelLap >= 0 && lap == g_fuelLap + 1;
+        ir_fuel.lapType = FuelLapType::GREEN;
+        ir_fuel.lapUsed = 0;
+        ir_fuel.lapProjected = 0;
+        g_fuelLap = lap;
+        g_fuelLapStartLevel = level;
+        g_fuelRefueled = false;
+    }
+    else if( contiguous )
+    {
+        // FuelUsePerHour is in kg/h
+        const float kgPerLtr = ir_session.fuelKgPerLtr > 0 ? ir_session.fuelKgPerLtr : 0.75f;
+        ir_fuel.lapUsed += ir_FuelUsePerHour.getFloat() / kgPerLtr * (float)(dt / 3600.0);
+        if( level > g_fuelPrevLevel + 0.05f )
+            g_fuelRefueled = true;
+    }
+    g_fuelPrevLevel = level;
+
+    if( ir_carIdx.onPitRoad[carIdx] )
+        ir_fuel.lapType = FuelLapType::PIT;
+    else if( ir_fuel.lapType == FuelLapType::GREEN && (ir_race.isPreStart ||
+             (ir_SessionFlags.getInt() & (irsdk_yellow|irsdk_yellowWaving|irsdk_red|irsdk_checkered|irsdk_crossed|irsdk_oneLapToGreen|irsdk_caution|irsdk_cautionWaving|irsdk_disqualify|irsdk_repair))) )
+        ir_fuel.lapType = FuelLapType::YELLOW;
+
+    const float pct = ir_carIdx.lapDistPct[carIdx];
+    ir_fuel.lapProjected = ir_fuel.lapCounts && pct >= 0.25f ? ir_fuel.lapUsed / pct : 0;
+}
+
+void ir_setFuelStore( const char* path )
+{
+    g_fuelStoreEnabled = path != nullptr;
+    g_fuelStorePath = path ? path : "";
+    g_fuelStoreLoaded = false;
+}
+
+//
+// Pit strategy
+//
+
+static bool             g_strategyEnabled = true;
+static StrategyInputs   g_strategyConfig;           // the settings from the config, the rest gets filled in per request
+static double           g_strategyPrevRequest = -1;
+static int              g_strategySessionNum = -1;
+static int              g_strategyCautions = 0;
+static bool             g_strategyPrevCaution = false;
+static int              g_strategyGreenLeaderLap = -1;
+static float            g_strategyTread = -1;       // when the tread was last seen to change, and on what lap
+static int              g_strategyTreadLap = 0;
+static float            g_strategyTreadPerLap = 0;
+
+// Tire wear is only reported in the pit stall, so the trend comes from one stop to the next
+static void updateTireTrend( int lap )
+{
+    const float tread = std::min( { ir_LFwearL.getFloat(), ir_LFwearM.getFloat(), ir_LFwearR.getFloat(),
+                                    ir_RFwearL.getFloat(), ir_RFwearM.getFloat(), ir_RFwearR.getFloat(),
+                                    ir_LRwearL.getFloat(), ir_LRwearM.getFloat(), ir_LRwearR.getFloat(),
+                                    ir_RRwearL.getFloat(), ir_RRwearM.getFloat(), ir_RRwearR.getFloat() } );
+    if( tread <= 0 )
+        return;
+
+    if( g_strategyTread < 0 || tread > g_strategyTread + 0.001f )
+    {
+        // first look at them, or new ones
+        g_strategyTread = tread;
+        g_strategyTreadLap = lap;
+    }
+    else if( tread < g_strategyTread - 0.001f && lap > g_strategyTreadLap )
+    {
+        g_strategyTreadPerLap = (g_strategyTread - tread) / (lap - g_strategyTreadLap);
+        g_strategyTread = tread;
+        g_strategyTreadLap = lap;
+    }
+}
+
+static float fuelSpread( float perLap )
+{
+    const FuelLaps& green = ir_fuel.laps[(int)FuelLapType::GREEN];
+    if( green.count < 3 )
+        return 0.02f * perLap;
+
+    float v[IR_MAX_FUEL_LAPS];
+    for( int i=0; i<green.count; ++i )
+        v[i] = fabsf( green.used[i] - perLap );
+    return std::max( 0.005f * perLap, 1.4826f * median( v, green.count ) );
+}
+
+static void updateStrategy()
+{
+    if( !g_strategyEnabled )
+        return;
+
+    static StrategyEngine engine;
+    engine.fetch( ir_strategy );
+
+    const int carIdx = ir_session.driverCarIdx;
+    const int state = ir_SessionState.getInt();
+    if( ir_session.sessionType != SessionType::RACE || carIdx < 0 || state > irsdk_StateRacing )
+    {
+        ir_strategy = StrategyResult();
+        return;
+    }
+
+    // How likely a caution is, from the ones in this race so far and a prior worth 20 laps
+    const int sessionNum = ir_SessionNum.getInt();
+    if( sessionNum != g_strategySessionNum )
+    {
+        g_strategySessionNum = sessionNum;
+        g_strategyCautions = 0;
+        g_strategyGreenLeaderLap = -1;
+        g_strategyPrevRequest = -1;
+    }
+    const bool caution = (ir_SessionFlags.getInt() & (irsdk_caution | irsdk_cautionWaving)) != 0;
+    const int  leaderLap = ir_race.leaderIdx >= 0 ? ir_carIdx.lap[ir_race.leaderIdx] : -1;
+    if( !ir_race.isPreStart && g_strategyGreenLeaderLap < 0 )
+        g_strategyGreenLeaderLap = leaderLap;
+    if( !ir_race.isPreStart && caution && !g_strategyPrevCaution )
+        g_strategyCautions++;
+    g_strategyPrevCaution = caution;
+
+    const int lap = std::max( 0, ir_carIdx.lap[carIdx] );
+    updateTireTrend( lap );
+
+    // A new round about once a second
+    const double now = ir_SessionTime.getDouble();
+    if( g_strategyPrevRequest >= 0 && now >= g_strategyPrevRequest && now < g_strategyPrevRequest + 1.0 )
+        return;
+    g_strategyPrevRequest = now;
+
+    StrategyInputs in = g_strategyConfig;
+    in.lapTime = ir_race.estimatedLaptime;
+    in.lapPct = std::max( 0.0f, ir_carIdx.lapDistPct[carIdx] );
+    in.fuelLevel = ir_FuelLevel.getFloat();
+    in.tankSize = ir_session.fuelMaxLtr;
+    in.fuelPerLap = ir_getFuelPerLap( IR_MAX_FUEL_LAPS );
+    in.fuelPerLapSpread = fuelSpread( in.fuelPerLap );
+
+    const FuelLaps& yellow = ir_fuel.laps[(int)FuelLapType::YELLOW];
+    if( yellow.count >= 2 && in.fuelPerLap > 0 )
+    {
+        float v[IR_MAX_FUEL_LAPS];
+        memcpy( v, yellow.used, yellow.count * sizeof(float) );
+        in.cautionFuelFactor = std::min( 1.0f, std::max( 0.2f, median( v, yellow.count ) / in.fuelPerLap ) );
+    }
+
+    const int leaderLaps = g_strategyGreenLeaderLap >= 0 ? std::max( 0, leaderLap - g_strategyGreenLeaderLap ) : 0;
+    in.cautionChance = (g_strategyCautions + 20 * g_strategyConfig.cautionChance) / (leaderLaps + 20);
+
+    in.tireTread = g_strategyTread > 0 ? g_strategyTread : 1;
+    in.treadPerLap = g_strategyTreadPerLap;
+
+    // Same as the DDU, time limited sessions are turned into laps
+    const bool timeLimited = ir_SessionLapsTotal.getInt() == 32767 && ir_SessionTimeRemain.getDouble() < 48.0*3600.0;
+    if( timeLimited )
+        in.lapsToGo = in.lapTime > 0 ? int( 0.5 + ir_SessionTimeRemain.getDouble() / in.lapTime ) : 0;
+    else
+        in.lapsToGo = ir_SessionLapsRemainEx.getInt() != 32767 ? ir_SessionLapsRemainEx.getInt() : 0;
+
+    engine.request( in );
+}
+
+void ir_setStrategySimulation( bool on )
+{
+    g_strategyEnabled = on;
+}
+
+ConnectionStatus ir_tick()
+{
+    irsdkClient& irsdk = irsdkClient::instance();
+
+    irsdk.waitForData(16);
+
+    // Reads zeros when not connected
+    updateCarIdxSnapshot();
+
+    if( !irsdk.isConnected() )
+    {
+        updateRaceState();
+        return ConnectionStatus::DISCONNECTED;
+    }
+
+    // Constructed after the irsdk client, so it's torn down before the shared memory goes away.
+    static SessionParser parser;
+
+    if( irsdk.wasSessionStrUpdated() )
+    {
+        if( g_synchronousSessionParsing )
+            parser.parseNow( irsdk.getSessionStr(), ir_SessionNum.getInt(), irsdk.getStatusID() );
+        else
+            parser.request( irsdk.getSessionStr(), ir_SessionNum.getInt(), irsdk.getStatusID() );
+    }
+
+    // Pick up the newest parsed session, if there is one. Pit tracking is done here on the
+    // main thread, so carry that over for cars that are still around.
+    if( SessionSnapshot* snapshot = parser.fetch() )
+    {
+        std::swap( ir_session, snapshot->session );
+        ir_sessionParseStats = snapshot->stats;
+
+        const Session& prev = snapshot->session;
+        for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+        {
+            // someone else's pit stops and times now
+            if( strcmp( ir_session.cars[carIdx].userName, prev.cars[carIdx].userName ) )
+                resetSectorCar( carIdx );
+            else if( ir_session.cars[carIdx].userName[0] )
+                ir_session.cars[carIdx].lastLapInPits = prev.cars[carIdx].lastLapInPits;
         }
-        ir_session.sof = int(sof / cnt);
 
         ir_handleConfigChange();
-
-    } // if session string updated
+    }
 
     // Track cars in pits. Reset every time we're in the 'warmup' phase (just before starting pace laps).
     const bool resetPitAge = ir_SessionState.getInt() == irsdk_StateWarmup;
@@ -552,10 +1279,16 @@ ConnectionStatus ir_tick()
         Car& car = ir_session.cars[carIdx];
         if( resetPitAge )
             car.lastLapInPits = 0;
-        if( ir_SessionState.getInt() >= 0 /* work around getting garbage sometimes (?) */ && ir_CarIdxOnPitRoad.getBool(carIdx) )
-            car.lastLapInPits = ir_CarIdxLap.getInt(carIdx);
+        if( ir_SessionState.getInt() >= 0 /* work around getting garbage sometimes (?) */ && ir_carIdx.onPitRoad[carIdx] )
+            car.lastLapInPits = ir_carIdx.lap[carIdx];
     }
 
+    updateRaceState();
+    updateSectorTimes();
+    updateTimeTables();
+    updateFuel();
+    updateStrategy();
+
     // Check for both ir_IsOnTrack and ir_IsOnTrackCar, because I've seen iRacing report true for ir_IsOnTrack 
     // (for just a short time) even when we're not in the car in a practice session. Checking both does seem
     // to address that.
@@ -566,6 +1299,24 @@ void ir_handleConfigChange()
 {
     std::vector<std::string> buddies = g_cfg.getStringVec( "General", "buddies", {} );
     std::vector<std::string> flagged = g_cfg.getStringVec( "General", "flagged", {} );
+    std::vector<std::string> sectors = g_cfg.getStringVec( "General", "sector_boundaries", {} );
+
+    // What the pit strategy can't find out from the telemetry
+    g_strategyConfig.pitLaneLoss = g_cfg.getFloat( "Strategy", "pit_lane_loss", 25 );
+    g_strategyConfig.fuelFillRate = g_cfg.getFloat( "Strategy", "fuel_fill_rate", 2.5f );
+    g_strategyConfig.tireChangeTime = g_cfg.getFloat( "Strategy", "tire_change_time", 20 );
+    g_strategyConfig.wornTireLoss = g_cfg.getFloat( "Strategy", "worn_tire_loss", 3 );
+    g_strategyConfig.cautionChance = g_cfg.getFloat( "Strategy", "caution_chance_per_lap", 0.02f );
+    g_strategyConfig.cautionLaps = g_cfg.getInt( "Strategy", "caution_laps", 3 );
+    g_strategyConfig.budgetMs = g_cfg.getInt( "Strategy", "time_budget_ms", 20 );
+
+    // Lap fractions where the sectors start, empty for the track's own
+    g_sectorConfigNum = 0;
+    for( const std::string& pct : sectors )
+    {
+        if( g_sectorConfigNum < IR_MAX_SECTORS )
+            g_sectorConfigStartPct[g_sectorConfigNum++] = (float)atof( pct.c_str() );
+    }
 
     for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
     {
@@ -587,56 +1338,35 @@ void ir_handleConfigChange()
 
 bool ir_isPreStart()
 {
-    // To find out whether we're pacing, it isn't enough to check ir_PaceMode, because
-    // iRacing doesn't set it to irsdk_PaceModeNotPacing as one would expect. So in addition we check
-    // the session state, since initial pacing apparently counts as "parade laps".
-    return (ir_PaceMode.getInt() == irsdk_PaceModeSingleFileStart || ir_PaceMode.getInt() == irsdk_PaceModeDoubleFileStart) &&
-           (ir_SessionState.getInt() == irsdk_StateParadeLaps || ir_SessionState.getInt() == irsdk_StateWarmup || ir_SessionState.getInt() == irsdk_StateGetInCar);
+    return ir_race.isPreStart;
 }
 
 float ir_estimateLaptime()
 {
-    float best = ir_LapBestLapTime.getFloat();
-    if( best > 0 )
-        return best;
-    return ir_session.cars[ir_session.driverCarIdx].carClassEstLapTime;
+    return ir_race.estimatedLaptime;
 }
 
 int ir_getPosition( int carIdx )
 {
-    // Try the different sources we have for position data, in descending order of importance
-    int pos = ir_CarIdxPosition.getInt(carIdx);
-    if( pos > 0 )
-        return pos;
-
-    pos = ir_session.cars[carIdx].racePosition;
-    if( pos > 0 )
-        return pos;
-
-    pos = ir_session.cars[carIdx].qualPosition;
-    if( pos > 0 )
-        return pos;
-
-    pos = ir_session.cars[carIdx].practicePosition;
-    if( pos > 0 )
-        return pos;
+    if( carIdx < 0 || carIdx >= IR_MAX_CARS )
+        return 0;
 
-    return 0;
+    return ir_race.position[carIdx];
 }
 
 int ir_getLapDeltaToLeader( int carIdx, int ldrIdx )
 {
-    if( ir_session.sessionType!=SessionType::RACE || ir_isPreStart() || carIdx < 0 || ldrIdx < 0 )
+    if( ir_session.sessionType!=SessionType::RACE || ir_race.isPreStart || carIdx < 0 || ldrIdx < 0 )
         return 0;
 
-    const int carLapCount = std::max( ir_CarIdxLap.getInt(carIdx), ir_CarIdxLapCompleted.getInt(carIdx) );
-    const int ldrLapCount = std::max( ir_CarIdxLap.getInt(ldrIdx), ir_CarIdxLapCompleted.getInt(ldrIdx) );
+    const int carLapCount = std::max( ir_carIdx.lap[carIdx], ir_carIdx.lapCompleted[carIdx] );
+    const int ldrLapCount = std::max( ir_carIdx.lap[ldrIdx], ir_carIdx.lapCompleted[ldrIdx] );
 
    // if( carLapCount < 0 )
-     //   return ir_CarIdxLapCompleted.getInt(carIdx) - ir_CarIdxLapCompleted.getInt(ldrIdx);
+     //   return ir_carIdx.lapCompleted[carIdx] - ir_carIdx.lapCompleted[ldrIdx];
 
-    const float carPctAroundLap = ir_CarIdxLapDistPct.getFloat( carIdx );
-    const float ldrPctAroundLap = ir_CarIdxLapDistPct.getFloat( ldrIdx );
+    const float carPctAroundLap = ir_carIdx.lapDistPct[carIdx];
+    const float ldrPctAroundLap = ir_carIdx.lapDistPct[ldrIdx];
 
     if( carPctAroundLap < 0 || ldrPctAroundLap < 0 )
         return 0;
@@ -649,28 +1379,140 @@ int ir_getLapDeltaToLeader( int carIdx, int ldrIdx )
     return lapDelta;
 }
 
+float ir_getTimeBehind( int carIdx, int aheadIdx )
+{
+    if( carIdx < 0 || carIdx >= IR_MAX_CARS || aheadIdx < 0 || aheadIdx >= IR_MAX_CARS )
+        return -1;
+
+    const TimeTable* tt = readyTimeTable( carIdx );
+    const float from = ir_carIdx.lapDistPct[carIdx];
+    const float to = ir_carIdx.lapDistPct[aheadIdx];
+    if( !tt || from < 0 || to < 0 )
+        return -1;
+
+    return timeTableForward( *tt, from, to );
+}
+
+float ir_getGap( int carIdx, int refIdx )
+{
+    if( carIdx < 0 || carIdx >= IR_MAX_CARS || refIdx < 0 || refIdx >= IR_MAX_CARS )
+        return 0;
+
+    const CarIdxSnapshot& cs = ir_carIdx;
+    const float C = cs.lapDistPct[carIdx];
+    const float S = cs.lapDistPct[refIdx];
+
+    // The gap is how long the one behind takes to get to where the other one is
+    float ahead = C - S;
+    if( ahead < 0 )
+        ahead += 1.0f;
+    if( C >= 0 && S >= 0 )
+    {
+        const float t = ahead <= 0.5f ? ir_getTimeBehind( refIdx, carIdx ) : ir_getTimeBehind( carIdx, refIdx );
+        if( t >= 0 )
+            return ahead <= 0.5f ? t : -t;
+    }
+
+    // Does the delta between the cars span across the start/finish line?
+    const float L = ir_race.estimatedLaptime;
+    const float estC = cs.estTime[carIdx];
+    const float estS = cs.estTime[refIdx];
+    if( fabsf( C - S ) > 0.5f )
+        return estS > estC ? (estC - estS) + L : (estC - estS) - L;
+    return estC - estS;
+}
+
+float ir_getFuelPerLap( int numLaps )
+{
+    const FuelLaps& green = ir_fuel.laps[(int)FuelLapType::GREEN];
+    const int n = green.count;
+    if( n && numLaps > 0 )
+    {
+        // Median and median absolute deviation of all the green laps, scaled to match a standard deviation.
+        // With fewer than three laps there's nothing to tell an outlier by.
+        float limit = FLT_MAX;
+        float med = 0;
+        if( n >= 3 )
+        {
+            float v[IR_MAX_FUEL_LAPS];
+            memcpy( v, green.used, n * sizeof(float) );
+            med = median( v, n );
+            for( int i=0; i<n; ++i )
+                v[i] = fabsf( green.used[i] - med );
+            limit = std::max( 3 * 1.4826f * median( v, n ), 0.02f * med );
+        }
+
+        float sum = 0;
+        int cnt = 0;
+        for( int i=n-1; i>=0 && cnt<numLaps; --i )
+        {
+            if( fabsf( green.used[i] - med ) > limit )
+                continue;
+            sum += green.used[i];
+            cnt++;
+        }
+        if( cnt )
+            return sum / cnt;
+    }
+
+    return ir_fuel.storedPerLap > 0 ? ir_fuel.storedPerLap : ir_fuel.lapProjected;
+}
+
 void ir_printVariables()
 {
-    if( !irsdk_isConnected() )
+    irsdkClient& irsdk = irsdkClient::instance();
+    const irsdk_header* header = irsdk.getHeader();
+    if( !irsdk.isConnected() || !header )
         return;
 
-    const irsdk_header* header = irsdk_getHeader();
-
     printf("IRSDK Variables:\n");
     for( int i=0; i<header->numVars; ++i )
     {
-        const irsdk_varHeader* var = irsdk_getVarHeaderEntry(i);
+        const irsdk_varHeader* var = irsdk.getVarHeader(i);
         std::string type;
+        std::string cppType;
         switch( var->type )
         {
         case irsdk_char: type="char"; break;
         case irsdk_bool: type="bool"; break;
         case irsdk_int: type="int"; break;
-        case irsdk_bitField: type="bitfield"; break;
+        case irsdk_bitField: type="bitfield"; cppType="int"; break;
         case irsdk_float: type="float"; break;
         case irsdk_double: type="double"; break;
         }
-        printf( "irsdkCVar ir_%s(\"%s\");    // %s[%d] %s (%s)\n",
-            var->name, var->name, type.c_str(), var->count, var->desc, var->unit );
+        if( cppType.empty() )
+            cppType = type;
+
+        char decl[64];
+        if( var->count == 1 )
+            sprintf( decl, "irsdkVar<%s>", cppType.c_str() );
+        else
+            sprintf( decl, "irsdkVar<%s,%d>", cppType.c_str(), var->count );
+
+        printf( "%s ir_%s(\"%s\");    // %s[%d] %s (%s)\n",
+            decl, var->name, var->name, type.c_str(), var->count, var->desc, var->unit );
+    }
+}
+
+void ir_printMissingVariables()
+{
+    const irsdkVarResolveStats& stats = irsdkVarBase::getResolveStats();
+    if( !stats.numMissing )
+        return;
+
+    static const char* const typeNames[] = { "char", "bool", "int", "bitfield", "float", "double" };
+
+    printf( "%d of %d telemetry variables not available:\n", stats.numMissing, stats.numRegistered );
+    for( irsdkVarBase* var=irsdkVarBase::getFirst(); var; var=var->getNext() )
+    {
+        if( var->isValid() )
+            continue;
+
+        // a count means the sim has it, just not with the type and count it was declared with
+        const int type = var->getType();
+        if( var->getCount() > 0 && type >= 0 && type < irsdk_ETCount )
+            printf( "    %s (declared differently, the sim has %s[%d])\n", var->getName(), typeNames[type], var->getCount() );
+        else
+            printf( "    %s\n", var->getName() );
     }
 }
@@ -0,0 +1,838 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <limits.h>
+#include <algorithm>
+#include "irsdk_archive.h"
+
+// Large file offsets
+
+static bool seekTo(FILE *file, long long offset)
+{
+#ifdef _MSC_VER
+	return _fseeki64(file, offset, SEEK_SET) == 0;
+#else
+	return fseeko(file, (off_t)offset, SEEK_SET) == 0;
+#endif
+}
+
+static long long fileSize(FILE *file)
+{
+#ifdef _MSC_VER
+	if(_fseeki64(file, 0, SEEK_END))
+		return -1;
+	return _ftelli64(file);
+#else
+	if(fseeko(file, 0, SEEK_END))
+		return -1;
+	return (long long)ftello(file);
+#endif
+}
+
+static bool readAt(FILE *file, long long offset, void *data, size_t len)
+{
+	return seekTo(file, offset) && fread(data, 1, len, file) == len;
+}
+
+// Bit and byte packing
+
+typedef std::vector<unsigned char> Bytes;
+
+static void putVarint(Bytes &out, unsigned long long v)
+{
+	while(v >= 0x80)
+	{
+		out.push_back((unsigned char)(v | 0x80));
+		v >>= 7;
+	}
+	out.push_back((unsigned char)v);
+}
+
+static bool getVarint(const unsigned char *&p, const unsigned char *end, unsigned long long &v)
+{
+	v = 0;
+	for(int shift = 0; shift < 64 && p < end; shift += 7)
+	{
+		const unsigned char b = *p++;
+		v |= (unsigned long long)(b & 0x7f) << shift;
+		if(!(b & 0x80))
+			return true;
+	}
+	return false;
+}
+
+struct BitWriter
+{
+	Bytes &out;
+	unsigned long long acc;
+	int numBits;
+
+	BitWriter(Bytes &out) : out(out), acc(0), numBits(0) {}
+
+	void put(unsigned long long v, int bits)
+	{
+		if(bits > 32)
+		{
+			put(v >> 32, bits - 32);
+			bits = 32;
+		}
+		acc = (acc << bits) | (v & ((1ULL << bits) - 1));
+		numBits += bits;
+		while(numBits >= 8)
+		{
+			numBits -= 8;
+			out.push_back((unsigned char)(acc >> numBits));
+		}
+	}
+
+	void flush()
+	{
+		if(numBits)
+			out.push_back((unsigned char)(acc << (8 - numBits)));
+		numBits = 0;
+	}
+};
+
+struct BitReader
+{
+	const unsigned char *p;
+	const unsigned char *end;
+	unsigned long long acc;
+	int numBits;
+
+	BitReader(const unsigned char *p, const unsigned char *end) : p(p), end(end), acc(0), numBits(0) {}
+
+	bool get(int bits, unsigned long long &v)
+	{
+		if(bits > 32)
+		{
+			unsigned long long hi, lo;
+			if(!get(bits - 32, hi) || !get(32, lo))
+				return false;
+			v = (hi << 32) | lo;
+			return true;
+		}
+		while(numBits < bits)
+		{
+			if(p >= end)
+				return false;
+			acc = (acc << 8) | *p++;
+			numBits += 8;
+		}
+		numBits -= bits;
+		v = (acc >> numBits) & ((1ULL << bits) - 1);
+		return true;
+	}
+};
+
+// of a value that isn't 0
+static int leadingZeros(unsigned long long x, int width)
+{
+	int n = 0;
+	for(int shift = 32; shift; shift /= 2)
+	{
+		if(!(x >> (64 - shift)))
+		{
+			n += shift;
+			x <<= shift;
+		}
+	}
+	return n - (64 - width);
+}
+
+static int trailingZeros(unsigned long long x)
+{
+	int n = 0;
+	for(int shift = 32; shift; shift /= 2)
+	{
+		if(!(x & ((1ULL << shift) - 1)))
+		{
+			n += shift;
+			x >>= shift;
+		}
+	}
+	return n;
+}
+
+// Column codecs, over the raw bits of one entry of a variable for every record in a chunk
+
+enum Codec { CodecRuns, CodecDelta, CodecXor32, CodecXor64 };
+
+static Codec codecFor(int type)
+{
+	switch(type)
+	{
+	case irsdk_int:		return CodecDelta;
+	case irsdk_float:	return CodecXor32;
+	case irsdk_double:	return CodecXor64;
+	default:			return CodecRuns;	// bool, char, bitField
+	}
+}
+
+static void encodeRuns(const unsigned long long *vals, int n, Bytes &out)
+{
+	for(int i = 0; i < n; )
+	{
+		int run = 1;
+		while(i + run < n && vals[i + run] == vals[i])
+			run++;
+		putVarint(out, vals[i]);
+		putVarint(out, run);
+		i += run;
+	}
+}
+
+static bool decodeRuns(const unsigned char *p, const unsigned char *end, unsigned long long *vals, int n)
+{
+	for(int i = 0; i < n; )
+	{
+		unsigned long long v, run;
+		if(!getVarint(p, end, v) || !getVarint(p, end, run) || !run || run > (unsigned long long)(n - i))
+			return false;
+		for(int k = 0; k < (int)run; k++)
+			vals[i++] = v;
+	}
+	return true;
+}
+
+static void encodeDelta(const unsigned long long *vals, int n, Bytes &out)
+{
+	long long prev = 0;
+	for(int i = 0; i < n; i++)
+	{
+		const long long v = (int)(unsigned int)vals[i];
+		const long long d = v - prev;
+		putVarint(out, ((unsigned long long)d << 1) ^ (unsigned long long)(d >> 63));
+		prev = v;
+	}
+}
+
+static bool decodeDelta(const unsigned char *p, const unsigned char *end, unsigned long long *vals, int n)
+{
+	long long prev = 0;
+	for(int i = 0; i < n; i++)
+	{
+		unsigned long long zz;
+		if(!getVarint(p, end, zz))
+			return false;
+		prev += (long long)(zz >> 1) ^ -(long long)(zz & 1);
+		vals[i] = (unsigned int)prev;
+	}
+	return true;
+}
+
+// Each value goes as its XOR with the one before: a 0 bit if they're the same, otherwise the bits between
+// the first and last one that changed, in the window the last value used if they fit or a new one
+static void encodeXor(const unsigned long long *vals, int n, int width, Bytes &out)
+{
+	const int fieldBits = width == 32 ? 5 : 6;
+	BitWriter bw(out);
+
+	unsigned long long prev = 0;
+	int lead = -1, trail = 0;
+	for(int i = 0; i < n; i++)
+	{
+		const unsigned long long x = vals[i] ^ prev;
+		prev = vals[i];
+
+		if(!x)
+		{
+			bw.put(0, 1);
+			continue;
+		}
+
+		const int lz = leadingZeros(x, width);
+		const int tz = trailingZeros(x);
+		if(lead >= 0 && lz >= lead && tz >= trail)
+		{
+			bw.put(2, 2);
+			bw.put(x >> trail, width - lead - trail);
+		}
+		else
+		{
+			lead = lz;
+			trail = tz;
+			bw.put(3, 2);
+			bw.put(lead, fieldBits);
+			bw.put(width - lead - trail - 1, fieldBits);
+			bw.put(x >> trail, width - lead - trail);
+		}
+	}
+	bw.flush();
+}
+
+static bool decodeXor(const unsigned char *p, const unsigned char *end, unsigned long long *vals, int n, int width)
+{
+	const int fieldBits = width == 32 ? 5 : 6;
+	BitReader br(p, end);
+
+	unsigned long long prev = 0;
+	int lead = 0, len = 0;
+	for(int i = 0; i < n; i++)
+	{
+		unsigned long long bit, x;
+		if(!br.get(1, bit))
+			return false;
+		if(bit)
+		{
+			if(!br.get(1, bit))
+				return false;
+			if(bit)
+			{
+				unsigned long long l, m;
+				if(!br.get(fieldBits, l) || !br.get(fieldBits, m) || (int)(l + m) >= width)
+					return false;
+				lead = (int)l;
+				len = (int)m + 1;
+			}
+			else if(!len)
+				return false;
+
+			if(!br.get(len, x))
+				return false;
+			prev ^= x << (width - lead - len);
+		}
+		vals[i] = prev;
+	}
+	return true;
+}
+
+static void encodeColumn(Codec codec, const unsigned long long *vals, int n, Bytes &out)
+{
+	switch(codec)
+	{
+	case CodecRuns:		encodeRuns(vals, n, out); break;
+	case CodecDelta:	encodeDelta(vals, n, out); break;
+	case CodecXor32:	encodeXor(vals, n, 32, out); break;
+	case CodecXor64:	encodeXor(vals, n, 64, out); break;
+	}
+}
+
+static bool decodeColumnBits(Codec codec, const unsigned char *p, const unsigned char *end, unsigned long long *vals, int n)
+{
+	switch(codec)
+	{
+	case CodecRuns:		return decodeRuns(p, end, vals, n);
+	case CodecDelta:	return decodeDelta(p, end, vals, n);
+	case CodecXor32:	return decodeXor(p, end, vals, n, 32);
+	case CodecXor64:	return decodeXor(p, end, vals, n, 64);
+	}
+	return false;
+}
+
+static double bitsToDouble(int type, unsigned long long v)
+{
+	switch(type)
+	{
+	case irsdk_int:
+		return (int)(unsigned int)v;
+	case irsdk_float:
+	{
+		const unsigned int u = (unsigned int)v;
+		float f;
+		memcpy(&f, &u, sizeof(f));
+		return f;
+	}
+	case irsdk_double:
+	{
+		double d;
+		memcpy(&d, &v, sizeof(d));
+		return d;
+	}
+	default:
+		return (double)v;
+	}
+}
+
+// Reader
+
+irsdkArchive::irsdkArchive()
+	: m_file(NULL)
+	, m_fileSize(0)
+	, m_sessionTimeVar(-1)
+	, m_sessionVersion(-1)
+{
+	memset(&m_header, 0, sizeof(m_header));
+}
+
+irsdkArchive::~irsdkArchive()
+{
+	close();
+}
+
+bool irsdkArchive::open(const char *path)
+{
+	close();
+
+	m_file = fopen(path, "rb");
+	if(!m_file)
+		return false;
+
+	const long long size = fileSize(m_file);
+	m_fileSize = size;
+	irsdk_archiveHeader &h = m_header;
+	if(!readAt(m_file, 0, &h, sizeof(h)) || memcmp(h.magic, IRSDK_ARCHIVE_MAGIC, sizeof(h.magic)) || h.ver != IRSDK_ARCHIVE_VER ||
+	   h.numVars <= 0 || h.numColumns < h.numVars || h.recordCount < 0 || h.chunkRecords <= 0 || h.numChunks < 0 || h.numSessionVersions < 0 ||
+	   h.varHeaderOffset < 0 || h.chunkIndexOffset < 0 || h.sessionVersionOffset < 0 ||
+	   h.varHeaderOffset + h.numVars * (long long)sizeof(irsdk_varHeader) > size ||
+	   h.chunkIndexOffset + h.numChunks * (long long)sizeof(irsdk_archiveChunk) > size ||
+	   h.sessionVersionOffset + h.numSessionVersions * (long long)sizeof(irsdk_diskSessionVersion) > size)
+	{
+		close();
+		return false;
+	}
+
+	m_vars.resize(h.numVars);
+	m_chunks.resize(h.numChunks);
+	m_sessionVersions.resize(h.numSessionVersions);
+	if(!readAt(m_file, h.varHeaderOffset, &m_vars[0], m_vars.size() * sizeof(irsdk_varHeader)) ||
+	   (h.numChunks && !readAt(m_file, h.chunkIndexOffset, &m_chunks[0], m_chunks.size() * sizeof(irsdk_archiveChunk))) ||
+	   (h.numSessionVersions && !readAt(m_file, h.sessionVersionOffset, &m_sessionVersions[0], m_sessionVersions.size() * sizeof(irsdk_diskSessionVersion))))
+	{
+		close();
+		return false;
+	}
+
+	m_firstColumn.resize(h.numVars);
+	int column = 0;
+	for(int i=0; i<h.numVars; i++)
+	{
+		m_firstColumn[i] = column;
+		column += m_vars[i].count;
+		if(m_vars[i].count <= 0 || column > h.numColumns)
+		{
+			close();
+			return false;
+		}
+
+		if(m_vars[i].type == irsdk_double && 0 == strncmp(m_vars[i].name, "SessionTime", IRSDK_MAX_STRING))
+			m_sessionTimeVar = i;
+	}
+
+	return true;
+}
+
+void irsdkArchive::close()
+{
+	if(m_file)
+		fclose(m_file);
+	m_file = NULL;
+	m_fileSize = 0;
+
+	memset(&m_header, 0, sizeof(m_header));
+	m_vars.clear();
+	m_firstColumn.clear();
+	m_chunks.clear();
+	m_sessionVersions.clear();
+	m_sessionTimeVar = -1;
+	m_sessionInfo.clear();
+	m_sessionVersion = -1;
+}
+
+const irsdk_archiveHeader *irsdkArchive::getHeader() const
+{
+	return m_file ? &m_header : NULL;
+}
+
+const irsdk_varHeader *irsdkArchive::getVarHeaderEntry(int index) const
+{
+	if(index >= 0 && index < (int)m_vars.size())
+		return &m_vars[index];
+	return NULL;
+}
+
+int irsdkArchive::varNameToIndex(const char *name) const
+{
+	if(name)
+	{
+		for(int i=0; i<(int)m_vars.size(); i++)
+			if(0 == strncmp(name, m_vars[i].name, IRSDK_MAX_STRING))
+				return i;
+	}
+	return -1;
+}
+
+const irsdk_archiveChunk *irsdkArchive::getChunk(int index) const
+{
+	if(index >= 0 && index < (int)m_chunks.size())
+		return &m_chunks[index];
+	return NULL;
+}
+
+int irsdkArchive::findChunk(double sessionTime) const
+{
+	// session time only goes up within a session
+	int lo = 0, hi = (int)m_chunks.size();
+	while(lo < hi)
+	{
+		const int mid = (lo + hi) / 2;
+		if(m_chunks[mid].endTime < sessionTime)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < (int)m_chunks.size() ? lo : -1;
+}
+
+bool irsdkArchive::decodeColumn(int chunk, int column, std::vector<double> &values)
+{
+	const irsdk_archiveChunk &c = m_chunks[chunk];
+	const long long dataOffset = c.offset + (long long)m_header.numColumns * sizeof(unsigned int);
+
+	// where the column starts and ends
+	unsigned int ends[2] = {0, 0};
+	if(column == 0)
+	{
+		if(!readAt(m_file, c.offset, &ends[1], sizeof(ends[1])))
+			return false;
+	}
+	else if(!readAt(m_file, c.offset + (column - 1) * (long long)sizeof(unsigned int), ends, sizeof(ends)))
+		return false;
+
+	if(ends[1] < ends[0] || dataOffset + ends[1] > m_fileSize || c.numRecords <= 0)
+		return false;
+
+	m_buf.resize(ends[1] - ends[0] + 1);
+	if(!readAt(m_file, dataOffset + ends[0], &m_buf[0], ends[1] - ends[0]))
+		return false;
+
+	int var = (int)(std::upper_bound(m_firstColumn.begin(), m_firstColumn.end(), column) - m_firstColumn.begin()) - 1;
+	const int type = m_vars[var].type;
+
+	std::vector<unsigned long long> bits(c.numRecords);
+	if(!decodeColumnBits(codecFor(type), &m_buf[0], &m_buf[0] + (ends[1] - ends[0]), &bits[0], c.numRecords))
+		return false;
+
+	values.resize(c.numRecords);
+	for(int i=0; i<c.numRecords; i++)
+		values[i] = bitsToDouble(type, bits[i]);
+	return true;
+}
+
+bool irsdkArchive::decodeTimes(int chunk, std::vector<double> &times)
+{
+	if(m_sessionTimeVar >= 0)
+		return decodeColumn(chunk, m_firstColumn[m_sessionTimeVar], times);
+
+	// no session time, go by the tick rate
+	const irsdk_archiveChunk &c = m_chunks[chunk];
+	const double tickRate = m_header.tickRate > 0 ? m_header.tickRate : 60;
+	times.resize(c.numRecords);
+	for(int i=0; i<c.numRecords; i++)
+		times[i] = (c.firstRecord + i) / tickRate;
+	return true;
+}
+
+int irsdkArchive::read(int var, int entry, double startTime, double endTime, std::vector<double> *times, std::vector<double> *values)
+{
+	const irsdk_varHeader *vh = getVarHeaderEntry(var);
+	if(!m_file || !vh || entry < 0 || entry >= vh->count)
+		return -1;
+
+	std::vector<double> chunkValues;
+	int count = 0;
+	for(int i=0; i<(int)m_chunks.size(); i++)
+	{
+		// every chunk in the range, sessions each start their time over
+		const irsdk_archiveChunk &c = m_chunks[i];
+		if(c.endTime < startTime || c.startTime > endTime)
+			continue;
+
+		if(!decodeTimes(i, m_times) || (values && !decodeColumn(i, m_firstColumn[var] + entry, chunkValues)))
+			return -1;
+
+		for(int r=0; r<c.numRecords; r++)
+		{
+			if(m_times[r] < startTime || m_times[r] > endTime)
+				continue;
+			if(times)
+				times->push_back(m_times[r]);
+			if(values)
+				values->push_back(chunkValues[r]);
+			count++;
+		}
+	}
+	return count;
+}
+
+int irsdkArchive::read(const char *name, int entry, double startTime, double endTime, std::vector<double> *times, std::vector<double> *values)
+{
+	return read(varNameToIndex(name), entry, startTime, endTime, times, values);
+}
+
+int irsdkArchive::readRecords(int var, int entry, int firstRecord, int numRecords, std::vector<double> *values)
+{
+	const irsdk_varHeader *vh = getVarHeaderEntry(var);
+	if(!m_file || !vh || entry < 0 || entry >= vh->count || firstRecord < 0 || numRecords < 0 || !values)
+		return -1;
+
+	const int lastRecord = std::min(firstRecord + numRecords, m_header.recordCount);
+	std::vector<double> chunkValues;
+	int count = 0;
+	for(int i = firstRecord / m_header.chunkRecords; i<(int)m_chunks.size() && m_chunks[i].firstRecord < lastRecord; i++)
+	{
+		const irsdk_archiveChunk &c = m_chunks[i];
+		if(!decodeColumn(i, m_firstColumn[var] + entry, chunkValues))
+			return -1;
+
+		const int from = std::max(firstRecord, c.firstRecord);
+		const int to = std::min(lastRecord, c.firstRecord + c.numRecords);
+		values->insert(values->end(), chunkValues.begin() + (from - c.firstRecord), chunkValues.begin() + (to - c.firstRecord));
+		count += to - from;
+	}
+	return count;
+}
+
+const char *irsdkArchive::getSessionInfoStr(int record)
+{
+	if(!m_file || m_sessionVersions.empty())
+		return NULL;
+
+	int v = 0;
+	while(v + 1 < (int)m_sessionVersions.size() && m_sessionVersions[v + 1].record <= record)
+		v++;
+
+	if(v != m_sessionVersion)
+	{
+		const irsdk_diskSessionVersion &sv = m_sessionVersions[v];
+		m_sessionInfo.assign(sv.len > 0 ? sv.len : 0, '\0');
+		if(sv.len > 0 && !readAt(m_file, sv.offset, &m_sessionInfo[0], sv.len))
+			return NULL;
+		m_sessionVersion = v;
+	}
+	return m_sessionInfo.c_str();
+}
+
+// Converter
+
+// every version of the session string in the .ibt, one if irsdkRecorder didn't write it
+static bool readSessionVersions(FILE *file, long long size, const irsdk_header &h, std::vector<irsdk_diskSessionVersion> &table, std::vector<std::string> &strings)
+{
+	irsdk_diskSessionVersions footer;
+	if(size >= (long long)sizeof(footer) && readAt(file, size - sizeof(footer), &footer, sizeof(footer)) &&
+	   0 == memcmp(footer.magic, IRSDK_SESSIONVERSIONS_MAGIC, sizeof(footer.magic)) && footer.count > 0 &&
+	   footer.tableOffset >= 0 && footer.tableOffset + footer.count * (long long)sizeof(irsdk_diskSessionVersion) <= size)
+	{
+		table.resize(footer.count);
+		strings.resize(footer.count);
+		if(!readAt(file, footer.tableOffset, &table[0], table.size() * sizeof(irsdk_diskSessionVersion)))
+			return false;
+		for(int i=0; i<footer.count; i++)
+		{
+			if(table[i].len < 0 || table[i].offset < 0 || table[i].offset + table[i].len > size)
+				return false;
+			strings[i].assign(table[i].len, '\0');
+			if(table[i].len && !readAt(file, table[i].offset, &strings[i][0], table[i].len))
+				return false;
+		}
+		return true;
+	}
+
+	// just the one in the header
+	if(h.sessionInfoLen < 0 || h.sessionInfoOffset < 0 || (long long)h.sessionInfoOffset + h.sessionInfoLen > size)
+		return false;
+	std::string str(h.sessionInfoLen, '\0');
+	if(h.sessionInfoLen && !readAt(file, h.sessionInfoOffset, &str[0], h.sessionInfoLen))
+		return false;
+	str.resize(strlen(str.c_str()));
+
+	irsdk_diskSessionVersion v;
+	v.record = 0;
+	v.len = (int)str.size();
+	v.offset = 0;
+	table.assign(1, v);
+	strings.assign(1, str);
+	return true;
+}
+
+static bool convert(FILE *in, FILE *out, int chunkRecords)
+{
+	const long long size = fileSize(in);
+
+	irsdk_header h;
+	irsdk_diskSubHeader sub;
+	if(!readAt(in, 0, &h, sizeof(h)) || !readAt(in, sizeof(h), &sub, sizeof(sub)) ||
+	   h.numVars <= 0 || h.bufLen <= 0 || h.varHeaderOffset < 0 || h.varBuf[0].bufOffset < 0 ||
+	   (long long)h.varHeaderOffset + h.numVars * (long long)sizeof(irsdk_varHeader) > size)
+		return false;
+
+	std::vector<irsdk_varHeader> vars(h.numVars);
+	if(!readAt(in, h.varHeaderOffset, &vars[0], vars.size() * sizeof(irsdk_varHeader)))
+		return false;
+
+	int numColumns = 0;
+	int sessionTimeOffset = -1;
+	for(const irsdk_varHeader &vh : vars)
+	{
+		if(vh.type < 0 || vh.type >= irsdk_ETCount || vh.count <= 0 || vh.offset < 0 ||
+		   vh.offset + vh.count * irsdk_VarTypeBytes[vh.type] > h.bufLen)
+			return false;
+		numColumns += vh.count;
+		if(vh.type == irsdk_double && 0 == strncmp(vh.name, "SessionTime", IRSDK_MAX_STRING))
+			sessionTimeOffset = vh.offset;
+	}
+
+	// the sub header has the count, but files that didn't get closed properly only have the rows
+	const long long rowsInFile = (size - h.varBuf[0].bufOffset) / h.bufLen;
+	int recordCount = (int)std::min(rowsInFile, (long long)INT_MAX);
+	if(sub.sessionRecordCount > 0 && sub.sessionRecordCount < recordCount)
+		recordCount = sub.sessionRecordCount;
+
+	std::vector<irsdk_diskSessionVersion> sessionTable;
+	std::vector<std::string> sessionStrings;
+	if(!readSessionVersions(in, size, h, sessionTable, sessionStrings))
+		return false;
+
+	irsdk_archiveHeader ah;
+	memset(&ah, 0, sizeof(ah));
+	memcpy(ah.magic, IRSDK_ARCHIVE_MAGIC, sizeof(ah.magic));
+	ah.ver = IRSDK_ARCHIVE_VER;
+	ah.tickRate = h.tickRate;
+	ah.numVars = h.numVars;
+	ah.numColumns = numColumns;
+	ah.recordCount = recordCount;
+	ah.chunkRecords = chunkRecords;
+	ah.numSessionVersions = (int)sessionTable.size();
+	ah.varHeaderOffset = sizeof(ah);
+	ah.sub = sub;
+	ah.sub.sessionRecordCount = recordCount;
+
+	long long pos = 0;
+	auto write = [&](const void *data, size_t len) -> bool
+	{
+		if(len && fwrite(data, 1, len, out) != len)
+			return false;
+		pos += len;
+		return true;
+	};
+
+	if(!write(&ah, sizeof(ah)) || !write(&vars[0], vars.size() * sizeof(irsdk_varHeader)))
+		return false;
+
+	// a chunk of rows at a time, turned into columns
+	std::vector<char> rows((size_t)chunkRecords * h.bufLen);
+	std::vector<unsigned long long> vals(chunkRecords);
+	std::vector<unsigned int> columnEnds(numColumns);
+	std::vector<irsdk_archiveChunk> chunks;
+	Bytes data;
+
+	if(!seekTo(in, h.varBuf[0].bufOffset))
+		return false;
+
+	for(int first = 0; first < recordCount; first += chunkRecords)
+	{
+		const int n = std::min(chunkRecords, recordCount - first);
+		if(fread(&rows[0], h.bufLen, n, in) != (size_t)n)
+			return false;
+
+		irsdk_archiveChunk c;
+		c.firstRecord = first;
+		c.numRecords = n;
+		c.offset = pos;
+		if(sessionTimeOffset >= 0)
+		{
+			memcpy(&c.startTime, &rows[sessionTimeOffset], sizeof(double));
+			memcpy(&c.endTime, &rows[(size_t)(n - 1) * h.bufLen + sessionTimeOffset], sizeof(double));
+		}
+		else
+		{
+			const double tickRate = h.tickRate > 0 ? h.tickRate : 60;
+			c.startTime = first / tickRate;
+			c.endTime = (first + n - 1) / tickRate;
+		}
+
+		data.clear();
+		int column = 0;
+		for(const irsdk_varHeader &vh : vars)
+		{
+			const int bytes = irsdk_VarTypeBytes[vh.type];
+			const Codec codec = codecFor(vh.type);
+			for(int e = 0; e < vh.count; e++)
+			{
+				const char *src = &rows[vh.offset + e * bytes];
+				for(int r = 0; r < n; r++, src += h.bufLen)
+				{
+					vals[r] = 0;
+					memcpy(&vals[r], src, bytes);	// little endian, like the sim
+				}
+				encodeColumn(codec, &vals[0], n, data);
+				if(data.size() > UINT_MAX)
+					return false;
+				columnEnds[column++] = (unsigned int)data.size();
+			}
+		}
+
+		if(!write(&columnEnds[0], columnEnds.size() * sizeof(unsigned int)) || !write(&data[0], data.size()))
+			return false;
+		chunks.push_back(c);
+	}
+
+	// session strings, their table and the chunk index
+	for(size_t i=0; i<sessionTable.size(); i++)
+	{
+		sessionTable[i].offset = pos;
+		sessionTable[i].len = (int)sessionStrings[i].size();
+		if(!write(sessionStrings[i].data(), sessionStrings[i].size()))
+			return false;
+	}
+
+	ah.sessionVersionOffset = pos;
+	if(!write(&sessionTable[0], sessionTable.size() * sizeof(irsdk_diskSessionVersion)))
+		return false;
+
+	ah.numChunks = (int)chunks.size();
+	ah.chunkIndexOffset = pos;
+	if(!chunks.empty() && !write(&chunks[0], chunks.size() * sizeof(irsdk_archiveChunk)))
+		return false;
+
+	// and now the header knows where everything is
+	return seekTo(out, 0) && fwrite(&ah, sizeof(ah), 1, out) == 1;
+}
+
+bool irsdk_archiveConvert(const char *ibtPath, const char *archivePath, int chunkRecords)
+{
+	if(chunkRecords <= 0)
+		return false;
+
+	FILE *in = fopen(ibtPath, "rb");
+	if(!in)
+		return false;
+
+	FILE *out = fopen(archivePath, "wb");
+	if(!out)
+	{
+		fclose(in);
+		return false;
+	}
+
+	bool ok = convert(in, out, chunkRecords);
+	fclose(in);
+	ok = fclose(out) == 0 && ok;
+
+	// don't leave half an archive behind
+	if(!ok)
+		remove(archivePath);
+	return ok;
+}
@@ -0,0 +1,134 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef IRSDKARCHIVE_H
+#define IRSDKARCHIVE_H
+
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include "irsdk_defines.h"
+
+// Columnar telemetry archive, an .ibt turned on its side.
+//
+// The records are cut into chunks of a fixed number of records. Inside a chunk every entry of every
+// variable is a column of its own, compressed by type:
+//   int				delta from the previous record, zig-zag varint
+//   float, double		XOR with the previous record, leading and trailing zero bits left out (Gorilla)
+//   bool, char, bitField	runs of the same value
+// Every column starts over at the start of its chunk, so any one of them decodes on its own.
+//
+// Layout: irsdk_archiveHeader, the variables' irsdk_varHeaders, then the chunks, each a table of where
+// its columns end followed by the columns. The session strings with their irsdk_diskSessionVersion
+// table and the chunk index with the session time range of every chunk come last.
+//
+// Not part of iRon itself, tools/archivetool.cpp builds it in.
+
+static const char IRSDK_ARCHIVE_MAGIC[8] = "IRONARC";
+static const int IRSDK_ARCHIVE_VER = 1;
+
+struct irsdk_archiveHeader
+{
+	char magic[8];
+	int ver;
+	int tickRate;
+
+	int numVars;
+	int numColumns;				// one for every entry of every variable
+	int recordCount;
+	int chunkRecords;			// records per chunk, the last one can have fewer
+
+	int numChunks;
+	int numSessionVersions;
+	long long varHeaderOffset;		// irsdk_varHeader[numVars]
+	long long chunkIndexOffset;		// irsdk_archiveChunk[numChunks]
+	long long sessionVersionOffset;	// irsdk_diskSessionVersion[numSessionVersions]
+
+	irsdk_diskSubHeader sub;	// from the .ibt
+};
+
+struct irsdk_archiveChunk
+{
+	double startTime;		// session time of the first and last record
+	double endTime;
+	int firstRecord;
+	int numRecords;
+	long long offset;		// unsigned int columnEnd[numColumns], relative to the end of that table, then the columns
+};
+
+// Reads channels out of an archive, decoding only the chunks and columns asked for.
+class irsdkArchive
+{
+public:
+	irsdkArchive();
+	~irsdkArchive();
+
+	// reads the header and index, the columns stay on disk
+	bool open(const char *path);
+	void close();
+	bool isOpen() const { return m_file != NULL; }
+
+	const irsdk_archiveHeader *getHeader() const;
+	const irsdk_varHeader *getVarHeaderEntry(int index) const;
+	int varNameToIndex(const char *name) const;
+
+	int getNumChunks() const { return (int)m_chunks.size(); }
+	const irsdk_archiveChunk *getChunk(int index) const;
+	// first chunk that ends at or after the session time, -1 if they all end before it
+	int findChunk(double sessionTime) const;
+
+	// Appends one entry of a variable for every record between the session times, along with their session
+	// times if asked for. Doubles hold every variable type exactly. Returns how many records, -1 on errors.
+	int read(int var, int entry, double startTime, double endTime, std::vector<double> *times, std::vector<double> *values);
+	int read(const char *name, int entry, double startTime, double endTime, std::vector<double> *times, std::vector<double> *values);
+	// the same by record number
+	int readRecords(int var, int entry, int firstRecord, int numRecords, std::vector<double> *values);
+
+	// the session string the sim had out at the time of the record
+	const char *getSessionInfoStr(int record);
+
+protected:
+	bool decodeColumn(int chunk, int column, std::vector<double> &values);
+	// session times of every record in the chunk
+	bool decodeTimes(int chunk, std::vector<double> &times);
+
+	FILE *m_file;
+	long long m_fileSize;
+	irsdk_archiveHeader m_header;
+	std::vector<irsdk_varHeader> m_vars;
+	std::vector<int> m_firstColumn;			// of every variable
+	std::vector<irsdk_archiveChunk> m_chunks;
+	std::vector<irsdk_diskSessionVersion> m_sessionVersions;
+	int m_sessionTimeVar;
+
+	std::vector<unsigned char> m_buf;
+	std::vector<double> m_times;
+	std::string m_sessionInfo;
+	int m_sessionVersion;
+};
+
+// Converts an .ibt, including every session string version irsdkRecorder kept, chunkRecords records to a chunk.
+bool irsdk_archiveConvert(const char *ibtPath, const char *archivePath, int chunkRecords = 600);
+
+#endif // IRSDKARCHIVE_H
@@ -29,22 +29,144 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string.h>
 
 #include <assert.h>
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "irsdk_defines.h"
 #include "yaml_parser.h"
 #include "irsdk_client.h"
 
 #pragma warning(disable:4996)
 
+typedef std::chrono::steady_clock irsdkClock;
+
+// The header and variable headers of one connection, as the ingestion thread found them on connect
+struct irsdkIngestLayout
+{
+	irsdk_header header;
+	std::vector<irsdk_varHeader> vars;
+};
+
+// A copy of the session string
+struct irsdkSessionCopy
+{
+	std::string str;
+	int update = -1;
+};
+
+// The sim rewrites the session string in place, so a copy only counts if the update count
+// didn't move while we took it. Returns false if there's nothing new or the copy got torn,
+// then try again with the next row.
+static bool copySessionStr(irsdkSessionCopy &copy)
+{
+	const irsdk_header *header = irsdk_getHeader();
+	const int update = irsdk_getSessionInfoStrUpdate();
+	const char *str = irsdk_getSessionInfoStr();
+	if(!header || !str || update == copy.update)
+		return false;
+
+	copy.str.assign(str, strnlen(str, header->sessionInfoLen));
+	if(irsdk_getSessionInfoStrUpdate() != update)
+		return false;
+
+	copy.update = update;
+	return true;
+}
+
+// One row as copied by the ingestion thread
+struct irsdkIngestSlot
+{
+	char *data = NULL;
+	int cap = 0;
+	int bufLen = 0;
+	int gen = -1;			// connection the row is from
+	int rangesVersion = -1;	// copy ranges it was written with, FULL_ROW if all of it
+	bool connected = false;
+	double copyUs = 0;
+	irsdkClock::time_point copied;
+
+	// what the main thread would otherwise have to ask the sim for, NULL when not connected
+	std::shared_ptr<const irsdkIngestLayout> layout;
+	std::shared_ptr<const irsdkSessionCopy> session;
+	irsdk_copyStats copyStats = irsdk_copyStats();
+};
+
+// State shared between the ingestion thread and the thread calling waitForData().
+//
+// Rows are handed over through a triple buffer, like the session parser in iracing.cpp does:
+// the ingestion thread always has a slot to write into, the main thread always has one to read from,
+// and the third one is traded between them with an atomic exchange. Neither side ever waits for the
+// other, the mutex and condition variable are only there for the main thread to sleep on.
+class irsdkIngest
+{
+public:
+	static const int FRESH = 0x4;		// set in middle when it holds a row the main thread hasn't seen
+	static const int FULL_ROW = -2;
+
+	irsdkIngestSlot slots[3];
+	int back = 0;						// ingestion thread only
+	int front = 1;						// main thread only
+	std::atomic<int> middle{2};
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::atomic<bool> quit{false};
+	std::thread thread;
+
+	// copy ranges handed over from the main thread
+	std::mutex rangesMutex;
+	std::vector<irsdk_dataRange> ranges;
+	int rangesGen = -1;					// connection they're for, -1 to copy everything
+	std::atomic<int> rangesVersion{0};
+
+	std::atomic<int> dropped{0};
+
+	// every full row copied goes here too, see irsdkClient::setRowSink()
+	std::atomic<irsdkRowSink *> sink{nullptr};
+
+	// main thread only
+	int frontGen = -1;
+	bool frontDone = true;
+	irsdkClock::time_point pickedUp;
+	double totalUs = 0;
+
+	~irsdkIngest()
+	{
+		for(irsdkIngestSlot &slot : slots)
+			delete[] slot.data;
+	}
+};
+
 irsdkClient& irsdkClient::instance()
 {
 	static irsdkClient INSTANCE;
 	return INSTANCE;
 }
 
+irsdkClient::~irsdkClient()
+{
+	stopIngestThread();
+	shutdown();
+	delete[] m_copyRanges;
+	delete m_sinkSession;
+}
+
 bool irsdkClient::waitForData(int timeoutMS)
 {
+	if(m_ingest)
+		return pickupIngested(timeoutMS);
+
+	// only the subscribed parts, or everything if we don't know them yet or are recording
+	const irsdk_dataRange *ranges = useCopyRanges() && !isRecording() ? m_copyRanges : NULL;
+
 	// wait for start of session or new data
-	if(irsdk_waitForDataReady(timeoutMS, m_data) && irsdk_getHeader())
+	if(irsdk_waitForDataReadyRanges(timeoutMS, m_data, ranges, m_numCopyRanges) && irsdk_getHeader())
 	{
 		// if new connection, or data changed lenght then init
 		if(!m_data || m_nData != irsdk_getHeader()->bufLen)
@@ -62,19 +184,33 @@ bool irsdkClient::waitForData(int timeoutMS)
 
 			// and try to fill in the data
 			if(irsdk_getNewData(m_data))
+			{
+				pushToSink();
 				return true;
+			}
 		}
 		else if(m_data)
 		{
+			if(!ranges)
+				pushToSink();
+
 			// else we are allready initialized, and data is ready for processing
 			return true;
 		}
 	}
 	else if(!isConnected())
 	{
+		if(m_rowSink)
+			m_rowSink->pushEnd();
+
 		// else session ended
 		if(m_data)
+		{
 			delete[] m_data;
+
+			// let anyone pointing into the buffer know it's gone
+			m_statusID++;
+		}
 		m_data = NULL;
 
 		// reset session info str status
@@ -84,27 +220,389 @@ bool irsdkClient::waitForData(int timeoutMS)
 	return false;
 }
 
+void irsdkClient::pushToSink()
+{
+	if(!m_rowSink)
+		return;
+
+	if(!m_sinkSession)
+		m_sinkSession = new irsdkSessionCopy();
+	copySessionStr(*m_sinkSession);
+
+	m_rowSink->pushRow(m_data, m_nData, m_sinkSession->update >= 0 ? m_sinkSession->str.c_str() : NULL, m_sinkSession->update);
+}
+
 void irsdkClient::shutdown()
 {
 	irsdk_shutdown();
 	if(m_data)
-		delete[] m_data;
+	{
+		// with the ingestion thread, it's one of its slots
+		if(!m_ingest)
+			delete[] m_data;
+		m_statusID++;
+	}
 	m_data = NULL;
 
 	// reset session info str status
 	m_lastSessionCt = -1;
 }
 
+void irsdkClient::setCopyRanges(const irsdk_dataRange *ranges, int numRanges)
+{
+	if(numRanges > m_maxCopyRanges || !m_copyRanges)
+	{
+		delete[] m_copyRanges;
+		m_maxCopyRanges = numRanges > 16 ? numRanges : 16;
+		m_copyRanges = new irsdk_dataRange[m_maxCopyRanges];
+	}
+
+	m_numCopyRanges = numRanges;
+	m_copyRangeBytes = 0;
+	for(int i = 0; i < numRanges; i++)
+	{
+		assert(ranges[i].offset >= 0 && ranges[i].offset + ranges[i].len <= m_nData);
+		m_copyRanges[i] = ranges[i];
+		m_copyRangeBytes += ranges[i].len;
+	}
+
+	m_copyRangesStatusID = m_statusID;
+	m_copyRangesVersion++;
+
+	handCopyRangesToIngest();
+}
+
+void irsdkClient::setCopySubscribedOnly(bool enable)
+{
+	m_copySubscribedOnly = enable;
+	handCopyRangesToIngest();
+}
+
+void irsdkClient::handCopyRangesToIngest()
+{
+	if(!m_ingest)
+		return;
+
+	std::lock_guard<std::mutex> lock(m_ingest->rangesMutex);
+
+	if(useCopyRanges())
+	{
+		m_ingest->ranges.assign(m_copyRanges, m_copyRanges + m_numCopyRanges);
+		m_ingest->rangesGen = m_ingest->frontGen;
+	}
+	else
+	{
+		m_ingest->ranges.clear();
+		m_ingest->rangesGen = -1;
+	}
+
+	m_ingest->rangesVersion = m_copyRangesVersion;
+}
+
+void irsdkClient::startIngestThread()
+{
+	if(m_ingest)
+		return;
+
+	// from here on m_data points into the ingestion slots
+	if(m_data)
+	{
+		delete[] m_data;
+		m_data = NULL;
+		m_statusID++;
+	}
+
+	m_ingest = new irsdkIngest();
+	m_ingest->sink = m_rowSink;
+	m_ingest->thread = std::thread(&irsdkClient::ingestLoop, this);
+}
+
+void irsdkClient::stopIngestThread()
+{
+	if(!m_ingest)
+		return;
+
+	m_ingest->quit = true;
+	m_ingest->thread.join();
+
+	if(m_data)
+		m_statusID++;
+	m_data = NULL;
+
+	delete m_ingest;
+	m_ingest = NULL;
+}
+
+void irsdkClient::ingestLoop()
+{
+	irsdkIngest &in = *m_ingest;
+
+	std::vector<irsdk_dataRange> ranges;
+	int rangesGen = -1;
+	int rangesVersion = -1;
+
+	int gen = 0;
+	int bufLen = 0;
+	bool connected = false;
+
+	std::shared_ptr<const irsdkIngestLayout> layout;
+	std::shared_ptr<const irsdkSessionCopy> session;
+	std::shared_ptr<irsdkSessionCopy> sessionCopy;
+
+	while(!in.quit)
+	{
+		// pick up changes to what we're supposed to copy
+		if(in.rangesVersion != rangesVersion)
+		{
+			std::lock_guard<std::mutex> lock(in.rangesMutex);
+			ranges = in.ranges;
+			rangesGen = in.rangesGen;
+			rangesVersion = in.rangesVersion;
+		}
+
+		irsdkIngestSlot &slot = in.slots[in.back];
+
+		// make room before the row arrives, so we don't lose a tick to allocating
+		const irsdk_header *header = irsdk_getHeader();
+		if(header && header->bufLen > slot.cap)
+		{
+			delete[] slot.data;
+			slot.cap = header->bufLen;
+			slot.data = new char[slot.cap];
+			slot.gen = -1;
+		}
+
+		// a slot that hasn't had a full row of this connection yet needs one, and so does the sink
+		irsdkRowSink *sink = in.sink;
+		const bool fullRow = !connected || slot.gen != gen || rangesGen != gen || (sink && sink->isRecording());
+
+		if(irsdk_waitForDataReadyRanges(16, slot.data, fullRow ? NULL : ranges.data(), (int)ranges.size()) && irsdk_getHeader() && slot.data)
+		{
+			header = irsdk_getHeader();
+
+			// new connection, or the data changed length
+			if(!connected || bufLen != header->bufLen)
+			{
+				connected = true;
+				bufLen = header->bufLen;
+				gen++;
+
+				std::shared_ptr<irsdkIngestLayout> l = std::make_shared<irsdkIngestLayout>();
+				l->header = *header;
+				l->vars.assign(irsdk_getVarHeaderPtr(), irsdk_getVarHeaderPtr() + header->numVars);
+				layout = l;
+				session.reset();
+
+				if(!fullRow || slot.cap < bufLen)
+				{
+					if(slot.cap < bufLen)
+					{
+						delete[] slot.data;
+						slot.cap = bufLen;
+						slot.data = new char[slot.cap];
+					}
+					irsdk_copyLatestDataRanges(slot.data, NULL, 0);
+				}
+			}
+
+			slot.bufLen = bufLen;
+			slot.gen = gen;
+			slot.rangesVersion = fullRow ? irsdkIngest::FULL_ROW : rangesVersion;
+			slot.connected = true;
+			slot.copied = irsdkClock::now();
+			slot.copyUs = irsdk_getCopyStats()->lastCopyUs;
+
+			// a new session string goes with this row. The main thread may still be reading the last
+			// one, so every version gets a copy of its own.
+			if(irsdk_getSessionInfoStrUpdate() != (session ? session->update : -1))
+			{
+				if(!sessionCopy)
+					sessionCopy = std::make_shared<irsdkSessionCopy>();
+				if(copySessionStr(*sessionCopy))
+				{
+					session = sessionCopy;
+					sessionCopy.reset();
+				}
+			}
+
+			slot.layout = layout;
+			slot.session = session;
+			slot.copyStats = *irsdk_getCopyStats();
+
+			if(sink && fullRow)
+				sink->pushRow(slot.data, bufLen, session ? session->str.c_str() : NULL, session ? session->update : -1);
+		}
+		else if(connected && !irsdk_isConnected())
+		{
+			// session ended
+			connected = false;
+			if(sink)
+				sink->pushEnd();
+			gen++;
+
+			slot.gen = gen;
+			slot.connected = false;
+			slot.copied = irsdkClock::now();
+			slot.copyUs = 0;
+			slot.layout.reset();
+			slot.session.reset();
+			slot.copyStats = *irsdk_getCopyStats();
+		}
+		else
+		{
+			continue;
+		}
+
+		// publish
+		const int prev = in.middle.exchange(in.back | irsdkIngest::FRESH);
+		if(prev & irsdkIngest::FRESH)
+			in.dropped++;
+		in.back = prev & ~irsdkIngest::FRESH;
+
+		{
+			std::lock_guard<std::mutex> lock(in.mutex);
+		}
+		in.cv.notify_one();
+	}
+}
+
+bool irsdkClient::pickupIngested(int timeoutMS)
+{
+	irsdkIngest &in = *m_ingest;
+
+	if(!(in.middle.load() & irsdkIngest::FRESH))
+	{
+		std::unique_lock<std::mutex> lock(in.mutex);
+		in.cv.wait_for(lock, std::chrono::milliseconds(timeoutMS), [&in]{ return (in.middle.load() & irsdkIngest::FRESH) != 0; });
+	}
+
+	if(!(in.middle.load() & irsdkIngest::FRESH))
+		return false;
+
+	in.front = in.middle.exchange(in.front) & ~irsdkIngest::FRESH;
+	const irsdkIngestSlot &slot = in.slots[in.front];
+
+	in.pickedUp = irsdkClock::now();
+	in.frontDone = !slot.connected;
+
+	// new connection, or session ended
+	if(slot.gen != in.frontGen)
+	{
+		in.frontGen = slot.gen;
+		m_statusID++;
+
+		// reset session info str status
+		m_lastSessionCt = -1;
+	}
+
+	m_data = slot.connected ? slot.data : NULL;
+	m_nData = slot.connected ? slot.bufLen : 0;
+
+	// A row written before the subscribed ranges last changed has whatever was last copied into the
+	// slot for newly subscribed variables. Only the ingestion thread talks to the sim, so rather than
+	// filling them in here they read like that until rows with the new ranges come in, a tick or two.
+	return m_data != NULL;
+}
+
+void irsdkClient::frameDone()
+{
+	if(!m_ingest || m_ingest->frontDone)
+		return;
+
+	irsdkIngest &in = *m_ingest;
+	const irsdkIngestSlot &slot = in.slots[in.front];
+	in.frontDone = true;
+
+	const irsdkClock::time_point now = irsdkClock::now();
+	irsdkLatencyStats &l = m_latency;
+	l.lastCopyUs = slot.copyUs;
+	l.lastQueueUs = std::chrono::duration<double, std::micro>(in.pickedUp - slot.copied).count();
+	l.lastRenderUs = std::chrono::duration<double, std::micro>(now - in.pickedUp).count();
+	l.lastUs = l.lastCopyUs + l.lastQueueUs + l.lastRenderUs;
+
+	l.frames++;
+	in.totalUs += l.lastUs;
+	l.meanUs = in.totalUs / l.frames;
+	if(l.lastUs > l.maxUs)
+		l.maxUs = l.lastUs;
+	l.dropped = in.dropped;
+}
+
+void irsdkClient::setRowSink(irsdkRowSink *sink)
+{
+	m_rowSink = sink;
+	if(m_ingest)
+		m_ingest->sink = sink;
+}
+
+void irsdkClient::refreshData(const irsdk_dataRange *ranges, int numRanges)
+{
+	// when copying everything, the data is current anyway
+	if(useCopyRanges() && !m_ingest)
+		irsdk_copyLatestDataRanges(m_data, ranges, numRanges);
+}
+
+const irsdk_header *irsdkClient::getHeader() const
+{
+	if(m_ingest)
+	{
+		const irsdkIngestLayout *layout = m_ingest->slots[m_ingest->front].layout.get();
+		return layout ? &layout->header : NULL;
+	}
+
+	return irsdk_getHeader();
+}
+
+const irsdk_varHeader *irsdkClient::getVarHeaders() const
+{
+	if(m_ingest)
+	{
+		const irsdkIngestLayout *layout = m_ingest->slots[m_ingest->front].layout.get();
+		return layout && !layout->vars.empty() ? layout->vars.data() : NULL;
+	}
+
+	return irsdk_getVarHeaderPtr();
+}
+
+const irsdk_varHeader *irsdkClient::getVarHeader(int idx) const
+{
+	if(m_ingest)
+	{
+		const irsdkIngestLayout *layout = m_ingest->slots[m_ingest->front].layout.get();
+		return layout && idx >= 0 && idx < (int)layout->vars.size() ? &layout->vars[idx] : NULL;
+	}
+
+	return irsdk_getVarHeaderEntry(idx);
+}
+
+const irsdk_copyStats &irsdkClient::getCopyStats() const
+{
+	if(m_ingest)
+		return m_ingest->slots[m_ingest->front].copyStats;
+
+	return *irsdk_getCopyStats();
+}
+
 bool irsdkClient::isConnected()
 {
+	// the ingestion thread keeps track of the connection, and hands over a NULL row once it's gone
+	if(m_ingest)
+		return m_data != NULL;
+
 	return m_data != NULL && irsdk_isConnected();
 }
 
 int irsdkClient::getVarIdx(const char*name)
 {
-	if(isConnected())
+	if(isConnected() && name)
 	{
-		return irsdk_varNameToIndex(name);
+		const irsdk_header *header = getHeader();
+		for(int idx = 0; header && idx < header->numVars; idx++)
+		{
+			const irsdk_varHeader *vh = getVarHeader(idx);
+			if(vh && 0 == strncmp(name, vh->name, IRSDK_MAX_STRING))
+				return idx;
+		}
 	}
 
 	return -1;
@@ -114,7 +612,7 @@ int /*irsdk_VarType*/ irsdkClient::getVarType(int idx)
 {
 	if(isConnected())
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			return vh->type;
@@ -133,7 +631,7 @@ int irsdkClient::getVarCount(int idx)
 {
 	if(isConnected())
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			return vh->count;
@@ -152,11 +650,14 @@ bool irsdkClient::getVarBool(int idx, int entry)
 {
 	if(isConnected())
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
+				if(m_copySubscribedOnly)
+					irsdkVarBase::subscribeIdx(idx);
+
 				const char * data = m_data + vh->offset;
 				switch(vh->type)
 				{
@@ -205,11 +706,14 @@ int irsdkClient::getVarInt(int idx, int entry)
 {
 	if(isConnected())
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
+				if(m_copySubscribedOnly)
+					irsdkVarBase::subscribeIdx(idx);
+
 				const char * data = m_data + vh->offset;
 				switch(vh->type)
 				{
@@ -255,11 +759,14 @@ float irsdkClient::getVarFloat(int idx, int entry)
 {
 	if(isConnected())
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
+				if(m_copySubscribedOnly)
+					irsdkVarBase::subscribeIdx(idx);
+
 				const char * data = m_data + vh->offset;
 				switch(vh->type)
 				{
@@ -305,11 +812,14 @@ double irsdkClient::getVarDouble(int idx, int entry)
 {
 	if(isConnected())
 	{
-		const irsdk_varHeader *vh = irsdk_getVarHeaderEntry(idx);
+		const irsdk_varHeader *vh = getVarHeader(idx);
 		if(vh)
 		{
 			if(entry >= 0 && entry < vh->count)
 			{
+				if(m_copySubscribedOnly)
+					irsdkVarBase::subscribeIdx(idx);
+
 				const char * data = m_data + vh->offset;
 				switch(vh->type)
 				{
@@ -361,7 +871,7 @@ int irsdkClient::getSessionStrVal(const char *path, char *val, int valLen)
 
 		const char *tVal = NULL;
 		int tValLen = 0;
-		if(parseYaml(irsdk_getSessionInfoStr(), path, &tVal, &tValLen))
+		if(parseYaml(sessionStr(), path, &tVal, &tValLen))
 		{
 			// dont overflow out buffer
 			int len = tValLen;
@@ -389,12 +899,34 @@ const char* irsdkClient::getSessionStr()
 	if(isConnected())
 	{
 		m_lastSessionCt = getSessionCt(); 
-		return irsdk_getSessionInfoStr(); 
+		return sessionStr(); 
 	}
 
 	return NULL;
 }
 
+int irsdkClient::getSessionCt()
+{
+	if(m_ingest)
+	{
+		const irsdkSessionCopy *session = m_ingest->slots[m_ingest->front].session.get();
+		return session ? session->update : -1;
+	}
+
+	return irsdk_getSessionInfoStrUpdate();
+}
+
+const char *irsdkClient::sessionStr() const
+{
+	if(m_ingest)
+	{
+		const irsdkSessionCopy *session = m_ingest->slots[m_ingest->front].session.get();
+		return session ? session->str.c_str() : NULL;
+	}
+
+	return irsdk_getSessionInfoStr();
+}
+
 
 //----------------------------------
 
@@ -493,3 +1025,289 @@ double irsdkCVar::getDouble(int entry)
 	return 0.0;
 }
 
+//----------------------------------
+
+// what disconnected and missing variables read from, big enough for 64 doubles
+static const double s_zeros[64] = { 0 };
+static const char *const s_zerosBase = (const char*)s_zeros;
+
+irsdkVarBase *irsdkVarBase::s_first = NULL;
+irsdkVarResolveStats irsdkVarBase::s_stats = { -1, 0, 0, 0, 0.0 };
+int irsdkVarBase::s_copyMergeGap = 64;
+
+// open addressing hash table of var header indices, keyed by name
+static std::vector<int> s_nameTable;
+static int s_nameTableStatusID = -1;
+
+static unsigned hashVarName(const char *name)
+{
+	// FNV-1a
+	unsigned h = 2166136261u;
+	for(int i = 0; i < IRSDK_MAX_STRING && name[i]; i++)
+		h = (h ^ (unsigned char)name[i]) * 16777619u;
+	return h;
+}
+
+static void buildNameTable(int statusID)
+{
+	s_nameTableStatusID = statusID;
+
+	const irsdk_header *header = irsdkClient::instance().getHeader();
+	const int numVars = header ? header->numVars : 0;
+
+	size_t size = 16;
+	while(size < (size_t)numVars * 2)
+		size *= 2;
+	s_nameTable.assign(size, -1);
+
+	const size_t mask = size - 1;
+	for(int idx = 0; idx < numVars; idx++)
+	{
+		const irsdk_varHeader *vh = irsdkClient::instance().getVarHeader(idx);
+		if(!vh)
+			continue;
+
+		size_t slot = hashVarName(vh->name) & mask;
+		while(s_nameTable[slot] >= 0)
+			slot = (slot + 1) & mask;
+		s_nameTable[slot] = idx;
+	}
+}
+
+// variables read through irsdkClient::getVar*() or irsdkCVar, by index into the var headers of s_idxSubscribedStatusID
+static std::vector<char> s_idxSubscribed;
+static int s_idxSubscribedStatusID = -1;
+
+static int findVarIdx(const char *name)
+{
+	if(s_nameTable.empty())
+		return -1;
+
+	const size_t mask = s_nameTable.size() - 1;
+	for(size_t slot = hashVarName(name) & mask; s_nameTable[slot] >= 0; slot = (slot + 1) & mask)
+	{
+		const irsdk_varHeader *vh = irsdkClient::instance().getVarHeader(s_nameTable[slot]);
+		if(vh && 0 == strncmp(name, vh->name, IRSDK_MAX_STRING))
+			return s_nameTable[slot];
+	}
+
+	return -1;
+}
+
+irsdkVarBase::irsdkVarBase(const char *name, bool (*typeMatches)(int), int count)
+	: m_typeMatches(typeMatches)
+	, m_declaredCount(count)
+	, m_next(s_first)
+	, m_subscribed(false)
+	, m_client(&irsdkClient::instance())
+	, m_base(&s_zerosBase)
+	, m_offset(0)
+	, m_statusID(-1)
+	, m_type(0)
+	, m_count(0)
+	, m_valid(false)
+{
+	assert(count * sizeof(double) <= sizeof(s_zeros));
+
+	strncpy(m_name, name, max_string);
+	m_name[max_string-1] = '\0';
+
+	s_first = this;
+}
+
+irsdkVarBase::~irsdkVarBase()
+{
+	for(irsdkVarBase **v = &s_first; *v; v = &(*v)->m_next)
+	{
+		if(*v == this)
+		{
+			*v = m_next;
+			break;
+		}
+	}
+}
+
+void irsdkVarBase::resolveAll()
+{
+	const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+	irsdkClient &client = irsdkClient::instance();
+	const int statusID = client.getStatusID();
+	const bool connected = client.getData() != NULL;
+
+	if(connected)
+	{
+		buildNameTable(statusID);
+	}
+	else
+	{
+		s_nameTable.clear();
+		s_nameTableStatusID = statusID;
+	}
+
+	irsdkVarResolveStats stats = { statusID, 0, 0, 0, 0.0 };
+	stats.numHeaderVars = connected && client.getHeader() ? client.getHeader()->numVars : 0;
+
+	for(irsdkVarBase *v = s_first; v; v = v->m_next)
+	{
+		v->resolve(connected ? findVarIdx(v->m_name) : -1);
+
+		stats.numRegistered++;
+		if(!v->m_valid)
+			stats.numMissing++;
+	}
+
+	updateCopyRanges();
+
+	stats.resolveMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+	s_stats = stats;
+}
+
+void irsdkVarBase::resolveOne(bool subscribe)
+{
+	const bool newSubscription = subscribe && !m_subscribed;
+	if(subscribe)
+		m_subscribed = true;
+
+	if(s_nameTableStatusID != m_client->getStatusID())
+	{
+		// first use since a (re)connect, do everybody. The whole row was copied on connect
+		// and keeps being copied until the ranges are known, so our data is current.
+		resolveAll();
+		return;
+	}
+
+	resolve(m_client->getData() ? findVarIdx(m_name) : -1);
+
+	if(newSubscription && m_valid)
+	{
+		updateCopyRanges();
+
+		// what's in the data buffer for us is from whenever the whole row was last copied
+		irsdk_dataRange range = { m_offset, m_count * irsdk_VarTypeBytes[m_type] };
+		m_client->refreshData(&range, 1);
+	}
+}
+
+void irsdkVarBase::subscribeIdx(int varIdx)
+{
+	irsdkClient &client = irsdkClient::instance();
+	const irsdk_varHeader *vh = client.getVarHeader(varIdx);
+	if(!vh)
+		return;
+
+	const int statusID = client.getStatusID();
+	if(s_idxSubscribedStatusID != statusID)
+	{
+		s_idxSubscribed.clear();
+		s_idxSubscribedStatusID = statusID;
+	}
+
+	if(varIdx < (int)s_idxSubscribed.size() && s_idxSubscribed[varIdx])
+		return;
+
+	if(varIdx >= (int)s_idxSubscribed.size())
+		s_idxSubscribed.resize(varIdx + 1, 0);
+	s_idxSubscribed[varIdx] = 1;
+
+	// the irsdkVar<> ranges have to be current for this connection before adding to them
+	if(s_nameTableStatusID != statusID)
+		resolveAll();
+	else
+		updateCopyRanges();
+
+	// what's in the data buffer for it is from whenever the whole row was last copied
+	irsdk_dataRange range = { vh->offset, vh->count * irsdk_VarTypeBytes[vh->type] };
+	client.refreshData(&range, 1);
+}
+
+void irsdkVarBase::updateCopyRanges()
+{
+	irsdkClient &client = irsdkClient::instance();
+	if(!client.getData())
+		return;
+
+	static std::vector<irsdk_dataRange> ranges;
+	ranges.clear();
+
+	for(irsdkVarBase *v = s_first; v; v = v->m_next)
+	{
+		if(v->m_subscribed && v->m_valid)
+		{
+			irsdk_dataRange range = { v->m_offset, v->m_count * irsdk_VarTypeBytes[v->m_type] };
+			ranges.push_back(range);
+		}
+	}
+
+	// and the ones read by index
+	if(s_idxSubscribedStatusID == client.getStatusID())
+	{
+		for(size_t idx = 0; idx < s_idxSubscribed.size(); idx++)
+		{
+			const irsdk_varHeader *vh = s_idxSubscribed[idx] ? client.getVarHeader((int)idx) : NULL;
+			if(vh)
+			{
+				irsdk_dataRange range = { vh->offset, vh->count * irsdk_VarTypeBytes[vh->type] };
+				ranges.push_back(range);
+			}
+		}
+	}
+
+	std::sort(ranges.begin(), ranges.end(), [](const irsdk_dataRange &a, const irsdk_dataRange &b) { return a.offset < b.offset; });
+
+	// merge overlapping and nearby ranges
+	int n = 0;
+	int bytes = 0;
+	for(size_t i = 0; i < ranges.size(); i++)
+	{
+		if(n > 0 && ranges[i].offset <= ranges[n-1].offset + ranges[n-1].len + s_copyMergeGap)
+		{
+			const int end = std::max(ranges[n-1].offset + ranges[n-1].len, ranges[i].offset + ranges[i].len);
+			bytes += end - (ranges[n-1].offset + ranges[n-1].len);
+			ranges[n-1].len = end - ranges[n-1].offset;
+		}
+		else
+		{
+			bytes += ranges[i].len;
+			ranges[n++] = ranges[i];
+		}
+	}
+
+	// if that doesn't skip a good part of the row, one big copy is just as fast
+	const irsdk_header *header = client.getHeader();
+	if(header && bytes * 4 > header->bufLen * 3)
+	{
+		ranges[0].offset = 0;
+		ranges[0].len = header->bufLen;
+		n = 1;
+	}
+
+	client.setCopyRanges(ranges.data(), n);
+}
+
+void irsdkVarBase::resolve(int varIdx)
+{
+	// unsubscribed variables stay stale, so their first read subscribes them
+	m_statusID = m_subscribed ? m_client->getStatusID() : -1;
+	m_base = &s_zerosBase;
+	m_offset = 0;
+	m_type = 0;
+	m_count = 0;
+	m_valid = false;
+
+	const irsdk_varHeader *vh = m_client->getVarHeader(varIdx);
+	if(!vh)
+		return;
+
+	m_type = vh->type;
+	m_count = vh->count;
+
+	// the variable exists, but not the way we declared it. Reads as zero and is
+	// reported with the missing ones, m_type and m_count say what the sim has.
+	if(!m_typeMatches(vh->type) || vh->count < m_declaredCount)
+		return;
+
+	m_base = m_client->getDataRef();
+	m_offset = vh->offset;
+	m_valid = true;
+}
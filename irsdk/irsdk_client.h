@@ -28,6 +28,43 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef IRSDKCLIENT_H
 #define IRSDKCLIENT_H
 
+#include <assert.h>
+
+struct irsdk_dataRange;
+struct irsdk_header;
+struct irsdk_varHeader;
+struct irsdk_copyStats;
+struct irsdkSessionCopy;
+class irsdkIngest;
+
+// Time from the ingestion thread picking up a tick until the overlays are done with it, see irsdkClient::frameDone()
+struct irsdkLatencyStats
+{
+	int frames;				// ticks that made it to the overlays
+	int dropped;			// ticks replaced by a newer one before the main loop got to them
+	double lastUs;
+	double meanUs;
+	double maxUs;
+	double lastCopyUs;		// breakdown of the last one: copying out of the sim,
+	double lastQueueUs;		// waiting to be picked up,
+	double lastRenderUs;	// and the overlays updating
+};
+
+// Gets every full row the client copies out of the sim, on the thread doing the copying, see irsdkClient::setRowSink().
+// irsdkRecorder is one. Must not wait on anything, it holds up the next row, and must not call irsdk_*() itself.
+class irsdkRowSink
+{
+public:
+	virtual ~irsdkRowSink() {}
+
+	// wants rows right now, the client then copies full rows even in setCopySubscribedOnly() mode
+	virtual bool isRecording() const = 0;
+	// sessionStr is a copy of the session string the row goes with, NULL until the client has a good one
+	virtual void pushRow(const char *row, int bufLen, const char *sessionStr, int sessionUpdate) = 0;
+	// the sim went away
+	virtual void pushEnd() = 0;
+};
+
 // A C++ wrapper around the irsdk calls that takes care of the details of maintaining a connection.
 // reads out the data into a cache so you don't have to worry about timming
 class irsdkClient
@@ -36,12 +73,62 @@ public:
 	// singleton
 	static irsdkClient& instance();
 
-	// wait for live data, or if a .ibt file is open
+	// wait for live data, or if a .ibt file is open (irsdk_ibtOpen())
 	// then read the next line from the file.
+	// With the ingestion thread running, this picks up the newest row it has copied instead.
 	bool waitForData(int timeoutMS = 16);
 
+	// Copy rows out of the sim on a thread of its own, as soon as the sim signals them, into a triple
+	// buffer. waitForData() then just swaps in the newest complete row without locking, so a slow frame
+	// doesn't delay picking up telemetry and vice versa. Call from the thread that calls waitForData().
+	// While it runs, that thread is the only one talking to the sim: the header, variable headers,
+	// session string and copy stats below all come from copies it hands over with each row.
+	void startIngestThread();
+	void stopIngestThread();
+
+	// the caller is done with the current row, for the latency stats
+	void frameDone();
+	const irsdkLatencyStats &getLatencyStats() const { return m_latency; }
+
+	// Hand every full row to sink as it comes in, for example to record them, NULL for none.
+	// Call from the thread that calls waitForData(), and keep the sink around until the ingestion thread is stopped.
+	void setRowSink(irsdkRowSink *sink);
+	bool isRecording() const { return m_rowSink && m_rowSink->isRecording(); }
+
 	bool isConnected();
-	int getStatusID() { return m_statusID; }
+
+	// changes whenever the data buffer is (re)allocated or released, so anything
+	// pointing into it has to be looked up again
+	int getStatusID() const { return m_statusID; }
+
+	// cached copy of the latest data line, NULL if not connected.
+	// Moves around with the ingestion thread running, so hold on to getDataRef() instead.
+	const char *getData() const { return m_data; }
+	const char *const *getDataRef() const { return &m_data; }
+
+	// Only copy the parts of the data line that irsdkVar<> handles have read so far, instead of all of it.
+	// Reading a variable through getVar*() or irsdkCVar subscribes it as well. The first such read of
+	// each variable per connection works the copy ranges out again, so it costs as much as a resolve.
+	void setCopySubscribedOnly(bool enable);
+
+	// bytes copied out of the sim per tick, and in how many pieces
+	int getCopyBytes() const { return useCopyRanges() ? m_copyRangeBytes : m_nData; }
+	int getCopyRangeCount() const { return useCopyRanges() ? m_numCopyRanges : (m_data ? 1 : 0); }
+
+	// sorted, non overlapping parts of the current data line to copy, see setCopySubscribedOnly()
+	void setCopyRanges(const irsdk_dataRange *ranges, int numRanges);
+
+	// fill in parts of the cached data line from the most recent one, without waiting for new data.
+	// Does nothing with the ingestion thread running, the next rows it copies have them instead.
+	void refreshData(const irsdk_dataRange *ranges, int numRanges);
+
+	// the sim's header and variable headers for the current row, NULL if not connected
+	const irsdk_header *getHeader() const;
+	const irsdk_varHeader *getVarHeaders() const;
+	const irsdk_varHeader *getVarHeader(int idx) const;
+
+	// of whoever copies rows out of the sim, as of the current row
+	const irsdk_copyStats &getCopyStats() const;
 
 	int getVarIdx(const char*name);
 
@@ -71,7 +158,7 @@ public:
 	//---
 
 	// value that increments with each update to string
-	int getSessionCt() { return irsdk_getSessionInfoStrUpdate(); }
+	int getSessionCt();
 
 	// has string changed since we last read any values from it
 	bool wasSessionStrUpdated() { return m_lastSessionCt != getSessionCt(); } 
@@ -80,7 +167,7 @@ public:
 	//****Note, this is a linear parser, so it is slow!
 	int getSessionStrVal(const char *path, char *val, int valLen);
 
-	// get the whole string
+	// get the whole string, valid until the next waitForData()
 	const char *getSessionStr();
 
 protected:
@@ -89,17 +176,52 @@ protected:
 		: m_data(NULL)
 		, m_nData(0)
 		, m_statusID(0)
+		, m_copyRanges(NULL)
+		, m_numCopyRanges(0)
+		, m_maxCopyRanges(0)
+		, m_copyRangeBytes(0)
+		, m_copyRangesStatusID(-1)
+		, m_copyRangesVersion(0)
+		, m_copySubscribedOnly(false)
+		, m_ingest(NULL)
+		, m_rowSink(NULL)
+		, m_sinkSession(NULL)
 		, m_lastSessionCt(-1)
-	{ }
+	{
+		m_latency = irsdkLatencyStats();
+	}
 
-	~irsdkClient() { shutdown(); }
+	~irsdkClient();
 
 	void shutdown();
 
+	// ranges are only valid for the data buffer they were made for
+	bool useCopyRanges() const { return m_copySubscribedOnly && m_data && m_copyRangesStatusID == m_statusID; }
+
+	bool pickupIngested(int timeoutMS);
+	void ingestLoop();
+	void handCopyRangesToIngest();
+	const char *sessionStr() const;
+	void pushToSink();
+
 	char *m_data;
 	int m_nData;
 	int m_statusID;
 
+	irsdk_dataRange *m_copyRanges;
+	int m_numCopyRanges;
+	int m_maxCopyRanges;
+	int m_copyRangeBytes;
+	int m_copyRangesStatusID;
+	int m_copyRangesVersion;
+	bool m_copySubscribedOnly;
+
+	irsdkIngest *m_ingest;
+	irsdkLatencyStats m_latency;
+
+	irsdkRowSink *m_rowSink;
+	irsdkSessionCopy *m_sinkSession;	// what goes with the rows handed to it without the ingestion thread
+
 	int m_lastSessionCt;
 
 	static irsdkClient *m_instance;
@@ -136,4 +258,152 @@ protected:
 	int m_statusID;
 };
 
+
+// Maps a C++ type to the irsdk_VarType it is stored as, returned as int so we don't depend on irsdk_defines.h
+template<typename T> struct irsdkVarTypeOf;
+template<> struct irsdkVarTypeOf<char>   { static bool matches(int type) { return type == 0; } };					// irsdk_char
+template<> struct irsdkVarTypeOf<bool>   { static bool matches(int type) { return type == 1; } };					// irsdk_bool
+template<> struct irsdkVarTypeOf<int>    { static bool matches(int type) { return type == 2 || type == 3; } };	// irsdk_int, irsdk_bitField
+template<> struct irsdkVarTypeOf<float>  { static bool matches(int type) { return type == 4; } };					// irsdk_float
+template<> struct irsdkVarTypeOf<double> { static bool matches(int type) { return type == 5; } };					// irsdk_double
+
+// Result of the last irsdkVarBase::resolveAll()
+struct irsdkVarResolveStats
+{
+	int statusID;
+	int numHeaderVars;	// variables the sim provides
+	int numRegistered;	// irsdkVar<> instances
+	int numMissing;		// registered, but not provided, or not with the declared type and count
+	double resolveMs;	// building the name table and resolving everything
+};
+
+// Non templated part of irsdkVar<>.
+// Every instance registers itself in a global list, so on (re)connect all of them
+// can be resolved in one go against a hash table of the var header names.
+class irsdkVarBase
+{
+public:
+	const char *getName() const { return m_name; }
+
+	// returns irsdk_VarType as int so we don't depend on irsdk_defines.h
+	int getType() { checkHeader(); return m_type; }
+	int getCount() { checkHeader(); return m_count; }
+	bool isValid() { checkHeader(); return m_valid; }
+
+	// all instances, in no particular order
+	static irsdkVarBase *getFirst() { return s_first; }
+	irsdkVarBase *getNext() const { return m_next; }
+
+	// look up every registered variable in one pass, done automatically on first use after a (re)connect
+	static void resolveAll();
+	static const irsdkVarResolveStats &getResolveStats() { return s_stats; }
+
+	// A variable is subscribed once it has been read, the client then keeps copying it every tick when
+	// in irsdkClient::setCopySubscribedOnly() mode. Subscribed variables less than this many bytes apart
+	// are copied as one piece, since a short extra copy is cheaper than another memcpy call.
+	bool isSubscribed() const { return m_subscribed; }
+	static void setCopyMergeGap(int bytes) { s_copyMergeGap = bytes; }
+
+protected:
+	irsdkVarBase(const char *name, bool (*typeMatches)(int), int count);
+	~irsdkVarBase();
+
+	// before reading the data. Until the first read after a (re)connect m_statusID
+	// stays stale for unsubscribed variables, so that read ends up here as well.
+	void checkStatus()
+	{
+		if(m_statusID != m_client->getStatusID())
+			resolveOne(true);
+	}
+
+	// before reading the type or count only
+	void checkHeader()
+	{
+		if(m_statusID != m_client->getStatusID())
+			resolveOne(false);
+	}
+
+	// just this variable, reusing the name table if it's current
+	void resolveOne(bool subscribe);
+
+	// look up our offset in the current data buffer, or point at zeros if we can't
+	void resolve(int varIdx);
+
+	// hand the merged ranges of all subscribed variables to the client
+	static void updateCopyRanges();
+
+	// for irsdkClient::getVar*(), which has no instance to keep the subscription in
+	static void subscribeIdx(int varIdx);
+	friend class irsdkClient;
+
+	static const int max_string = 32; //IRSDK_MAX_STRING
+	char m_name[max_string];
+	bool (*m_typeMatches)(int);
+	int m_declaredCount;
+	irsdkVarBase *m_next;
+	bool m_subscribed;
+
+	static irsdkVarBase *s_first;
+	static irsdkVarResolveStats s_stats;
+	static int s_copyMergeGap;
+
+	irsdkClient *m_client;
+	const char *const *m_base;	// the client's data buffer, or zeros
+	int m_offset;				// of our first entry in it
+	int m_statusID;
+	int m_type;
+	int m_count;
+	bool m_valid;
+};
+
+// Typed handle to a telemetry variable, for example irsdkVar<float,64> for a per car float.
+// The variable is looked up once per connection, after that a read is a status check and a load.
+// Missing variables, or ones that don't have the declared type and count, read as zero.
+// Create a global instance of this and it will take care of the details for you.
+template<typename T, int N = 1>
+class irsdkVar : public irsdkVarBase
+{
+public:
+	explicit irsdkVar(const char *name)
+		: irsdkVarBase(name, &irsdkVarTypeOf<T>::matches, N)
+	{ }
+
+	// entry is the array offset, or 0 if not an array element
+	T get(int entry = 0)
+	{
+		checkStatus();
+
+		if((unsigned)entry >= (unsigned)N)
+		{
+			// invalid offset
+			assert(false);
+			return T();
+		}
+
+		return ((const T*)(*m_base + m_offset))[entry];
+	}
+
+	// all N entries, for bulk copies, valid until the next waitForData(). Points at zeros if the variable isn't available.
+	const T *getArray()
+	{
+		checkStatus();
+		return (const T*)(*m_base + m_offset);
+	}
+
+	// same conversions as irsdkClient::getVarBool() and friends
+	bool getBool(int entry = 0) { return toBool(get(entry)); }
+	int getInt(int entry = 0) { return (int)get(entry); }
+	float getFloat(int entry = 0) { return (float)get(entry); }
+	double getDouble(int entry = 0) { return (double)get(entry); }
+
+protected:
+	static bool toBool(char v) { return v != 0; }
+	static bool toBool(bool v) { return v; }
+	static bool toBool(int v) { return v != 0; }
+	// test float/double for greater than 1.0 so that
+	// we have a chance of this being usefull
+	static bool toBool(float v) { return v >= 1.0f; }
+	static bool toBool(double v) { return v >= 1.0; }
+};
+
 #endif // IRSDKCLIENT_H
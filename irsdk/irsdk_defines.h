@@ -81,11 +81,23 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 // Constant Definitions
 
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
 #include <tchar.h>
 
 static const _TCHAR IRSDK_DATAVALIDEVENTNAME[] = _T("Local\\IRSDKDataValidEvent");
 static const _TCHAR IRSDK_MEMMAPFILENAME[]     = _T("Local\\IRSDKMemMapFileName");
 static const _TCHAR IRSDK_BROADCASTMSGNAME[]   = _T("IRSDK_BROADCASTMSG");
+#else
+// POSIX stand-ins for the above, see irsdk_source_posix.cpp.
+// The memory map is a shm object with the same layout, the data valid event a shm object
+// holding a single int that the producer increments and futex wakes after each row.
+static const char IRSDK_DATAVALIDEVENTNAME[] = "/IRSDKDataValidEvent";
+static const char IRSDK_MEMMAPFILENAME[]     = "/IRSDKMemMapFileName";
+static const char IRSDK_BROADCASTMSGNAME[]   = "IRSDK_BROADCASTMSG";
+#endif
 
 static const int IRSDK_MAX_BUFS = 4;
 static const int IRSDK_MAX_STRING = 32;
@@ -336,6 +348,26 @@ struct irsdk_varHeader
 	}
 };
 
+// a span of bytes within a buffer row, see irsdk_getNewDataRanges()
+struct irsdk_dataRange
+{
+	int offset;			// offset from start of buffer row
+	int len;			// in bytes
+};
+
+// what happened while copying rows out of shared memory, see irsdk_getCopyStats()
+struct irsdk_copyStats
+{
+	int copies;			// rows copied successfully
+	int tornReads;		// copies the sim overwrote while we were reading them
+	int retries;		// copy attempts after a torn read
+	int failedReads;	// new data was there, but every attempt got torn
+	int skippedTicks;	// rows the sim wrote that were never copied
+	double lastCopyUs;	// time spent copying, including retries
+	double maxCopyUs;
+	double totalCopyUs;
+};
+
 struct irsdk_varBuf
 {
 	int tickCount;		// used to detect changes in data
@@ -375,6 +407,54 @@ struct irsdk_diskSubHeader
 	int sessionRecordCount;
 };
 
+// Not part of the sim's format: every version of the session string during a recording, where the
+// header only has room for one. Written after the last record by irsdkRecorder, as a table of these
+// followed by an irsdk_diskSessionVersions at the very end of the file. Readers that go by the
+// header and sub header never see it.
+static const char IRSDK_SESSIONVERSIONS_MAGIC[8] = "IRONSSV";
+
+struct irsdk_diskSessionVersion
+{
+	int record;				// first record it applies to
+	int len;				// without the terminating zero
+	long long offset;		// from the start of the file
+};
+
+struct irsdk_diskSessionVersions
+{
+	char magic[8];			// IRSDK_SESSIONVERSIONS_MAGIC
+	int count;
+	int pad;
+	long long tableOffset;	// of irsdk_diskSessionVersion[count]
+};
+
+//----
+// Where the shared memory comes from
+
+// irsdk_startup() and friends only touch the mapped header and data rows, and wait
+// on the data valid signal, through one of these. Defaults to the platform's own.
+struct irsdk_source
+{
+	const char *name;
+	// map the memory and open the signal, returns the start of the memory or NULL if not there (yet).
+	// Called until it succeeds, and again after close()
+	const char *(*open)();
+	void (*close)();
+	// sleep until the producer signals a new row or timeOut ms pass.
+	// A signal given since the last call counts, like an auto reset event
+	void (*waitForSignal)(int timeOut);
+};
+
+#ifdef _WIN32
+extern const irsdk_source irsdk_windowsSource;	// the sim itself
+#else
+extern const irsdk_source irsdk_posixSource;	// tools/shmproducer.cpp, or anything else writing the same layout
+#endif
+
+// call before irsdk_startup(), or it shuts down the current one first. NULL for the default
+void irsdk_setSource(const irsdk_source *source);
+const irsdk_source *irsdk_getSource();
+
 //----
 // Client function definitions
 
@@ -383,6 +463,19 @@ void irsdk_shutdown();
 
 bool irsdk_getNewData(char *data);
 bool irsdk_waitForDataReady(int timeOut, char *data);
+
+// same as above, but only copy the given parts of the row into data, the rest is left untouched.
+// ranges == NULL copies the whole row.
+bool irsdk_getNewDataRanges(char *data, const irsdk_dataRange *ranges, int numRanges);
+bool irsdk_waitForDataReadyRanges(int timeOut, char *data, const irsdk_dataRange *ranges, int numRanges);
+
+// copy parts of the most recent row without marking it as received,
+// to fill in variables that weren't part of the ranges so far
+bool irsdk_copyLatestDataRanges(char *data, const irsdk_dataRange *ranges, int numRanges);
+
+// counters for the copies done by the functions above, for diagnostics
+const irsdk_copyStats *irsdk_getCopyStats();
+void irsdk_resetCopyStats();
 bool irsdk_isConnected();
 
 const irsdk_header *irsdk_getHeader();
@@ -0,0 +1,441 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <string.h>
+#include <limits.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <vector>
+#include "irsdk_ibt.h"
+
+static const char *pFile = NULL;
+static size_t fileSize = 0;
+
+// what the reader gets instead of the sim's memory map: the file's header, variable headers and
+// session string followed by a buffer per varBuf entry that the records get copied into
+static std::vector<char> view;
+static irsdk_header *pHeader = NULL;		// view's
+
+static const irsdk_diskSubHeader *pSubHeader = NULL;
+static long long firstRecordOffset = 0;
+static int recordCount = 0;
+static int sessionTimeOffset = -1;			// within a record
+
+// every version of the session string if irsdkRecorder wrote the file, see irsdk_diskSessionVersions
+static const irsdk_diskSessionVersion *sessionVersions = NULL;
+static int numSessionVersions = 0;
+static int curSessionVersion = -1;			// only touched by the thread waiting on the data
+
+static std::atomic<double> playSpeed(1.0);
+static std::atomic<int> pendingSeek(-1);
+static std::atomic<int> servedRecord(-1);
+
+// only touched by the thread waiting on the data
+static int nextRecord = 0;
+static int publishCount = 0;
+static std::chrono::steady_clock::time_point clockStart;
+static int clockRecord = 0;					// the one due at clockStart
+static double clockSpeed = 1.0;
+
+static const char *mapFile(const char *path, size_t *size)
+{
+#ifdef _WIN32
+	HANDLE hFile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	const char *mem = NULL;
+	LARGE_INTEGER li;
+	if(GetFileSizeEx(hFile, &li) && li.QuadPart > 0)
+	{
+		HANDLE hMap = CreateFileMapping(hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+		if(hMap)
+		{
+			mem = (const char *)MapViewOfFile(hMap, FILE_MAP_READ, 0, 0, 0);
+			*size = (size_t)li.QuadPart;
+
+			// the view keeps them alive
+			CloseHandle(hMap);
+		}
+	}
+	CloseHandle(hFile);
+	return mem;
+#else
+	int fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return NULL;
+
+	const char *mem = NULL;
+	struct stat st;
+	if(fstat(fd, &st) == 0 && st.st_size > 0)
+	{
+		void *p = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if(p != MAP_FAILED)
+		{
+			mem = (const char *)p;
+			*size = st.st_size;
+		}
+	}
+	close(fd);
+	return mem;
+#endif
+}
+
+static void unmapFile()
+{
+	if(pFile)
+	{
+#ifdef _WIN32
+		UnmapViewOfFile(pFile);
+#else
+		munmap((void *)pFile, fileSize);
+#endif
+	}
+
+	pFile = NULL;
+	fileSize = 0;
+	std::vector<char>().swap(view);
+	pHeader = NULL;
+	pSubHeader = NULL;
+	recordCount = 0;
+	sessionTimeOffset = -1;
+	sessionVersions = NULL;
+	numSessionVersions = 0;
+}
+
+static bool inFile(long long offset, long long len)
+{
+	return offset >= 0 && len >= 0 && offset + len <= (long long)fileSize;
+}
+
+static double recordSessionTime(int index)
+{
+	double t;
+	memcpy(&t, pFile + firstRecordOffset + (long long)index * pHeader->bufLen + sessionTimeOffset, sizeof(t));
+	return t;
+}
+
+static void findSessionVersions()
+{
+	if((fileSize & 7) || !inFile((long long)fileSize - sizeof(irsdk_diskSessionVersions), sizeof(irsdk_diskSessionVersions)))
+		return;
+
+	const irsdk_diskSessionVersions *footer = (const irsdk_diskSessionVersions *)(pFile + fileSize - sizeof(irsdk_diskSessionVersions));
+	if(memcmp(footer->magic, IRSDK_SESSIONVERSIONS_MAGIC, sizeof(footer->magic)) || footer->count <= 0 || (footer->tableOffset & 7) ||
+	   !inFile(footer->tableOffset, (long long)footer->count * sizeof(irsdk_diskSessionVersion)))
+		return;
+
+	const irsdk_diskSessionVersion *table = (const irsdk_diskSessionVersion *)(pFile + footer->tableOffset);
+	for(int i=0; i<footer->count; i++)
+		if(!inFile(table[i].offset, table[i].len + 1LL) || table[i].len < 0 || table[i].len == INT_MAX || (i && table[i].record < table[i-1].record))
+			return;
+
+	sessionVersions = table;
+	numSessionVersions = footer->count;
+}
+
+// copy the session string that goes with the record into the view
+static void updateSessionVersion(int index)
+{
+	if(!numSessionVersions)
+		return;
+
+	int v = 0;
+	while(v + 1 < numSessionVersions && sessionVersions[v + 1].record <= index)
+		v++;
+
+	if(v != curSessionVersion)
+	{
+		curSessionVersion = v;
+		char *sessionInfo = &view[pHeader->sessionInfoOffset];
+		memcpy(sessionInfo, pFile + sessionVersions[v].offset, sessionVersions[v].len);
+		sessionInfo[sessionVersions[v].len] = '\0';
+		pHeader->sessionInfoLen = sessionVersions[v].len + 1;
+		pHeader->sessionInfoUpdate++;
+	}
+}
+
+// the sim always overwrites its oldest buffer, here with the next record
+static void publish(int index)
+{
+	updateSessionVersion(index);
+
+	int oldest = 0;
+	for(int i=1; i<pHeader->numBuf; i++)
+		if(pHeader->varBuf[i].tickCount < pHeader->varBuf[oldest].tickCount)
+			oldest = i;
+
+	memcpy(&view[pHeader->varBuf[oldest].bufOffset], pFile + firstRecordOffset + (long long)index * pHeader->bufLen, pHeader->bufLen);
+	std::atomic_thread_fence(std::memory_order_release);
+	pHeader->varBuf[oldest].tickCount = ++publishCount;
+
+	servedRecord = index;
+}
+
+static void restartClock(int record)
+{
+	clockStart = std::chrono::steady_clock::now();
+	clockRecord = record;
+	clockSpeed = playSpeed;
+}
+
+bool irsdk_ibtOpen(const char *path)
+{
+	irsdk_ibtClose();
+
+	pFile = mapFile(path, &fileSize);
+	if(!pFile)
+		return false;
+
+	const irsdk_header *fileHeader = (const irsdk_header *)pFile;
+	pSubHeader = (const irsdk_diskSubHeader *)(pFile + sizeof(irsdk_header));
+
+	const bool valid = inFile(0, sizeof(irsdk_header) + sizeof(irsdk_diskSubHeader)) &&
+		fileHeader->ver >= 1 && fileHeader->ver <= IRSDK_VER &&
+		fileHeader->tickRate > 0 && fileHeader->bufLen > 0 && fileHeader->numVars > 0 &&
+		inFile(fileHeader->varHeaderOffset, (long long)fileHeader->numVars * sizeof(irsdk_varHeader)) &&
+		inFile(fileHeader->sessionInfoOffset, fileHeader->sessionInfoLen) && fileHeader->sessionInfoLen > 0 &&
+		inFile(fileHeader->varBuf[0].bufOffset, fileHeader->bufLen);
+	if(!valid)
+	{
+		unmapFile();
+		return false;
+	}
+
+	// a recording that got cut short may not have its record count filled in
+	firstRecordOffset = fileHeader->varBuf[0].bufOffset;
+	recordCount = (int)std::min<long long>((fileSize - firstRecordOffset) / fileHeader->bufLen, INT_MAX);
+	if(pSubHeader->sessionRecordCount > 0 && pSubHeader->sessionRecordCount < recordCount)
+		recordCount = pSubHeader->sessionRecordCount;
+
+	const irsdk_varHeader *vars = (const irsdk_varHeader *)(pFile + fileHeader->varHeaderOffset);
+	for(int i=0; i<fileHeader->numVars; i++)
+		if(vars[i].type == irsdk_double && vars[i].offset >= 0 && vars[i].offset + 8 <= fileHeader->bufLen &&
+		   0 == strncmp(vars[i].name, "SessionTime", IRSDK_MAX_STRING))
+			sessionTimeOffset = vars[i].offset;
+
+	findSessionVersions();
+	curSessionVersion = -1;
+
+	// room for the longest session string, and buffers 16 byte aligned like the sim's
+	int sessionInfoLen = fileHeader->sessionInfoLen;
+	for(int i=0; i<numSessionVersions; i++)
+		sessionInfoLen = std::max(sessionInfoLen, sessionVersions[i].len + 1);
+
+	const long long varHeaderOffset = sizeof(irsdk_header);
+	const long long sessionInfoOffset = varHeaderOffset + (long long)fileHeader->numVars * sizeof(irsdk_varHeader);
+	const long long bufOffset = (sessionInfoOffset + sessionInfoLen + 15) & ~15LL;
+	const long long bufStride = (fileHeader->bufLen + 15LL) & ~15LL;
+	const long long viewSize = bufOffset + 3 * bufStride;
+	if(viewSize > INT_MAX)
+	{
+		unmapFile();
+		return false;
+	}
+
+	view.assign((size_t)viewSize, 0);
+	pHeader = (irsdk_header *)view.data();
+	memcpy(pHeader, fileHeader, sizeof(irsdk_header));
+	memcpy(&view[(size_t)varHeaderOffset], vars, (size_t)fileHeader->numVars * sizeof(irsdk_varHeader));
+	memcpy(&view[(size_t)sessionInfoOffset], pFile + fileHeader->sessionInfoOffset, fileHeader->sessionInfoLen);
+	view[(size_t)sessionInfoOffset + fileHeader->sessionInfoLen - 1] = '\0';
+
+	// make it look like the sim's memory map with nothing published yet
+	pHeader->varHeaderOffset = (int)varHeaderOffset;
+	pHeader->sessionInfoOffset = (int)sessionInfoOffset;
+	pHeader->sessionInfoUpdate = 1;
+	pHeader->status = irsdk_stConnected;
+	pHeader->numBuf = 3;
+	for(int i=0; i<pHeader->numBuf; i++)
+	{
+		pHeader->varBuf[i].tickCount = 0;
+		pHeader->varBuf[i].bufOffset = (int)(bufOffset + i * bufStride);
+	}
+
+	nextRecord = 0;
+	publishCount = 0;
+	pendingSeek = -1;
+	servedRecord = -1;
+	restartClock(0);
+
+	irsdk_setSource(&irsdk_ibtSource);
+	return true;
+}
+
+void irsdk_ibtClose()
+{
+	if(irsdk_getSource() == &irsdk_ibtSource)
+		irsdk_setSource(NULL);
+
+	unmapFile();
+}
+
+bool irsdk_ibtIsOpen()
+{
+	return pFile != NULL;
+}
+
+const irsdk_diskSubHeader *irsdk_ibtGetDiskSubHeader()
+{
+	return pSubHeader;
+}
+
+int irsdk_ibtGetRecordCount()
+{
+	return recordCount;
+}
+
+int irsdk_ibtGetRecord()
+{
+	return servedRecord;
+}
+
+void irsdk_ibtSetSpeed(double speed)
+{
+	playSpeed = std::max(0.0, speed);
+}
+
+double irsdk_ibtGetSpeed()
+{
+	return playSpeed;
+}
+
+void irsdk_ibtSeekRecord(int index)
+{
+	pendingSeek = std::max(0, std::min(index, recordCount - 1));
+}
+
+void irsdk_ibtSeekTime(double sessionTime)
+{
+	if(!pFile || sessionTimeOffset < 0 || recordCount <= 0)
+		return;
+
+	// records are written every tick, so it's usually right where the tick rate says
+	const double t0 = recordSessionTime(0);
+	int index = std::max(0, std::min((int)((sessionTime - t0) * pHeader->tickRate + 0.5), recordCount - 1));
+	const bool hit = recordSessionTime(index) >= sessionTime && (index == 0 || recordSessionTime(index - 1) < sessionTime);
+
+	// unless logging was paused for a while, then search
+	if(!hit)
+	{
+		int lo = 0;
+		int hi = recordCount - 1;
+		while(lo < hi)
+		{
+			const int mid = lo + (hi - lo) / 2;
+			if(recordSessionTime(mid) < sessionTime)
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		index = lo;
+	}
+
+	irsdk_ibtSeekRecord(index);
+}
+
+// irsdk_source
+
+static const char *ibtOpen()
+{
+	return pFile ? view.data() : NULL;
+}
+
+static void ibtClose()
+{
+	// irsdk_ibtClose() unmaps it
+}
+
+static void ibtWaitForSignal(int timeOut)
+{
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeOut);
+
+	const int seek = pendingSeek.exchange(-1);
+	if(seek >= 0)
+	{
+		nextRecord = seek;
+		restartClock(nextRecord);
+
+		// back from the end, let the reader see the connection first
+		if(!(pHeader->status & irsdk_stConnected))
+		{
+			pHeader->status = irsdk_stConnected;
+			return;
+		}
+	}
+
+	if(nextRecord >= recordCount)
+	{
+		// like the sim going away
+		pHeader->status = 0;
+		std::this_thread::sleep_until(deadline);
+		return;
+	}
+
+	const double speed = playSpeed;
+	if(speed != clockSpeed)
+		restartClock(nextRecord);
+
+	if(speed <= 0.0)
+	{
+		publish(nextRecord++);
+		return;
+	}
+
+	const double ticksPerSec = pHeader->tickRate * speed;
+	const std::chrono::steady_clock::time_point due = clockStart +
+		std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((nextRecord - clockRecord) / ticksPerSec));
+	if(due > deadline)
+	{
+		std::this_thread::sleep_until(deadline);
+		return;
+	}
+	std::this_thread::sleep_until(due);
+
+	// fell behind, skip to the newest one that's due like the sim would
+	const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - clockStart).count();
+	const int newest = std::min(clockRecord + (int)(elapsed * ticksPerSec), recordCount - 1);
+	nextRecord = std::max(nextRecord, newest);
+
+	publish(nextRecord++);
+}
+
+const irsdk_source irsdk_ibtSource =
+{
+	"ibt",
+	ibtOpen,
+	ibtClose,
+	ibtWaitForSignal
+};
@@ -0,0 +1,69 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef IRSDKIBT_H
+#define IRSDKIBT_H
+
+#include "irsdk_defines.h"
+
+// Plays back a .ibt telemetry file as if the sim were running, through irsdk_startup() and friends,
+// so irsdkClient and everything built on it works the same on recorded telemetry.
+//
+// The file is memory mapped read only. Its header already describes the variables and session string
+// the way the sim's memory map does, so those are copied into a small block laid out like the sim's,
+// and each record is copied into its oldest buffer when it's up next. The header's offsets are ints,
+// this way they never point past the block, so files over 2 GB play back to the end.
+// Files written by irsdkRecorder also carry every version of the session string, and each one is
+// served along with the records it went with.
+//
+// Playback moves on inside irsdk_waitForDataReady(), so whichever thread waits on the data drives it.
+// The other functions can be called from any thread, and take effect on the next wait. Open the file
+// before anything starts waiting on the data, it swaps out the source underneath.
+// With irsdkClient's ingestion thread running, rows the main loop doesn't get to in time are dropped
+// like live ones, so read without it to see every record when playing back as fast as possible.
+
+// map the file and switch irsdk_setSource() over to it, false if it isn't a telemetry file
+bool irsdk_ibtOpen(const char *path);
+// and back to the default source
+void irsdk_ibtClose();
+bool irsdk_ibtIsOpen();
+
+// NULL if nothing is open
+const irsdk_diskSubHeader *irsdk_ibtGetDiskSubHeader();
+int irsdk_ibtGetRecordCount();
+// the record served last, -1 before the first one
+int irsdk_ibtGetRecord();
+
+// 1 is real time, 2 twice as fast and so on, 0 as fast as the rows are read
+void irsdk_ibtSetSpeed(double speed);
+double irsdk_ibtGetSpeed();
+
+// continue with the given record, clamped to the ones in the file
+void irsdk_ibtSeekRecord(int index);
+// continue with the first record at or after the given SessionTime
+void irsdk_ibtSeekTime(double sessionTime);
+
+extern const irsdk_source irsdk_ibtSource;
+
+#endif // IRSDKIBT_H
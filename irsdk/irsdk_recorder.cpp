@@ -0,0 +1,375 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <algorithm>
+#include "irsdk_recorder.h"
+
+irsdkRecorder::irsdkRecorder()
+	: m_state(Idle)
+	, m_pushing(0)
+	, m_ended(false)
+	, m_file(NULL)
+	, m_bufLen(0)
+	, m_sessionInfoLen(0)
+	, m_sessionTimeOffset(-1)
+	, m_lapOffset(-1)
+	, m_ringRows(0)
+	, m_head(0)
+	, m_tail(0)
+	, m_sessionHead(0)
+	, m_sessionTail(0)
+	, m_lastSessionUpdate(-1)
+	, m_accepted(0)
+	, m_filePos(0)
+	, m_haveFirstRow(false)
+	, m_firstSessionTime(0)
+	, m_lastSessionTime(0)
+	, m_lastLap(0)
+	, m_statRows(0)
+	, m_statDropped(0)
+	, m_statSessions(0)
+	, m_statBatches(0)
+	, m_statBytes(0)
+{
+}
+
+irsdkRecorder::~irsdkRecorder()
+{
+	stop();
+}
+
+bool irsdkRecorder::start(const char *path, const irsdk_header *header, const irsdk_varHeader *vars, int queueRows)
+{
+	if(isRecording())
+		return false;
+
+	// done with the last one, if it ended by itself
+	if(m_thread.joinable())
+		m_thread.join();
+
+	if(!header || !vars || header->bufLen <= 0 || queueRows <= 0)
+		return false;
+
+	m_file = fopen(path, "wb");
+	if(!m_file)
+		return false;
+
+	m_bufLen = header->bufLen;
+	m_sessionInfoLen = header->sessionInfoLen > 1 ? header->sessionInfoLen : 1;
+	const int numVars = header->numVars;
+
+	// laid out like the sim lays out its own recordings
+	irsdk_header h = *header;
+	h.status = 0;
+	h.varHeaderOffset = sizeof(irsdk_header) + sizeof(irsdk_diskSubHeader);
+	h.sessionInfoOffset = h.varHeaderOffset + numVars * sizeof(irsdk_varHeader);
+	h.sessionInfoLen = m_sessionInfoLen;
+	h.numBuf = 1;
+	memset(h.varBuf, 0, sizeof(h.varBuf));
+	h.varBuf[0].bufOffset = h.sessionInfoOffset + m_sessionInfoLen;
+
+	irsdk_diskSubHeader sub;
+	memset(&sub, 0, sizeof(sub));
+	sub.sessionStartDate = time(NULL);
+
+	m_prefix.assign(h.varBuf[0].bufOffset, 0);
+	memcpy(&m_prefix[0], &h, sizeof(h));
+	memcpy(&m_prefix[sizeof(h)], &sub, sizeof(sub));
+	memcpy(&m_prefix[h.varHeaderOffset], vars, numVars * sizeof(irsdk_varHeader));
+
+	m_sessionTimeOffset = -1;
+	m_lapOffset = -1;
+	for(int i=0; i<numVars; i++)
+	{
+		const irsdk_varHeader *vh = &vars[i];
+		if(vh->type == irsdk_double && 0 == strncmp(vh->name, "SessionTime", IRSDK_MAX_STRING))
+			m_sessionTimeOffset = vh->offset;
+		else if(vh->type == irsdk_int && 0 == strncmp(vh->name, "Lap", IRSDK_MAX_STRING))
+			m_lapOffset = vh->offset;
+	}
+
+	// all the memory the producer will touch, up front
+	m_ringRows = queueRows;
+	m_ring.resize((size_t)m_ringRows * m_bufLen);
+	m_sessionBuf.resize((size_t)NumSessionSlots * m_sessionInfoLen);
+	m_head = 0;
+	m_tail = 0;
+	m_sessionHead = 0;
+	m_sessionTail = 0;
+	m_accepted = 0;
+	m_ended = false;
+
+	// the first session string comes with the first row
+	m_lastSessionUpdate = -1;
+	m_sessions.clear();
+	m_sessionTable.clear();
+
+	m_filePos = 0;
+	m_haveFirstRow = false;
+	m_statRows = 0;
+	m_statDropped = 0;
+	m_statSessions = 0;
+	m_statBatches = 0;
+	m_statBytes = 0;
+
+	m_state = Recording;
+	m_thread = std::thread(&irsdkRecorder::writerLoop, this);
+	return true;
+}
+
+void irsdkRecorder::stop()
+{
+	int recording = Recording;
+	m_state.compare_exchange_strong(recording, Stopping);
+
+	if(m_thread.joinable())
+		m_thread.join();
+}
+
+bool irsdkRecorder::isRecording() const
+{
+	return m_state == Recording && !m_ended;
+}
+
+void irsdkRecorder::pushRow(const char *row, int bufLen, const char *sessionStr, int sessionUpdate)
+{
+	// stop() waits for us to get out of here before the writer drains the ring for the last time
+	m_pushing = 1;
+
+	if(m_state == Recording && !m_ended)
+	{
+		if(bufLen != m_bufLen)
+		{
+			// the sim restarted with other variables, that's a different file
+			m_ended = true;
+		}
+		else
+		{
+			// new session string, goes with this row. If its queue is full, try again next row.
+			if(sessionStr && sessionUpdate != m_lastSessionUpdate)
+			{
+				const unsigned head = m_sessionHead.load(std::memory_order_relaxed);
+				if(head - m_sessionTail.load(std::memory_order_acquire) < NumSessionSlots)
+				{
+					char *dst = &m_sessionBuf[(size_t)(head % NumSessionSlots) * m_sessionInfoLen];
+					const int len = (int)strnlen(sessionStr, m_sessionInfoLen - 1);
+					memcpy(dst, sessionStr, len);
+					dst[len] = '\0';
+
+					m_sessionSlots[head % NumSessionSlots].record = m_accepted;
+					m_sessionSlots[head % NumSessionSlots].len = len;
+					m_sessionHead.store(head + 1, std::memory_order_release);
+					m_lastSessionUpdate = sessionUpdate;
+				}
+			}
+
+			const unsigned head = m_head.load(std::memory_order_relaxed);
+			if(head - m_tail.load(std::memory_order_acquire) < m_ringRows)
+			{
+				memcpy(&m_ring[(size_t)(head % m_ringRows) * m_bufLen], row, m_bufLen);
+				m_head.store(head + 1, std::memory_order_release);
+				m_accepted++;
+			}
+			else
+			{
+				m_statDropped++;
+			}
+		}
+	}
+
+	m_pushing.store(0, std::memory_order_release);
+}
+
+void irsdkRecorder::pushEnd()
+{
+	if(m_state == Recording)
+		m_ended = true;
+}
+
+irsdkRecorderStats irsdkRecorder::getStats() const
+{
+	irsdkRecorderStats stats;
+	stats.rows = m_statRows;
+	stats.dropped = m_statDropped;
+	stats.sessionVersions = m_statSessions;
+	stats.batches = m_statBatches;
+	stats.bytes = m_statBytes;
+	stats.recording = isRecording();
+	return stats;
+}
+
+bool irsdkRecorder::write(const void *data, size_t len)
+{
+	if(len && fwrite(data, 1, len, m_file) != len)
+		return false;
+
+	m_filePos += len;
+	m_statBytes += len;
+	return true;
+}
+
+void irsdkRecorder::writerLoop()
+{
+	bool ok = write(&m_prefix[0], m_prefix.size());
+
+	while(ok && m_state != Stopping && !m_ended)
+	{
+		writeSessions();
+		ok = writeRows();
+
+		// let a few rows pile up, the producer never waits on us
+		if(ok)
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	}
+
+	// However we got here, the producer won't queue anything once it sees this and is out of
+	// pushRow(), but it may have been in the middle of a row when it was set
+	m_ended = true;
+	while(m_pushing)
+		std::this_thread::yield();
+
+	// so one more round picks up the rest. Not after the disk gave out, keep what made it.
+	if(ok)
+	{
+		writeSessions();
+		writeRows();
+	}
+
+	finish();
+	m_state = Idle;
+}
+
+void irsdkRecorder::writeSessions()
+{
+	const unsigned head = m_sessionHead.load(std::memory_order_acquire);
+	unsigned tail = m_sessionTail.load(std::memory_order_relaxed);
+
+	for(; tail != head; tail++)
+	{
+		const SessionSlot &slot = m_sessionSlots[tail % NumSessionSlots];
+		const char *str = &m_sessionBuf[(size_t)(tail % NumSessionSlots) * m_sessionInfoLen];
+
+		irsdk_diskSessionVersion v = { slot.record, slot.len, (long long)m_sessions.size() };
+		m_sessionTable.push_back(v);
+		m_sessions.insert(m_sessions.end(), str, str + slot.len + 1);
+		m_statSessions++;
+	}
+
+	m_sessionTail.store(tail, std::memory_order_release);
+}
+
+bool irsdkRecorder::writeRows()
+{
+	const unsigned head = m_head.load(std::memory_order_acquire);
+	const unsigned tail = m_tail.load(std::memory_order_relaxed);
+	const unsigned n = head - tail;
+	if(!n)
+		return true;
+
+	// at most two runs, before and after the ring wraps
+	const unsigned first = tail % m_ringRows;
+	const unsigned run = std::min(n, m_ringRows - first);
+	bool ok = write(&m_ring[(size_t)first * m_bufLen], (size_t)run * m_bufLen);
+	if(ok && n > run)
+		ok = write(&m_ring[0], (size_t)(n - run) * m_bufLen);
+
+	// for the sub header
+	const char *firstRow = &m_ring[(size_t)first * m_bufLen];
+	const char *lastRow = &m_ring[(size_t)((head - 1) % m_ringRows) * m_bufLen];
+	if(m_sessionTimeOffset >= 0)
+	{
+		if(!m_haveFirstRow)
+			memcpy(&m_firstSessionTime, firstRow + m_sessionTimeOffset, sizeof(double));
+		memcpy(&m_lastSessionTime, lastRow + m_sessionTimeOffset, sizeof(double));
+	}
+	if(m_lapOffset >= 0)
+		memcpy(&m_lastLap, lastRow + m_lapOffset, sizeof(int));
+	m_haveFirstRow = true;
+
+	m_tail.store(head, std::memory_order_release);
+
+	if(ok)
+	{
+		m_statRows += n;
+		m_statBatches++;
+	}
+	else
+	{
+		// out of disk, keep what made it
+		m_ended = true;
+	}
+
+	return ok;
+}
+
+void irsdkRecorder::finish()
+{
+	// never got a session string, still needs the one version
+	if(m_sessionTable.empty())
+	{
+		irsdk_diskSessionVersion v = { 0, 0, (long long)m_sessions.size() };
+		m_sessionTable.push_back(v);
+		m_sessions.push_back('\0');
+	}
+
+	// every session string version after the last record, with a table to find them by
+	const long long sessionsPos = m_filePos;
+	write(&m_sessions[0], m_sessions.size());
+	for(irsdk_diskSessionVersion &v : m_sessionTable)
+		v.offset += sessionsPos;
+
+	irsdk_diskSessionVersions footer;
+	memset(&footer, 0, sizeof(footer));
+	memcpy(footer.magic, IRSDK_SESSIONVERSIONS_MAGIC, sizeof(footer.magic));
+	footer.count = (int)m_sessionTable.size();
+
+	// the table and footer get read in place out of the mapped file, so keep them aligned
+	static const char pad[8] = {};
+	write(pad, (size_t)(-m_filePos & 7));
+	footer.tableOffset = m_filePos;
+	write(&m_sessionTable[0], m_sessionTable.size() * sizeof(irsdk_diskSessionVersion));
+	write(&footer, sizeof(footer));
+
+	// fill in the sub header, and leave the final session string in the header's room for it like the sim does
+	irsdk_header *h = (irsdk_header *)&m_prefix[0];
+	irsdk_diskSubHeader *sub = (irsdk_diskSubHeader *)&m_prefix[sizeof(irsdk_header)];
+	sub->sessionStartTime = m_firstSessionTime;
+	sub->sessionEndTime = m_lastSessionTime;
+	sub->sessionLapCount = m_lastLap;
+	sub->sessionRecordCount = m_statRows;
+	h->varBuf[0].tickCount = m_statRows;
+
+	const irsdk_diskSessionVersion &last = m_sessionTable.back();
+	memset(&m_prefix[h->sessionInfoOffset], 0, m_sessionInfoLen);
+	memcpy(&m_prefix[h->sessionInfoOffset], &m_sessions[(size_t)(last.offset - sessionsPos)], last.len);
+
+	if(fseek(m_file, 0, SEEK_SET) == 0)
+		fwrite(&m_prefix[0], 1, m_prefix.size(), m_file);
+
+	fclose(m_file);
+	m_file = NULL;
+}
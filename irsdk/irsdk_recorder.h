@@ -0,0 +1,131 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef IRSDKRECORDER_H
+#define IRSDKRECORDER_H
+
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "irsdk_defines.h"
+#include "irsdk_client.h"
+
+struct irsdkRecorderStats
+{
+	int rows;				// written to the file
+	int dropped;			// lost because the queue was full, the disk didn't keep up
+	int sessionVersions;	// session strings recorded
+	int batches;			// writes it took
+	long long bytes;
+	bool recording;
+};
+
+// Records the sim's telemetry into an .ibt file, one row per tick plus every version of the session string
+// (see irsdk_diskSessionVersions), as it's read. irsdk_ibtOpen() plays them back.
+// Hand it to irsdkClient::setRowSink() to record what the client reads, or push rows yourself.
+//
+// Rows go through a single producer, single consumer ring of preallocated rows to a writer thread, which
+// writes whatever piled up in one go every few ticks. The thread copying rows out of the sim never waits
+// on the disk, locks or allocates: when the ring is full the row is dropped and counted instead.
+class irsdkRecorder : public irsdkRowSink
+{
+public:
+	irsdkRecorder();
+	~irsdkRecorder();
+
+	// With the header and variables of the rows to come, for example irsdkClient::getHeader() and getVarHeaders().
+	// The session strings come with the rows. Any thread, but not at the same time as stop().
+	bool start(const char *path, const irsdk_header *header, const irsdk_varHeader *vars, int queueRows = 1024);
+	// write out what's queued and finish the file
+	void stop();
+	virtual bool isRecording() const;
+
+	// Called by the one thread copying rows out of the sim, with the full row and the session string it goes with
+	virtual void pushRow(const char *row, int bufLen, const char *sessionStr, int sessionUpdate);
+	// the sim went away, finish the file
+	virtual void pushEnd();
+
+	irsdkRecorderStats getStats() const;
+
+protected:
+	enum { Idle, Recording, Stopping };
+	static const int NumSessionSlots = 4;
+
+	void writerLoop();
+	bool writeRows();
+	void writeSessions();
+	void finish();
+	bool write(const void *data, size_t len);
+
+	std::atomic<int> m_state;
+	std::atomic<int> m_pushing;			// producer is inside pushRow()
+	std::atomic<bool> m_ended;			// by the producer, session over or the data changed layout
+	std::thread m_thread;
+
+	FILE *m_file;
+	std::vector<char> m_prefix;			// header, sub header, var headers and room for the last session string
+	int m_bufLen;
+	int m_sessionInfoLen;
+	int m_sessionTimeOffset;
+	int m_lapOffset;
+
+	// rows, written by the producer at m_head and read by the writer at m_tail
+	std::vector<char> m_ring;
+	unsigned m_ringRows;
+	alignas(64) std::atomic<unsigned> m_head;
+	alignas(64) std::atomic<unsigned> m_tail;
+
+	// session string versions, same scheme
+	struct SessionSlot
+	{
+		int record;
+		int len;
+	};
+	std::vector<char> m_sessionBuf;		// NumSessionSlots * m_sessionInfoLen
+	SessionSlot m_sessionSlots[NumSessionSlots];
+	alignas(64) std::atomic<unsigned> m_sessionHead;
+	alignas(64) std::atomic<unsigned> m_sessionTail;
+
+	// producer only
+	int m_lastSessionUpdate;
+	int m_accepted;						// rows queued so far, the record index of the next one
+
+	// writer only
+	std::vector<char> m_sessions;		// all versions, zero terminated, written after the records
+	std::vector<irsdk_diskSessionVersion> m_sessionTable;
+	long long m_filePos;
+	bool m_haveFirstRow;
+	double m_firstSessionTime;
+	double m_lastSessionTime;
+	int m_lastLap;
+
+	std::atomic<int> m_statRows;
+	std::atomic<int> m_statDropped;
+	std::atomic<int> m_statSessions;
+	std::atomic<int> m_statBatches;
+	std::atomic<long long> m_statBytes;
+};
+
+#endif // IRSDKRECORDER_H
@@ -0,0 +1,129 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include "irsdk_snapshot.h"
+
+// the sim writes these from another process
+static int readTickCount(const irsdk_header *header, int buf)
+{
+	return *(volatile const int *)&header->varBuf[buf].tickCount;
+}
+
+// copy a row out of shared memory, either all of it or just the given ranges
+static void copyRow(char *data, const char *row, int bufLen, const irsdk_dataRange *ranges, int numRanges)
+{
+	if(!ranges)
+	{
+		memcpy(data, row, bufLen);
+		return;
+	}
+
+	for(int i = 0; i < numRanges; i++)
+		memcpy(data + ranges[i].offset, row + ranges[i].offset, ranges[i].len);
+}
+
+int irsdk_copyNewestRow(const irsdk_header *header, const char *sharedMem, int lastTickCount,
+						char *data, const irsdk_dataRange *ranges, int numRanges, irsdk_copyStats *stats)
+{
+	const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+
+	const int numBuf = header->numBuf;
+	const int maxAttempts = 2 * numBuf;
+
+	int torn = -1;	// buffer that got overwritten on the last attempt
+	int attempts = 0;
+	int tick = -1;
+
+	while(attempts < maxAttempts)
+	{
+		// freshest buffer newer than what we have, except the one that just got overwritten
+		int buf = -1;
+		int bufTick = lastTickCount;
+		for(int i = 0; i < numBuf; i++)
+		{
+			const int t = readTickCount(header, i);
+			if(i != torn && t > bufTick)
+			{
+				buf = i;
+				bufTick = t;
+			}
+		}
+
+		if(buf < 0)
+		{
+			// nothing new at all
+			if(torn < 0)
+				break;
+
+			// only the one that got overwritten is newer, it's complete by now
+			torn = -1;
+			continue;
+		}
+
+		if(attempts++ > 0)
+			stats->retries++;
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		copyRow(data, sharedMem + header->varBuf[buf].bufOffset, header->bufLen, ranges, numRanges);
+		std::atomic_thread_fence(std::memory_order_acquire);
+
+		int newer = 0;
+		for(int i = 0; i < numBuf; i++)
+			if(i != buf && readTickCount(header, i) > bufTick)
+				newer++;
+
+		if(readTickCount(header, buf) == bufTick && (numBuf < 2 || newer < numBuf - 1))
+		{
+			tick = bufTick;
+			break;
+		}
+
+		stats->tornReads++;
+		torn = buf;
+	}
+
+	if(tick >= 0)
+	{
+		const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+		stats->copies++;
+		stats->lastCopyUs = us;
+		stats->totalCopyUs += us;
+		if(us > stats->maxCopyUs)
+			stats->maxCopyUs = us;
+
+		// tick counts go up by one per row
+		if(lastTickCount >= 0 && tick > lastTickCount + 1)
+			stats->skippedTicks += tick - lastTickCount - 1;
+	}
+	else if(attempts > 0)
+	{
+		// every attempt got torn
+		stats->failedReads++;
+	}
+
+	return tick;
+}
@@ -0,0 +1,42 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef IRSDKSNAPSHOT_H
+#define IRSDKSNAPSHOT_H
+
+#include "irsdk_defines.h"
+
+// Copies the newest row newer than lastTickCount out of the sim's triple buffered shared memory.
+//
+// The sim always overwrites its oldest buffer, and only updates that buffer's tick count once it's
+// done writing. So a copy is good if the tick count didn't change while we read it, and the buffer
+// didn't become the oldest one either (in which case the sim may be halfway through rewriting it).
+// A torn copy is retried with the freshest buffer that isn't the one that just got overwritten.
+//
+// Copies all of the row if ranges is NULL, otherwise just the ranges.
+// Returns the tick count of the row copied, or -1 if there was nothing newer or every attempt got torn.
+int irsdk_copyNewestRow(const irsdk_header *header, const char *sharedMem, int lastTickCount,
+						char *data, const irsdk_dataRange *ranges, int numRanges, irsdk_copyStats *stats);
+
+#endif // IRSDKSNAPSHOT_H
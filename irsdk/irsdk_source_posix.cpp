@@ -0,0 +1,138 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+// Stand-in for the sim's memory mapped file on platforms without it, so the
+// ingestion path can be run and load tested there, see tools/shmproducer.cpp.
+//
+// IRSDK_MEMMAPFILENAME is a shm object laid out exactly like the sim's memory map.
+// IRSDK_DATAVALIDEVENTNAME is a shm object holding one int, which the producer
+// increments after publishing each row and then wakes any futex waiters on.
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <stddef.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "irsdk_defines.h"
+
+static const char *pSharedMem = NULL;
+static size_t sharedMemSize = 0;
+
+static const int *pSignal = NULL;
+static int lastSignal = 0;
+
+static const void *mapShm(const char *name, size_t minSize, size_t *size)
+{
+	int fd = shm_open(name, O_RDONLY, 0);
+	if(fd < 0)
+		return NULL;
+
+	const void *mem = NULL;
+	struct stat st;
+	if(fstat(fd, &st) == 0 && (size_t)st.st_size >= minSize)
+	{
+		void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+		if(p != MAP_FAILED)
+		{
+			mem = p;
+			*size = st.st_size;
+		}
+	}
+
+	// the mapping stays valid without it
+	close(fd);
+	return mem;
+}
+
+static const char *posixOpen()
+{
+	if(!pSharedMem)
+		pSharedMem = (const char *)mapShm(IRSDK_MEMMAPFILENAME, sizeof(irsdk_header), &sharedMemSize);
+
+	if(pSharedMem)
+	{
+		if(!pSignal)
+		{
+			size_t size;
+			pSignal = (const int *)mapShm(IRSDK_DATAVALIDEVENTNAME, sizeof(int), &size);
+			if(pSignal)
+				lastSignal = __atomic_load_n(pSignal, __ATOMIC_ACQUIRE);
+		}
+
+		if(pSignal)
+			return pSharedMem;
+	}
+
+	return NULL;
+}
+
+static void posixClose()
+{
+	if(pSignal)
+		munmap((void *)pSignal, sizeof(int));
+
+	if(pSharedMem)
+		munmap((void *)pSharedMem, sharedMemSize);
+
+	pSignal = NULL;
+	pSharedMem = NULL;
+	sharedMemSize = 0;
+}
+
+static void posixWaitForSignal(int timeOut)
+{
+	int signal = __atomic_load_n(pSignal, __ATOMIC_ACQUIRE);
+
+	if(signal == lastSignal && timeOut > 0)
+	{
+#ifdef __linux__
+		// returns right away if the producer got to it first
+		struct timespec ts = { timeOut / 1000, (timeOut % 1000) * 1000000L };
+		syscall(SYS_futex, pSignal, FUTEX_WAIT, signal, &ts, NULL, 0);
+#else
+		// no futex, poll instead
+		struct timespec ms = { 0, 1000000L };
+		for(int i=0; i<timeOut && signal == __atomic_load_n(pSignal, __ATOMIC_ACQUIRE); i++)
+			nanosleep(&ms, NULL);
+#endif
+		signal = __atomic_load_n(pSignal, __ATOMIC_ACQUIRE);
+	}
+
+	lastSignal = signal;
+}
+
+const irsdk_source irsdk_posixSource =
+{
+	"posix",
+	posixOpen,
+	posixClose,
+	posixWaitForSignal
+};
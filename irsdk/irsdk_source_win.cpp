@@ -0,0 +1,105 @@
+/*
+Copyright (c) 2013, iRacing.com Motorsport Simulations, LLC.
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+    * Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+    * Neither the name of iRacing.com Motorsport Simulations nor the
+      names of its contributors may be used to endorse or promote products
+      derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR
+ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define MIN_WIN_VER 0x0501
+
+#ifndef WINVER
+#	define WINVER			MIN_WIN_VER
+#endif
+
+#ifndef _WIN32_WINNT
+#	define _WIN32_WINNT		MIN_WIN_VER 
+#endif
+
+#include <windows.h>
+
+#include "irsdk_defines.h"
+
+// for timeBeginPeriod()
+#pragma comment(lib, "Winmm")
+
+// The sim's own memory mapped file and data valid event
+
+static HANDLE hDataValidEvent = NULL;
+static HANDLE hMemMapFile = NULL;
+
+static const char *pSharedMem = NULL;
+
+static const char *winOpen()
+{
+	if(!hMemMapFile)
+		hMemMapFile = OpenFileMapping( FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
+
+	if(hMemMapFile)
+	{
+		if(!pSharedMem)
+			pSharedMem = (const char *)MapViewOfFile(hMemMapFile, FILE_MAP_READ, 0, 0, 0);
+
+		if(pSharedMem)
+		{
+			if(!hDataValidEvent)
+				hDataValidEvent = OpenEvent(SYNCHRONIZE, false, IRSDK_DATAVALIDEVENTNAME);
+
+			if(hDataValidEvent)
+				return pSharedMem;
+			//else printf("Error opening event: %d\n", GetLastError()); 
+		}
+		//else printf("Error mapping file: %d\n", GetLastError()); 
+	}
+	//else printf("Error opening file: %d\n", GetLastError()); 
+
+	return NULL;
+}
+
+static void winClose()
+{
+	if(hDataValidEvent)
+		CloseHandle(hDataValidEvent);
+
+	if(pSharedMem)
+		UnmapViewOfFile(pSharedMem);
+
+	if(hMemMapFile)
+		CloseHandle(hMemMapFile);
+
+	hDataValidEvent = NULL;
+	pSharedMem = NULL;
+	hMemMapFile = NULL;
+}
+
+static void winWaitForSignal(int timeOut)
+{
+	WaitForSingleObject(hDataValidEvent, timeOut);
+}
+
+const irsdk_source irsdk_windowsSource =
+{
+	"windows",
+	winOpen,
+	winClose,
+	winWaitForSignal
+};
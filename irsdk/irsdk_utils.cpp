@@ -25,6 +25,7 @@ ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
 SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#ifdef _WIN32
 #define MIN_WIN_VER 0x0501
 
 #ifndef WINVER
@@ -36,25 +37,35 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <windows.h>
+#endif
+
 #include <stdio.h>
+#include <string.h>
 #include <time.h>
 #include <limits.h>
+#include <chrono>
+#include <thread>
 
 #ifdef _MSC_VER
 #include <crtdbg.h>
 #endif
 
 #include "irsdk_defines.h"
+#include "irsdk_snapshot.h"
 
-// for timeBeginPeriod()
-#pragma comment(lib, "Winmm")
+#ifdef _WIN32
 // for RegisterWindowMessage() and SendMessage()
 #pragma comment(lib, "User32")
+#endif
 
 // Local memory
 
-static HANDLE hDataValidEvent = NULL;
-static HANDLE hMemMapFile = NULL;
+#ifdef _WIN32
+static const irsdk_source *defaultSource = &irsdk_windowsSource;
+#else
+static const irsdk_source *defaultSource = &irsdk_posixSource;
+#endif
+static const irsdk_source *source = defaultSource;
 
 static const char *pSharedMem = NULL;
 static const irsdk_header *pHeader = NULL;
@@ -65,69 +76,67 @@ static bool isInitialized = false;
 static const double timeout = 30.0; // timeout after 30 seconds with no communication
 static time_t lastValidTime = 0;
 
+static irsdk_copyStats copyStats = {};
+
 // Function Implementations
 
-bool irsdk_startup()
+void irsdk_setSource(const irsdk_source *newSource)
 {
-	if(!hMemMapFile)
-	{
-		hMemMapFile = OpenFileMapping( FILE_MAP_READ, FALSE, IRSDK_MEMMAPFILENAME);
-		lastTickCount = INT_MAX;
-	}
+	if(!newSource)
+		newSource = defaultSource;
 
-	if(hMemMapFile)
+	if(newSource != source)
 	{
-		if(!pSharedMem)
-		{
-			pSharedMem = (const char *)MapViewOfFile(hMemMapFile, FILE_MAP_READ, 0, 0, 0);
-			pHeader = (irsdk_header *)pSharedMem;
-			lastTickCount = INT_MAX;
-		}
+		irsdk_shutdown();
+		source = newSource;
+	}
+}
 
-		if(pSharedMem)
-		{
-			if(!hDataValidEvent)
-			{
-				hDataValidEvent = OpenEvent(SYNCHRONIZE, false, IRSDK_DATAVALIDEVENTNAME);
-				lastTickCount = INT_MAX;
-			}
+const irsdk_source *irsdk_getSource()
+{
+	return source;
+}
 
-			if(hDataValidEvent)
-			{
-				isInitialized = true;
-				return isInitialized;
-			}
-			//else printf("Error opening event: %d\n", GetLastError()); 
-		}
-		//else printf("Error mapping file: %d\n", GetLastError()); 
+bool irsdk_startup()
+{
+	if(!isInitialized)
+	{
+		pSharedMem = source->open();
+		pHeader = (const irsdk_header *)pSharedMem;
+		lastTickCount = INT_MAX;
+		isInitialized = pSharedMem != NULL;
 	}
-	//else printf("Error opening file: %d\n", GetLastError()); 
 
-	isInitialized = false;
 	return isInitialized;
 }
 
 void irsdk_shutdown()
 {
-	if(hDataValidEvent)
-		CloseHandle(hDataValidEvent);
-
 	if(pSharedMem)
-		UnmapViewOfFile(pSharedMem);
-
-	if(hMemMapFile)
-		CloseHandle(hMemMapFile);
+		source->close();
 
-	hDataValidEvent = NULL;
 	pSharedMem = NULL;
 	pHeader = NULL;
-	hMemMapFile = NULL;
 
 	isInitialized = false;
 	lastTickCount = INT_MAX;
 }
 
+static int latestBuf()
+{
+	int latest = 0;
+	for(int i=1; i<pHeader->numBuf; i++)
+		if(pHeader->varBuf[latest].tickCount < pHeader->varBuf[i].tickCount)
+		   latest = i;
+	return latest;
+}
+
 bool irsdk_getNewData(char *data)
+{
+	return irsdk_getNewDataRanges(data, NULL, 0);
+}
+
+bool irsdk_getNewDataRanges(char *data, const irsdk_dataRange *ranges, int numRanges)
 {
 	if(isInitialized || irsdk_startup())
 	{
@@ -142,10 +151,7 @@ bool irsdk_getNewData(char *data)
 			return false;
 		}
 
-		int latest = 0;
-		for(int i=1; i<pHeader->numBuf; i++)
-			if(pHeader->varBuf[latest].tickCount < pHeader->varBuf[i].tickCount)
-			   latest = i;	
+		int latest = latestBuf();
 
 		// if newer than last recieved, than report new data
 		if(lastTickCount < pHeader->varBuf[latest].tickCount)
@@ -153,19 +159,15 @@ bool irsdk_getNewData(char *data)
 			// if asked to retrieve the data
 			if(data)
 			{
-				// try twice to get the data out
-				for(int count = 0; count < 2; count++)
+				// falls back to an older buffer if the newest one changes out from under us
+				const int tick = irsdk_copyNewestRow(pHeader, pSharedMem, lastTickCount, data, ranges, numRanges, &copyStats);
+				if(tick >= 0)
 				{
-					int curTickCount =  pHeader->varBuf[latest].tickCount;
-					memcpy(data, pSharedMem + pHeader->varBuf[latest].bufOffset, pHeader->bufLen);
-					if(curTickCount ==  pHeader->varBuf[latest].tickCount)
-					{
-						lastTickCount = curTickCount;
-						lastValidTime = time(NULL);
-						return true;
-					}
+					lastTickCount = tick;
+					lastValidTime = time(NULL);
+					return true;
 				}
-				// if here, the data changed out from under us.
+				// if here, every buffer changed out from under us, counted in copyStats.failedReads
 				return false;
 			}
 			else
@@ -188,7 +190,34 @@ bool irsdk_getNewData(char *data)
 }
 
 
+bool irsdk_copyLatestDataRanges(char *data, const irsdk_dataRange *ranges, int numRanges)
+{
+	if(isInitialized && data && (pHeader->status & irsdk_stConnected))
+	{
+		// not part of the regular per tick copies, so don't count it
+		irsdk_copyStats stats = {};
+		return irsdk_copyNewestRow(pHeader, pSharedMem, -1, data, ranges, numRanges, &stats) >= 0;
+	}
+
+	return false;
+}
+
+const irsdk_copyStats *irsdk_getCopyStats()
+{
+	return &copyStats;
+}
+
+void irsdk_resetCopyStats()
+{
+	memset(&copyStats, 0, sizeof(copyStats));
+}
+
 bool irsdk_waitForDataReady(int timeOut, char *data)
+{
+	return irsdk_waitForDataReadyRanges(timeOut, data, NULL, 0);
+}
+
+bool irsdk_waitForDataReadyRanges(int timeOut, char *data, const irsdk_dataRange *ranges, int numRanges)
 {
 #ifdef _MSC_VER
 	_ASSERTE(timeOut >= 0);
@@ -197,14 +226,14 @@ bool irsdk_waitForDataReady(int timeOut, char *data)
 	if(isInitialized || irsdk_startup())
 	{
 		// just to be sure, check before we sleep
-		if(irsdk_getNewData(data))
+		if(irsdk_getNewDataRanges(data, ranges, numRanges))
 			return true;
 
 		// sleep till signaled
-		WaitForSingleObject(hDataValidEvent, timeOut);
+		source->waitForSignal(timeOut);
 
 		// we woke up, so check for data
-		if(irsdk_getNewData(data))
+		if(irsdk_getNewDataRanges(data, ranges, numRanges))
 			return true;
 		else
 			return false;
@@ -212,7 +241,7 @@ bool irsdk_waitForDataReady(int timeOut, char *data)
 
 	// sleep if error
 	if(timeOut > 0)
-		Sleep(timeOut);
+		std::this_thread::sleep_for(std::chrono::milliseconds(timeOut));
 
 	return false;
 }
@@ -331,14 +360,19 @@ int irsdk_varNameToOffset(const char *name)
 
 unsigned int irsdk_getBroadcastMsgID()
 {
+#ifdef _WIN32
 	static unsigned int msgId = RegisterWindowMessage(IRSDK_BROADCASTMSGNAME); 
 
 	return msgId;
+#else
+	// nothing to send window messages to
+	return 0;
+#endif
 }
 
 void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, int var2, int var3)
 {
-	irsdk_broadcastMsg(msg, var1, (int)MAKELONG(var2, var3));
+	irsdk_broadcastMsg(msg, var1, (int)((var2 & 0xffff) | ((unsigned int)(var3 & 0xffff) << 16)));
 }
 
 void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, float var2)
@@ -351,12 +385,19 @@ void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, float var2)
 
 void irsdk_broadcastMsg(irsdk_BroadcastMsg msg, int var1, int var2)
 {
+#ifdef _WIN32
 	static unsigned int msgId = irsdk_getBroadcastMsgID();
 
 	if(msgId && msg >= 0 && msg < irsdk_BroadcastLast)
 	{
 		SendNotifyMessage(HWND_BROADCAST, msgId, MAKELONG(msg, var1), var2);
 	}
+#else
+	// no window messages, the sim can't be remote controlled from here
+	(void)msg;
+	(void)var1;
+	(void)var2;
+#endif
 }
 
 int irsdk_padCarNum(int num, int zero)
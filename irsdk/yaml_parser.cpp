@@ -28,6 +28,8 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdio.h>
 #include <string.h>
 
+#include "yaml_parser.h"
+
 enum yaml_state {
 	space,
 	key,
@@ -174,3 +176,315 @@ bool parseYaml(const char *data, const char* path, const char **val, int *len)
 	return false;
 }
 
+
+//----------------------------------
+
+void yamlDocument::clear()
+{
+	m_data = NULL;
+	m_len = 0;
+	m_nodes.clear();
+	m_scope.clear();
+	m_firstRoot = -1;
+	m_lastRoot = -1;
+}
+
+void yamlDocument::addNode(const yaml_node &n)
+{
+	const int idx = (int)m_nodes.size();
+	m_nodes.push_back(n);
+	yaml_node &node = m_nodes.back();
+
+	// close any scopes that are not indented less than us
+	while(!m_scope.empty() && m_nodes[m_scope.back()].depth >= node.depth)
+		m_scope.pop_back();
+
+	node.parent = m_scope.empty() ? -1 : m_scope.back();
+	node.firstChild = -1;
+	node.lastChild = -1;
+	node.nextSibling = -1;
+
+	if(node.parent >= 0)
+	{
+		yaml_node &parent = m_nodes[node.parent];
+		if(parent.lastChild >= 0)
+			m_nodes[parent.lastChild].nextSibling = idx;
+		else
+			parent.firstChild = idx;
+		parent.lastChild = idx;
+	}
+	else
+	{
+		if(m_lastRoot >= 0)
+			m_nodes[m_lastRoot].nextSibling = idx;
+		else
+			m_firstRoot = idx;
+		m_lastRoot = idx;
+	}
+
+	m_scope.push_back(idx);
+}
+
+bool yamlDocument::parse(const char *data)
+{
+	clear();
+
+	if(!data)
+		return false;
+
+	m_data = data;
+
+	const char *p = data;
+	while(*p)
+	{
+		yaml_node node;
+		node.depth = 0;
+		node.isListItem = false;
+
+		// indentation, dashes count towards depth just like in parseYaml()
+		while(*p == ' ' || *p == '-')
+		{
+			if(*p == '-')
+				node.isListItem = true;
+			node.depth++;
+			p++;
+		}
+
+		const char *key = p;
+		while(*p && *p != ':' && *p != '\n' && *p != '\r')
+			p++;
+
+		// only "key: value" lines are of interest, skip anything else
+		if(*p == ':' && p > key)
+		{
+			node.keyOffset = (int)(key - data);
+			node.keyLen = (int)(p - key);
+
+			p++;
+			while(*p == ' ')
+				p++;
+
+			const char *val = p;
+			while(*p && *p != '\n' && *p != '\r')
+				p++;
+
+			node.valOffset = (int)(val - data);
+			node.valLen = (int)(p - val);
+
+			addNode(node);
+		}
+		else
+		{
+			while(*p && *p != '\n' && *p != '\r')
+				p++;
+		}
+
+		while(*p == '\n' || *p == '\r')
+			p++;
+	}
+
+	m_len = (int)(p - data);
+	return true;
+}
+
+bool yamlDocument::keyEquals(int idx, const char *key, int keyLen) const
+{
+	const yaml_node &node = m_nodes[idx];
+	return node.keyLen == keyLen && 0 == strncmp(m_data + node.keyOffset, key, keyLen);
+}
+
+bool yamlDocument::matches(int idx, const char *key, int keyLen, const char *sel, int selLen) const
+{
+	if(!keyEquals(idx, key, keyLen))
+		return false;
+
+	const yaml_node &node = m_nodes[idx];
+	return !sel || (node.valLen == selLen && 0 == strncmp(m_data + node.valOffset, sel, selLen));
+}
+
+int yamlDocument::findNode(const char *path, int scope) const
+{
+	if(!m_data || !path)
+		return -1;
+
+	int node = scope;
+
+	// set after a "{value}" match, the following keys are then searched
+	// in the same list entry rather than just below the matched node
+	int entry = -1;
+
+	while(*path)
+	{
+		// split off the next "Key:" and optional "{value}"
+		const char *key = path;
+		while(*path && *path != ':')
+			path++;
+		if(*path != ':')
+			return -1;
+		const int keyLen = (int)(path - key);
+		path++;
+
+		const char *sel = NULL;
+		int selLen = 0;
+		if(*path == '{')
+		{
+			sel = ++path;
+			while(*path && *path != '}')
+				path++;
+			selLen = (int)(path - sel);
+			if(*path == '}')
+				path++;
+		}
+
+		const int first = node >= 0 ? m_nodes[node].firstChild : m_firstRoot;
+
+		int found = -1;
+		for(int i = first; i >= 0 && found < 0; i = m_nodes[i].nextSibling)
+		{
+			if(matches(i, key, keyLen, sel, selLen))
+				found = i;
+		}
+
+		// rest of the list entry we matched last time around
+		if(found < 0 && entry >= 0)
+		{
+			for(int i = m_nodes[entry].nextSibling; i >= 0 && !m_nodes[i].isListItem && found < 0; i = m_nodes[i].nextSibling)
+			{
+				if(matches(i, key, keyLen, sel, selLen))
+					found = i;
+			}
+		}
+
+		if(found < 0)
+			return -1;
+
+		node = found;
+		entry = sel ? found : -1;
+	}
+
+	return node;
+}
+
+bool yamlDocument::getValue(const char *path, const char **val, int *len) const
+{
+	if(!val || !len)
+		return false;
+
+	*val = NULL;
+	*len = 0;
+
+	const int idx = findNode(path);
+	if(idx < 0)
+		return false;
+
+	*val = m_data + m_nodes[idx].valOffset;
+	*len = m_nodes[idx].valLen;
+	return true;
+}
+
+int yamlDocument::getFirstEntry(int list) const
+{
+	if(list < 0 || list >= (int)m_nodes.size())
+		return -1;
+
+	int idx = m_nodes[list].firstChild;
+	while(idx >= 0 && !m_nodes[idx].isListItem)
+		idx = m_nodes[idx].nextSibling;
+
+	return idx;
+}
+
+int yamlDocument::getNextEntry(int entry) const
+{
+	if(entry < 0)
+		return -1;
+
+	int idx = m_nodes[entry].nextSibling;
+	while(idx >= 0 && !m_nodes[idx].isListItem)
+		idx = m_nodes[idx].nextSibling;
+
+	return idx;
+}
+
+void yamlDocument::getEntryValues(int entry, const yamlQuery &query, yaml_value *vals) const
+{
+	for(int i = 0; i < query.getKeyCount(); i++)
+	{
+		vals[i].val = NULL;
+		vals[i].len = 0;
+		vals[i].node = -1;
+	}
+
+	for(int idx = entry; idx >= 0; idx = m_nodes[idx].nextSibling)
+	{
+		const yaml_node &node = m_nodes[idx];
+		if(idx != entry && node.isListItem)
+			break;
+
+		const int q = query.find(m_data + node.keyOffset, node.keyLen);
+		if(q >= 0 && !vals[q].val)
+		{
+			vals[q].val = m_data + node.valOffset;
+			vals[q].len = node.valLen;
+			vals[q].node = idx;
+		}
+	}
+}
+
+//----------------------------------
+
+yamlQuery::yamlQuery(const char *const *keys, int numKeys)
+	: m_numKeys(0)
+{
+	for(int i = 0; i < numKeys && i < max_keys; i++)
+	{
+		m_keys[i] = keys[i];
+		m_keyLens[i] = (int)strlen(keys[i]);
+		m_numKeys++;
+	}
+}
+
+int yamlQuery::find(const char *key, int keyLen) const
+{
+	for(int i = 0; i < m_numKeys; i++)
+	{
+		if(m_keyLens[i] == keyLen && 0 == strncmp(m_keys[i], key, keyLen))
+			return i;
+	}
+
+	return -1;
+}
+
+int yamlDocument::getSubtreeEnd(int idx) const
+{
+	// ends where the next node that isn't nested below us starts
+	for(int n = idx; n >= 0; n = m_nodes[n].parent)
+	{
+		if(m_nodes[n].nextSibling >= 0)
+			return getLineStart(m_nodes[n].nextSibling);
+	}
+
+	return m_len;
+}
+
+void yamlDocument::getSpan(int idx, const char **begin, int *len) const
+{
+	const int start = getLineStart(idx);
+	*begin = m_data + start;
+	*len = getSubtreeEnd(idx) - start;
+}
+
+void yamlDocument::getEntrySpan(int entry, const char **begin, int *len) const
+{
+	const int start = getLineStart(entry);
+	const int next = getNextEntry(entry);
+
+	int end = m_len;
+	if(next >= 0)
+		end = getLineStart(next);
+	else if(m_nodes[entry].parent >= 0)
+		end = getSubtreeEnd(m_nodes[entry].parent);
+
+	*begin = m_data + start;
+	*len = end - start;
+}
@@ -28,7 +28,127 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef YAML_PARSER_H
 #define YAML_PARSER_H
 
+#include <stddef.h>
+#include <vector>
+
 // super simple YAML parser
+// Note: this is a linear scan over the whole string for every lookup, see
+// yamlDocument if you need to look up more than a handful of values.
 bool parseYaml(const char *data, const char* path, const char **val, int *len);
 
+// One "key: value" line of a yamlDocument.
+// Offsets are relative to the start of the document, lengths don't include the ':'.
+struct yaml_node
+{
+	int keyOffset;
+	int keyLen;
+	int valOffset;
+	int valLen;			// includes trailing spaces, same as parseYaml()
+	int depth;			// count of leading spaces and dashes, same as parseYaml()
+	bool isListItem;	// line opens a new list entry ("- CarIdx: 3")
+
+	int parent;			// -1 for top level nodes
+	int firstChild;		// -1 if none
+	int lastChild;		// -1 if none
+	int nextSibling;	// -1 if none
+};
+
+// A value pulled out of a yamlDocument, val is NULL if the key wasn't there.
+// node is the index of the node the value came from, use it to descend into nested lists.
+struct yaml_value
+{
+	const char *val;
+	int len;
+	int node;
+};
+
+// A fixed set of keys to pull out of every entry of a list in a single pass,
+// see yamlDocument::getEntryValues(). Keys are given without the trailing ':'.
+class yamlQuery
+{
+public:
+	yamlQuery(const char *const *keys, int numKeys);
+
+	int getKeyCount() const { return m_numKeys; }
+
+	// index of the key in the query, or -1
+	int find(const char *key, int keyLen) const;
+
+protected:
+	static const int max_keys = 32;
+	const char *m_keys[max_keys];
+	int m_keyLens[max_keys];
+	int m_numKeys;
+};
+
+// Tokenizes a YAML string once into a flat array of nodes, so that many lookups
+// can be done against the same string without rescanning it every time.
+// Paths use the same syntax as parseYaml(), ie "DriverInfo:Drivers:CarIdx:{3}UserName:".
+// The document does not copy the string, it has to stay alive while the document is in use.
+class yamlDocument
+{
+public:
+	yamlDocument()
+		: m_data(NULL)
+		, m_len(0)
+		, m_firstRoot(-1)
+		, m_lastRoot(-1)
+	{ }
+
+	// tokenize the string, replacing any previous content
+	// node storage is reused between calls, so reparsing does not allocate once warmed up
+	bool parse(const char *data);
+	void clear();
+
+	// find a node by path, relative to node 'scope' or the top level if scope is -1
+	// returns the node index or -1 if not found
+	int findNode(const char *path, int scope = -1) const;
+
+	// look up a value by path, same contract as parseYaml()
+	bool getValue(const char *path, const char **val, int *len) const;
+
+	const char *getData() const { return m_data; }
+	int getDataLen() const { return m_len; }
+
+	int getNodeCount() const { return (int)m_nodes.size(); }
+	const yaml_node &getNode(int idx) const { return m_nodes[idx]; }
+
+	const char *getKey(int idx) const { return m_data + m_nodes[idx].keyOffset; }
+	const char *getVal(int idx) const { return m_data + m_nodes[idx].valOffset; }
+
+	// walk the entries of the list below node 'list', ie the "- Key: value" lines
+	// returns the node that opens the entry, or -1 when done
+	int getFirstEntry(int list) const;
+	int getNextEntry(int entry) const;
+
+	// fill vals[0..query.getKeyCount()-1] with the values of the keys found in a list entry,
+	// visiting each node of the entry only once
+	void getEntryValues(int entry, const yamlQuery &query, yaml_value *vals) const;
+
+	// byte range of a node including everything nested below it, starting at the line's indentation
+	void getSpan(int idx, const char **begin, int *len) const;
+
+	// byte range of a whole list entry, from its "- " line up to the next entry
+	void getEntrySpan(int entry, const char **begin, int *len) const;
+
+	// top level nodes, iterate with getNode(idx).nextSibling
+	int getFirstRoot() const { return m_firstRoot; }
+
+	// does node idx have this key? key is not ':' terminated
+	bool keyEquals(int idx, const char *key, int keyLen) const;
+
+protected:
+	void addNode(const yaml_node &node);
+	int getLineStart(int idx) const { return m_nodes[idx].keyOffset - m_nodes[idx].depth; }
+	int getSubtreeEnd(int idx) const;
+	bool matches(int idx, const char *key, int keyLen, const char *sel, int selLen) const;
+
+	const char *m_data;
+	int m_len;
+	std::vector<yaml_node> m_nodes;
+	std::vector<int> m_scope;	// open parents during parse(), indexed by nesting level
+	int m_firstRoot;
+	int m_lastRoot;
+};
+
 #endif //YAML_PARSER_H
@@ -31,11 +31,14 @@ SOFTWARE.
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
+#include <time.h>
 #include <string>
 #include <vector>
 #include <windows.h>
 #include "iracing.h"
 #include "Config.h"
+#include "Bench.h"
 #include "OverlayCover.h"
 #include "OverlayRelative.h"
 #include "OverlayInputs.h"
@@ -43,6 +46,8 @@ SOFTWARE.
 #include "OverlayDebug.h"
 #include "OverlayDDU.h"
 #include "OverlayRay.h"
+#include "irsdk/irsdk_ibt.h"
+#include "irsdk/irsdk_recorder.h"
 
 enum class Hotkey
 {
@@ -113,13 +118,25 @@ static void giveFocusToIracing()
         SetForegroundWindow(hwnd);
 }
 
-int main()
+int main(int argc, char** argv)
 {
     // Bump priority up so we get time from the sim
     SetPriorityClass(GetCurrentProcess(), HIGH_PRIORITY_CLASS);
 
     // Load the config and watch it for changes
     g_cfg.load();
+
+    // Time the tick pipeline on a recorded telemetry file, without any windows: iRon --bench <file.ibt> [ticks]
+    if (argc > 1 && !strcmp(argv[1], "--bench"))
+    {
+        if (argc < 3)
+        {
+            printf("usage: iRon --bench <file.ibt> [ticks]\n");
+            return 1;
+        }
+        return runBench(argv[2], argc > 3 ? atoi(argv[3]) : 0);
+    }
+
     g_cfg.watchForChanges();
 
     // Register global hotkeys
@@ -144,6 +161,21 @@ int main()
     printf("\nHappy Racing!\n");
     printf("====================================================================================\n\n");
 
+    // Play back a recorded telemetry file instead of the sim: iRon <file.ibt> [speed]
+    bool playingBack = false;
+    if (argc > 1)
+    {
+        playingBack = irsdk_ibtOpen(argv[1]);
+        if (playingBack)
+        {
+            if (argc > 2)
+                irsdk_ibtSetSpeed(atof(argv[2]));
+            printf("Playing back %s, %d records at %gx speed\n\n", argv[1], irsdk_ibtGetRecordCount(), irsdk_ibtGetSpeed());
+        }
+        else
+            printf("Can't play back %s, not a telemetry file\n\n", argv[1]);
+    }
+
     // Create overlays
     std::vector<Overlay*> overlays;
     overlays.push_back(new OverlayCover());
@@ -156,8 +188,18 @@ int main()
     overlays.push_back(new OverlayDebug());
 #endif
 
+    // Only copy the telemetry the overlays actually read out of the sim each tick, and do that
+    // on a thread of its own so it's picked up right away no matter what the overlays are doing
+    irsdkClient::instance().setCopySubscribedOnly(true);
+    irsdkClient::instance().startIngestThread();
+
+    // Gets every row the client copies while recording, see record_telemetry below
+    irsdkRecorder recorder;
+    irsdkClient::instance().setRowSink(&recorder);
+
     ConnectionStatus  status = ConnectionStatus::UNKNOWN;
     bool              uiEdit = false;
+    int               reportedResolveID = -1;
 
     while (true)
     {
@@ -172,10 +214,32 @@ int main()
             else
                 printf("iRacing connected (%s)\n", ConnectionStatusStr[(int)status]);
 
+            // Record the telemetry of every connection to a file of its own, if asked to. That includes the
+            // one that's already there on startup, whether or not its first row came in with the first tick.
+            const bool wasConnected = prevStatus != ConnectionStatus::UNKNOWN && prevStatus != ConnectionStatus::DISCONNECTED;
+            if (!wasConnected && status != ConnectionStatus::DISCONNECTED &&
+                g_cfg.getBool("General", "record_telemetry", false) && !playingBack)
+            {
+                char path[64];
+                const time_t now = time(NULL);
+                strftime(path, sizeof(path), "iRon_%Y%m%d_%H%M%S.ibt", localtime(&now));
+                if (recorder.start(path, irsdkClient::instance().getHeader(), irsdkClient::instance().getVarHeaders()))
+                    printf("Recording telemetry to %s\n", path);
+                else
+                    printf("Can't record telemetry to %s\n", path);
+            }
+
             // Enable user-selected overlays, but only if we're driving
             handleConfigChange(overlays, status);
         }
 
+        // Once per connection, let the user know if the sim doesn't provide some of the variables we use
+        if (status != ConnectionStatus::DISCONNECTED && irsdkVarBase::getResolveStats().statusID != reportedResolveID)
+        {
+            reportedResolveID = irsdkVarBase::getResolveStats().statusID;
+            ir_printMissingVariables();
+        }
+
         if (ir_session.sessionType != prevSessionType)
         {
             for (Overlay* o : overlays)
@@ -183,10 +247,25 @@ int main()
         }
 
         dbg("connection status: %s, session type: %s, session state: %d, pace mode: %d, on track: %d, flags: 0x%X", ConnectionStatusStr[(int)status], SessionTypeStr[(int)ir_session.sessionType], ir_SessionState.getInt(), ir_PaceMode.getInt(), (int)ir_IsOnTrackCar.getBool(), ir_SessionFlags.getInt());
+        dbg("session updates: %d, last update reparsed %d sections and %d drivers", ir_sessionParseStats.updates, ir_sessionParseStats.sectionsParsed, ir_sessionParseStats.driversParsed);
+        dbg("telemetry vars: %d resolved against %d in %.3f ms, %d missing", irsdkVarBase::getResolveStats().numRegistered, irsdkVarBase::getResolveStats().numHeaderVars, irsdkVarBase::getResolveStats().resolveMs, irsdkVarBase::getResolveStats().numMissing);
+        dbg("telemetry copy: %d bytes in %d pieces per tick", irsdkClient::instance().getCopyBytes(), irsdkClient::instance().getCopyRangeCount());
+        {
+            const irsdk_copyStats& cs = irsdkClient::instance().getCopyStats();
+            dbg("telemetry copies: %d, skipped ticks: %d, torn: %d, retries: %d, failed: %d, copy time: %.1f us (max %.1f us)", cs.copies, cs.skippedTicks, cs.tornReads, cs.retries, cs.failedReads, cs.lastCopyUs, cs.maxCopyUs);
+
+            const irsdkLatencyStats& lat = irsdkClient::instance().getLatencyStats();
+            dbg("telemetry latency: %.0f us (copy %.0f, queued %.0f, overlays %.0f), mean %.0f us, max %.0f us, %d ticks dropped", lat.lastUs, lat.lastCopyUs, lat.lastQueueUs, lat.lastRenderUs, lat.meanUs, lat.maxUs, lat.dropped);
+
+            const irsdkRecorderStats rs = recorder.getStats();
+            if (rs.recording || rs.rows)
+                dbg("telemetry recording: %s, %d rows, %d dropped, %d session strings, %d writes, %.1f MB", rs.recording ? "on" : "off", rs.rows, rs.dropped, rs.sessionVersions, rs.batches, rs.bytes / (1024.0 * 1024.0));
+        }
 
         // Update roughly every 16ms
         for (Overlay* o : overlays)
             o->update();
+        irsdkClient::instance().frameDone();
 
         // Watch for config change signal
         if (g_cfg.hasChanged())
@@ -246,6 +325,10 @@ int main()
         }
     }
 
+    // the recorder goes away with us
+    irsdkClient::instance().stopIngestThread();
+    irsdkClient::instance().setRowSink(NULL);
+
     for (Overlay* o : overlays)
         delete o;
 }
@@ -0,0 +1,230 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//
+// Telemetry archive tool.
+//
+// Converts .ibt files, the sim's or iRon's own recordings, into the columnar archive described in
+// irsdk_archive.h, and reads channels back out of them:
+//
+//   cl /O2 /EHsc /DNDEBUG tools\archivetool.cpp irsdk\irsdk_archive.cpp
+//   archivetool convert <file.ibt> <file.ira> [--chunk N] [--verify]
+//   archivetool read <file.ira> <variable> [entry] [start end]
+//
+// --verify decodes every column again and compares it with the .ibt, value for value.
+// read prints the session time and value of every record between the session times.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <chrono>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_archive.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static double secondsSince( Clock::time_point t0 )
+{
+    return std::chrono::duration<double>( Clock::now() - t0 ).count();
+}
+
+static long long sizeOf( const char* path )
+{
+    FILE* f = fopen( path, "rb" );
+    if( !f )
+        return -1;
+    fseek( f, 0, SEEK_END );
+    const long long size = ftell( f );
+    fclose( f );
+    return size;
+}
+
+// the same as the archive's doubles
+static double rawValue( const char* src, int type )
+{
+    switch( type )
+    {
+    case irsdk_char:     return (unsigned char)*src;
+    case irsdk_bool:     return (unsigned char)*src;
+    case irsdk_int:      { int v; memcpy( &v, src, sizeof(v) ); return v; }
+    case irsdk_bitField: { unsigned int v; memcpy( &v, src, sizeof(v) ); return v; }
+    case irsdk_float:    { float v; memcpy( &v, src, sizeof(v) ); return v; }
+    case irsdk_double:   { double v; memcpy( &v, src, sizeof(v) ); return v; }
+    }
+    return 0;
+}
+
+static bool sameValue( double a, double b )
+{
+    return a == b || (a != a && b != b);
+}
+
+// every value of every column against the rows in the .ibt
+static int verify( const char* ibtPath, irsdkArchive& ar )
+{
+    FILE* f = fopen( ibtPath, "rb" );
+    if( !f )
+        return -1;
+
+    irsdk_header h;
+    if( fread( &h, sizeof(h), 1, f ) != 1 )
+    {
+        fclose( f );
+        return -1;
+    }
+
+    const irsdk_archiveHeader* ah = ar.getHeader();
+    std::vector<char> rows( (size_t)ah->chunkRecords * h.bufLen );
+    std::vector<double> values;
+    int mismatches = 0;
+
+    for( int c=0; c<ar.getNumChunks(); ++c )
+    {
+        const irsdk_archiveChunk* chunk = ar.getChunk( c );
+        fseek( f, h.varBuf[0].bufOffset + (long)chunk->firstRecord * h.bufLen, SEEK_SET );
+        if( fread( rows.data(), h.bufLen, chunk->numRecords, f ) != (size_t)chunk->numRecords )
+        {
+            mismatches++;
+            break;
+        }
+
+        for( int v=0; v<ah->numVars; ++v )
+        {
+            const irsdk_varHeader* vh = ar.getVarHeaderEntry( v );
+            for( int e=0; e<vh->count; ++e )
+            {
+                values.clear();
+                if( ar.readRecords( v, e, chunk->firstRecord, chunk->numRecords, &values ) != chunk->numRecords )
+                {
+                    mismatches++;
+                    continue;
+                }
+                for( int r=0; r<chunk->numRecords; ++r )
+                {
+                    const char* src = &rows[(size_t)r * h.bufLen + vh->offset + e * irsdk_VarTypeBytes[vh->type]];
+                    if( !sameValue( values[r], rawValue( src, vh->type ) ) )
+                    {
+                        if( mismatches++ < 10 )
+                            printf( "mismatch: %s[%d] record %d: %g, not %g\n", vh->name, e, chunk->firstRecord + r, values[r], rawValue( src, vh->type ) );
+                    }
+                }
+            }
+        }
+    }
+
+    fclose( f );
+    return mismatches;
+}
+
+static int convertFile( int argc, char** argv )
+{
+    const char* ibtPath = argv[2];
+    const char* archivePath = argv[3];
+    int  chunk = 600;
+    bool check = false;
+    for( int i=4; i<argc; ++i )
+    {
+        if( !strcmp( argv[i], "--chunk" ) && i+1<argc )
+            chunk = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--verify" ) )
+            check = true;
+    }
+
+    const Clock::time_point t0 = Clock::now();
+    if( !irsdk_archiveConvert( ibtPath, archivePath, chunk ) )
+    {
+        printf( "Can't convert %s\n", ibtPath );
+        return 1;
+    }
+    const double secs = secondsSince( t0 );
+
+    irsdkArchive ar;
+    if( !ar.open( archivePath ) )
+    {
+        printf( "Can't read back %s\n", archivePath );
+        return 1;
+    }
+
+    const irsdk_archiveHeader* ah = ar.getHeader();
+    const long long ibtSize = sizeOf( ibtPath );
+    const long long archiveSize = sizeOf( archivePath );
+    printf( "%d records, %d variables in %d columns, %d chunks, %d session strings\n", ah->recordCount, ah->numVars, ah->numColumns, ah->numChunks, ah->numSessionVersions );
+    printf( "%.1f MB -> %.1f MB (%.1fx) in %.2f s\n", ibtSize / 1048576.0, archiveSize / 1048576.0, (double)ibtSize / archiveSize, secs );
+
+    if( check )
+    {
+        const int mismatches = verify( ibtPath, ar );
+        if( mismatches )
+        {
+            printf( "FAILED: %d mismatches\n", mismatches );
+            return 1;
+        }
+        printf( "verified every value\n" );
+    }
+    return 0;
+}
+
+static int readChannel( int argc, char** argv )
+{
+    irsdkArchive ar;
+    if( !ar.open( argv[2] ) )
+    {
+        printf( "Can't open %s\n", argv[2] );
+        return 1;
+    }
+
+    const int    entry = argc > 4 ? atoi( argv[4] ) : 0;
+    const double start = argc > 6 ? atof( argv[5] ) : -1e300;
+    const double end = argc > 6 ? atof( argv[6] ) : 1e300;
+
+    std::vector<double> times, values;
+    const Clock::time_point t0 = Clock::now();
+    const int n = ar.read( argv[3], entry, start, end, &times, &values );
+    const double secs = secondsSince( t0 );
+    if( n < 0 )
+    {
+        printf( "Can't read %s[%d]\n", argv[3], entry );
+        return 1;
+    }
+
+    for( int i=0; i<n; ++i )
+        printf( "%.4f %.9g\n", times[i], values[i] );
+    fprintf( stderr, "%d records in %.2f ms\n", n, secs * 1000 );
+    return 0;
+}
+
+int main( int argc, char** argv )
+{
+    if( argc >= 4 && !strcmp( argv[1], "convert" ) )
+        return convertFile( argc, argv );
+    if( argc >= 4 && !strcmp( argv[1], "read" ) )
+        return readChannel( argc, argv );
+
+    printf( "usage: archivetool convert <file.ibt> <file.ira> [--chunk N] [--verify]\n"
+            "       archivetool read <file.ira> <variable> [entry] [start end]\n" );
+    return 1;
+}
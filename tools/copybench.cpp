@@ -0,0 +1,369 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//
+// Telemetry copy benchmark.
+//
+// Compares copying the whole data row out of the sim each tick with copying only the variables
+// iRon reads (irsdkClient::setCopySubscribedOnly()), gathered as merged ranges.
+//
+// The header is synthetic but laid out like the real one: the variables from simvars.h, triple
+// buffered with tick counts like the sim does.
+// The irsdk shared memory functions are replaced by an in-memory fake that copies through the same
+// irsdk_copyNewestRow() irsdk_utils.cpp uses, so this runs without the sim:
+//
+//   cl /O2 /EHsc /DNDEBUG tools\copybench.cpp irsdk\irsdk_client.cpp irsdk\irsdk_snapshot.cpp irsdk\yaml_parser.cpp
+//   copybench [--ticks N] [--cold] [--no-caridx]
+//
+// --cold evicts the caches between ticks, closer to reading rows another core has just written.
+// --no-caridx leaves out the per car arrays, which make up most of what iRon reads.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <limits.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_client.h"
+#include "../irsdk/irsdk_snapshot.h"
+#include "simvars.h"
+
+//
+// Fake irsdk backend
+//
+
+static irsdk_header g_header;
+static std::vector<irsdk_varHeader> g_vars;
+static std::vector<char> g_shared;
+static int g_lastTickCount = INT_MAX;
+static time_t g_lastValidTime;
+
+static void setupFakeSim()
+{
+    g_vars.resize( NumSimVars );
+
+    int offset = 0;
+    for( int i=0; i<NumSimVars; ++i )
+    {
+        irsdk_varHeader& vh = g_vars[i];
+        vh.clear();
+        strcpy( vh.name, SimVars[i].name );
+        vh.type = SimVars[i].type;
+        vh.count = SimVars[i].count;
+        vh.offset = offset;
+        offset += irsdk_VarTypeBytes[vh.type] * vh.count;
+    }
+
+    memset( &g_header, 0, sizeof(g_header) );
+    g_header.ver = IRSDK_VER;
+    g_header.status = irsdk_stConnected;
+    g_header.tickRate = 60;
+    g_header.numVars = NumSimVars;
+    g_header.numBuf = 3;
+    g_header.bufLen = offset;
+
+    g_shared.assign( g_header.numBuf * offset, 0 );
+    for( int i=0; i<g_header.numBuf; ++i )
+        g_header.varBuf[i].bufOffset = i * offset;
+}
+
+// What the sim does every tick: write the oldest buffer, then publish its tick count
+static void produceTick( int tick )
+{
+    irsdk_varBuf& vb = g_header.varBuf[tick % g_header.numBuf];
+    memset( &g_shared[vb.bufOffset], tick & 0xff, g_header.bufLen );
+    vb.tickCount = tick;
+}
+
+bool irsdk_startup() { return true; }
+void irsdk_shutdown() {}
+
+static irsdk_copyStats g_copyStats;
+
+// same work as the real one
+bool irsdk_getNewDataRanges( char* data, const irsdk_dataRange* ranges, int numRanges )
+{
+    int latest = 0;
+    for( int i=1; i<g_header.numBuf; ++i )
+        if( g_header.varBuf[latest].tickCount < g_header.varBuf[i].tickCount )
+            latest = i;
+    const int latestTick = g_header.varBuf[latest].tickCount;
+
+    if( g_lastTickCount < latestTick )
+    {
+        if( data )
+        {
+            const int tick = irsdk_copyNewestRow( &g_header, g_shared.data(), g_lastTickCount, data, ranges, numRanges, &g_copyStats );
+            if( tick < 0 )
+                return false;
+            g_lastTickCount = tick;
+        }
+        else
+        {
+            g_lastTickCount = latestTick;
+        }
+        g_lastValidTime = time( NULL );
+        return true;
+    }
+    else if( g_lastTickCount > latestTick )
+    {
+        g_lastTickCount = latestTick;
+        return false;
+    }
+
+    return false;
+}
+
+bool irsdk_getNewData( char* data )
+{
+    return irsdk_getNewDataRanges( data, NULL, 0 );
+}
+
+bool irsdk_waitForDataReadyRanges( int, char* data, const irsdk_dataRange* ranges, int numRanges )
+{
+    return irsdk_getNewDataRanges( data, ranges, numRanges );
+}
+
+bool irsdk_waitForDataReady( int timeOut, char* data )
+{
+    return irsdk_waitForDataReadyRanges( timeOut, data, NULL, 0 );
+}
+
+bool irsdk_copyLatestDataRanges( char* data, const irsdk_dataRange* ranges, int numRanges )
+{
+    irsdk_copyStats stats = {};
+    return irsdk_copyNewestRow( &g_header, g_shared.data(), -1, data, ranges, numRanges, &stats ) >= 0;
+}
+
+const irsdk_copyStats* irsdk_getCopyStats() { return &g_copyStats; }
+void irsdk_resetCopyStats() { memset( &g_copyStats, 0, sizeof(g_copyStats) ); }
+
+bool irsdk_isConnected()
+{
+    int elapsed = (int)difftime( time(NULL), g_lastValidTime );
+    return (g_header.status & irsdk_stConnected) > 0 && elapsed < 30;
+}
+
+const irsdk_header* irsdk_getHeader() { return &g_header; }
+const char* irsdk_getData( int index ) { return &g_shared[g_header.varBuf[index].bufOffset]; }
+const char* irsdk_getSessionInfoStr() { return ""; }
+int irsdk_getSessionInfoStrUpdate() { return 0; }
+const irsdk_varHeader* irsdk_getVarHeaderPtr() { return g_vars.data(); }
+
+const irsdk_varHeader* irsdk_getVarHeaderEntry( int index )
+{
+    if( index >= 0 && index < g_header.numVars )
+        return &g_vars[index];
+    return NULL;
+}
+
+int irsdk_varNameToIndex( const char* name )
+{
+    for( int index=0; index<g_header.numVars; index++ )
+        if( 0 == strncmp( name, g_vars[index].name, IRSDK_MAX_STRING ) )
+            return index;
+    return -1;
+}
+
+int irsdk_varNameToOffset( const char* name )
+{
+    const irsdk_varHeader* vh = irsdk_getVarHeaderEntry( irsdk_varNameToIndex( name ) );
+    return vh ? vh->offset : -1;
+}
+
+//
+// Benchmark
+//
+
+typedef std::chrono::steady_clock Clock;
+
+static bool g_noCarIdx = false;
+
+static bool isUsed( const SimVar& fv )
+{
+    return fv.used && !(g_noCarIdx && !strncmp( fv.name, "CarIdx", 6 ));
+}
+
+// a variable handle like iRon's globals, read once if the overlays use it
+template<typename T>
+static void makeVar( const SimVar& fv )
+{
+    irsdkVar<T>* v = new irsdkVar<T>( fv.name );
+    if( isUsed( fv ) )
+        v->get();
+}
+
+static std::vector<char> g_evict;
+
+static void evictCaches()
+{
+    for( size_t i=0; i<g_evict.size(); i+=64 )
+        g_evict[i]++;
+}
+
+struct Result
+{
+    double  medianNs;
+    double  meanNs;
+    int     bytes;
+    int     pieces;
+    int     stale;  // used variables that didn't get the latest tick
+};
+
+static Result run( int ticks, bool cold, int& tick )
+{
+    irsdkClient& client = irsdkClient::instance();
+    std::vector<double> ns;
+    ns.reserve( ticks );
+
+    Result r = {};
+    for( int i=0; i<ticks; ++i )
+    {
+        produceTick( ++tick );
+        if( cold )
+            evictCaches();
+
+        const Clock::time_point t0 = Clock::now();
+        client.waitForData( 0 );
+        ns.push_back( (double)std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - t0 ).count() );
+
+        // every variable the overlays read has to be from this tick
+        const char* data = client.getData();
+        for( int v=0; v<NumSimVars; ++v )
+        {
+            if( !isUsed( SimVars[v] ) )
+                continue;
+            const int len = irsdk_VarTypeBytes[g_vars[v].type] * g_vars[v].count;
+            for( int b=0; b<len; ++b )
+            {
+                if( (unsigned char)data[g_vars[v].offset + b] != (unsigned char)(tick & 0xff) )
+                {
+                    r.stale++;
+                    break;
+                }
+            }
+        }
+    }
+
+    double sum = 0;
+    for( double x : ns )
+        sum += x;
+    std::nth_element( ns.begin(), ns.begin() + ns.size()/2, ns.end() );
+
+    r.medianNs = ns[ns.size()/2];
+    r.meanNs = sum / ns.size();
+    r.bytes = client.getCopyBytes();
+    r.pieces = client.getCopyRangeCount();
+    return r;
+}
+
+static void print( const char* name, const Result& r )
+{
+    printf( "%-22s %6d bytes in %3d pieces   median %7.0f ns   mean %7.0f ns   stale %d\n", name, r.bytes, r.pieces, r.medianNs, r.meanNs, r.stale );
+}
+
+int main( int argc, char** argv )
+{
+    int  ticks = 0;
+    bool cold = false;
+
+    for( int i=1; i<argc; ++i )
+    {
+        if( !strcmp( argv[i], "--ticks" ) && i+1<argc )
+            ticks = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--cold" ) )
+            cold = true;
+        else if( !strcmp( argv[i], "--no-caridx" ) )
+            g_noCarIdx = true;
+        else
+        {
+            printf( "usage: copybench [--ticks N] [--cold] [--no-caridx]\n" );
+            return 1;
+        }
+    }
+    if( ticks <= 0 )
+        ticks = cold ? 2000 : 50000;
+    if( cold )
+        g_evict.assign( 32 * 1024 * 1024, 0 );
+
+    setupFakeSim();
+
+    // like iRon: a handle for every variable, only some of which get read. They live as long as the process.
+    int numUsed = 0;
+    for( int i=0; i<NumSimVars; ++i )
+    {
+        const SimVar& fv = SimVars[i];
+        switch( fv.type )
+        {
+        case irsdk_bool:   makeVar<bool>( fv ); break;
+        case irsdk_int:    makeVar<int>( fv ); break;
+        case irsdk_float:  makeVar<float>( fv ); break;
+        case irsdk_double: makeVar<double>( fv ); break;
+        }
+        numUsed += isUsed( fv );
+    }
+
+    // connect: the first ticks only set up the connection and the data buffer
+    irsdkClient& client = irsdkClient::instance();
+    int tick = 0;
+    while( !client.getData() || !client.isConnected() )
+    {
+        produceTick( ++tick );
+        client.waitForData( 0 );
+    }
+    irsdkVarBase::resolveAll();
+
+    printf( "%d variables, %d used, %d bytes per row, %d ticks%s\n\n", NumSimVars, numUsed, g_header.bufLen, ticks, cold ? ", cold caches" : "" );
+
+    client.setCopySubscribedOnly( false );
+    const Result full = run( ticks, cold, tick );
+    print( "full row", full );
+
+    const int gaps[] = { 0, 64, 256 };
+    int failed = full.stale;
+    for( int gap : gaps )
+    {
+        client.setCopySubscribedOnly( true );
+        irsdkVarBase::setCopyMergeGap( gap );
+        irsdkVarBase::resolveAll();
+
+        char name[64];
+        sprintf( name, "subscribed, gap %d", gap );
+        const Result r = run( ticks, cold, tick );
+        print( name, r );
+        failed += r.stale;
+    }
+
+    if( failed )
+    {
+        printf( "\nFAILED: %d stale reads\n", failed );
+        return 1;
+    }
+    return 0;
+}
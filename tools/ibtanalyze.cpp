@@ -0,0 +1,1038 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//
+// Batch .ibt analyzer.
+//
+// Goes through a folder of telemetry files, the sim's or iRon's own recordings, and writes a table
+// with lap times, best sectors, fuel per lap and stints for every one of them:
+//
+//   cl /O2 /EHsc /DNDEBUG tools\ibtanalyze.cpp irsdk\yaml_parser.cpp
+//   ibtanalyze <folder> [--threads N] [--csv file]
+//   ibtanalyze --make-corpus <folder> [files] [max laps]
+//   ibtanalyze --bench <folder>
+//
+// Every file is memory mapped and is a task of its own on a work stealing thread pool. Big files are
+// cut into chunks of records that get scanned for sector line crossings as tasks of their own, which
+// idle threads steal, and whichever finishes last strings the crossings together into laps.
+// Variables are found through the file's irsdk_varHeaders and the sectors, track and car come out of
+// the session string through parseYaml(), the same as iRon does it with the sim.
+//
+// --make-corpus writes synthetic races of all lengths to benchmark with, --bench analyzes a folder
+// with 1, 2, 4... threads up to the number of cores and shows how it scales.
+//
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/yaml_parser.h"
+
+typedef std::chrono::steady_clock Clock;
+
+// records scanned per task in big files, about 18 minutes at 60 Hz
+static const int ChunkRecords = 65536;
+
+//
+// Memory mapped input
+//
+
+class MappedFile
+{
+public:
+    MappedFile() : m_data(NULL), m_size(0) {}
+    ~MappedFile() { close(); }
+
+    bool open( const std::string& path )
+    {
+        close();
+#ifdef _WIN32
+        HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+        if( file == INVALID_HANDLE_VALUE )
+            return false;
+        LARGE_INTEGER size;
+        HANDLE mapping = NULL;
+        if( GetFileSizeEx( file, &size ) && size.QuadPart > 0 )
+            mapping = CreateFileMapping( file, NULL, PAGE_READONLY, 0, 0, NULL );
+        CloseHandle( file );
+        if( !mapping )
+            return false;
+        m_data = (const char*)MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+        CloseHandle( mapping );
+        m_size = (size_t)size.QuadPart;
+#else
+        const int fd = ::open( path.c_str(), O_RDONLY );
+        if( fd < 0 )
+            return false;
+        struct stat st;
+        void* p = MAP_FAILED;
+        if( fstat( fd, &st ) == 0 && st.st_size > 0 )
+            p = mmap( NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+        ::close( fd );
+        if( p == MAP_FAILED )
+            return false;
+        // read front to back
+        madvise( p, (size_t)st.st_size, MADV_SEQUENTIAL );
+        m_data = (const char*)p;
+        m_size = (size_t)st.st_size;
+#endif
+        return m_data != NULL;
+    }
+
+    void close()
+    {
+        if( m_data )
+        {
+#ifdef _WIN32
+            UnmapViewOfFile( m_data );
+#else
+            munmap( (void*)m_data, m_size );
+#endif
+        }
+        m_data = NULL;
+        m_size = 0;
+    }
+
+    const char* data() const { return m_data; }
+    size_t      size() const { return m_size; }
+
+private:
+    const char* m_data;
+    size_t      m_size;
+};
+
+static std::vector<std::string> listIbtFiles( const std::string& folder )
+{
+    std::vector<std::string> files;
+#ifdef _WIN32
+    WIN32_FIND_DATAA fd;
+    HANDLE find = FindFirstFileA( (folder + "\\*.ibt").c_str(), &fd );
+    if( find != INVALID_HANDLE_VALUE )
+    {
+        do
+        {
+            if( !(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) )
+                files.push_back( folder + "\\" + fd.cFileName );
+        } while( FindNextFileA( find, &fd ) );
+        FindClose( find );
+    }
+#else
+    if( DIR* dir = opendir( folder.c_str() ) )
+    {
+        while( dirent* e = readdir( dir ) )
+        {
+            const size_t len = strlen( e->d_name );
+            if( len > 4 && !strcmp( e->d_name + len - 4, ".ibt" ) )
+                files.push_back( folder + "/" + e->d_name );
+        }
+        closedir( dir );
+    }
+#endif
+    std::sort( files.begin(), files.end() );
+    return files;
+}
+
+//
+// Work stealing thread pool
+//
+// Every worker has a deque of its own. It takes its newest task off the back, and when it runs out
+// it steals the oldest off the front of somebody else's, which tends to be the biggest piece of work
+// left. Tasks submitted from a worker go on its own deque, from outside they're dealt out in turn.
+//
+
+class WorkStealingPool
+{
+public:
+    typedef std::function<void()> Task;
+
+    explicit WorkStealingPool( int numThreads )
+        : m_queued(0)
+        , m_pending(0)
+        , m_next(0)
+        , m_steals(0)
+        , m_quit(false)
+    {
+        for( int i=0; i<numThreads; ++i )
+            m_workers.emplace_back( new Worker() );
+        for( int i=0; i<numThreads; ++i )
+            m_threads.emplace_back( &WorkStealingPool::run, this, i );
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock( m_idleMutex );
+            m_quit = true;
+        }
+        m_idle.notify_all();
+        for( std::thread& t : m_threads )
+            t.join();
+    }
+
+    void submit( Task task )
+    {
+        const int self = t_pool == this ? t_self : (int)(m_next++ % m_workers.size());
+        {
+            std::lock_guard<std::mutex> lock( m_idleMutex );
+            m_pending++;
+        }
+        {
+            std::lock_guard<std::mutex> lock( m_workers[self]->mutex );
+            m_workers[self]->tasks.push_back( std::move( task ) );
+        }
+        {
+            std::lock_guard<std::mutex> lock( m_idleMutex );
+            m_queued++;
+        }
+        m_idle.notify_one();
+    }
+
+    // until every task is done, along with the ones they submitted
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock( m_idleMutex );
+        m_done.wait( lock, [this]{ return m_pending == 0; } );
+    }
+
+    int getSteals() const { return m_steals; }
+
+private:
+    struct Worker
+    {
+        std::mutex       mutex;
+        std::deque<Task> tasks;
+    };
+
+    bool take( int self, Task& task )
+    {
+        {
+            Worker& w = *m_workers[self];
+            std::lock_guard<std::mutex> lock( w.mutex );
+            if( !w.tasks.empty() )
+            {
+                task = std::move( w.tasks.back() );
+                w.tasks.pop_back();
+                return true;
+            }
+        }
+
+        const int n = (int)m_workers.size();
+        for( int i=1; i<n; ++i )
+        {
+            Worker& victim = *m_workers[(self + i) % n];
+            std::lock_guard<std::mutex> lock( victim.mutex );
+            if( !victim.tasks.empty() )
+            {
+                task = std::move( victim.tasks.front() );
+                victim.tasks.pop_front();
+                m_steals++;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run( int self )
+    {
+        t_pool = this;
+        t_self = self;
+
+        for( ;; )
+        {
+            {
+                std::unique_lock<std::mutex> lock( m_idleMutex );
+                m_idle.wait( lock, [this]{ return m_queued > 0 || m_quit; } );
+                if( m_quit )
+                    return;
+                m_queued--;
+            }
+
+            // there's a task for us somewhere, it may just not have landed in a deque yet
+            Task task;
+            while( !take( self, task ) )
+                std::this_thread::yield();
+            task();
+
+            std::lock_guard<std::mutex> lock( m_idleMutex );
+            if( --m_pending == 0 )
+                m_done.notify_all();
+        }
+    }
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread>             m_threads;
+    std::mutex                           m_idleMutex;
+    std::condition_variable              m_idle;
+    std::condition_variable              m_done;
+    int                                  m_queued;      // tasks nobody has claimed yet, under m_idleMutex
+    int                                  m_pending;     // tasks not done yet, under m_idleMutex
+    std::atomic<unsigned>                m_next;
+    std::atomic<int>                     m_steals;
+    bool                                 m_quit;
+
+    static thread_local WorkStealingPool* t_pool;
+    static thread_local int               t_self;
+};
+
+thread_local WorkStealingPool* WorkStealingPool::t_pool = NULL;
+thread_local int               WorkStealingPool::t_self = 0;
+
+//
+// Analysis
+//
+
+// a car crossing one of the sector lines, or turning onto or off pit road
+struct Event
+{
+    enum Type { Sector, PitIn, PitOut };
+
+    Type   type;
+    int    sector;      // 0 is the start/finish line
+    double time;
+    float  fuel;
+};
+
+struct Stint
+{
+    int    laps;
+    double bestLap;
+    double totalLapTime;
+};
+
+struct Summary
+{
+    std::string         track;
+    std::string         car;
+    std::string         driver;
+    int                 records;
+    double              duration;
+    int                 laps;           // timed, between two start/finish crossings
+    double              bestLap;
+    double              meanLap;
+    double              fuelPerLap;     // over green laps that didn't see the pits
+    int                 fuelLaps;
+    std::vector<double> bestSectors;
+    std::vector<Stint>  stints;
+};
+
+struct FileJob
+{
+    std::string              path;
+    std::string              error;
+    MappedFile               map;
+    const irsdk_header*      header;
+    const char*              rows;
+    int                      records;
+
+    // offsets into a row, -1 if the file doesn't have it
+    int                      sessionTime;
+    int                      lapDistPct;
+    int                      fuelLevel;
+    int                      onPitRoad;
+
+    std::vector<float>               sectorStarts;
+    std::vector<std::vector<Event>>  parts;     // crossings found by each chunk
+    std::atomic<int>                 partsLeft;
+    Summary                          summary;
+};
+
+static std::string yamlString( const char* session, const char* path )
+{
+    const char* val;
+    int len;
+    if( !parseYaml( session, path, &val, &len ) )
+        return "";
+    while( len > 0 && val[len-1] == ' ' )
+        len--;
+    return std::string( val, len );
+}
+
+static int varOffset( const irsdk_header* h, const char* data, const char* name, int type )
+{
+    const irsdk_varHeader* vars = (const irsdk_varHeader*)(data + h->varHeaderOffset);
+    for( int i=0; i<h->numVars; ++i )
+        if( vars[i].type == type && !strncmp( vars[i].name, name, IRSDK_MAX_STRING ) )
+            return vars[i].offset;
+    return -1;
+}
+
+template<typename T>
+static T rowValue( const FileJob& job, int record, int offset )
+{
+    T v;
+    memcpy( &v, job.rows + (size_t)record * job.header->bufLen + offset, sizeof(v) );
+    return v;
+}
+
+// checks the file and finds what the analysis needs in it, false if it can't be analyzed
+static bool prepare( FileJob& job )
+{
+    if( !job.map.open( job.path ) )
+    {
+        job.error = "can't map";
+        return false;
+    }
+
+    const char* data = job.map.data();
+    const size_t size = job.map.size();
+    const irsdk_header* h = (const irsdk_header*)data;
+    if( size < sizeof(irsdk_header) + sizeof(irsdk_diskSubHeader) || h->numVars <= 0 || h->bufLen <= 0 ||
+        h->varHeaderOffset < 0 || (size_t)h->varHeaderOffset + (size_t)h->numVars * sizeof(irsdk_varHeader) > size ||
+        h->sessionInfoOffset < 0 || h->sessionInfoLen <= 0 || (size_t)h->sessionInfoOffset + h->sessionInfoLen > size ||
+        h->varBuf[0].bufOffset <= 0 || (size_t)h->varBuf[0].bufOffset > size )
+    {
+        job.error = "not a telemetry file";
+        return false;
+    }
+
+    const irsdk_diskSubHeader* sub = (const irsdk_diskSubHeader*)(data + sizeof(irsdk_header));
+    job.header = h;
+    job.rows = data + h->varBuf[0].bufOffset;
+    job.records = (int)std::min( (size - h->varBuf[0].bufOffset) / h->bufLen, (size_t)INT_MAX );
+    if( sub->sessionRecordCount > 0 && sub->sessionRecordCount < job.records )
+        job.records = sub->sessionRecordCount;
+
+    job.sessionTime = varOffset( h, data, "SessionTime", irsdk_double );
+    job.lapDistPct  = varOffset( h, data, "LapDistPct", irsdk_float );
+    job.fuelLevel   = varOffset( h, data, "FuelLevel", irsdk_float );
+    job.onPitRoad   = varOffset( h, data, "OnPitRoad", irsdk_bool );
+    if( job.sessionTime < 0 || job.lapDistPct < 0 )
+    {
+        job.error = "no SessionTime or LapDistPct";
+        return false;
+    }
+
+    // the session string isn't necessarily terminated within its room
+    const std::string session( data + h->sessionInfoOffset, strnlen( data + h->sessionInfoOffset, h->sessionInfoLen ) );
+    char path[128];
+    for( int s=0; ; ++s )
+    {
+        sprintf( path, "SplitTimeInfo:Sectors:SectorNum:{%d}SectorStartPct:", s );
+        const std::string pct = yamlString( session.c_str(), path );
+        if( pct.empty() )
+            break;
+        job.sectorStarts.push_back( (float)atof( pct.c_str() ) );
+    }
+    if( job.sectorStarts.empty() || job.sectorStarts[0] != 0 )
+        job.sectorStarts.insert( job.sectorStarts.begin(), 0.0f );
+
+    Summary& sum = job.summary;
+    sum.track = yamlString( session.c_str(), "WeekendInfo:TrackDisplayName:" );
+    const std::string carIdx = yamlString( session.c_str(), "DriverInfo:DriverCarIdx:" );
+    sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarScreenName:", atoi( carIdx.c_str() ) );
+    sum.car = yamlString( session.c_str(), path );
+    sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}UserName:", atoi( carIdx.c_str() ) );
+    sum.driver = yamlString( session.c_str(), path );
+    sum.records = job.records;
+    return true;
+}
+
+// Sector line crossings and pit road turns between the records in [first, last), one record of the
+// chunk before included. Crossings are interpolated between the two records they happen between.
+static void scan( const FileJob& job, int first, int last, std::vector<Event>& events )
+{
+    const std::vector<float>& sectors = job.sectorStarts;
+    const int numSectors = (int)sectors.size();
+
+    for( int i=std::max( first, 1 ); i<last; ++i )
+    {
+        const double t0 = rowValue<double>( job, i-1, job.sessionTime );
+        const double t1 = rowValue<double>( job, i, job.sessionTime );
+        const float  p0 = rowValue<float>( job, i-1, job.lapDistPct );
+        const float  p1 = rowValue<float>( job, i, job.lapDistPct );
+
+        if( job.onPitRoad >= 0 )
+        {
+            const bool pit0 = rowValue<bool>( job, i-1, job.onPitRoad );
+            const bool pit1 = rowValue<bool>( job, i, job.onPitRoad );
+            if( pit0 != pit1 )
+            {
+                Event e = { pit1 ? Event::PitIn : Event::PitOut, -1, t1, 0 };
+                events.push_back( e );
+            }
+        }
+
+        // off the track, towed, or a new session
+        if( p0 < 0 || p1 < 0 || t1 <= t0 || t1 - t0 > 1.0 )
+            continue;
+
+        float dist;
+        if( p1 >= p0 && p1 - p0 < 0.5f )
+            dist = p1 - p0;
+        else if( p0 > 0.75f && p1 < 0.25f )
+            dist = 1.0f - p0 + p1;      // over the start/finish line
+        else
+            continue;
+        if( dist <= 0 )
+            continue;
+
+        const float fuel0 = job.fuelLevel >= 0 ? rowValue<float>( job, i-1, job.fuelLevel ) : 0;
+        const float fuel1 = job.fuelLevel >= 0 ? rowValue<float>( job, i, job.fuelLevel ) : 0;
+
+        // every line in (p0, p1], in the order they're crossed
+        const size_t crossed = events.size();
+        for( int s=0; s<numSectors; ++s )
+        {
+            float along = sectors[s] - p0;
+            if( along <= 0 )
+                along += 1.0f;
+            if( along > dist )
+                continue;
+
+            const double f = along / dist;
+            Event e = { Event::Sector, s, t0 + f * (t1 - t0), (float)(fuel0 + f * (fuel1 - fuel0)) };
+            events.push_back( e );
+        }
+        std::sort( events.begin() + crossed, events.end(), []( const Event& a, const Event& b ) { return a.time < b.time; } );
+    }
+}
+
+// Strings the crossings of all the chunks together into laps, sectors and stints
+static void summarize( FileJob& job )
+{
+    Summary& sum = job.summary;
+    const int numSectors = (int)job.sectorStarts.size();
+    sum.bestSectors.assign( numSectors, 0 );
+
+    sum.duration = job.records > 1 ? rowValue<double>( job, job.records-1, job.sessionTime ) - rowValue<double>( job, 0, job.sessionTime ) : 0;
+
+    const Event* prev = NULL;       // last crossing, NULL after anything that breaks the lap up
+    const Event* lapStart = NULL;
+    int          sectorsInLap = 0;
+    bool         pittedInLap = false;
+    double       fuelUsed = 0;
+    Stint        stint = {};
+
+    auto endStint = [&]()
+    {
+        if( stint.laps )
+            sum.stints.push_back( stint );
+        stint = Stint();
+    };
+
+    for( const std::vector<Event>& part : job.parts )
+    {
+        for( const Event& e : part )
+        {
+            if( e.type != Event::Sector )
+            {
+                // laps through the pits are timed, but don't count for fuel, and a stint ends on the way in
+                pittedInLap = true;
+                if( e.type == Event::PitIn )
+                    endStint();
+                continue;
+            }
+
+            // a sector is timed from one line to the next, otherwise a gap broke it up
+            const bool inSequence = prev && e.sector == (prev->sector + 1) % numSectors && e.time > prev->time;
+            if( inSequence )
+            {
+                const int    s = prev->sector;
+                const double t = e.time - prev->time;
+                if( !sum.bestSectors[s] || t < sum.bestSectors[s] )
+                    sum.bestSectors[s] = t;
+                sectorsInLap++;
+            }
+            else
+            {
+                lapStart = NULL;
+            }
+
+            if( e.sector == 0 )
+            {
+                if( lapStart && sectorsInLap == numSectors )
+                {
+                    const double t = e.time - lapStart->time;
+                    sum.laps++;
+                    sum.meanLap += t;
+                    if( !sum.bestLap || t < sum.bestLap )
+                        sum.bestLap = t;
+
+                    stint.laps++;
+                    stint.totalLapTime += t;
+                    if( !stint.bestLap || t < stint.bestLap )
+                        stint.bestLap = t;
+
+                    if( !pittedInLap && job.fuelLevel >= 0 && lapStart->fuel > e.fuel )
+                    {
+                        fuelUsed += lapStart->fuel - e.fuel;
+                        sum.fuelLaps++;
+                    }
+                }
+                lapStart = &e;
+                sectorsInLap = 0;
+                pittedInLap = false;
+            }
+            prev = &e;
+        }
+    }
+    endStint();
+
+    if( sum.laps )
+        sum.meanLap /= sum.laps;
+    if( sum.fuelLaps )
+        sum.fuelPerLap = fuelUsed / sum.fuelLaps;
+}
+
+static void finishPart( FileJob& job )
+{
+    if( --job.partsLeft > 0 )
+        return;
+
+    summarize( job );
+    job.parts.clear();
+    job.map.close();
+}
+
+static void analyze( WorkStealingPool& pool, FileJob& job )
+{
+    if( !prepare( job ) )
+    {
+        job.map.close();
+        return;
+    }
+
+    // big files go in chunks for idle threads to pick up
+    const int numParts = std::max( 1, (job.records + ChunkRecords - 1) / ChunkRecords );
+    job.parts.resize( numParts );
+    job.partsLeft = numParts;
+
+    for( int p=1; p<numParts; ++p )
+    {
+        pool.submit( [&job, p]()
+        {
+            scan( job, p * ChunkRecords, std::min( job.records, (p + 1) * ChunkRecords ), job.parts[p] );
+            finishPart( job );
+        } );
+    }
+
+    scan( job, 0, std::min( job.records, ChunkRecords ), job.parts[0] );
+    finishPart( job );
+}
+
+// every file in the folder, returns the seconds it took
+static double analyzeAll( const std::vector<std::string>& files, int numThreads, std::vector<std::unique_ptr<FileJob>>& jobs, int* steals )
+{
+    jobs.clear();
+    for( const std::string& f : files )
+    {
+        jobs.emplace_back( new FileJob() );
+        jobs.back()->path = f;
+    }
+
+    const Clock::time_point t0 = Clock::now();
+    {
+        WorkStealingPool pool( numThreads );
+        for( std::unique_ptr<FileJob>& job : jobs )
+        {
+            FileJob* j = job.get();
+            pool.submit( [&pool, j]() { analyze( pool, *j ); } );
+        }
+        pool.wait();
+        if( steals )
+            *steals = pool.getSteals();
+    }
+    return std::chrono::duration<double>( Clock::now() - t0 ).count();
+}
+
+//
+// Output
+//
+
+static std::string lapTimeStr( double t )
+{
+    if( t <= 0 )
+        return "-";
+    char s[32];
+    sprintf( s, "%d:%06.3f", (int)(t / 60), fmod( t, 60.0 ) );
+    return s;
+}
+
+static std::string baseName( const std::string& path )
+{
+    const size_t slash = path.find_last_of( "/\\" );
+    return slash == std::string::npos ? path : path.substr( slash + 1 );
+}
+
+static void printTable( const std::vector<std::unique_ptr<FileJob>>& jobs )
+{
+    printf( "%-32s %-24s %-20s %5s %10s %10s %10s %8s  %-26s %s\n", "file", "track", "car", "laps", "best", "mean", "theory", "fuel/lap", "best sectors", "stints (laps, best)" );
+    for( const std::unique_ptr<FileJob>& job : jobs )
+    {
+        const Summary& s = job->summary;
+        if( !job->error.empty() )
+        {
+            printf( "%-32s %s\n", baseName( job->path ).c_str(), job->error.c_str() );
+            continue;
+        }
+
+        double theory = 0;
+        std::string sectors;
+        for( double t : s.bestSectors )
+        {
+            char buf[16];
+            if( t > 0 )
+                sprintf( buf, "%s%.3f", sectors.empty() ? "" : " ", t );
+            else
+                sprintf( buf, "%s-", sectors.empty() ? "" : " " );
+            sectors += buf;
+            theory = theory >= 0 && t > 0 ? theory + t : -1;
+        }
+
+        std::string stints;
+        for( const Stint& st : s.stints )
+        {
+            char buf[48];
+            sprintf( buf, "%s%d %s", stints.empty() ? "" : ", ", st.laps, lapTimeStr( st.bestLap ).c_str() );
+            stints += buf;
+        }
+
+        char fuel[16] = "-";
+        if( s.fuelLaps )
+            sprintf( fuel, "%.3f", s.fuelPerLap );
+
+        printf( "%-32s %-24.24s %-20.20s %5d %10s %10s %10s %8s  %-26s %s\n", baseName( job->path ).c_str(), s.track.c_str(), s.car.c_str(), s.laps,
+                lapTimeStr( s.bestLap ).c_str(), lapTimeStr( s.meanLap ).c_str(), lapTimeStr( theory ).c_str(), fuel, sectors.c_str(), stints.c_str() );
+    }
+}
+
+static bool writeCsv( const char* path, const std::vector<std::unique_ptr<FileJob>>& jobs )
+{
+    FILE* f = fopen( path, "w" );
+    if( !f )
+        return false;
+
+    fprintf( f, "file,track,car,driver,records,duration,laps,best_lap,mean_lap,fuel_per_lap,fuel_laps,best_sectors,stints,error\n" );
+    for( const std::unique_ptr<FileJob>& job : jobs )
+    {
+        const Summary& s = job->summary;
+        std::string sectors, stints;
+        for( double t : s.bestSectors )
+        {
+            char buf[16];
+            sprintf( buf, "%s%.3f", sectors.empty() ? "" : " ", t );
+            sectors += buf;
+        }
+        for( const Stint& st : s.stints )
+        {
+            char buf[64];
+            sprintf( buf, "%s%d/%.3f/%.3f", stints.empty() ? "" : " ", st.laps, st.bestLap, st.totalLapTime / st.laps );
+            stints += buf;
+        }
+        fprintf( f, "\"%s\",\"%s\",\"%s\",\"%s\",%d,%.3f,%d,%.3f,%.3f,%.4f,%d,%s,%s,%s\n", baseName( job->path ).c_str(), s.track.c_str(), s.car.c_str(), s.driver.c_str(),
+                 s.records, s.duration, s.laps, s.bestLap, s.meanLap, s.fuelPerLap, s.fuelLaps, sectors.c_str(), stints.c_str(), job->error.c_str() );
+    }
+    return fclose( f ) == 0;
+}
+
+//
+// Synthetic corpus
+//
+
+struct SynthVar
+{
+    const char* name;
+    int         type;
+    int         count;
+};
+
+static const SynthVar SynthVars[] = {
+    { "SessionTime", irsdk_double, 1 },
+    { "SessionTick", irsdk_int, 1 },
+    { "Lap", irsdk_int, 1 },
+    { "LapDistPct", irsdk_float, 1 },
+    { "FuelLevel", irsdk_float, 1 },
+    { "OnPitRoad", irsdk_bool, 1 },
+    { "Speed", irsdk_float, 1 },
+    { "RPM", irsdk_float, 1 },
+    { "Throttle", irsdk_float, 1 },
+    { "Brake", irsdk_float, 1 },
+    { "SteeringWheelAngle", irsdk_float, 1 },
+    { "CarIdxLapDistPct", irsdk_float, 64 },
+    { "CarIdxPosition", irsdk_int, 64 },
+    { "CarIdxTrackSurface", irsdk_int, 64 },
+};
+
+// A stint race at 60 Hz: laps of about 90 s, a pit stop with fuel every 20 laps
+static bool makeSyntheticIbt( const std::string& path, int laps, unsigned seed )
+{
+    const int numVars = sizeof(SynthVars) / sizeof(SynthVars[0]);
+    std::vector<irsdk_varHeader> vars( numVars );
+    int bufLen = 0;
+    for( int i=0; i<numVars; ++i )
+    {
+        vars[i].clear();
+        strcpy( vars[i].name, SynthVars[i].name );
+        vars[i].type = SynthVars[i].type;
+        vars[i].count = SynthVars[i].count;
+        vars[i].offset = bufLen;
+        bufLen += irsdk_VarTypeBytes[vars[i].type] * vars[i].count;
+    }
+    auto offsetOf = [&]( int i ) { return vars[i].offset; };
+
+    char session[1024];
+    memset( session, 0, sizeof(session) );
+    snprintf( session, sizeof(session),
+        "---\nWeekendInfo:\n TrackDisplayName: Synthetic Raceway %u\n\nDriverInfo:\n DriverCarIdx: 0\n Drivers:\n"
+        " - CarIdx: 0\n   UserName: Driver %u\n   CarScreenName: Synthetic GT\n\n"
+        "SplitTimeInfo:\n Sectors:\n - SectorNum: 0\n   SectorStartPct: 0.000000\n - SectorNum: 1\n   SectorStartPct: 0.331000\n"
+        " - SectorNum: 2\n   SectorStartPct: 0.702000\n\n...\n", seed % 7, seed );
+
+    irsdk_header h;
+    memset( &h, 0, sizeof(h) );
+    h.ver = IRSDK_VER;
+    h.tickRate = 60;
+    h.numVars = numVars;
+    h.varHeaderOffset = sizeof(irsdk_header) + sizeof(irsdk_diskSubHeader);
+    h.sessionInfoOffset = h.varHeaderOffset + numVars * (int)sizeof(irsdk_varHeader);
+    h.sessionInfoLen = sizeof(session);
+    h.numBuf = 1;
+    h.bufLen = bufLen;
+    h.varBuf[0].bufOffset = h.sessionInfoOffset + h.sessionInfoLen;
+
+    FILE* f = fopen( path.c_str(), "wb" );
+    if( !f )
+        return false;
+
+    irsdk_diskSubHeader sub;
+    memset( &sub, 0, sizeof(sub) );
+    fwrite( &h, sizeof(h), 1, f );
+    fwrite( &sub, sizeof(sub), 1, f );
+    fwrite( vars.data(), sizeof(irsdk_varHeader), numVars, f );
+    fwrite( session, sizeof(session), 1, f );
+
+    srand( seed );
+    std::vector<char> row( bufLen, 0 );
+    auto put = [&]( int var, int entry, const void* v ) { memcpy( &row[offsetOf( var ) + entry * irsdk_VarTypeBytes[vars[var].type]], v, irsdk_VarTypeBytes[vars[var].type] ); };
+
+    const double baseLap = 88.0 + seed % 5;
+    double lapTime = baseLap;
+    float  pct = 0.9f, fuel = 60.0f;
+    int    lap = 0, tick = 0, pitTicks = 0;
+    bool   pit = false;
+    while( lap < laps )
+    {
+        const double t = tick / 60.0;
+
+        // slower through the corners
+        const double speed = 1.0 + 0.3 * sin( pct * 6.2832 * 4 );
+        if( pitTicks > 0 )
+        {
+            // stopped in the box, filling up
+            pitTicks--;
+            fuel = std::min( 60.0f, fuel + 0.05f );
+        }
+        else
+        {
+            const float step = (float)(speed / (lapTime * 60.0));
+            pct += step * (pit ? 0.5f : 1.0f);
+            fuel -= 2.3f * step;
+            if( pit && pct > 0.02f && pct < 0.5f && !pitTicks && fuel < 59.0f )
+                pitTicks = 25 * 60;
+            if( pct >= 1.0f )
+            {
+                pct -= 1.0f;
+                lap++;
+                lapTime = baseLap + (rand() % 2000) / 1000.0 - 0.5;
+            }
+            // in the pits from the end of every 20th lap to the start of the next one
+            pit = (lap % 20 == 19 && pct > 0.95f) || (lap % 20 == 0 && lap && pct < 0.05f);
+        }
+
+        const int   lapNum = lap;
+        const bool  onPitRoad = pit;
+        const float spd = (float)(speed * 50.0), rpm = 5000.0f + 2000.0f * (float)speed, throttle = (float)(speed - 0.7), brake = 0.0f, steer = (float)sin( t );
+        put( 0, 0, &t );
+        put( 1, 0, &tick );
+        put( 2, 0, &lapNum );
+        put( 3, 0, &pct );
+        put( 4, 0, &fuel );
+        put( 5, 0, &onPitRoad );
+        put( 6, 0, &spd );
+        put( 7, 0, &rpm );
+        put( 8, 0, &throttle );
+        put( 9, 0, &brake );
+        put( 10, 0, &steer );
+        for( int c=0; c<64; ++c )
+        {
+            const float cp = c < 30 ? fmodf( pct + c * 0.031f, 1.0f ) : -1.0f;
+            const int   pos = c < 30 ? c + 1 : 0;
+            const int   surface = c < 30 ? 3 : -1;
+            put( 11, c, &cp );
+            put( 12, c, &pos );
+            put( 13, c, &surface );
+        }
+        fwrite( row.data(), bufLen, 1, f );
+        tick++;
+    }
+
+    sub.sessionStartTime = 0;
+    sub.sessionEndTime = (tick - 1) / 60.0;
+    sub.sessionLapCount = lap;
+    sub.sessionRecordCount = tick;
+    fseek( f, sizeof(h), SEEK_SET );
+    fwrite( &sub, sizeof(sub), 1, f );
+    return fclose( f ) == 0;
+}
+
+static int makeCorpus( const std::string& folder, int files, int maxLaps )
+{
+    long long bytes = 0;
+    for( int i=0; i<files; ++i )
+    {
+        // mostly short sessions, a few long races
+        const int laps = i % 5 == 4 ? maxLaps : 3 + (i * 7) % std::max( 1, maxLaps / 3 );
+        char name[64];
+        sprintf( name, "/synthetic_%03d.ibt", i );
+        if( !makeSyntheticIbt( folder + name, laps, 1000 + i ) )
+        {
+            printf( "Can't write %s%s\n", folder.c_str(), name );
+            return 1;
+        }
+        MappedFile m;
+        if( m.open( folder + name ) )
+            bytes += m.size();
+    }
+    printf( "%d files, %.1f MB\n", files, bytes / 1048576.0 );
+    return 0;
+}
+
+//
+// Main
+//
+
+static long long totalBytes( const std::vector<std::string>& files )
+{
+    long long bytes = 0;
+    for( const std::string& f : files )
+    {
+        MappedFile m;
+        if( m.open( f ) )
+            bytes += m.size();
+    }
+    return bytes;
+}
+
+static int bench( const std::string& folder )
+{
+    const std::vector<std::string> files = listIbtFiles( folder );
+    if( files.empty() )
+    {
+        printf( "No .ibt files in %s\n", folder.c_str() );
+        return 1;
+    }
+
+    const double mb = totalBytes( files ) / 1048576.0;
+    const int cores = std::max( 1, (int)std::thread::hardware_concurrency() );
+    printf( "%d files, %.1f MB, %d cores\n\n", (int)files.size(), mb, cores );
+
+    // once to get the files into the page cache
+    std::vector<std::unique_ptr<FileJob>> jobs;
+    analyzeAll( files, cores, jobs, NULL );
+
+    double single = 0;
+    for( int threads=1; ; threads = std::min( threads * 2, cores ) )
+    {
+        double best = 1e30;
+        int steals = 0;
+        for( int rep=0; rep<3; ++rep )
+            best = std::min( best, analyzeAll( files, threads, jobs, &steals ) );
+        if( threads == 1 )
+            single = best;
+
+        printf( "%3d threads  %8.1f ms  %8.0f MB/s  speedup %5.2f  efficiency %3.0f%%  steals %d\n", threads, best * 1000, mb / best, single / best, 100 * single / best / threads, steals );
+        if( threads == cores )
+            break;
+    }
+    return 0;
+}
+
+int main( int argc, char** argv )
+{
+    if( argc >= 3 && !strcmp( argv[1], "--make-corpus" ) )
+        return makeCorpus( argv[2], argc > 3 ? atoi( argv[3] ) : 24, argc > 4 ? atoi( argv[4] ) : 30 );
+    if( argc >= 3 && !strcmp( argv[1], "--bench" ) )
+        return bench( argv[2] );
+
+    if( argc < 2 || argv[1][0] == '-' )
+    {
+        printf( "usage: ibtanalyze <folder> [--threads N] [--csv file]\n"
+                "       ibtanalyze --make-corpus <folder> [files] [max laps]\n"
+                "       ibtanalyze --bench <folder>\n" );
+        return 1;
+    }
+
+    int threads = std::max( 1, (int)std::thread::hardware_concurrency() );
+    const char* csv = NULL;
+    for( int i=2; i<argc; ++i )
+    {
+        if( !strcmp( argv[i], "--threads" ) && i+1<argc )
+            threads = std::max( 1, atoi( argv[++i] ) );
+        else if( !strcmp( argv[i], "--csv" ) && i+1<argc )
+            csv = argv[++i];
+    }
+
+    const std::vector<std::string> files = listIbtFiles( argv[1] );
+    if( files.empty() )
+    {
+        printf( "No .ibt files in %s\n", argv[1] );
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<FileJob>> jobs;
+    const double secs = analyzeAll( files, threads, jobs, NULL );
+    printTable( jobs );
+    printf( "\n%d files in %.2f s on %d threads\n", (int)files.size(), secs, threads );
+
+    if( csv && !writeCsv( csv, jobs ) )
+    {
+        printf( "Can't write %s\n", csv );
+        return 1;
+    }
+    return 0;
+}
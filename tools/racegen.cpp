@@ -0,0 +1,1429 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//
+// Synthetic race generator.
+//
+// Simulates a whole race and writes it to an .ibt file: grid, pace lap, start, laps with pace noise,
+// pit stops, cautions with the pace car out and a restart, drivers leaving and joining, tows, incidents
+// and the checkered flag, for up to 63 cars plus the pace car in up to four classes.
+// Every row has all the variables from simvars.h, and the session string changes along with the race,
+// results a couple of seconds after cars cross the line, drivers as soon as they come or go.
+//
+// The rows and session strings go into memory laid out like the sim's, served as an irsdk_source,
+// and irsdkRecorder records them, so the file is exactly what recording the sim would give.
+// Play it back with iRon to see the overlays react, or time the tick with iRon --bench:
+//
+//   cl /O2 /EHsc /DNDEBUG tools\racegen.cpp irsdk\irsdk_recorder.cpp irsdk\irsdk_utils.cpp irsdk\irsdk_source_win.cpp irsdk\irsdk_snapshot.cpp
+//   racegen <file.ibt> [--cars N] [--classes N] [--laps N] [--lap-time S] [--hz N] [--seed N] [--player P]
+//                      [--cautions N] [--pits] [--tows N] [--churn N] [--incidents N] [--results-every S]
+//                      [--storm S] [--max-session] [--stress]
+//
+// --pits starts everyone with too little fuel to make it to the end. --churn is how many drivers leave
+// and how many join during the race. --storm rewrites the session string every tick for that many
+// seconds after the start and every restart, --max-session fills it up to the size of the sim's buffer and gives the
+// drivers names longer than iRon stores. --stress turns all of it up.
+// The same seed always gives the same race.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_recorder.h"
+#include "simvars.h"
+
+static const int    MaxCars = 64;               // including the pace car
+static const int    PaceCarIdx = 0;
+static const int    SessionInfoLen = 512 * 1024;
+static const double TrackLength = 4013.0;       // m
+static const int    QueueRows = 4096;
+
+static const double PitEntryPct = 0.93;
+static const double PitStallPct = 0.03;         // on the next lap
+static const double PitExitPct = 0.10;
+static const double PaceGap = 0.0035;           // laps between cars behind the pace car
+
+struct CarClass
+{
+    int         id;
+    const char* shortName;
+    const char* screenName;
+    const char* color;
+    int         relSpeed;
+    double      lapFactor;
+    double      fuelPerLap;     // l
+    double      tank;           // l
+};
+
+static const CarClass Classes[] =
+{
+    { 4029, "LMP2", "Synthetic LMP2", "0xffda59", 100, 1.00, 3.2,  75 },
+    { 2708, "GT3",  "Synthetic GT3",  "0x33ceff",  92, 1.07, 2.9, 100 },
+    { 4084, "GT4",  "Synthetic GT4",  "0x53ff77",  86, 1.13, 2.3,  90 },
+    { 4011, "TCR",  "Synthetic TCR",  "0xae6bff",  82, 1.18, 2.0,  60 },
+};
+static const int NumClasses = sizeof(Classes) / sizeof(Classes[0]);
+
+static const char* const FirstNames[] = { "Alex", "Sam", "Jamie", "Chris", "Robin", "Kim", "Max", "Toni", "Luca", "Noa",
+                                          "J\xc3\xbcrgen", "\xc5\x81ukasz", "S\xc3\xb8ren", "Jos\xc3\xa9", "Ren\xc3\xa9" };
+static const char* const LastNames[] = { "Smith", "Meyer", "Rossi", "Kowalski", "Jensen", "Garcia", "Tanaka", "Dubois", "Novak", "Silva",
+                                         "M\xc3\xbcller", "Nu\xc3\xb1" "ez", "Ekstr\xc3\xb6m", "\xc5\xa0imek", "\xc3\x96zt\xc3\xbcrk" };
+
+//
+// Options
+//
+
+struct Options
+{
+    int     cars = 24;
+    int     classes = 2;
+    int     laps = 10;
+    double  lapTime = 90;
+    int     hz = 60;
+    unsigned seed = 1;
+    int     player = 0;         // grid position, 0 for mid field
+    int     cautions = 1;
+    bool    pits = false;
+    int     tows = 1;
+    int     churn = 1;
+    int     incidents = 20;
+    double  resultsEvery = 2;
+    double  storm = 0;
+    bool    maxSession = false;
+};
+
+static Options g_opt;
+
+//
+// Random numbers, the same everywhere for the same seed
+//
+
+class Rng
+{
+    public:
+
+        explicit Rng( unsigned seed ) : m_gen( seed ) {}
+
+        double uniform() { return (m_gen() + 0.5) / 4294967296.0; }
+        double uniform( double lo, double hi ) { return lo + (hi - lo) * uniform(); }
+        int below( int n ) { return std::min( n - 1, (int)(uniform() * n) ); }
+
+        double normal()
+        {
+            const double u = uniform();
+            const double v = uniform();
+            return sqrt( -2.0 * log( u ) ) * cos( 6.283185307179586 * v );
+        }
+
+    private:
+
+        std::mt19937 m_gen;
+};
+
+//
+// Race model
+//
+
+enum Phase { PHASE_Gone, PHASE_Track, PHASE_PitLane, PHASE_PitStall, PHASE_Towing };
+
+struct SimCar
+{
+    Phase   phase = PHASE_Gone;
+    int     cls = 0;
+    char    name[160] = "";
+    char    team[160] = "";
+    int     userId = 0;
+    int     number = 0;
+    int     irating = 0;
+    int     licLevel = 0;
+    double  sr = 0;
+    int     incidents = 0;
+
+    double  skill = 1;          // lap time factor
+    double  lapNoise = 0;       // this lap's
+    double  dist = 0;           // laps driven, negative before the start
+    double  rate = 0;           // laps per second this tick
+    double  lapStartTime = -1;
+    float   lastLap = -1;
+    float   bestLap = -1;
+    int     bestLapNum = -1;
+    float   qualTime = 0;
+    int     gridPos = 0;
+
+    double  fuel = 0;
+    int     pitLap = INT_MAX;   // box at the end of this lap
+    bool    wantsPit = false;
+    double  phaseUntil = 0;
+    double  towTime = 0;
+    int     finishPos = 0;
+    int     lapsLed = 0;
+
+    int lap() const { return phase == PHASE_Gone ? -1 : (int)floor( dist ) + 1; }
+    int lapsCompleted() const { return phase == PHASE_Gone ? -1 : std::max( 0, (int)floor( dist ) ); }
+    double pct() const { return dist - floor( dist ); }
+};
+
+struct Race
+{
+    SimCar      cars[MaxCars];
+    double      t = 0;
+    int         tick = 0;
+    int         state = irsdk_StateGetInCar;
+    unsigned    flags = irsdk_startHidden;
+    int         paceMode = irsdk_PaceModeDoubleFileStart;
+    bool        pacing = true;          // pace car out, field lined up behind it
+    bool        paceCarIn = false;      // pace car pulled off, green at the line
+    int         cautionLapsLeft = 0;
+    int         cautionLeaderLap = 0;
+    double      cautionTime = -1;
+    double      greenTime = -1;
+    double      restartTime = -1;        // start, or the last restart
+    double      checkeredTime = -1;
+    double      coolDownTime = -1;
+    int         finishers = 0;
+    int         driverCarIdx = 1;
+    int         leaderIdx = -1;
+
+    // what's left to happen, times into the race
+    std::vector<double> cautionAt, towAt, leaveAt, joinAt, incidentAt;
+
+    // session string
+    bool        driversDirty = false;
+    bool        resultsDirty = false;
+    double      lastResultsTime = -1e9;
+    int         sessionVersions = 1;
+    int         maxSessionLen = 0;
+
+    // totals to report
+    int         numCautions = 0, numPitStops = 0, numTows = 0, numJoins = 0, numLeaves = 0, numIncidents = 0;
+};
+
+static Race g_race;
+static Rng  g_rng( 1 );
+
+static double classLapTime( int cls )
+{
+    return g_opt.lapTime * Classes[cls].lapFactor;
+}
+
+static bool isRacing( const SimCar& c )
+{
+    return c.phase != PHASE_Gone && c.finishPos == 0;
+}
+
+static void makeDriver( SimCar& c, int carIdx, int cls )
+{
+    c = SimCar();
+    c.cls = cls;
+    c.userId = 100000 + (int)(g_rng.uniform() * 800000);
+    c.number = 1 + carIdx + g_rng.below( 3 ) * 100;
+    c.irating = std::max( 350, (int)(1800 + 900 * g_rng.normal()) );
+    c.licLevel = 1 + g_rng.below( 20 );
+    c.sr = g_rng.uniform( 1.0, 4.99 );
+    c.skill = 1.0 + fabs( 0.006 * g_rng.normal() ) + (3000 - std::min( 3000, c.irating )) * 0.000004;
+
+    const char* first = FirstNames[g_rng.below( (int)(sizeof(FirstNames)/sizeof(FirstNames[0])) )];
+    const char* last = LastNames[g_rng.below( (int)(sizeof(LastNames)/sizeof(LastNames[0])) )];
+    if( g_opt.maxSession )
+    {
+        // longer than the 64 bytes iRon keeps, with multi byte characters across the cut
+        snprintf( c.name, sizeof(c.name), "%s-\xc3\xa9\xc3\xa9\xc3\xa9 %s %s-%s von und zu %s%d", first, last, first, last, last, carIdx );
+        snprintf( c.team, sizeof(c.team), "%s %s Motorsport Racing Team Endurance Academy %d", last, first, carIdx );
+    }
+    else
+    {
+        snprintf( c.name, sizeof(c.name), "%s %s%d", first, last, carIdx );
+        snprintf( c.team, sizeof(c.team), "%s Racing", last );
+    }
+}
+
+// Fuel at the start, and after a stop: with --pits nobody gets to the end on what they start with
+static double fuelFor( const SimCar& c, int lapsLeft )
+{
+    const CarClass& cls = Classes[c.cls];
+    const double needed = cls.fuelPerLap * (lapsLeft + 2);
+    if( g_opt.pits )
+        return std::min( cls.tank, std::max( 3 * cls.fuelPerLap, needed * g_rng.uniform( 0.4, 0.7 ) ) );
+    return std::min( cls.tank, needed );
+}
+
+static std::vector<double> randomTimes( int n, double from, double to )
+{
+    std::vector<double> v;
+    for( int i=0; i<n; ++i )
+        v.push_back( g_rng.uniform( from, to ) );
+    std::sort( v.begin(), v.end() );
+    return v;
+}
+
+static void setupRace()
+{
+    Race& r = g_race;
+    const int numCars = std::max( 1, std::min( MaxCars - 1, g_opt.cars ) );
+    const int numClasses = std::max( 1, std::min( NumClasses, g_opt.classes ) );
+
+    // car indices don't go by grid position in the sim either
+    std::vector<int> idx;
+    for( int i=1; i<=numCars; ++i )
+        idx.push_back( i );
+    for( int i=(int)idx.size()-1; i>0; --i )
+        std::swap( idx[i], idx[g_rng.below( i + 1 )] );
+
+    for( int i=0; i<numCars; ++i )
+    {
+        SimCar& c = r.cars[idx[i]];
+        makeDriver( c, idx[i], i * numClasses / numCars );
+        c.phase = PHASE_Track;
+        c.qualTime = (float)(classLapTime( c.cls ) * c.skill * (1.0 + 0.002 * g_rng.normal()));
+    }
+
+    // faster classes up front, by qualifying time within a class
+    std::sort( idx.begin(), idx.end(), [&]( int a, int b ) {
+        const SimCar& ca = r.cars[a];
+        const SimCar& cb = r.cars[b];
+        return ca.cls != cb.cls ? ca.cls < cb.cls : ca.qualTime < cb.qualTime;
+    } );
+    for( int i=0; i<numCars; ++i )
+    {
+        SimCar& c = r.cars[idx[i]];
+        c.gridPos = i + 1;
+        c.dist = -1.0 + 0.25 - i * PaceGap;
+        c.fuel = fuelFor( c, g_opt.laps );
+    }
+
+    const int player = g_opt.player > 0 ? std::min( g_opt.player, numCars ) : (numCars + 1) / 2;
+    r.driverCarIdx = idx[player - 1];
+
+    SimCar& pace = r.cars[PaceCarIdx];
+    pace.phase = PHASE_Track;
+    pace.cls = 0;
+    strcpy( pace.name, "Pace Car" );
+    strcpy( pace.team, "Pace Car" );
+    pace.userId = -1;
+    pace.dist = -1.0 + 0.25 + 2 * PaceGap;
+
+    // the race itself is about laps * lap time long, starting 40 s or so in
+    const double raceLen = g_opt.laps * classLapTime( 0 );
+    const double start = 40 + classLapTime( 0 ) * 1.6;
+    r.cautionAt = randomTimes( g_opt.cautions, start + 0.1 * raceLen, start + 0.75 * raceLen );
+    r.towAt = randomTimes( g_opt.tows, start + 0.05 * raceLen, start + 0.8 * raceLen );
+    r.leaveAt = randomTimes( g_opt.churn, start, start + 0.8 * raceLen );
+    r.joinAt = randomTimes( g_opt.churn, start, start + 0.8 * raceLen );
+    r.incidentAt = randomTimes( g_opt.incidents, start - 60, start + raceLen );
+}
+
+// Random car that's still in the race, or -1
+static int pickRacingCar( bool allowPlayer )
+{
+    std::vector<int> v;
+    for( int i=1; i<MaxCars; ++i )
+        if( isRacing( g_race.cars[i] ) && g_race.cars[i].phase == PHASE_Track && (allowPlayer || i != g_race.driverCarIdx) )
+            v.push_back( i );
+    return v.empty() ? -1 : v[g_rng.below( (int)v.size() )];
+}
+
+static bool due( std::vector<double>& when )
+{
+    if( when.empty() || when.front() > g_race.t )
+        return false;
+    when.erase( when.begin() );
+    return true;
+}
+
+static void handleEvents()
+{
+    Race& r = g_race;
+    // no caution right after a restart, the next one waits a lap
+    const bool green = r.state == irsdk_StateRacing && !r.pacing && r.t > r.restartTime + classLapTime( 0 );
+
+    if( green && due( r.cautionAt ) )
+    {
+        // pace car comes out ahead of the leader and picks up the field
+        r.pacing = true;
+        r.paceCarIn = false;
+        r.cautionLapsLeft = 2 + g_rng.below( 2 );
+        r.cautionLeaderLap = r.cars[r.leaderIdx].lapsCompleted();
+        r.cautionTime = r.t;
+        r.paceMode = irsdk_PaceModeSingleFileRestart;
+        r.flags = irsdk_cautionWaving | irsdk_yellowWaving;
+        SimCar& pace = r.cars[PaceCarIdx];
+        pace.phase = PHASE_Track;
+        pace.dist = r.cars[r.leaderIdx].dist + 0.05;
+        r.numCautions++;
+    }
+    if( r.pacing && (r.flags & irsdk_cautionWaving) && r.t > r.cautionTime + 10 )
+        r.flags = irsdk_caution | irsdk_yellow;
+
+    if( r.state == irsdk_StateRacing && due( r.towAt ) )
+    {
+        const int i = pickRacingCar( true );
+        if( i >= 0 )
+        {
+            // the further from the pits, the longer it takes
+            SimCar& c = r.cars[i];
+            c.phase = PHASE_Towing;
+            c.towTime = 30 + 90 * (1.0 - c.pct());
+            c.phaseUntil = r.t + c.towTime;
+            r.numTows++;
+        }
+    }
+
+    if( r.state == irsdk_StateRacing && due( r.leaveAt ) )
+    {
+        const int i = pickRacingCar( false );
+        if( i >= 0 )
+        {
+            r.cars[i] = SimCar();
+            r.driversDirty = true;
+            r.numLeaves++;
+        }
+    }
+
+    if( r.state == irsdk_StateRacing && due( r.joinAt ) )
+    {
+        for( int i=1; i<MaxCars; ++i )
+        {
+            SimCar& c = r.cars[i];
+            if( c.phase != PHASE_Gone || i == r.driverCarIdx )
+                continue;
+
+            // late joiners start from their pit stall
+            makeDriver( c, i, g_rng.below( std::max( 1, std::min( NumClasses, g_opt.classes ) ) ) );
+            c.phase = PHASE_PitStall;
+            c.dist = PitStallPct;
+            c.phaseUntil = r.t + 5;
+            c.lapStartTime = r.t;
+            c.fuel = fuelFor( c, g_opt.laps );
+            c.qualTime = 0;
+            r.driversDirty = true;
+            r.numJoins++;
+            break;
+        }
+    }
+
+    if( r.state != irsdk_StateGetInCar && due( r.incidentAt ) )
+    {
+        const int i = pickRacingCar( true );
+        if( i >= 0 )
+        {
+            static const int Points[] = { 1, 1, 1, 2, 2, 4 };
+            r.cars[i].incidents += Points[g_rng.below( 6 )];
+            r.driversDirty = true;
+            r.numIncidents++;
+        }
+    }
+}
+
+// When the car crossed the line since the last tick, lap times aren't rounded to ticks in the sim either
+static double lineTime( const SimCar& c )
+{
+    return c.rate > 0 ? g_race.t - c.pct() / c.rate : g_race.t;
+}
+
+static void completeLap( int carIdx )
+{
+    Race& r = g_race;
+    SimCar& c = r.cars[carIdx];
+
+    if( r.greenTime >= 0 && c.lapStartTime >= 0 )
+    {
+        c.lastLap = (float)(lineTime( c ) - c.lapStartTime);
+        if( c.phase == PHASE_Track && (c.bestLap < 0 || c.lastLap < c.bestLap) )
+        {
+            c.bestLap = c.lastLap;
+            c.bestLapNum = c.lapsCompleted();
+        }
+    }
+    if( r.greenTime >= 0 )
+        c.lapStartTime = lineTime( c );
+    c.lapNoise = 0.004 * g_rng.normal();
+
+    if( carIdx == r.leaderIdx && r.state == irsdk_StateRacing )
+        c.lapsLed++;
+    if( r.checkeredTime >= 0 && c.finishPos == 0 && carIdx != PaceCarIdx )
+        c.finishPos = ++r.finishers;
+
+    r.resultsDirty = true;
+}
+
+static void moveCars( double dt )
+{
+    Race& r = g_race;
+    SimCar& pace = r.cars[PaceCarIdx];
+
+    // everyone's still sitting on the grid
+    if( r.state < irsdk_StateParadeLaps || (r.state == irsdk_StateParadeLaps && r.t < 40) )
+        return;
+
+    // running order, for the pace car to line the field up in
+    std::vector<int> order;
+    for( int i=1; i<MaxCars; ++i )
+        if( r.cars[i].phase == PHASE_Track )
+            order.push_back( i );
+    std::sort( order.begin(), order.end(), [&]( int a, int b ) { return r.cars[a].dist > r.cars[b].dist; } );
+
+    const double paceRate = 1.0 / (classLapTime( 0 ) * 1.7);
+    if( r.pacing && pace.phase == PHASE_Track )
+        pace.rate = paceRate;
+
+    for( int i=0; i<(int)order.size(); ++i )
+    {
+        SimCar& c = r.cars[order[i]];
+        const double lapTime = classLapTime( c.cls ) * c.skill * (1.0 + c.lapNoise) * (c.finishPos ? 1.5 : 1.0);
+
+        // flat out, through three corners a lap: sqrt(1-a^2) makes the lap take lapTime exactly
+        const double a = 0.2;
+        const double raceRate = (1.0 + a * sin( 6.283185307179586 * 3 * c.pct() )) / (lapTime * sqrt( 1 - a * a ));
+
+        if( r.pacing && r.state <= irsdk_StateRacing )
+        {
+            // catch up to your place in line at race pace, don't run into the one in front
+            const double leadDist = pace.phase == PHASE_Track ? pace.dist : r.cars[order[0]].dist + 2 * PaceGap;
+            const double target = leadDist - 2 * PaceGap - i * PaceGap;
+            c.rate = std::max( 0.3 * paceRate, std::min( raceRate, paceRate + 0.3 * (target - c.dist) ) );
+            if( !r.paceCarIn && pace.phase != PHASE_Track )
+                c.rate = paceRate;
+        }
+        else
+        {
+            c.rate = raceRate;
+        }
+    }
+
+    for( int i=0; i<MaxCars; ++i )
+    {
+        SimCar& c = r.cars[i];
+        const int prevLaps = (int)floor( c.dist );
+
+        switch( c.phase )
+        {
+        case PHASE_Gone:
+            continue;
+
+        case PHASE_Track:
+            if( i == PaceCarIdx && !r.pacing )
+                continue;
+            c.dist += c.rate * dt;
+            break;
+
+        case PHASE_PitLane:
+            c.rate = 1.0 / (classLapTime( c.cls ) * 2.5);
+            c.dist += c.rate * dt;
+            if( c.wantsPit && c.dist - floor( c.dist ) >= PitStallPct && c.dist - floor( c.dist ) < PitExitPct )
+            {
+                // fuel and four tires
+                c.wantsPit = false;
+                c.phase = PHASE_PitStall;
+                c.phaseUntil = r.t + 22 + 4 * g_rng.normal() * 0.5;
+                const double before = c.fuel;
+                c.fuel = std::max( c.fuel, fuelFor( c, g_opt.laps - c.lapsCompleted() ) );
+                c.phaseUntil += (c.fuel - before) / 2.5;
+                c.pitLap = INT_MAX;
+                r.numPitStops++;
+            }
+            else if( !c.wantsPit && c.dist - floor( c.dist ) >= PitExitPct && c.dist - floor( c.dist ) < PitEntryPct )
+            {
+                c.phase = PHASE_Track;
+            }
+            break;
+
+        case PHASE_PitStall:
+            c.rate = 0;
+            if( r.t >= c.phaseUntil && i != PaceCarIdx )
+                c.phase = PHASE_PitLane;
+            break;
+
+        case PHASE_Towing:
+            c.rate = 0;
+            c.towTime = std::max( 0.0, c.phaseUntil - r.t );
+            if( r.t >= c.phaseUntil )
+            {
+                // lands in the stall, the rest of the lap counts as driven, then repairs
+                c.dist = floor( c.dist ) + 1 + PitStallPct;
+                c.phase = PHASE_PitStall;
+                c.phaseUntil = r.t + 30;
+                c.towTime = 0;
+            }
+            break;
+        }
+
+        if( i == PaceCarIdx )
+            continue;
+
+        c.fuel = std::max( 0.0, c.fuel - Classes[c.cls].fuelPerLap * c.rate * dt * (r.pacing ? 0.4 : 1.0) );
+
+        if( (int)floor( c.dist ) > prevLaps && c.dist >= 0 )
+            completeLap( i );
+
+        // box this lap?
+        if( c.phase == PHASE_Track && r.state == irsdk_StateRacing && c.pct() >= PitEntryPct && c.pct() < PitEntryPct + 0.02 && !c.finishPos &&
+            (c.fuel < Classes[c.cls].fuelPerLap * 1.3 || c.lapsCompleted() >= c.pitLap) && c.lapsCompleted() < g_opt.laps - 1 )
+        {
+            c.phase = PHASE_PitLane;
+            c.wantsPit = true;
+        }
+    }
+}
+
+static void parkPaceCar()
+{
+    SimCar& pace = g_race.cars[PaceCarIdx];
+    pace.phase = PHASE_PitStall;
+    pace.dist = ceil( pace.dist ) + PitStallPct;
+    pace.rate = 0;
+}
+
+static void updateRaceState()
+{
+    Race& r = g_race;
+
+    // leader: most laps, first across the line after the checkered flag
+    int leader = -1;
+    for( int i=1; i<MaxCars; ++i )
+    {
+        const SimCar& c = r.cars[i];
+        if( c.phase == PHASE_Gone )
+            continue;
+        if( leader < 0 || (c.finishPos && (!r.cars[leader].finishPos || c.finishPos < r.cars[leader].finishPos)) ||
+            (!c.finishPos && !r.cars[leader].finishPos && c.dist > r.cars[leader].dist) )
+            leader = i;
+    }
+    r.leaderIdx = leader;
+    if( leader < 0 )
+        return;
+    const SimCar& ldr = r.cars[leader];
+
+    switch( r.state )
+    {
+    case irsdk_StateGetInCar:
+        if( r.t >= 20 )
+            r.state = irsdk_StateWarmup;
+        break;
+
+    case irsdk_StateWarmup:
+        if( r.t >= 35 )
+        {
+            r.state = irsdk_StateParadeLaps;
+            r.flags = irsdk_startReady;
+        }
+        break;
+
+    case irsdk_StateParadeLaps:
+        if( !r.paceCarIn && ldr.pct() > 0.85 && ldr.dist < 0 )
+        {
+            r.paceCarIn = true;
+            r.flags = irsdk_startSet;
+            parkPaceCar();
+        }
+        if( ldr.dist >= 0 )
+        {
+            r.state = irsdk_StateRacing;
+            r.flags = irsdk_startGo | irsdk_green;
+            r.pacing = false;
+            r.paceMode = irsdk_PaceModeNotPacing;
+            r.greenTime = r.t;
+            r.restartTime = r.t;
+            for( int i=1; i<MaxCars; ++i )
+                if( r.cars[i].phase != PHASE_Gone )
+                {
+                    // the rest start their first lap when they get to the line
+                    if( r.cars[i].dist >= 0 )
+                        r.cars[i].lapStartTime = lineTime( r.cars[i] );
+                    r.cars[i].pitLap = (int)(Classes[r.cars[i].cls].tank / Classes[r.cars[i].cls].fuelPerLap) - g_rng.below( 3 );
+                }
+        }
+        break;
+
+    case irsdk_StateRacing:
+        if( !r.pacing && r.t > r.greenTime + 5 )
+            r.flags &= ~irsdk_startGo;
+
+        if( r.pacing )
+        {
+            // count down the caution laps at the line, pace car in with a lap to go
+            if( ldr.lapsCompleted() != r.cautionLeaderLap )
+            {
+                r.cautionLeaderLap = ldr.lapsCompleted();
+                if( --r.cautionLapsLeft <= 0 && r.paceCarIn )
+                {
+                    r.pacing = false;
+                    r.paceCarIn = false;
+                    r.flags = irsdk_green;
+                    r.paceMode = irsdk_PaceModeNotPacing;
+                    r.restartTime = r.t;
+                }
+                else if( r.cautionLapsLeft <= 1 )
+                {
+                    r.flags = irsdk_caution | irsdk_oneLapToGreen;
+                }
+            }
+            if( r.cautionLapsLeft <= 1 && !r.paceCarIn && ldr.pct() > 0.85 )
+            {
+                r.paceCarIn = true;
+                parkPaceCar();
+            }
+        }
+
+        if( !r.pacing && ldr.lapsCompleted() == g_opt.laps - 1 )
+            r.flags = (r.flags & ~irsdk_green) | irsdk_white;
+
+        if( ldr.lapsCompleted() >= g_opt.laps && r.checkeredTime < 0 )
+        {
+            r.state = irsdk_StateCheckered;
+            r.flags = irsdk_checkered;
+            r.checkeredTime = r.t;
+            r.pacing = false;
+            r.cars[leader].finishPos = ++r.finishers;
+        }
+        break;
+
+    case irsdk_StateCheckered:
+    {
+        bool allDone = true;
+        for( int i=1; i<MaxCars; ++i )
+            if( isRacing( r.cars[i] ) && r.cars[i].phase != PHASE_Towing )
+                allDone = false;
+        if( allDone || r.t > r.checkeredTime + 180 )
+        {
+            r.state = irsdk_StateCoolDown;
+            r.coolDownTime = r.t;
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+//
+// Session string
+//
+
+static void appendf( std::string& s, const char* fmt, ... )
+{
+    char buf[1024];
+    va_list args;
+    va_start( args, fmt );
+    const int n = vsnprintf( buf, sizeof(buf), fmt, args );
+    va_end( args );
+    s.append( buf, std::min( n, (int)sizeof(buf) - 1 ) );
+}
+
+// Cars by race position: finishers in the order they finished, then by distance
+static std::vector<int> raceOrder()
+{
+    const Race& r = g_race;
+    std::vector<int> order;
+    for( int i=1; i<MaxCars; ++i )
+        if( r.cars[i].phase != PHASE_Gone )
+            order.push_back( i );
+
+    std::sort( order.begin(), order.end(), [&]( int a, int b ) {
+        const SimCar& ca = r.cars[a];
+        const SimCar& cb = r.cars[b];
+        if( r.greenTime < 0 )
+            return ca.gridPos != cb.gridPos ? (ca.gridPos && (!cb.gridPos || ca.gridPos < cb.gridPos)) : a < b;
+        if( ca.finishPos || cb.finishPos )
+            return ca.finishPos && (!cb.finishPos || ca.finishPos < cb.finishPos);
+        // a towed car keeps the distance where it stopped
+        return ca.dist != cb.dist ? ca.dist > cb.dist : a < b;
+    } );
+    return order;
+}
+
+static void appendDriver( std::string& s, int carIdx )
+{
+    const SimCar& c = g_race.cars[carIdx];
+    const bool isPace = carIdx == PaceCarIdx;
+    const CarClass& cls = Classes[c.cls];
+    const char licChar = "RDCBAP"[std::min( 5, (c.licLevel + 3) / 4 )];
+    static const char* const LicColors[] = { "0xfc0706", "0xff8c00", "0xfeec04", "0x33cc00", "0x0153db", "0x000000" };
+
+    appendf( s, " - CarIdx: %d\n", carIdx );
+    appendf( s, "   UserName: %s\n", c.name );
+    appendf( s, "   AbbrevName: \n" );
+    appendf( s, "   Initials: \n" );
+    appendf( s, "   UserID: %d\n", c.userId );
+    appendf( s, "   TeamID: 0\n" );
+    appendf( s, "   TeamName: %s\n", c.team );
+    appendf( s, "   CarNumber: \"%d\"\n", isPace ? 0 : c.number );
+    appendf( s, "   CarNumberRaw: %d\n", isPace ? 0 : c.number );
+    appendf( s, "   CarPath: %s\n", isPace ? "safety pcporsche911cup" : cls.shortName );
+    appendf( s, "   CarScreenName: %s\n", isPace ? "safety pcporsche911cup" : cls.screenName );
+    appendf( s, "   CarScreenNameShort: %s\n", isPace ? "safety pcporsche911cup" : cls.screenName );
+    appendf( s, "   CarID: %d\n", isPace ? 11 : cls.id );
+    appendf( s, "   CarClassID: %d\n", isPace ? 11 : cls.id );
+    appendf( s, "   CarIsPaceCar: %d\n", (int)isPace );
+    appendf( s, "   CarIsAI: 0\n" );
+    appendf( s, "   CarClassShortName: %s\n", isPace ? "" : cls.shortName );
+    appendf( s, "   CarClassRelSpeed: %d\n", isPace ? 0 : cls.relSpeed );
+    appendf( s, "   CarClassColor: %s\n", isPace ? "0xffffff" : cls.color );
+    appendf( s, "   CarClassEstLapTime: %.4f\n", classLapTime( c.cls ) * (isPace ? 1.25 : 1.0) );
+    appendf( s, "   IRating: %d\n", isPace ? 0 : c.irating );
+    appendf( s, "   LicLevel: %d\n", isPace ? 1 : c.licLevel );
+    appendf( s, "   LicString: %c %.2f\n", isPace ? 'R' : licChar, isPace ? 0.01 : c.sr );
+    appendf( s, "   LicColor: %s\n", isPace ? "0xundefined" : LicColors[std::min( 5, (c.licLevel + 3) / 4 )] );
+    appendf( s, "   IsSpectator: 0\n" );
+    appendf( s, "   CurDriverIncidentCount: %d\n", c.incidents );
+    appendf( s, "   TeamIncidentCount: %d\n", c.incidents );
+}
+
+static std::string buildSessionStr()
+{
+    const Race& r = g_race;
+    const SimCar& self = r.cars[r.driverCarIdx];
+    std::string s;
+    s.reserve( g_opt.maxSession ? SessionInfoLen : 64 * 1024 );
+
+    int numClasses = 0;
+    for( int k=0; k<NumClasses; ++k )
+        for( int i=1; i<MaxCars; ++i )
+            if( r.cars[i].phase != PHASE_Gone && r.cars[i].cls == k )
+            {
+                numClasses++;
+                break;
+            }
+
+    appendf( s, "---\n" );
+    appendf( s, "WeekendInfo:\n" );
+    appendf( s, " TrackName: synthetic\n" );
+    appendf( s, " TrackID: 999\n" );
+    appendf( s, " TrackLength: %.2f km\n", TrackLength / 1000 );
+    appendf( s, " TrackDisplayName: Synthetic Raceway\n" );
+    appendf( s, " TrackNumTurns: 9\n" );
+    appendf( s, " SeriesID: 1\n" );
+    appendf( s, " SessionID: %u\n", 100000 + g_opt.seed );
+    appendf( s, " SubSessionID: %u\n", 40000000 + g_opt.seed );
+    appendf( s, " Official: 0\n" );
+    appendf( s, " NumCarClasses: %d\n", numClasses );
+    appendf( s, " WeekendOptions:\n" );
+    appendf( s, "  NumStarters: %d\n", std::min( MaxCars - 1, g_opt.cars ) );
+    appendf( s, "  StartingGrid: 2x2 inline pole\n" );
+    appendf( s, "  RestartType: single file\n" );
+    appendf( s, "  IsFixedSetup: 0\n" );
+    appendf( s, "\n" );
+
+    appendf( s, "SessionInfo:\n" );
+    appendf( s, " Sessions:\n" );
+    appendf( s, " - SessionNum: 0\n" );
+    appendf( s, "   SessionLaps: %d\n", g_opt.laps );
+    appendf( s, "   SessionTime: unlimited\n" );
+    appendf( s, "   SessionNumLapsToAvg: 0\n" );
+    appendf( s, "   SessionType: Race\n" );
+    appendf( s, "   SessionTrackRubberState: moderately low usage\n" );
+    appendf( s, "   SessionName: RACE\n" );
+    if( r.greenTime < 0 )
+    {
+        appendf( s, "   ResultsPositions: \n" );
+    }
+    else
+    {
+        appendf( s, "   ResultsPositions:\n" );
+        const std::vector<int> order = raceOrder();
+        std::vector<int> classPos( NumClasses, 0 );
+        for( int p=0; p<(int)order.size(); ++p )
+        {
+            const SimCar& c = r.cars[order[p]];
+            appendf( s, "   - Position: %d\n", p + 1 );
+            appendf( s, "     ClassPosition: %d\n", classPos[c.cls]++ );
+            appendf( s, "     CarIdx: %d\n", order[p] );
+            appendf( s, "     Lap: %d\n", c.lapsCompleted() );
+            appendf( s, "     Time: %.4f\n", c.lapStartTime >= 0 ? c.lapStartTime - r.greenTime : 0.0 );
+            appendf( s, "     FastestLap: %d\n", c.bestLapNum );
+            appendf( s, "     FastestTime: %.4f\n", c.bestLap );
+            appendf( s, "     LastTime: %.4f\n", c.lastLap );
+            appendf( s, "     LapsLed: %d\n", c.lapsLed );
+            appendf( s, "     LapsComplete: %d\n", c.lapsCompleted() );
+            appendf( s, "     LapsDriven: %.3f\n", std::max( 0.0, c.dist ) );
+            appendf( s, "     Incidents: %d\n", c.incidents );
+            appendf( s, "     ReasonOutId: 0\n" );
+            appendf( s, "     ReasonOutStr: Running\n" );
+        }
+    }
+    appendf( s, "   ResultsFastestLap:\n" );
+    appendf( s, "   - CarIdx: 255\n" );
+    appendf( s, "     FastestLap: 0\n" );
+    appendf( s, "     FastestTime: -1.0000\n" );
+    appendf( s, "\n" );
+
+    appendf( s, "QualifyResultsInfo:\n" );
+    appendf( s, " Results:\n" );
+    {
+        std::vector<int> grid;
+        for( int i=1; i<MaxCars; ++i )
+            if( r.cars[i].phase != PHASE_Gone && r.cars[i].gridPos )
+                grid.push_back( i );
+        std::sort( grid.begin(), grid.end(), [&]( int a, int b ) { return r.cars[a].gridPos < r.cars[b].gridPos; } );
+        std::vector<int> classPos( NumClasses, 0 );
+        for( int p=0; p<(int)grid.size(); ++p )
+        {
+            const SimCar& c = r.cars[grid[p]];
+            appendf( s, " - Position: %d\n", p );
+            appendf( s, "   ClassPosition: %d\n", classPos[c.cls]++ );
+            appendf( s, "   CarIdx: %d\n", grid[p] );
+            appendf( s, "   FastestLap: 2\n" );
+            appendf( s, "   FastestTime: %.4f\n", c.qualTime );
+        }
+    }
+    appendf( s, "\n" );
+
+    appendf( s, "DriverInfo:\n" );
+    appendf( s, " DriverCarIdx: %d\n", r.driverCarIdx );
+    appendf( s, " DriverUserID: %d\n", self.userId );
+    appendf( s, " PaceCarIdx: %d\n", PaceCarIdx );
+    appendf( s, " DriverCarIdleRPM: 1100.000\n" );
+    appendf( s, " DriverCarRedLine: 8000.000\n" );
+    appendf( s, " DriverCarFuelKgPerLtr: 0.750\n" );
+    appendf( s, " DriverCarFuelMaxLtr: %.3f\n", Classes[self.cls].tank );
+    appendf( s, " DriverCarMaxFuelPct: 1.000\n" );
+    appendf( s, " DriverCarSLFirstRPM: 6500.000\n" );
+    appendf( s, " DriverCarSLShiftRPM: 7300.000\n" );
+    appendf( s, " DriverCarSLLastRPM: 7600.000\n" );
+    appendf( s, " DriverCarSLBlinkRPM: 7800.000\n" );
+    appendf( s, " DriverCarEstLapTime: %.4f\n", classLapTime( self.cls ) );
+    appendf( s, " Drivers:\n" );
+    for( int i=0; i<MaxCars; ++i )
+        if( r.cars[i].phase != PHASE_Gone || (i == PaceCarIdx) )
+            appendDriver( s, i );
+    appendf( s, "\n" );
+
+    appendf( s, "SplitTimeInfo:\n" );
+    appendf( s, " Sectors:\n" );
+    static const double Sectors[] = { 0.0, 0.27, 0.55, 0.81 };
+    for( int i=0; i<4; ++i )
+    {
+        appendf( s, " - SectorNum: %d\n", i );
+        appendf( s, "   SectorStartPct: %.6f\n", Sectors[i] );
+    }
+    appendf( s, "\n" );
+
+    // the biggest thing in the real one, fill up to what the sim's buffer holds
+    appendf( s, "CarSetup:\n" );
+    appendf( s, " UpdateCount: 1\n" );
+    appendf( s, " Tires:\n" );
+    appendf( s, "  LeftFront:\n" );
+    appendf( s, "   StartingPressure: 152 kPa\n" );
+    appendf( s, "   LastHotPressure: 152 kPa\n" );
+    appendf( s, "   LastTempsOMI: 27C, 27C, 27C\n" );
+    appendf( s, "   TreadRemaining: 100%%, 100%%, 100%%\n" );
+    if( g_opt.maxSession )
+    {
+        appendf( s, " Notes:\n" );
+        const int limit = SessionInfoLen - 256;
+        for( int n=0; (int)s.size() < limit; ++n )
+            appendf( s, "  Line%05d: %.*s\n", n, std::min( 80, limit - (int)s.size() ), "setup notes setup notes setup notes setup notes setup notes setup notes setup notes" );
+    }
+    appendf( s, "\n...\n" );
+
+    return s;
+}
+
+//
+// Fake sim memory, served to irsdk_utils.cpp and through that to irsdkRecorder
+//
+
+static std::vector<char>   g_mem;
+static irsdk_header*        g_header = NULL;
+static irsdk_varHeader*     g_vars = NULL;
+static char*                g_row = NULL;
+
+static const char* genOpen() { return g_mem.empty() ? NULL : g_mem.data(); }
+static void genClose() {}
+static void genWaitForSignal( int ) {}
+
+static const irsdk_source g_genSource = { "racegen", genOpen, genClose, genWaitForSignal };
+
+static void setupMemory()
+{
+    int bufLen = 0;
+    for( int i=0; i<NumSimVars; ++i )
+        bufLen += irsdk_VarTypeBytes[SimVars[i].type] * SimVars[i].count;
+
+    const int varHeaderOffset = (int)sizeof(irsdk_header);
+    const int sessionInfoOffset = varHeaderOffset + NumSimVars * (int)sizeof(irsdk_varHeader);
+    const int bufOffset = (sessionInfoOffset + SessionInfoLen + 15) & ~15;
+    g_mem.assign( bufOffset + bufLen, 0 );
+
+    g_header = (irsdk_header*)&g_mem[0];
+    g_vars = (irsdk_varHeader*)&g_mem[varHeaderOffset];
+    g_row = &g_mem[bufOffset];
+
+    int offset = 0;
+    for( int i=0; i<NumSimVars; ++i )
+    {
+        irsdk_varHeader& vh = g_vars[i];
+        vh.clear();
+        strcpy( vh.name, SimVars[i].name );
+        vh.type = SimVars[i].type;
+        vh.count = SimVars[i].count;
+        vh.offset = offset;
+        offset += irsdk_VarTypeBytes[vh.type] * vh.count;
+    }
+
+    g_header->ver = IRSDK_VER;
+    g_header->status = irsdk_stConnected;
+    g_header->tickRate = g_opt.hz;
+    g_header->sessionInfoUpdate = 0;
+    g_header->sessionInfoLen = SessionInfoLen;
+    g_header->sessionInfoOffset = sessionInfoOffset;
+    g_header->numVars = NumSimVars;
+    g_header->varHeaderOffset = varHeaderOffset;
+    g_header->numBuf = 1;
+    g_header->bufLen = bufLen;
+    g_header->varBuf[0].tickCount = -1;
+    g_header->varBuf[0].bufOffset = bufOffset;
+}
+
+// Returns whether it changed
+static bool publishSessionStr()
+{
+    const std::string s = buildSessionStr();
+    char* dst = &g_mem[g_header->sessionInfoOffset];
+    const int len = std::min( (int)s.size(), SessionInfoLen - 1 );
+    if( !strncmp( dst, s.c_str(), SessionInfoLen ) )
+        return false;
+
+    memcpy( dst, s.c_str(), len );
+    dst[len] = '\0';
+    g_header->sessionInfoUpdate++;
+    g_race.maxSessionLen = std::max( g_race.maxSessionLen, len );
+    return true;
+}
+
+//
+// Telemetry row
+//
+
+struct Offsets
+{
+    int sessionTime, sessionTick, sessionNum, sessionState, sessionUniqueID, sessionFlags, sessionTimeRemain;
+    int sessionLapsRemain, sessionLapsRemainEx, sessionTimeTotal, sessionLapsTotal, paceMode, displayUnits;
+    int isOnTrack, isOnTrackCar, onPitRoad, playerCarPosition, playerCarClassPosition, playerCarClass, playerCarIdx;
+    int playerTrackSurface, playerCarTowTime, playerCarInPitStall, playerCarMyIncidentCount;
+    int carLap, carLapCompleted, carLapDistPct, carTrackSurface, carOnPitRoad, carPosition, carClassPosition, carClass;
+    int carF2Time, carEstTime, carLastLapTime, carBestLapTime, carBestLapNum, carPaceLine, carPaceRow, carPaceFlags;
+    int carSteer, carRPM, carGear;
+    int lap, lapCompleted, lapDist, lapDistPct, raceLaps, lapBestLap, lapBestLapTime, lapLastLapTime, lapCurrentLapTime;
+    int lapDeltaToBestLap, lapDeltaToBestLapOK;
+    int fuelLevel, fuelLevelPct, fuelUsePerHour, speed, rpm, gear, throttle, brake, clutch, steeringWheelAngle;
+};
+
+static Offsets g_off;
+
+static int varOffset( const char* name )
+{
+    for( int i=0; i<NumSimVars; ++i )
+        if( !strcmp( g_vars[i].name, name ) )
+            return g_vars[i].offset;
+    return -1;
+}
+
+template<typename T>
+static void put( int offset, int entry, T value )
+{
+    if( offset >= 0 )
+        memcpy( g_row + offset + entry * sizeof(T), &value, sizeof(T) );
+}
+
+static void setupOffsets()
+{
+    Offsets& o = g_off;
+    o.sessionTime = varOffset( "SessionTime" );
+    o.sessionTick = varOffset( "SessionTick" );
+    o.sessionNum = varOffset( "SessionNum" );
+    o.sessionState = varOffset( "SessionState" );
+    o.sessionUniqueID = varOffset( "SessionUniqueID" );
+    o.sessionFlags = varOffset( "SessionFlags" );
+    o.sessionTimeRemain = varOffset( "SessionTimeRemain" );
+    o.sessionLapsRemain = varOffset( "SessionLapsRemain" );
+    o.sessionLapsRemainEx = varOffset( "SessionLapsRemainEx" );
+    o.sessionTimeTotal = varOffset( "SessionTimeTotal" );
+    o.sessionLapsTotal = varOffset( "SessionLapsTotal" );
+    o.paceMode = varOffset( "PaceMode" );
+    o.displayUnits = varOffset( "DisplayUnits" );
+    o.isOnTrack = varOffset( "IsOnTrack" );
+    o.isOnTrackCar = varOffset( "IsOnTrackCar" );
+    o.onPitRoad = varOffset( "OnPitRoad" );
+    o.playerCarPosition = varOffset( "PlayerCarPosition" );
+    o.playerCarClassPosition = varOffset( "PlayerCarClassPosition" );
+    o.playerCarClass = varOffset( "PlayerCarClass" );
+    o.playerCarIdx = varOffset( "PlayerCarIdx" );
+    o.playerTrackSurface = varOffset( "PlayerTrackSurface" );
+    o.playerCarTowTime = varOffset( "PlayerCarTowTime" );
+    o.playerCarInPitStall = varOffset( "PlayerCarInPitStall" );
+    o.playerCarMyIncidentCount = varOffset( "PlayerCarMyIncidentCount" );
+    o.carLap = varOffset( "CarIdxLap" );
+    o.carLapCompleted = varOffset( "CarIdxLapCompleted" );
+    o.carLapDistPct = varOffset( "CarIdxLapDistPct" );
+    o.carTrackSurface = varOffset( "CarIdxTrackSurface" );
+    o.carOnPitRoad = varOffset( "CarIdxOnPitRoad" );
+    o.carPosition = varOffset( "CarIdxPosition" );
+    o.carClassPosition = varOffset( "CarIdxClassPosition" );
+    o.carClass = varOffset( "CarIdxClass" );
+    o.carF2Time = varOffset( "CarIdxF2Time" );
+    o.carEstTime = varOffset( "CarIdxEstTime" );
+    o.carLastLapTime = varOffset( "CarIdxLastLapTime" );
+    o.carBestLapTime = varOffset( "CarIdxBestLapTime" );
+    o.carBestLapNum = varOffset( "CarIdxBestLapNum" );
+    o.carPaceLine = varOffset( "CarIdxPaceLine" );
+    o.carPaceRow = varOffset( "CarIdxPaceRow" );
+    o.carPaceFlags = varOffset( "CarIdxPaceFlags" );
+    o.carSteer = varOffset( "CarIdxSteer" );
+    o.carRPM = varOffset( "CarIdxRPM" );
+    o.carGear = varOffset( "CarIdxGear" );
+    o.lap = varOffset( "Lap" );
+    o.lapCompleted = varOffset( "LapCompleted" );
+    o.lapDist = varOffset( "LapDist" );
+    o.lapDistPct = varOffset( "LapDistPct" );
+    o.raceLaps = varOffset( "RaceLaps" );
+    o.lapBestLap = varOffset( "LapBestLap" );
+    o.lapBestLapTime = varOffset( "LapBestLapTime" );
+    o.lapLastLapTime = varOffset( "LapLastLapTime" );
+    o.lapCurrentLapTime = varOffset( "LapCurrentLapTime" );
+    o.lapDeltaToBestLap = varOffset( "LapDeltaToBestLap" );
+    o.lapDeltaToBestLapOK = varOffset( "LapDeltaToBestLap_OK" );
+    o.fuelLevel = varOffset( "FuelLevel" );
+    o.fuelLevelPct = varOffset( "FuelLevelPct" );
+    o.fuelUsePerHour = varOffset( "FuelUsePerHour" );
+    o.speed = varOffset( "Speed" );
+    o.rpm = varOffset( "RPM" );
+    o.gear = varOffset( "Gear" );
+    o.throttle = varOffset( "Throttle" );
+    o.brake = varOffset( "Brake" );
+    o.clutch = varOffset( "Clutch" );
+    o.steeringWheelAngle = varOffset( "SteeringWheelAngle" );
+}
+
+static int trackSurface( const SimCar& c )
+{
+    switch( c.phase )
+    {
+    case PHASE_Track:       return irsdk_OnTrack;
+    case PHASE_PitLane:     return irsdk_AproachingPits;
+    case PHASE_PitStall:    return irsdk_InPitStall;
+    default:                return irsdk_NotInWorld;
+    }
+}
+
+static void writeRow()
+{
+    const Race& r = g_race;
+    const Offsets& o = g_off;
+
+    const std::vector<int> order = raceOrder();
+    int position[MaxCars] = {};
+    int classPosition[MaxCars] = {};
+    std::vector<int> classCount( NumClasses, 0 );
+    for( int p=0; p<(int)order.size(); ++p )
+    {
+        position[order[p]] = p + 1;
+        classPosition[order[p]] = ++classCount[r.cars[order[p]].cls];
+    }
+
+    const SimCar* leader = r.leaderIdx >= 0 ? &r.cars[r.leaderIdx] : NULL;
+    for( int i=0; i<MaxCars; ++i )
+    {
+        const SimCar& c = r.cars[i];
+        if( c.phase == PHASE_Gone )
+        {
+            put<int>( o.carLap, i, -1 );
+            put<int>( o.carLapCompleted, i, -1 );
+            put<float>( o.carLapDistPct, i, -1.0f );
+            put<int>( o.carTrackSurface, i, irsdk_NotInWorld );
+            put<bool>( o.carOnPitRoad, i, false );
+            put<int>( o.carPosition, i, 0 );
+            put<int>( o.carClassPosition, i, 0 );
+            put<int>( o.carClass, i, 0 );
+            put<float>( o.carF2Time, i, 0.0f );
+            put<float>( o.carEstTime, i, 0.0f );
+            put<float>( o.carLastLapTime, i, -1.0f );
+            put<float>( o.carBestLapTime, i, -1.0f );
+            put<int>( o.carBestLapNum, i, -1 );
+            put<int>( o.carPaceLine, i, -1 );
+            put<int>( o.carPaceRow, i, -1 );
+            put<int>( o.carPaceFlags, i, 0 );
+            put<float>( o.carSteer, i, 0.0f );
+            put<float>( o.carRPM, i, 0.0f );
+            put<int>( o.carGear, i, 0 );
+            continue;
+        }
+
+        const bool towing = c.phase == PHASE_Towing;
+        const double pct = c.pct();
+        const double lapTime = classLapTime( c.cls );
+        const float rpm = c.rate > 0 ? (float)(4500 + 3000 * fmod( c.rate * lapTime * 3.2 + pct * 11, 1.0 )) : 1100.0f;
+
+        put<int>( o.carLap, i, c.lap() );
+        put<int>( o.carLapCompleted, i, c.lapsCompleted() );
+        put<float>( o.carLapDistPct, i, towing ? -1.0f : (float)pct );
+        put<int>( o.carTrackSurface, i, trackSurface( c ) );
+        put<bool>( o.carOnPitRoad, i, c.phase == PHASE_PitLane || c.phase == PHASE_PitStall );
+        put<int>( o.carPosition, i, i == PaceCarIdx || r.greenTime < 0 ? 0 : position[i] );
+        put<int>( o.carClassPosition, i, i == PaceCarIdx || r.greenTime < 0 ? 0 : classPosition[i] );
+        put<int>( o.carClass, i, i == PaceCarIdx ? 11 : Classes[c.cls].id );
+        put<float>( o.carF2Time, i, leader && i != PaceCarIdx && r.greenTime >= 0 ? (float)std::max( 0.0, (leader->dist - c.dist) * lapTime ) : 0.0f );
+        put<float>( o.carEstTime, i, towing ? 0.0f : (float)(pct * lapTime) );
+        put<float>( o.carLastLapTime, i, c.lastLap );
+        put<float>( o.carBestLapTime, i, c.bestLap );
+        put<int>( o.carBestLapNum, i, c.bestLapNum );
+        put<int>( o.carPaceLine, i, r.pacing && i != PaceCarIdx && c.phase == PHASE_Track ? (r.greenTime < 0 ? (c.gridPos - 1) % 2 : 0) : -1 );
+        put<int>( o.carPaceRow, i, r.pacing && i != PaceCarIdx && c.phase == PHASE_Track ? (r.greenTime < 0 ? (c.gridPos - 1) / 2 : position[i] - 1) : -1 );
+        put<int>( o.carPaceFlags, i, 0 );
+        put<float>( o.carSteer, i, (float)(0.3 * sin( 6.283185307179586 * 3 * pct )) );
+        put<float>( o.carRPM, i, rpm );
+        put<int>( o.carGear, i, c.rate > 0 ? 2 + (int)(pct * 12) % 4 : 0 );
+    }
+
+    const int self = r.driverCarIdx;
+    const SimCar& me = r.cars[self];
+    const double pct = me.pct();
+    const double speed = me.rate * TrackLength;
+    const double accel = sin( 6.283185307179586 * 3 * pct + 1.2 );
+    const int leaderLaps = leader ? leader->lapsCompleted() : 0;
+
+    put<double>( o.sessionTime, 0, r.t );
+    put<int>( o.sessionTick, 0, r.tick );
+    put<int>( o.sessionNum, 0, 0 );
+    put<int>( o.sessionState, 0, r.state );
+    put<int>( o.sessionUniqueID, 0, 1 );
+    put<int>( o.sessionFlags, 0, (int)r.flags );
+    put<double>( o.sessionTimeRemain, 0, (double)IRSDK_UNLIMITED_TIME );
+    put<int>( o.sessionLapsRemain, 0, std::max( 0, g_opt.laps - leaderLaps ) );
+    put<int>( o.sessionLapsRemainEx, 0, r.greenTime < 0 ? g_opt.laps : std::max( 0, g_opt.laps - leaderLaps ) );
+    put<double>( o.sessionTimeTotal, 0, (double)IRSDK_UNLIMITED_TIME );
+    put<int>( o.sessionLapsTotal, 0, g_opt.laps );
+    put<int>( o.paceMode, 0, r.paceMode );
+    put<int>( o.displayUnits, 0, 1 );
+
+    const bool inCar = me.phase != PHASE_Gone && me.phase != PHASE_Towing && r.state != irsdk_StateCoolDown;
+    put<bool>( o.isOnTrack, 0, inCar );
+    put<bool>( o.isOnTrackCar, 0, inCar );
+    put<bool>( o.onPitRoad, 0, me.phase == PHASE_PitLane || me.phase == PHASE_PitStall );
+    put<int>( o.playerCarPosition, 0, r.greenTime < 0 ? 0 : position[self] );
+    put<int>( o.playerCarClassPosition, 0, r.greenTime < 0 ? 0 : classPosition[self] );
+    put<int>( o.playerCarClass, 0, Classes[me.cls].id );
+    put<int>( o.playerCarIdx, 0, self );
+    put<int>( o.playerTrackSurface, 0, trackSurface( me ) );
+    put<float>( o.playerCarTowTime, 0, (float)me.towTime );
+    put<bool>( o.playerCarInPitStall, 0, me.phase == PHASE_PitStall );
+    put<int>( o.playerCarMyIncidentCount, 0, me.incidents );
+
+    put<int>( o.lap, 0, me.lap() );
+    put<int>( o.lapCompleted, 0, me.lapsCompleted() );
+    put<float>( o.lapDist, 0, (float)(pct * TrackLength) );
+    put<float>( o.lapDistPct, 0, (float)pct );
+    put<int>( o.raceLaps, 0, r.greenTime < 0 ? 0 : me.lapsCompleted() );
+    put<int>( o.lapBestLap, 0, me.bestLapNum );
+    put<float>( o.lapBestLapTime, 0, me.bestLap > 0 ? me.bestLap : 0.0f );
+    put<float>( o.lapLastLapTime, 0, me.lastLap > 0 ? me.lastLap : 0.0f );
+    put<float>( o.lapCurrentLapTime, 0, me.lapStartTime >= 0 ? (float)(r.t - me.lapStartTime) : 0.0f );
+    put<float>( o.lapDeltaToBestLap, 0, me.bestLap > 0 && me.lapStartTime >= 0 ? (float)(r.t - me.lapStartTime - pct * me.bestLap) : 0.0f );
+    put<bool>( o.lapDeltaToBestLapOK, 0, me.bestLap > 0 );
+
+    put<float>( o.fuelLevel, 0, (float)me.fuel );
+    put<float>( o.fuelLevelPct, 0, (float)(me.fuel / Classes[me.cls].tank) );
+    put<float>( o.fuelUsePerHour, 0, (float)(Classes[me.cls].fuelPerLap * me.rate * (r.pacing ? 0.4 : 1.0) * 0.75 * 3600) );
+    put<float>( o.speed, 0, (float)speed );
+    put<float>( o.rpm, 0, me.rate > 0 ? (float)(4500 + 3000 * fmod( speed / 12.0, 1.0 )) : 1100.0f );
+    put<int>( o.gear, 0, me.rate > 0 ? std::min( 6, 1 + (int)(speed / 12.0) ) : 0 );
+    put<float>( o.throttle, 0, me.rate > 0 ? (float)std::max( 0.0, std::min( 1.0, 0.6 + accel ) ) : 0.0f );
+    put<float>( o.brake, 0, me.rate > 0 ? (float)std::max( 0.0, std::min( 1.0, -accel - 0.4 ) ) : 0.0f );
+    put<float>( o.clutch, 0, 1.0f );
+    put<float>( o.steeringWheelAngle, 0, (float)(1.2 * sin( 6.283185307179586 * 3 * pct )) );
+}
+
+//
+// Main loop
+//
+
+// Session strings have to go out with the rows they belong to, and the rows can't be dropped, so
+// don't let the recorder's queues fill up. It drains them every 20 ms.
+static void waitForRecorder( irsdkRecorder& rec, int pushed )
+{
+    while( true )
+    {
+        const irsdkRecorderStats s = rec.getStats();
+        if( pushed - s.rows - s.dropped < QueueRows - 16 && g_race.sessionVersions - s.sessionVersions < 3 )
+            break;
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+}
+
+static int run( const char* path )
+{
+    Race& r = g_race;
+    setupRace();
+    setupMemory();
+    setupOffsets();
+
+    publishSessionStr();
+    writeRow();
+
+    // the first look only syncs up to the tick count, the next row is what counts as connected
+    irsdk_setSource( &g_genSource );
+    irsdk_getNewData( NULL );
+    g_header->varBuf[0].tickCount = 0;
+    if( !irsdk_getNewData( NULL ) || !irsdk_isConnected() )
+    {
+        printf( "Can't connect to the generated telemetry\n" );
+        return 1;
+    }
+
+    irsdkRecorder rec;
+    if( !rec.start( path, g_header, g_vars, QueueRows ) )
+    {
+        printf( "Can't write %s\n", path );
+        return 1;
+    }
+
+    const double estSeconds = 40 + classLapTime( 0 ) * (1.6 + g_opt.laps + 0.5 * g_opt.cautions) + 60;
+    printf( "Generating a %d lap race for %d cars in %d classes at %d Hz, about %.0f MB of rows\n", g_opt.laps, std::min( MaxCars - 1, g_opt.cars ),
+        std::max( 1, std::min( NumClasses, g_opt.classes ) ), g_opt.hz, estSeconds * g_opt.hz * g_header->bufLen / (1024.0 * 1024.0) );
+
+    const double dt = 1.0 / g_opt.hz;
+    int pushed = 0;
+    for( r.tick=0; ; ++r.tick )
+    {
+        r.t = r.tick * dt;
+
+        handleEvents();
+        moveCars( dt );
+        updateRaceState();
+
+        // results come in a little while after the line, drivers right away, everything every tick in a storm
+        const bool storm = r.greenTime >= 0 && r.t < r.greenTime + g_opt.storm;
+        const bool resultsDue = r.resultsDirty && r.t >= r.lastResultsTime + g_opt.resultsEvery;
+        if( storm || resultsDue || r.driversDirty )
+        {
+            if( resultsDue || storm )
+            {
+                r.lastResultsTime = r.t;
+                r.resultsDirty = false;
+            }
+            r.driversDirty = false;
+            if( publishSessionStr() )
+                r.sessionVersions++;
+        }
+
+        writeRow();
+        g_header->varBuf[0].tickCount = r.tick;
+
+        waitForRecorder( rec, pushed );
+        rec.pushRow( g_row, g_header->bufLen, &g_mem[g_header->sessionInfoOffset], g_header->sessionInfoUpdate );
+        pushed++;
+
+        if( r.coolDownTime >= 0 && r.t > r.coolDownTime + 15 )
+            break;
+    }
+
+    rec.pushEnd();
+    rec.stop();
+    irsdk_shutdown();
+    irsdk_setSource( NULL );
+
+    const irsdkRecorderStats s = rec.getStats();
+    printf( "%d rows (%.0f s), %d dropped, %d session strings up to %d bytes, %.1f MB\n", s.rows, r.t, s.dropped, s.sessionVersions, r.maxSessionLen, s.bytes / (1024.0 * 1024.0) );
+    printf( "%d cautions, %d pit stops, %d tows, %d left, %d joined, %d incidents\n", r.numCautions, r.numPitStops, r.numTows, r.numLeaves, r.numJoins, r.numIncidents );
+    return s.dropped || s.sessionVersions != r.sessionVersions ? 1 : 0;
+}
+
+int main( int argc, char** argv )
+{
+    const char* path = NULL;
+    Options& o = g_opt;
+
+    for( int i=1; i<argc; ++i )
+    {
+        const bool more = i + 1 < argc;
+        if( !strcmp( argv[i], "--cars" ) && more )
+            o.cars = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--classes" ) && more )
+            o.classes = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--laps" ) && more )
+            o.laps = std::max( 1, atoi( argv[++i] ) );
+        else if( !strcmp( argv[i], "--lap-time" ) && more )
+            o.lapTime = std::max( 20.0, atof( argv[++i] ) );
+        else if( !strcmp( argv[i], "--hz" ) && more )
+            o.hz = std::max( 1, atoi( argv[++i] ) );
+        else if( !strcmp( argv[i], "--seed" ) && more )
+            o.seed = (unsigned)strtoul( argv[++i], NULL, 10 );
+        else if( !strcmp( argv[i], "--player" ) && more )
+            o.player = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--cautions" ) && more )
+            o.cautions = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--pits" ) )
+            o.pits = true;
+        else if( !strcmp( argv[i], "--tows" ) && more )
+            o.tows = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--churn" ) && more )
+            o.churn = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--incidents" ) && more )
+            o.incidents = atoi( argv[++i] );
+        else if( !strcmp( argv[i], "--results-every" ) && more )
+            o.resultsEvery = atof( argv[++i] );
+        else if( !strcmp( argv[i], "--storm" ) && more )
+            o.storm = atof( argv[++i] );
+        else if( !strcmp( argv[i], "--max-session" ) )
+            o.maxSession = true;
+        else if( !strcmp( argv[i], "--stress" ) )
+        {
+            o.cars = MaxCars - 1;
+            o.classes = NumClasses;
+            o.cautions = 3;
+            o.pits = true;
+            o.tows = 8;
+            o.churn = 8;
+            o.incidents = 200;
+            o.storm = 2;
+            o.maxSession = true;
+        }
+        else if( argv[i][0] != '-' && !path )
+            path = argv[i];
+        else
+            path = NULL, i = argc;
+    }
+
+    if( !path )
+    {
+        printf( "usage: racegen <file.ibt> [--cars N] [--classes N] [--laps N] [--lap-time S] [--hz N] [--seed N] [--player P]\n"
+                "                          [--cautions N] [--pits] [--tows N] [--churn N] [--incidents N] [--results-every S]\n"
+                "                          [--storm S] [--max-session] [--stress]\n" );
+        return 1;
+    }
+
+    g_rng = Rng( o.seed );
+    return run( path );
+}
@@ -0,0 +1,191 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//
+// Session parser handoff stress test.
+//
+// Hands session strings to SessionParser::request() the way ir_tick() does, as fast as it can, and
+// treats each one like the sim treats its shared memory: as soon as request() returns the string is
+// scribbled over and freed, as if the sim rewrote it or went away. Every string is stamped with its
+// version in the subsession ID and every driver's name, and has a different number of drivers, so a
+// snapshot parsed from a string that changed under the parser, or from two of them, shows up.
+// Every so often the status ID changes as on a reconnect. Fails if any snapshot mixes versions, goes
+// backwards, or if the last string never comes out the other end.
+//
+// Only depends on the session parser, so it builds anywhere. Worth running with -fsanitize=address
+// or -fsanitize=thread as well:
+//
+//   cl /O2 /EHsc /DNDEBUG tools\sessionstress.cpp SessionParser.cpp irsdk\yaml_parser.cpp
+//   g++ -O2 -std=c++17 -pthread -o sessionstress tools/sessionstress.cpp SessionParser.cpp irsdk/yaml_parser.cpp
+//
+// Usage:
+//
+//   sessionstress [--seconds N]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <chrono>
+#include "../SessionParser.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static int driversOf( int version )
+{
+    return 1 + version % (IR_MAX_CARS - 1);
+}
+
+static void makeSessionStr( std::string& s, int version )
+{
+    char buf[256];
+
+    s = "---\nWeekendInfo:\n";
+    snprintf( buf, sizeof(buf), " SubSessionID: %d\n TrackID: %d\n\n", version, version );
+    s += buf;
+
+    s += "SessionInfo:\n Sessions:\n - SessionNum: 0\n   SessionLaps: unlimited\n   SessionTime: 3600.0000 sec\n   SessionName: RACE\n\n";
+
+    s += "DriverInfo:\n DriverCarIdx: 0\n Drivers:\n";
+    for( int carIdx=0; carIdx<driversOf(version); ++carIdx )
+    {
+        snprintf( buf, sizeof(buf), " - CarIdx: %d\n   UserName: Driver%d v%d\n   CarNumber: \"%d\"\n   CarNumberRaw: %d\n   IRating: %d\n",
+                  carIdx, carIdx, version, carIdx, carIdx, 1000 + version % 3000 );
+        s += buf;
+    }
+    s += "\n...\n";
+}
+
+// The version the snapshot was parsed from, or -1 if it isn't what any one string says
+static int checkSnapshot( const Session& session )
+{
+    const int version = session.subsessionId;
+    if( session.trackId != version || session.sessionType != SessionType::RACE )
+        return -1;
+
+    char expected[64];
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        const bool present = carIdx < driversOf( version );
+        if( !present )
+        {
+            if( session.cars[carIdx].userName[0] )
+                return -1;
+            continue;
+        }
+
+        snprintf( expected, sizeof(expected), "Driver%d v%d", carIdx, version );
+        if( strcmp( session.cars[carIdx].userName, expected ) )
+            return -1;
+    }
+
+    return version;
+}
+
+int main( int argc, char** argv )
+{
+    double seconds = 3;
+
+    for( int i=1; i<argc; ++i )
+    {
+        if( !strcmp( argv[i], "--seconds" ) && i+1<argc )
+            seconds = atof( argv[++i] );
+        else
+        {
+            printf( "usage: sessionstress [--seconds N]\n" );
+            return 1;
+        }
+    }
+
+    SessionParser* parser = new SessionParser();
+    std::string yaml;
+
+    int requests = 0;
+    int snapshots = 0;
+    int bad = 0;
+    int backwards = 0;
+    int lastSeen = 0;
+    int statusId = 1;
+    int version = 0;
+
+    auto take = [&]( SessionSnapshot* snap ) {
+        const int v = checkSnapshot( snap->session );
+        snapshots++;
+        if( v < 0 )
+        {
+            if( bad++ < 5 )
+                printf( "    bad snapshot, subsession %d with %s first\n", snap->session.subsessionId, snap->session.cars[0].userName );
+        }
+        else if( v < lastSeen )
+            backwards++;
+        else
+            lastSeen = v;
+    };
+
+    const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( seconds ) );
+    while( Clock::now() < end )
+    {
+        version++;
+        if( version % 500 == 0 )
+            statusId++;
+
+        // like the sim's shared memory: only good until request() returns
+        makeSessionStr( yaml, version );
+        char* shared = new char[yaml.size() + 1];
+        memcpy( shared, yaml.c_str(), yaml.size() + 1 );
+
+        parser->request( shared, 0, statusId );
+        requests++;
+
+        memset( shared, 'x', yaml.size() );
+        delete[] shared;
+
+        if( SessionSnapshot* snap = parser->fetch() )
+            take( snap );
+
+        // give the worker a chance on a single core
+        if( version % 8 == 0 )
+            std::this_thread::yield();
+    }
+
+    // the last one has to make it through
+    const Clock::time_point deadline = Clock::now() + std::chrono::seconds( 5 );
+    while( lastSeen != version && Clock::now() < deadline )
+    {
+        if( SessionSnapshot* snap = parser->fetch() )
+            take( snap );
+        else
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+
+    delete parser;
+
+    const bool ok = !bad && !backwards && lastSeen == version;
+
+    printf( "%d requests, %d snapshots picked up, %d superseded before the worker got to them\n", requests, snapshots, requests - snapshots );
+    printf( "%d bad snapshots, %d went backwards, last version %d of %d%s\n", bad, backwards, lastSeen, version, lastSeen == version ? "" : "  <-- LOST" );
+    printf( ok ? "PASSED\n" : "FAILED\n" );
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,435 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+//
+// Stand-in for the sim on platforms without it.
+//
+// Writes telemetry into the shared memory that irsdk_source_posix.cpp reads, laid out exactly like
+// the sim's memory map (the variables from simvars.h, triple buffered), and signals each row on the
+// data valid futex. A handful of cars drive around so the values change like they would in a race.
+//
+//   g++ -O2 -std=c++17 -pthread -o shmproducer tools/shmproducer.cpp irsdk/irsdk_client.cpp irsdk/irsdk_utils.cpp irsdk/irsdk_source_posix.cpp irsdk/irsdk_snapshot.cpp irsdk/yaml_parser.cpp
+//   shmproducer [--hz N] [--cars N] [--seconds N] [--unlink]
+//   shmproducer --watch [--seconds N]
+//
+// --hz is 60 like the sim by default, 360 like its high rate disk logging for more load.
+// The sim's memory stays around after it exits, and so does this one unless --unlink is given, which
+// also means readers that still have it mapped won't see the next producer.
+// --watch runs the other end in another process: the ingestion thread and irsdkVar<> handles iRon
+// uses, printing once a second how many rows arrived, how late, and whether they were consistent.
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <math.h>
+#include <limits.h>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_client.h"
+#include "simvars.h"
+
+// Fixed, so a reader that mapped it earlier never reads past the end after a restart with other settings
+static const int MemSize = 2 << 20;
+static const int SessionInfoLen = 64 * 1024;
+static const int NumBuf = 3;
+static const int MaxCars = 64;
+
+static volatile sig_atomic_t g_quit = 0;
+
+static void onSignal( int )
+{
+    g_quit = 1;
+}
+
+static void* createShm( const char* name, size_t size )
+{
+    int fd = shm_open( name, O_CREAT | O_RDWR, 0644 );
+    if( fd < 0 )
+        return NULL;
+
+    struct stat st;
+    void* mem = NULL;
+    if( fstat( fd, &st ) == 0 && ((size_t)st.st_size >= size || ftruncate( fd, size ) == 0) )
+    {
+        mem = mmap( NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+        if( mem == MAP_FAILED )
+            mem = NULL;
+    }
+
+    close( fd );
+    return mem;
+}
+
+static void signalRow( int* signal )
+{
+    __atomic_fetch_add( signal, 1, __ATOMIC_RELEASE );
+#ifdef __linux__
+    syscall( SYS_futex, signal, FUTEX_WAKE, INT_MAX, NULL, NULL, 0 );
+#endif
+}
+
+//
+// Producer
+//
+
+struct Layout
+{
+    char*               mem;
+    irsdk_header*       header;
+    irsdk_varHeader*    vars;
+};
+
+static int varOffset( const Layout& l, const char* name )
+{
+    for( int i=0; i<l.header->numVars; ++i )
+        if( !strcmp( l.vars[i].name, name ) )
+            return l.vars[i].offset;
+    return -1;
+}
+
+template<typename T>
+static void put( char* row, int offset, int entry, T value )
+{
+    if( offset >= 0 )
+        memcpy( row + offset + entry * sizeof(T), &value, sizeof(T) );
+}
+
+static bool setupLayout( Layout& l, char* mem, int hz, int numCars )
+{
+    l.mem = mem;
+    l.header = (irsdk_header*)mem;
+    l.vars = (irsdk_varHeader*)(mem + sizeof(irsdk_header));
+
+    // nobody should read a half written header
+    l.header->status = 0;
+    __atomic_thread_fence( __ATOMIC_SEQ_CST );
+
+    int bufLen = 0;
+    for( int i=0; i<NumSimVars; ++i )
+    {
+        irsdk_varHeader& vh = l.vars[i];
+        vh.clear();
+        strcpy( vh.name, SimVars[i].name );
+        vh.type = SimVars[i].type;
+        vh.count = SimVars[i].count;
+        vh.offset = bufLen;
+        bufLen += irsdk_VarTypeBytes[vh.type] * vh.count;
+    }
+
+    const int sessionInfoOffset = (int)sizeof(irsdk_header) + NumSimVars * (int)sizeof(irsdk_varHeader);
+    const int firstBufOffset = (sessionInfoOffset + SessionInfoLen + 15) & ~15;
+    const int bufStride = (bufLen + 15) & ~15;
+    if( firstBufOffset + NumBuf * bufStride > MemSize )
+        return false;
+
+    l.header->ver = IRSDK_VER;
+    l.header->tickRate = hz;
+    l.header->sessionInfoLen = SessionInfoLen;
+    l.header->sessionInfoOffset = sessionInfoOffset;
+    l.header->numVars = NumSimVars;
+    l.header->varHeaderOffset = sizeof(irsdk_header);
+    l.header->numBuf = NumBuf;
+    l.header->bufLen = bufLen;
+    for( int i=0; i<NumBuf; ++i )
+    {
+        l.header->varBuf[i].tickCount = -1;
+        l.header->varBuf[i].bufOffset = firstBufOffset + i * bufStride;
+        memset( mem + l.header->varBuf[i].bufOffset, 0, bufLen );
+    }
+
+    char* yaml = mem + sessionInfoOffset;
+    int n = snprintf( yaml, SessionInfoLen,
+        "---\n"
+        "WeekendInfo:\n"
+        " TrackName: synthetic\n"
+        " TrackDisplayName: Synthetic Raceway\n"
+        " TrackLength: 4.00 km\n"
+        " NumCarClasses: 1\n"
+        "SessionInfo:\n"
+        " Sessions:\n"
+        " - SessionNum: 0\n"
+        "   SessionLaps: 50\n"
+        "   SessionTime: unlimited\n"
+        "   SessionType: Race\n"
+        "DriverInfo:\n"
+        " DriverCarIdx: 0\n"
+        " DriverCarFuelMaxLtr: 100.000\n"
+        " Drivers:\n" );
+    for( int c=0; c<numCars && n < SessionInfoLen; ++c )
+        n += snprintf( yaml + n, SessionInfoLen - n,
+            " - CarIdx: %d\n"
+            "   UserName: Driver %d\n"
+            "   TeamName: Team %d\n"
+            "   CarNumber: \"%d\"\n"
+            "   CarClassID: 1\n"
+            "   CarClassShortName: GT3\n"
+            "   IRating: %d\n"
+            "   LicString: A 4.99\n"
+            "   IsSpectator: 0\n"
+            "   CarIsPaceCar: 0\n",
+            c, c+1, c+1, c+1, 1500 + 97 * c );
+    if( n < SessionInfoLen )
+        snprintf( yaml + n, SessionInfoLen - n, "...\n" );
+    l.header->sessionInfoUpdate++;
+
+    return true;
+}
+
+static int produce( int hz, int numCars, int seconds, bool unlink )
+{
+    char* mem = (char*)createShm( IRSDK_MEMMAPFILENAME, MemSize );
+    int* signal = (int*)createShm( IRSDK_DATAVALIDEVENTNAME, sizeof(int) );
+    if( !mem || !signal )
+    {
+        printf( "Can't create the shared memory\n" );
+        return 1;
+    }
+
+    Layout l;
+    if( !setupLayout( l, mem, hz, numCars ) )
+    {
+        printf( "The variables don't fit into %d bytes\n", MemSize );
+        return 1;
+    }
+
+    const int offSessionTime    = varOffset( l, "SessionTime" );
+    const int offSessionTick    = varOffset( l, "SessionTick" );
+    const int offSessionState   = varOffset( l, "SessionState" );
+    const int offSessionRemain  = varOffset( l, "SessionTimeRemain" );
+    const int offLapsTotal      = varOffset( l, "SessionLapsTotal" );
+    const int offIsOnTrack      = varOffset( l, "IsOnTrack" );
+    const int offLap            = varOffset( l, "Lap" );
+    const int offLapDistPct     = varOffset( l, "LapDistPct" );
+    const int offRpm            = varOffset( l, "RPM" );
+    const int offGear           = varOffset( l, "Gear" );
+    const int offSpeed          = varOffset( l, "Speed" );
+    const int offThrottle       = varOffset( l, "Throttle" );
+    const int offBrake          = varOffset( l, "Brake" );
+    const int offFuel           = varOffset( l, "FuelLevel" );
+    const int offCarLap         = varOffset( l, "CarIdxLap" );
+    const int offCarLapDone     = varOffset( l, "CarIdxLapCompleted" );
+    const int offCarDistPct     = varOffset( l, "CarIdxLapDistPct" );
+    const int offCarSurface     = varOffset( l, "CarIdxTrackSurface" );
+    const int offCarPos         = varOffset( l, "CarIdxPosition" );
+    const int offCarClassPos    = varOffset( l, "CarIdxClassPosition" );
+    const int offCarClass       = varOffset( l, "CarIdxClass" );
+    const int offCarEstTime     = varOffset( l, "CarIdxEstTime" );
+    const int offCarLastLap     = varOffset( l, "CarIdxLastLapTime" );
+    const int offCarRpm         = varOffset( l, "CarIdxRPM" );
+    const int offCarGear        = varOffset( l, "CarIdxGear" );
+
+    const double baseLapTime = 90.0;
+    std::vector<double> dist( MaxCars, 0 );     // laps driven
+    std::vector<int> order( numCars );
+
+    l.header->status = irsdk_stConnected;
+    printf( "Producing %d rows/s of %d bytes for %d cars%s\n", hz, l.header->bufLen, numCars, seconds ? "" : ", Ctrl-C to stop" );
+
+    const std::chrono::steady_clock::duration period = std::chrono::nanoseconds( 1000000000LL / hz );
+    std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now();
+
+    for( int tick=0; !g_quit && (!seconds || tick < seconds * hz); ++tick )
+    {
+        const double t = (double)tick / hz;
+
+        // the sim writes the oldest buffer, then publishes its tick count
+        int buf = 0;
+        for( int i=1; i<NumBuf; ++i )
+            if( l.header->varBuf[i].tickCount < l.header->varBuf[buf].tickCount )
+                buf = i;
+        char* row = mem + l.header->varBuf[buf].bufOffset;
+
+        for( int c=0; c<numCars; ++c )
+        {
+            const double lapTime = baseLapTime * (1.0 + 0.003 * c) + 0.5 * sin( t * 0.05 + c );
+            dist[c] += 1.0 / (lapTime * hz);
+            const double pct = dist[c] - floor( dist[c] );
+            const int lapsDone = (int)dist[c];
+            const float rpm = 5000.0f + 2500.0f * (float)sin( pct * 40.0 + c );
+
+            put<int>( row, offCarLap, c, lapsDone + 1 );
+            put<int>( row, offCarLapDone, c, lapsDone );
+            put<float>( row, offCarDistPct, c, (float)pct );
+            put<int>( row, offCarSurface, c, irsdk_OnTrack );
+            put<int>( row, offCarClass, c, 1 );
+            put<float>( row, offCarEstTime, c, (float)(pct * baseLapTime) );
+            put<float>( row, offCarLastLap, c, lapsDone ? (float)lapTime : -1.0f );
+            put<float>( row, offCarRpm, c, rpm );
+            put<int>( row, offCarGear, c, 3 + (int)(pct * 4) % 3 );
+            order[c] = c;
+        }
+
+        std::sort( order.begin(), order.end(), [&]( int a, int b ) { return dist[a] > dist[b]; } );
+        for( int p=0; p<numCars; ++p )
+        {
+            put<int>( row, offCarPos, order[p], p + 1 );
+            put<int>( row, offCarClassPos, order[p], p + 1 );
+        }
+
+        // car 0 is us
+        const double pct0 = dist[0] - floor( dist[0] );
+        put<double>( row, offSessionTime, 0, t );
+        put<int>( row, offSessionTick, 0, tick );
+        put<int>( row, offSessionState, 0, irsdk_StateRacing );
+        put<double>( row, offSessionRemain, 0, IRSDK_UNLIMITED_TIME );
+        put<int>( row, offLapsTotal, 0, 50 );
+        put<bool>( row, offIsOnTrack, 0, true );
+        put<int>( row, offLap, 0, (int)dist[0] + 1 );
+        put<float>( row, offLapDistPct, 0, (float)pct0 );
+        put<float>( row, offRpm, 0, 5000.0f + 2500.0f * (float)sin( pct0 * 40.0 ) );
+        put<int>( row, offGear, 0, 3 + (int)(pct0 * 4) % 3 );
+        put<float>( row, offSpeed, 0, 4000.0f / (float)baseLapTime );
+        put<float>( row, offThrottle, 0, (float)(0.5 + 0.5 * sin( pct0 * 40.0 )) );
+        put<float>( row, offBrake, 0, 0.0f );
+        put<float>( row, offFuel, 0, 100.0f - 2.5f * (float)dist[0] );
+
+        __atomic_store_n( &l.header->varBuf[buf].tickCount, tick, __ATOMIC_RELEASE );
+        signalRow( signal );
+
+        next += period;
+        std::this_thread::sleep_until( next );
+    }
+
+    // like the sim going away
+    l.header->status = 0;
+    signalRow( signal );
+
+    if( unlink )
+    {
+        shm_unlink( IRSDK_MEMMAPFILENAME );
+        shm_unlink( IRSDK_DATAVALIDEVENTNAME );
+    }
+
+    return 0;
+}
+
+//
+// Consumer
+//
+
+static int watch( int seconds )
+{
+    irsdkVar<double>        sessionTime( "SessionTime" );
+    irsdkVar<int>           sessionTick( "SessionTick" );
+    irsdkVar<int,MaxCars>   carLapDone( "CarIdxLapCompleted" );
+    irsdkVar<float,MaxCars> carDistPct( "CarIdxLapDistPct" );
+    irsdkVar<int,MaxCars>   carPos( "CarIdxPosition" );
+
+    irsdkClient& client = irsdkClient::instance();
+    client.setCopySubscribedOnly( true );
+    client.startIngestThread();
+
+    int rows = 0;
+    int gaps = 0;           // rows the producer wrote that we never saw
+    int inconsistent = 0;   // variables from different ticks in the same row
+    int lastTick = -1;
+
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point nextPrint = start + std::chrono::seconds( 1 );
+
+    while( !g_quit && (!seconds || std::chrono::steady_clock::now() < start + std::chrono::seconds( seconds )) )
+    {
+        if( client.waitForData( 16 ) && client.isConnected() )
+        {
+            const int tick = sessionTick.getInt();
+            const int hz = irsdk_getHeader()->tickRate;
+            if( (int)floor( sessionTime.getDouble() * hz + 0.5 ) != tick )
+                inconsistent++;
+
+            // every car's position has to agree with its distance in the same row
+            for( int c=0; c<MaxCars; ++c )
+                for( int d=0; d<MaxCars; ++d )
+                    if( carPos.getInt( c ) > 0 && carPos.getInt( d ) > 0 && carPos.getInt( c ) < carPos.getInt( d ) &&
+                        carLapDone.getInt( c ) + carDistPct.getFloat( c ) < carLapDone.getInt( d ) + carDistPct.getFloat( d ) )
+                        inconsistent++;
+
+            if( lastTick >= 0 && tick > lastTick + 1 )
+                gaps += tick - lastTick - 1;
+            lastTick = tick;
+            rows++;
+        }
+        client.frameDone();
+
+        if( std::chrono::steady_clock::now() >= nextPrint )
+        {
+            const irsdkLatencyStats& lat = client.getLatencyStats();
+            const irsdk_copyStats* cs = irsdk_getCopyStats();
+            printf( "%s rows %5d  missed %4d  dropped %4d  inconsistent %d  latency mean %6.1f us  max %7.1f us  copy %5.1f us  %d bytes in %d pieces  torn %d\n",
+                client.isConnected() ? "connected   " : "disconnected",
+                rows, gaps, lat.dropped, inconsistent, lat.meanUs, lat.maxUs, cs->lastCopyUs,
+                client.getCopyBytes(), client.getCopyRangeCount(), cs->tornReads );
+            fflush( stdout );
+            nextPrint += std::chrono::seconds( 1 );
+        }
+    }
+
+    client.stopIngestThread();
+    return inconsistent ? 1 : 0;
+}
+
+int main( int argc, char** argv )
+{
+    int hz = 60;
+    int cars = 20;
+    int seconds = 0;
+    bool unlink = false;
+    bool watching = false;
+
+    for( int i=1; i<argc; ++i )
+    {
+        if( !strcmp( argv[i], "--hz" ) && i+1 < argc )
+            hz = std::max( 1, atoi( argv[++i] ) );
+        else if( !strcmp( argv[i], "--cars" ) && i+1 < argc )
+            cars = std::min( MaxCars, std::max( 1, atoi( argv[++i] ) ) );
+        else if( !strcmp( argv[i], "--seconds" ) && i+1 < argc )
+            seconds = std::max( 0, atoi( argv[++i] ) );
+        else if( !strcmp( argv[i], "--unlink" ) )
+            unlink = true;
+        else if( !strcmp( argv[i], "--watch" ) )
+            watching = true;
+        else
+        {
+            printf( "usage: shmproducer [--hz N] [--cars N] [--seconds N] [--unlink]\n       shmproducer --watch [--seconds N]\n" );
+            return 1;
+        }
+    }
+
+    signal( SIGINT, onSignal );
+    signal( SIGTERM, onSignal );
+
+    return watching ? watch( seconds ) : produce( hz, cars, seconds, unlink );
+}
@@ -0,0 +1,337 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#pragma once
+
+//
+// The telemetry variables the sim publishes, with the same names, types and array sizes in the same
+// order as iracing.cpp declares them (290 variables, about 7.4 KB per row), for the tools that stand
+// in for the sim. The ones the overlays read are marked as used.
+//
+
+#include "../irsdk/irsdk_defines.h"
+
+struct SimVar
+{
+    const char* name;
+    int         type;
+    int         count;
+    int         used;   // read by the overlays
+};
+
+static const SimVar SimVars[] =
+{
+    { "SessionTime",                     irsdk_double,  1, 1 },
+    { "SessionTick",                     irsdk_int,     1, 0 },
+    { "SessionNum",                      irsdk_int,     1, 1 },
+    { "SessionState",                    irsdk_int,     1, 1 },
+    { "SessionUniqueID",                 irsdk_int,     1, 0 },
+    { "SessionFlags",                    irsdk_int,     1, 1 },
+    { "SessionTimeRemain",               irsdk_double,  1, 1 },
+    { "SessionLapsRemain",               irsdk_int,     1, 0 },
+    { "SessionLapsRemainEx",             irsdk_int,     1, 1 },
+    { "SessionTimeTotal",                irsdk_double,  1, 0 },
+    { "SessionLapsTotal",                irsdk_int,     1, 1 },
+    { "SessionTimeOfDay",                irsdk_float,   1, 0 },
+    { "RadioTransmitCarIdx",             irsdk_int,     1, 0 },
+    { "RadioTransmitRadioIdx",           irsdk_int,     1, 0 },
+    { "RadioTransmitFrequencyIdx",       irsdk_int,     1, 0 },
+    { "DisplayUnits",                    irsdk_int,     1, 1 },
+    { "DriverMarker",                    irsdk_bool,    1, 0 },
+    { "PushToPass",                      irsdk_bool,    1, 0 },
+    { "ManualBoost",                     irsdk_bool,    1, 0 },
+    { "ManualNoBoost",                   irsdk_bool,    1, 0 },
+    { "IsOnTrack",                       irsdk_bool,    1, 1 },
+    { "IsReplayPlaying",                 irsdk_bool,    1, 0 },
+    { "ReplayFrameNum",                  irsdk_int,     1, 0 },
+    { "ReplayFrameNumEnd",               irsdk_int,     1, 0 },
+    { "IsDiskLoggingEnabled",            irsdk_bool,    1, 0 },
+    { "IsDiskLoggingActive",             irsdk_bool,    1, 0 },
+    { "FrameRate",                       irsdk_float,   1, 0 },
+    { "CpuUsageFG",                      irsdk_float,   1, 0 },
+    { "GpuUsage",                        irsdk_float,   1, 0 },
+    { "ChanAvgLatency",                  irsdk_float,   1, 0 },
+    { "ChanLatency",                     irsdk_float,   1, 0 },
+    { "ChanQuality",                     irsdk_float,   1, 0 },
+    { "ChanPartnerQuality",              irsdk_float,   1, 0 },
+    { "CpuUsageBG",                      irsdk_float,   1, 0 },
+    { "ChanClockSkew",                   irsdk_float,   1, 0 },
+    { "MemPageFaultSec",                 irsdk_float,   1, 0 },
+    { "PlayerCarPosition",               irsdk_int,     1, 0 },
+    { "PlayerCarClassPosition",          irsdk_int,     1, 0 },
+    { "PlayerCarClass",                  irsdk_int,     1, 0 },
+    { "PlayerTrackSurface",              irsdk_int,     1, 0 },
+    { "PlayerTrackSurfaceMaterial",      irsdk_int,     1, 0 },
+    { "PlayerCarIdx",                    irsdk_int,     1, 0 },
+    { "PlayerCarTeamIncidentCount",      irsdk_int,     1, 0 },
+    { "PlayerCarMyIncidentCount",        irsdk_int,     1, 1 },
+    { "PlayerCarDriverIncidentCount",    irsdk_int,     1, 0 },
+    { "PlayerCarWeightPenalty",          irsdk_float,   1, 0 },
+    { "PlayerCarPowerAdjust",            irsdk_float,   1, 0 },
+    { "PlayerCarDryTireSetLimit",        irsdk_int,     1, 0 },
+    { "PlayerCarTowTime",                irsdk_float,   1, 0 },
+    { "PlayerCarInPitStall",             irsdk_bool,    1, 0 },
+    { "PlayerCarPitSvStatus",            irsdk_int,     1, 0 },
+    { "PlayerTireCompound",              irsdk_int,     1, 0 },
+    { "PlayerFastRepairsUsed",           irsdk_int,     1, 0 },
+    { "CarIdxLap",                       irsdk_int,    64, 1 },
+    { "CarIdxLapCompleted",              irsdk_int,    64, 1 },
+    { "CarIdxLapDistPct",                irsdk_float,  64, 1 },
+    { "CarIdxTrackSurface",              irsdk_int,    64, 1 },
+    { "CarIdxTrackSurfaceMaterial",      irsdk_int,    64, 1 },
+    { "CarIdxOnPitRoad",                 irsdk_bool,   64, 1 },
+    { "CarIdxPosition",                  irsdk_int,    64, 1 },
+    { "CarIdxClassPosition",             irsdk_int,    64, 1 },
+    { "CarIdxClass",                     irsdk_int,    64, 1 },
+    { "CarIdxF2Time",                    irsdk_float,  64, 1 },
+    { "CarIdxEstTime",                   irsdk_float,  64, 1 },
+    { "CarIdxLastLapTime",               irsdk_float,  64, 1 },
+    { "CarIdxBestLapTime",               irsdk_float,  64, 1 },
+    { "CarIdxBestLapNum",                irsdk_int,    64, 1 },
+    { "CarIdxTireCompound",              irsdk_int,    64, 1 },
+    { "CarIdxQualTireCompound",          irsdk_int,    64, 1 },
+    { "CarIdxQualTireCompoundLocked",    irsdk_bool,   64, 1 },
+    { "CarIdxFastRepairsUsed",           irsdk_int,    64, 1 },
+    { "PaceMode",                        irsdk_int,     1, 1 },
+    { "CarIdxPaceLine",                  irsdk_int,    64, 1 },
+    { "CarIdxPaceRow",                   irsdk_int,    64, 1 },
+    { "CarIdxPaceFlags",                 irsdk_int,    64, 1 },
+    { "OnPitRoad",                       irsdk_bool,    1, 0 },
+    { "CarIdxSteer",                     irsdk_float,  64, 1 },
+    { "CarIdxRPM",                       irsdk_float,  64, 1 },
+    { "CarIdxGear",                      irsdk_int,    64, 1 },
+    { "SteeringWheelAngle",              irsdk_float,   1, 1 },
+    { "Throttle",                        irsdk_float,   1, 1 },
+    { "Brake",                           irsdk_float,   1, 1 },
+    { "Clutch",                          irsdk_float,   1, 0 },
+    { "Gear",                            irsdk_int,     1, 1 },
+    { "RPM",                             irsdk_float,   1, 1 },
+    { "Lap",                             irsdk_int,     1, 0 },
+    { "LapCompleted",                    irsdk_int,     1, 0 },
+    { "LapDist",                         irsdk_float,   1, 0 },
+    { "LapDistPct",                      irsdk_float,   1, 0 },
+    { "RaceLaps",                        irsdk_int,     1, 0 },
+    { "LapBestLap",                      irsdk_int,     1, 0 },
+    { "LapBestLapTime",                  irsdk_float,   1, 1 },
+    { "LapLastLapTime",                  irsdk_float,   1, 1 },
+    { "LapCurrentLapTime",               irsdk_float,   1, 0 },
+    { "LapLasNLapSeq",                   irsdk_int,     1, 0 },
+    { "LapLastNLapTime",                 irsdk_float,   1, 0 },
+    { "LapBestNLapLap",                  irsdk_int,     1, 0 },
+    { "LapBestNLapTime",                 irsdk_float,   1, 0 },
+    { "LapDeltaToBestLap",               irsdk_float,   1, 0 },
+    { "LapDeltaToBestLap_DD",            irsdk_float,   1, 0 },
+    { "LapDeltaToBestLap_OK",            irsdk_bool,    1, 0 },
+    { "LapDeltaToOptimalLap",            irsdk_float,   1, 0 },
+    { "LapDeltaToOptimalLap_DD",         irsdk_float,   1, 0 },
+    { "LapDeltaToOptimalLap_OK",         irsdk_bool,    1, 0 },
+    { "LapDeltaToSessionBestLap",        irsdk_float,   1, 1 },
+    { "LapDeltaToSessionBestLap_DD",     irsdk_float,   1, 0 },
+    { "LapDeltaToSessionBestLap_OK",     irsdk_bool,    1, 1 },
+    { "LapDeltaToSessionOptimalLap",     irsdk_float,   1, 0 },
+    { "LapDeltaToSessionOptimalLap_DD",  irsdk_float,   1, 0 },
+    { "LapDeltaToSessionOptimalLap_OK",  irsdk_bool,    1, 0 },
+    { "LapDeltaToSessionLastlLap",       irsdk_float,   1, 0 },
+    { "LapDeltaToSessionLastlLap_DD",    irsdk_float,   1, 0 },
+    { "LapDeltaToSessionLastlLap_OK",    irsdk_bool,    1, 0 },
+    { "Speed",                           irsdk_float,   1, 1 },
+    { "Yaw",                             irsdk_float,   1, 0 },
+    { "YawNorth",                        irsdk_float,   1, 0 },
+    { "Pitch",                           irsdk_float,   1, 0 },
+    { "Roll",                            irsdk_float,   1, 0 },
+    { "EnterExitReset",                  irsdk_int,     1, 0 },
+    { "TrackTemp",                       irsdk_float,   1, 0 },
+    { "TrackTempCrew",                   irsdk_float,   1, 1 },
+    { "AirTemp",                         irsdk_float,   1, 1 },
+    { "WeatherType",                     irsdk_int,     1, 0 },
+    { "Skies",                           irsdk_int,     1, 0 },
+    { "AirDensity",                      irsdk_float,   1, 0 },
+    { "AirPressure",                     irsdk_float,   1, 0 },
+    { "WindVel",                         irsdk_float,   1, 0 },
+    { "WindDir",                         irsdk_float,   1, 0 },
+    { "RelativeHumidity",                irsdk_float,   1, 0 },
+    { "FogLevel",                        irsdk_float,   1, 0 },
+    { "DCLapStatus",                     irsdk_int,     1, 0 },
+    { "DCDriversSoFar",                  irsdk_int,     1, 0 },
+    { "OkToReloadTextures",              irsdk_bool,    1, 0 },
+    { "LoadNumTextures",                 irsdk_bool,    1, 0 },
+    { "CarLeftRight",                    irsdk_int,     1, 0 },
+    { "PitsOpen",                        irsdk_bool,    1, 0 },
+    { "VidCapEnabled",                   irsdk_bool,    1, 0 },
+    { "VidCapActive",                    irsdk_bool,    1, 0 },
+    { "PitRepairLeft",                   irsdk_float,   1, 0 },
+    { "PitOptRepairLeft",                irsdk_float,   1, 0 },
+    { "PitstopActive",                   irsdk_bool,    1, 0 },
+    { "FastRepairUsed",                  irsdk_int,     1, 0 },
+    { "FastRepairAvailable",             irsdk_int,     1, 0 },
+    { "LFTiresUsed",                     irsdk_int,     1, 0 },
+    { "RFTiresUsed",                     irsdk_int,     1, 0 },
+    { "LRTiresUsed",                     irsdk_int,     1, 0 },
+    { "RRTiresUsed",                     irsdk_int,     1, 0 },
+    { "LeftTireSetsUsed",                irsdk_int,     1, 0 },
+    { "RightTireSetsUsed",               irsdk_int,     1, 0 },
+    { "FrontTireSetsUsed",               irsdk_int,     1, 0 },
+    { "RearTireSetsUsed",                irsdk_int,     1, 0 },
+    { "TireSetsUsed",                    irsdk_int,     1, 0 },
+    { "LFTiresAvailable",                irsdk_int,     1, 0 },
+    { "RFTiresAvailable",                irsdk_int,     1, 0 },
+    { "LRTiresAvailable",                irsdk_int,     1, 0 },
+    { "RRTiresAvailable",                irsdk_int,     1, 0 },
+    { "LeftTireSetsAvailable",           irsdk_int,     1, 1 },
+    { "RightTireSetsAvailable",          irsdk_int,     1, 1 },
+    { "FrontTireSetsAvailable",          irsdk_int,     1, 0 },
+    { "RearTireSetsAvailable",           irsdk_int,     1, 0 },
+    { "TireSetsAvailable",               irsdk_int,     1, 0 },
+    { "CamCarIdx",                       irsdk_int,     1, 0 },
+    { "CamCameraNumber",                 irsdk_int,     1, 0 },
+    { "CamGroupNumber",                  irsdk_int,     1, 0 },
+    { "CamCameraState",                  irsdk_int,     1, 0 },
+    { "IsOnTrackCar",                    irsdk_bool,    1, 1 },
+    { "IsInGarage",                      irsdk_bool,    1, 0 },
+    { "SteeringWheelPctTorque",          irsdk_float,   1, 0 },
+    { "SteeringWheelPctTorqueSign",      irsdk_float,   1, 0 },
+    { "SteeringWheelPctTorqueSignStops", irsdk_float,   1, 0 },
+    { "SteeringWheelPctDamper",          irsdk_float,   1, 0 },
+    { "SteeringWheelAngleMax",           irsdk_float,   1, 1 },
+    { "SteeringWheelLimiter",            irsdk_float,   1, 0 },
+    { "ShiftIndicatorPct",               irsdk_float,   1, 0 },
+    { "ShiftPowerPct",                   irsdk_float,   1, 0 },
+    { "ShiftGrindRPM",                   irsdk_float,   1, 0 },
+    { "ThrottleRaw",                     irsdk_float,   1, 0 },
+    { "BrakeRaw",                        irsdk_float,   1, 0 },
+    { "HandbrakeRaw",                    irsdk_float,   1, 0 },
+    { "SteeringWheelPeakForceNm",        irsdk_float,   1, 0 },
+    { "SteeringWheelMaxForceNm",         irsdk_float,   1, 0 },
+    { "SteeringWheelUseLinear",          irsdk_bool,    1, 0 },
+    { "BrakeABSactive",                  irsdk_bool,    1, 0 },
+    { "EngineWarnings",                  irsdk_int,     1, 1 },
+    { "FuelLevel",                       irsdk_float,   1, 1 },
+    { "FuelLevelPct",                    irsdk_float,   1, 1 },
+    { "PitSvFlags",                      irsdk_int,     1, 0 },
+    { "PitSvLFP",                        irsdk_float,   1, 0 },
+    { "PitSvRFP",                        irsdk_float,   1, 0 },
+    { "PitSvLRP",                        irsdk_float,   1, 0 },
+    { "PitSvRRP",                        irsdk_float,   1, 0 },
+    { "PitSvFuel",                       irsdk_float,   1, 1 },
+    { "PitSvTireCompound",               irsdk_int,     1, 0 },
+    { "CarIdxP2P_Status",                irsdk_bool,   64, 1 },
+    { "CarIdxP2P_Count",                 irsdk_int,    64, 1 },
+    { "ReplayPlaySpeed",                 irsdk_int,     1, 0 },
+    { "ReplayPlaySlowMotion",            irsdk_bool,    1, 0 },
+    { "ReplaySessionTime",               irsdk_double,  1, 0 },
+    { "ReplaySessionNum",                irsdk_int,     1, 0 },
+    { "TireLF_RumblePitch",              irsdk_float,   1, 0 },
+    { "TireRF_RumblePitch",              irsdk_float,   1, 0 },
+    { "TireLR_RumblePitch",              irsdk_float,   1, 0 },
+    { "TireRR_RumblePitch",              irsdk_float,   1, 0 },
+    { "SteeringWheelTorque_ST",          irsdk_float,   6, 0 },
+    { "SteeringWheelTorque",             irsdk_float,   1, 0 },
+    { "VelocityZ_ST",                    irsdk_float,   6, 0 },
+    { "VelocityY_ST",                    irsdk_float,   6, 0 },
+    { "VelocityX_ST",                    irsdk_float,   6, 0 },
+    { "VelocityZ",                       irsdk_float,   1, 0 },
+    { "VelocityY",                       irsdk_float,   1, 0 },
+    { "VelocityX",                       irsdk_float,   1, 0 },
+    { "YawRate_ST",                      irsdk_float,   6, 0 },
+    { "PitchRate_ST",                    irsdk_float,   6, 0 },
+    { "RollRate_ST",                     irsdk_float,   6, 0 },
+    { "YawRate",                         irsdk_float,   1, 0 },
+    { "PitchRate",                       irsdk_float,   1, 0 },
+    { "RollRate",                        irsdk_float,   1, 0 },
+    { "VertAccel_ST",                    irsdk_float,   6, 0 },
+    { "LatAccel_ST",                     irsdk_float,   6, 0 },
+    { "LongAccel_ST",                    irsdk_float,   6, 0 },
+    { "VertAccel",                       irsdk_float,   1, 0 },
+    { "LatAccel",                        irsdk_float,   1, 0 },
+    { "LongAccel",                       irsdk_float,   1, 0 },
+    { "dcStarter",                       irsdk_bool,    1, 0 },
+    { "dpRTireChange",                   irsdk_float,   1, 1 },
+    { "dpLTireChange",                   irsdk_float,   1, 1 },
+    { "dpFuelFill",                      irsdk_float,   1, 1 },
+    { "dpWindshieldTearoff",             irsdk_float,   1, 0 },
+    { "dpFuelAddKg",                     irsdk_float,   1, 0 },
+    { "dpFastRepair",                    irsdk_float,   1, 0 },
+    { "dcBrakeBias",                     irsdk_float,   1, 1 },
+    { "dpLFTireColdPress",               irsdk_float,   1, 0 },
+    { "dpRFTireColdPress",               irsdk_float,   1, 0 },
+    { "dpLRTireColdPress",               irsdk_float,   1, 0 },
+    { "dpRRTireColdPress",               irsdk_float,   1, 0 },
+    { "dpWeightJackerLeft",              irsdk_float,   1, 0 },
+    { "dpWeightJackerRight",             irsdk_float,   1, 0 },
+    { "WaterTemp",                       irsdk_float,   1, 1 },
+    { "WaterLevel",                      irsdk_float,   1, 0 },
+    { "FuelPress",                       irsdk_float,   1, 0 },
+    { "FuelUsePerHour",                  irsdk_float,   1, 0 },
+    { "OilTemp",                         irsdk_float,   1, 1 },
+    { "OilPress",                        irsdk_float,   1, 0 },
+    { "OilLevel",                        irsdk_float,   1, 0 },
+    { "Voltage",                         irsdk_float,   1, 0 },
+    { "ManifoldPress",                   irsdk_float,   1, 0 },
+    { "RFcoldPressure",                  irsdk_float,   1, 0 },
+    { "RFtempCL",                        irsdk_float,   1, 0 },
+    { "RFtempCM",                        irsdk_float,   1, 0 },
+    { "RFtempCR",                        irsdk_float,   1, 0 },
+    { "RFwearL",                         irsdk_float,   1, 1 },
+    { "RFwearM",                         irsdk_float,   1, 1 },
+    { "RFwearR",                         irsdk_float,   1, 1 },
+    { "LFcoldPressure",                  irsdk_float,   1, 0 },
+    { "LFtempCL",                        irsdk_float,   1, 0 },
+    { "LFtempCM",                        irsdk_float,   1, 0 },
+    { "LFtempCR",                        irsdk_float,   1, 0 },
+    { "LFwearL",                         irsdk_float,   1, 1 },
+    { "LFwearM",                         irsdk_float,   1, 1 },
+    { "LFwearR",                         irsdk_float,   1, 1 },
+    { "RRcoldPressure",                  irsdk_float,   1, 0 },
+    { "RRtempCL",                        irsdk_float,   1, 0 },
+    { "RRtempCM",                        irsdk_float,   1, 0 },
+    { "RRtempCR",                        irsdk_float,   1, 0 },
+    { "RRwearL",                         irsdk_float,   1, 1 },
+    { "RRwearM",                         irsdk_float,   1, 1 },
+    { "RRwearR",                         irsdk_float,   1, 1 },
+    { "LRcoldPressure",                  irsdk_float,   1, 0 },
+    { "LRtempCL",                        irsdk_float,   1, 0 },
+    { "LRtempCM",                        irsdk_float,   1, 0 },
+    { "LRtempCR",                        irsdk_float,   1, 0 },
+    { "LRwearL",                         irsdk_float,   1, 1 },
+    { "LRwearM",                         irsdk_float,   1, 1 },
+    { "LRwearR",                         irsdk_float,   1, 1 },
+    { "RRSHshockDefl",                   irsdk_float,   1, 0 },
+    { "RRSHshockDefl_ST",                irsdk_float,   6, 0 },
+    { "RRSHshockVel",                    irsdk_float,   1, 0 },
+    { "RRSHshockVel_ST",                 irsdk_float,   6, 0 },
+    { "LRSHshockDefl",                   irsdk_float,   1, 0 },
+    { "LRSHshockDefl_ST",                irsdk_float,   6, 0 },
+    { "LRSHshockVel",                    irsdk_float,   1, 0 },
+    { "LRSHshockVel_ST",                 irsdk_float,   6, 0 },
+    { "RFSHshockDefl",                   irsdk_float,   1, 0 },
+    { "RFSHshockDefl_ST",                irsdk_float,   6, 0 },
+    { "RFSHshockVel",                    irsdk_float,   1, 0 },
+    { "RFSHshockVel_ST",                 irsdk_float,   6, 0 },
+    { "LFSHshockDefl",                   irsdk_float,   1, 0 },
+    { "LFSHshockDefl_ST",                irsdk_float,   6, 0 },
+    { "LFSHshockVel",                    irsdk_float,   1, 0 },
+    { "LFSHshockVel_ST",                 irsdk_float,   6, 0 },
+};
+
+static const int NumSimVars = sizeof(SimVars) / sizeof(SimVars[0]);
@@ -0,0 +1,197 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+//
+// Snapshot reader stress test.
+//
+// Runs irsdk_copyNewestRow() against a fake sim on another thread that rewrites the triple buffered
+// rows the way iRacing does: always the oldest buffer, tick count updated once the row is written.
+// Every row holds nothing but its own tick count, so any copy that mixes two rows shows up.
+// Fails if a torn copy goes undetected, or if copied and skipped ticks don't add up.
+//
+// Only depends on the snapshot reader, so it builds anywhere:
+//
+//   g++ -O2 -std=c++17 -pthread -o snapshotstress tools/snapshotstress.cpp irsdk/irsdk_snapshot.cpp
+//
+// Usage:
+//
+//   snapshotstress [--seconds N]
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include "../irsdk/irsdk_snapshot.h"
+
+typedef std::chrono::steady_clock Clock;
+
+struct Scenario
+{
+    const char* name;
+    int         rateHz;         // 0 = as fast as possible
+    int         rowBytes;
+    int         readEveryMs;    // 0 = as fast as possible
+};
+
+struct FakeSim
+{
+    std::vector<int>    mem;    // header, then the rows
+    irsdk_header*       header;
+    char*               shared;
+    std::atomic<bool>   stop;
+    std::atomic<int>    produced;
+};
+
+static void setupFakeSim( FakeSim& sim, int rowBytes )
+{
+    const int numBuf = 3;
+    const int headerBytes = 1024;
+    rowBytes = (rowBytes + 63) & ~63;
+
+    sim.mem.assign( (headerBytes + numBuf * rowBytes) / sizeof(int), 0 );
+    sim.shared = (char*)sim.mem.data();
+    sim.header = (irsdk_header*)sim.shared;
+    sim.header->ver = IRSDK_VER;
+    sim.header->status = irsdk_stConnected;
+    sim.header->tickRate = 60;
+    sim.header->numBuf = numBuf;
+    sim.header->bufLen = rowBytes;
+    for( int i=0; i<numBuf; ++i )
+    {
+        sim.header->varBuf[i].tickCount = 0;
+        sim.header->varBuf[i].bufOffset = headerBytes + i * rowBytes;
+    }
+    sim.stop = false;
+    sim.produced = 0;
+}
+
+static void produce( FakeSim* sim, int rateHz )
+{
+    irsdk_header* header = sim->header;
+    const Clock::duration period = rateHz ? std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( 1.0 / rateHz ) ) : Clock::duration( 0 );
+    Clock::time_point next = Clock::now();
+
+    for( int tick=1; !sim->stop; ++tick )
+    {
+        // overwrite the oldest row
+        int buf = 0;
+        for( int i=1; i<header->numBuf; ++i )
+            if( header->varBuf[i].tickCount < header->varBuf[buf].tickCount )
+                buf = i;
+
+        volatile int* row = (volatile int*)(sim->shared + header->varBuf[buf].bufOffset);
+        for( int i=0; i<header->bufLen/(int)sizeof(int); ++i )
+            row[i] = tick;
+
+        // then publish it
+        std::atomic_thread_fence( std::memory_order_release );
+        *(volatile int*)&header->varBuf[buf].tickCount = tick;
+        sim->produced = tick;
+
+        if( rateHz )
+        {
+            next += period;
+            std::this_thread::sleep_until( next );
+        }
+    }
+}
+
+static bool run( const Scenario& sc, double seconds )
+{
+    FakeSim sim;
+    setupFakeSim( sim, sc.rowBytes );
+
+    std::vector<int> data( sim.header->bufLen / sizeof(int) );
+    irsdk_copyStats stats = {};
+    int lastTick = 0;
+    int undetected = 0;
+
+    std::thread producer( produce, &sim, sc.rateHz );
+
+    const Clock::time_point end = Clock::now() + std::chrono::duration_cast<Clock::duration>( std::chrono::duration<double>( seconds ) );
+    while( Clock::now() < end )
+    {
+        const int tick = irsdk_copyNewestRow( sim.header, sim.shared, lastTick, (char*)data.data(), NULL, 0, &stats );
+        if( tick >= 0 )
+        {
+            for( int v : data )
+            {
+                if( v != tick )
+                {
+                    undetected++;
+                    break;
+                }
+            }
+            lastTick = tick;
+        }
+
+        if( sc.readEveryMs )
+            std::this_thread::sleep_for( std::chrono::milliseconds( sc.readEveryMs ) );
+    }
+
+    sim.stop = true;
+    producer.join();
+
+    const bool accounted = stats.copies + stats.skippedTicks == lastTick;
+    const bool ok = !undetected && accounted;
+
+    printf( "%s\n", sc.name );
+    printf( "    produced %d ticks, copied %d, skipped %d, last copied tick %d%s\n", sim.produced.load(), stats.copies, stats.skippedTicks, lastTick, accounted ? "" : "  <-- DOESN'T ADD UP" );
+    printf( "    torn reads %d, retries %d, failed reads %d, undetected torn reads %d%s\n", stats.tornReads, stats.retries, stats.failedReads, undetected, undetected ? "  <-- FAILED" : "" );
+    printf( "    copy %.2f us mean, %.2f us max\n\n", stats.copies ? stats.totalCopyUs / stats.copies : 0.0, stats.maxCopyUs );
+    return ok;
+}
+
+int main( int argc, char** argv )
+{
+    double seconds = 3;
+
+    for( int i=1; i<argc; ++i )
+    {
+        if( !strcmp( argv[i], "--seconds" ) && i+1<argc )
+            seconds = atof( argv[++i] );
+        else
+        {
+            printf( "usage: snapshotstress [--seconds N]\n" );
+            return 1;
+        }
+    }
+
+    const Scenario scenarios[] =
+    {
+        { "360 Hz sim, reading every 16 ms like iRon",          360,  7431,    16 },
+        { "360 Hz sim, reading as fast as possible",            360,  7431,    0 },
+        { "unthrottled sim with 1 MB rows, unthrottled reader", 0,    1 << 20, 0 },
+    };
+
+    bool ok = true;
+    for( const Scenario& sc : scenarios )
+        ok &= run( sc, seconds );
+
+    printf( ok ? "PASSED\n" : "FAILED\n" );
+    return ok ? 0 : 1;
+}
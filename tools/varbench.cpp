@@ -0,0 +1,289 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//
+// Telemetry variable read benchmark.
+//
+// Compares the cost of reading telemetry through irsdkCVar (name lookup cached per connection, but a
+// connection check, header lookup and type switch on every read) with irsdkVar<T,N> (offset cached
+// per connection, a status check and a load per read). Also times resolving all variables on connect.
+//
+// The irsdk shared memory functions are replaced by an in-memory fake with the variables from
+// simvars.h, so this runs without the sim:
+//
+//   cl /O2 /EHsc /DNDEBUG tools\varbench.cpp irsdk\irsdk_client.cpp irsdk\yaml_parser.cpp
+//
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include "../irsdk/irsdk_defines.h"
+#include "../irsdk/irsdk_client.h"
+#include "simvars.h"
+
+//
+// Fake irsdk backend
+//
+
+static const int MaxCars = 64;
+static irsdk_header g_header;
+static std::vector<irsdk_varHeader> g_vars;
+static std::vector<char> g_row;
+static time_t g_lastValidTime;
+
+static int varIndex( const char* name )
+{
+    for( int i=0; i<NumSimVars; ++i )
+        if( !strcmp( SimVars[i].name, name ) )
+            return i;
+    return -1;
+}
+
+static void setupFakeSim()
+{
+    g_vars.resize( NumSimVars );
+
+    int offset = 0;
+    for( int i=0; i<NumSimVars; ++i )
+    {
+        irsdk_varHeader& vh = g_vars[i];
+        vh.clear();
+        strcpy( vh.name, SimVars[i].name );
+        vh.type = SimVars[i].type;
+        vh.count = SimVars[i].count;
+        vh.offset = offset;
+        offset += irsdk_VarTypeBytes[vh.type] * vh.count;
+    }
+
+    // the ones we read
+    const int pctOffset = g_vars[varIndex( "CarIdxLapDistPct" )].offset;
+    const int lapOffset = g_vars[varIndex( "CarIdxLap" )].offset;
+
+    g_row.assign( offset, 0 );
+    for( int i=0; i<MaxCars; ++i )
+    {
+        const float pct = i / float(MaxCars);
+        memcpy( &g_row[pctOffset + 4*i], &pct, 4 );
+        memcpy( &g_row[lapOffset + 4*i], &i, 4 );
+    }
+
+    memset( &g_header, 0, sizeof(g_header) );
+    g_header.ver = IRSDK_VER;
+    g_header.status = irsdk_stConnected;
+    g_header.tickRate = 60;
+    g_header.numVars = NumSimVars;
+    g_header.numBuf = 1;
+    g_header.bufLen = offset;
+    g_lastValidTime = time( NULL );
+}
+
+bool irsdk_startup() { return true; }
+void irsdk_shutdown() {}
+
+bool irsdk_getNewDataRanges( char* data, const irsdk_dataRange* ranges, int numRanges )
+{
+    if( !ranges )
+        memcpy( data, g_row.data(), g_row.size() );
+    for( int i=0; ranges && i<numRanges; ++i )
+        memcpy( data + ranges[i].offset, g_row.data() + ranges[i].offset, ranges[i].len );
+    return true;
+}
+
+bool irsdk_getNewData( char* data )
+{
+    return irsdk_getNewDataRanges( data, NULL, 0 );
+}
+
+bool irsdk_waitForDataReadyRanges( int, char* data, const irsdk_dataRange* ranges, int numRanges )
+{
+    if( data )
+        irsdk_getNewDataRanges( data, ranges, numRanges );
+    return true;
+}
+
+bool irsdk_waitForDataReady( int timeOut, char* data )
+{
+    return irsdk_waitForDataReadyRanges( timeOut, data, NULL, 0 );
+}
+
+bool irsdk_copyLatestDataRanges( char* data, const irsdk_dataRange* ranges, int numRanges )
+{
+    return irsdk_getNewDataRanges( data, ranges, numRanges );
+}
+
+static irsdk_copyStats g_copyStats;
+const irsdk_copyStats* irsdk_getCopyStats() { return &g_copyStats; }
+void irsdk_resetCopyStats() { memset( &g_copyStats, 0, sizeof(g_copyStats) ); }
+
+// same work as the real one
+bool irsdk_isConnected()
+{
+    int elapsed = (int)difftime( time(NULL), g_lastValidTime );
+    return (g_header.status & irsdk_stConnected) > 0 && elapsed < 30;
+}
+
+const irsdk_header* irsdk_getHeader() { return &g_header; }
+const char* irsdk_getData( int ) { return g_row.data(); }
+const char* irsdk_getSessionInfoStr() { return ""; }
+int irsdk_getSessionInfoStrUpdate() { return 0; }
+const irsdk_varHeader* irsdk_getVarHeaderPtr() { return g_vars.data(); }
+
+const irsdk_varHeader* irsdk_getVarHeaderEntry( int index )
+{
+    if( index >= 0 && index < g_header.numVars )
+        return &g_vars[index];
+    return NULL;
+}
+
+int irsdk_varNameToIndex( const char* name )
+{
+    for( int index=0; index<g_header.numVars; index++ )
+        if( 0 == strncmp( name, g_vars[index].name, IRSDK_MAX_STRING ) )
+            return index;
+    return -1;
+}
+
+int irsdk_varNameToOffset( const char* name )
+{
+    const irsdk_varHeader* vh = irsdk_getVarHeaderEntry( irsdk_varNameToIndex( name ) );
+    return vh ? vh->offset : -1;
+}
+
+//
+// Benchmark
+//
+
+typedef std::chrono::steady_clock Clock;
+
+template<typename F>
+static double nsPerRead( int reads, F f )
+{
+    double best = 1e30;
+    for( int it=0; it<5; ++it )
+    {
+        const Clock::time_point t0 = Clock::now();
+        f();
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - t0 ).count();
+        if( ns < best )
+            best = ns;
+    }
+    return best / reads;
+}
+
+int main()
+{
+    setupFakeSim();
+    irsdkClient::instance().waitForData( 0 );
+
+    irsdkCVar oldPct( "CarIdxLapDistPct" );
+    irsdkCVar oldLap( "CarIdxLap" );
+    irsdkVar<float,MaxCars> newPct( "CarIdxLapDistPct" );
+    irsdkVar<int,MaxCars> newLap( "CarIdxLap" );
+
+    // roughly what the overlays do per frame: a few vars for every car, many times over
+    const int frames = 20000;
+    const int reads = frames * MaxCars * 2;
+    volatile float sink = 0;
+
+    const double oldNs = nsPerRead( reads, [&]() {
+        float sum = 0;
+        for( int f=0; f<frames; ++f )
+            for( int i=0; i<MaxCars; ++i )
+                sum += oldPct.getFloat(i) + oldLap.getInt(i);
+        sink = sum;
+    });
+
+    const double newNs = nsPerRead( reads, [&]() {
+        float sum = 0;
+        for( int f=0; f<frames; ++f )
+            for( int i=0; i<MaxCars; ++i )
+                sum += newPct.getFloat(i) + newLap.getInt(i);
+        sink = sum;
+    });
+
+    if( oldPct.getFloat(10) != newPct.getFloat(10) || oldLap.getInt(10) != newLap.getInt(10) )
+    {
+        printf( "MISMATCH between irsdkCVar and irsdkVar\n" );
+        return 1;
+    }
+
+    printf( "irsdkCVar           %6.2f ns/read\n", oldNs );
+    printf( "irsdkVar<T,N>       %6.2f ns/read\n", newNs );
+    printf( "speedup             %6.1fx\n", oldNs / newNs );
+
+    // Resolving on connect: one linear name search per variable, versus one pass with a hash table.
+    // Each variable is declared with the type the sim has it as, like iracing.cpp does.
+    std::vector<irsdkVar<char>*>   charVars;
+    std::vector<irsdkVar<bool>*>   boolVars;
+    std::vector<irsdkVar<int>*>    intVars;
+    std::vector<irsdkVar<float>*>  floatVars;
+    std::vector<irsdkVar<double>*> doubleVars;
+    for( int i=0; i<NumSimVars; ++i )
+    {
+        const char* name = SimVars[i].name;
+        switch( SimVars[i].type )
+        {
+        case irsdk_char:     charVars.push_back( new irsdkVar<char>( name ) ); break;
+        case irsdk_bool:     boolVars.push_back( new irsdkVar<bool>( name ) ); break;
+        case irsdk_int:
+        case irsdk_bitField: intVars.push_back( new irsdkVar<int>( name ) ); break;
+        case irsdk_float:    floatVars.push_back( new irsdkVar<float>( name ) ); break;
+        case irsdk_double:   doubleVars.push_back( new irsdkVar<double>( name ) ); break;
+        }
+    }
+
+    volatile int idxSink = 0;
+    const double linearUs = nsPerRead( 1000, [&]() {
+        for( irsdkVarBase* v=irsdkVarBase::getFirst(); v; v=v->getNext() )
+            idxSink = irsdk_varNameToIndex( v->getName() );
+    });
+
+    double batchMs = 1e30;
+    for( int it=0; it<5; ++it )
+    {
+        irsdkVarBase::resolveAll();
+        batchMs = std::min( batchMs, irsdkVarBase::getResolveStats().resolveMs );
+    }
+
+    printf( "resolve %d vars     %6.1f us linear, %6.1f us batched, %d missing or mismatched\n", irsdkVarBase::getResolveStats().numRegistered, linearUs, batchMs * 1000, irsdkVarBase::getResolveStats().numMissing );
+
+    const int mismatched = irsdkVarBase::getResolveStats().numMissing;
+
+    for( irsdkVar<char>* v : charVars ) delete v;
+    for( irsdkVar<bool>* v : boolVars ) delete v;
+    for( irsdkVar<int>* v : intVars ) delete v;
+    for( irsdkVar<float>* v : floatVars ) delete v;
+    for( irsdkVar<double>* v : doubleVars ) delete v;
+
+    if( mismatched )
+    {
+        printf( "MISMATCH: %d variables didn't resolve\n", mismatched );
+        return 1;
+    }
+    return 0;
+}
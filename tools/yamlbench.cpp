@@ -0,0 +1,937 @@
+/*
+MIT License
+
+Copyright (c) 2021-2022 L. E. Spalt
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+
+//
+// Session string parsing benchmark.
+//
+// Replays captured session strings through the same sequence of lookups ir_tick() does, three ways:
+//
+//   legacy    the way it used to be done, a sprintf'd path and a linear parseYaml() scan per value
+//   document  the same lookups, against a yamlDocument made with one parse() per update. This is the
+//             benchmark of the yamlDocument index against the parseYaml() scanner it replaced.
+//   indexed   parseSessionStr() from SessionParser.cpp, the code iRon runs (one parse() per update,
+//             batch queries per list entry, and only reparsing sections and drivers whose contents changed)
+//
+// Reports time per update, bytes scanned and heap allocations for each, and checks that they all end up
+// with the same session. Then it runs the updates through SessionParser itself, both parseNow() and
+// request() to the worker thread and fetch() back, and counts the allocations of the whole round trip.
+// Allocations are shown for the last pass, once every buffer has grown to size, and for the first.
+//
+// Only depends on the session parser and the yaml parser, so it builds anywhere:
+//
+//   cl /O2 /EHsc /DNDEBUG tools\yamlbench.cpp SessionParser.cpp irsdk\yaml_parser.cpp
+//   g++ -O2 -std=c++17 -pthread -o yamlbench tools/yamlbench.cpp SessionParser.cpp irsdk/yaml_parser.cpp
+//
+// Usage:
+//
+//   yamlbench <dir or file>...      run on captured session strings
+//   yamlbench --synth <dir>         write a synthetic corpus (practice, 60 car multiclass race, team race)
+//
+// Inputs can be plain session strings, the sessionYaml.txt dump that debug builds of iRon write, which
+// holds every session string of a run, or .ibt files. Those have every version of the session string
+// if iRon recorded them (see irsdk_diskSessionVersions), the sim's own only have the last one.
+// Each file is replayed in order as one sequence of updates.
+//
+
+#ifdef _WIN32
+#include <windows.h>
+#include <direct.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include "../SessionParser.h"
+#include "../irsdk/irsdk_defines.h"
+
+// SessionParser allocates on its worker thread too, so this goes by g_allocCount
+#include "../AllocCount.h"
+
+static const char* const DumpSeparator = "\n\n==== NEW SESSION STRING ======================================\n";
+
+static void setLicenseColor( Car& car )
+{
+    unsigned licColHex = 0;
+    sscanf( car.licenseColStr, "0x%x", &licColHex );
+    car.licenseCol.r = float((licColHex >> 16) & 0xff) / 255.f;
+    car.licenseCol.g = float((licColHex >>  8) & 0xff) / 255.f;
+    car.licenseCol.b = float((licColHex >>  0) & 0xff) / 255.f;
+    car.licenseCol.a = 1;
+}
+
+static void setSessionType( Session& session, const char* sessionNameStr )
+{
+    if( !strcmp(sessionNameStr,"PRACTICE") )
+        session.sessionType = SessionType::PRACTICE;
+    if( !strcmp(sessionNameStr,"QUALIFY") )
+        session.sessionType = SessionType::QUALIFY;
+    else if( !strcmp(sessionNameStr,"RACE") )
+        session.sessionType = SessionType::RACE;
+}
+
+// Same truncation as yamlValueToStr() in SessionParser.cpp
+template<size_t N>
+static void copyStr( char (&dest)[N], const char* s, int count )
+{
+    if( count > int(N-1) )
+    {
+        count = int(N-1);
+        while( count > 0 && (s[count] & 0xC0) == 0x80 )
+            count--;
+    }
+
+    memcpy( dest, s, count );
+    dest[count] = 0;
+}
+
+static void computeSof( Session& session )
+{
+    double sof = 0;
+    int cnt = 0;
+    for( int i=0; i<IR_MAX_CARS; ++i )
+    {
+        const Car& car = session.cars[i];
+
+        if( car.isPaceCar || car.isSpectator || !car.userName[0] )
+            continue;
+
+        sof += car.irating;
+        cnt++;
+    }
+    session.sof = cnt ? int(sof / cnt) : 0;
+}
+
+//
+// Legacy path: one parseYaml() scan from the top of the string per value
+//
+
+static size_t g_bytesScanned = 0;
+
+// Set for the document path, which looks the same paths up in here instead
+static const yamlDocument* g_lookupDoc = nullptr;
+
+static bool legacyParseYaml( const char* yamlStr, const char* path, const char** s, int* count )
+{
+    if( g_lookupDoc )
+        return g_lookupDoc->getValue( path, s, count );
+
+    // parseYaml() walks the string from the start until it finds the value, or to the end if it doesn't
+    const bool found = parseYaml( yamlStr, path, s, count );
+    g_bytesScanned += found ? size_t(*s + *count - yamlStr) : strlen( yamlStr );
+    return found;
+}
+
+static bool legacyParseYamlInt( const char* yamlStr, const char* path, int* dest )
+{
+    int count = 0;
+    const char* s = nullptr;
+
+    if( legacyParseYaml(yamlStr, path, &s, &count) )
+    {
+        *dest = atoi( s );
+        return true;
+    }
+
+    return false;
+}
+
+static bool legacyParseYamlFloat( const char* yamlStr, const char* path, float* dest )
+{
+    int count = 0;
+    const char* s = nullptr;
+
+    if( legacyParseYaml(yamlStr, path, &s, &count) )
+    {
+        (*dest) = (float)atof( s );
+        return true;
+    }
+
+    return false;
+}
+
+static bool legacyParseYamlStr( const char* yamlStr, const char* path, std::string& dest )
+{
+    int count = 0;
+    const char* s = nullptr;
+
+    if( legacyParseYaml(yamlStr, path, &s, &count) )
+    {
+        // strip leading quotes
+        if( *s == '"' )
+        {
+            s++;
+            count--;
+        }
+
+        dest.assign( s, count );
+
+        // strip trailing quotes
+        if( !dest.empty() && dest[dest.length()-1]=='"' )
+            dest.pop_back();
+
+        return true;
+    }
+
+    return false;
+}
+
+static void legacyUpdate( const char* sessionYaml, int sessionNum, Session& ir_session )
+{
+    char path[256];
+
+    // Weekend info
+    sprintf( path, "WeekendInfo:SubSessionID:" );
+    legacyParseYamlInt( sessionYaml, path, &ir_session.subsessionId );
+
+    sprintf( path, "WeekendInfo:TrackID:" );
+    legacyParseYamlInt( sessionYaml, path, &ir_session.trackId );
+
+    sprintf( path, "WeekendInfo:WeekendOptions:IsFixedSetup:" );
+    legacyParseYamlInt( sessionYaml, path, &ir_session.isFixedSetup );
+
+    // Current session type
+    std::string sessionNameStr;
+    sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionName:", sessionNum );
+    legacyParseYamlStr( sessionYaml, path, sessionNameStr );
+    setSessionType( ir_session, sessionNameStr.c_str() );
+
+    // Driver/car info
+    legacyParseYamlInt( sessionYaml, "DriverInfo:DriverCarIdx:", &ir_session.driverCarIdx );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarFuelMaxLtr:", &ir_session.fuelMaxLtr );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarFuelKgPerLtr:", &ir_session.fuelKgPerLtr );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarIdleRPM:", &ir_session.rpmIdle );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarRedLine:", &ir_session.rpmRedline );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLFirstRPM:", &ir_session.rpmSLFirst );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLShiftRPM:", &ir_session.rpmSLShift );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLLastRPM:", &ir_session.rpmSLLast );
+    legacyParseYamlFloat( sessionYaml, "DriverInfo:DriverCarSLBlinkRPM:", &ir_session.rpmSLBlink );
+
+    // Per-Driver info
+    for( int carIdx=0; carIdx<IR_MAX_CARS; ++carIdx )
+    {
+        Car& car = ir_session.cars[carIdx];
+
+        car.isSelf = int( carIdx==ir_session.driverCarIdx );
+
+        // The old code kept these in std::string members of Car, so go through strings the same way.
+        // A missing value left the member as it was, not what the last lookup found.
+        std::string str;
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}UserName:", carIdx );
+        if( !legacyParseYamlStr( sessionYaml, path, str ) )
+        {
+            car = Car();
+            continue;
+        }
+
+        for( char& c : str )
+            c = (c=='\n'||c=='\r') ? ' ' : c;
+        copyStr( car.userName, str.c_str(), (int)str.size() );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarNumber:", carIdx );
+        str = car.carNumberStr;
+        legacyParseYamlStr( sessionYaml, path, str );
+        copyStr( car.carNumberStr, str.c_str(), (int)str.size() );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarNumberRaw:", carIdx );
+        legacyParseYamlInt( sessionYaml, path, &car.carNumber );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}LicString:", carIdx );
+        str = car.licenseStr;
+        legacyParseYamlStr( sessionYaml, path, str );
+        copyStr( car.licenseStr, str.c_str(), (int)str.size() );
+        const std::string SRstr = str.empty() ? "0" : std::string( str.begin()+1, str.end() );
+        car.licenseChar = str.empty() ? 'R' : str[0];
+        car.licenseSR = (float)atof( SRstr.c_str() );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}LicColor:", carIdx );
+        str = car.licenseColStr;
+        legacyParseYamlStr( sessionYaml, path, str );
+        copyStr( car.licenseColStr, str.c_str(), (int)str.size() );
+        setLicenseColor( car );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}IRating:", carIdx );
+        legacyParseYamlInt( sessionYaml, path, &car.irating );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarIsPaceCar:", carIdx );
+        legacyParseYamlInt( sessionYaml, path, &car.isPaceCar );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}IsSpectator:", carIdx );
+        legacyParseYamlInt( sessionYaml, path, &car.isSpectator );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CurDriverIncidentCount:", carIdx );
+        legacyParseYamlInt( sessionYaml, path, &car.incidentCount );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarClassEstLapTime:", carIdx );
+        legacyParseYamlFloat( sessionYaml, path, &car.carClassEstLapTime );
+
+        sprintf( path, "DriverInfo:Drivers:CarIdx:{%d}CarID:", carIdx );
+        legacyParseYamlInt( sessionYaml, path, &car.carId );
+
+        car.practicePosition = 0;
+        car.qualPosition = 0;
+        car.racePosition = 0;
+    }
+
+    // Sector lines
+    ir_session.numSectors = 0;
+    while( ir_session.numSectors < IR_MAX_SECTORS )
+    {
+        sprintf( path, "SplitTimeInfo:Sectors:SectorNum:{%d}SectorStartPct:", ir_session.numSectors );
+        if( !legacyParseYamlFloat( sessionYaml, path, &ir_session.sectorStartPct[ir_session.numSectors] ) )
+            break;
+        ir_session.numSectors++;
+    }
+
+    // Qualifying results info
+    for( int pos=0; pos<IR_MAX_CARS; ++pos )
+    {
+        sprintf( path, "QualifyResultsInfo:Results:Position:{%d}CarIdx:", pos );
+        int carIdx = -1;
+        if( legacyParseYamlInt( sessionYaml, path, &carIdx ) ) {
+            ir_session.cars[carIdx].qualPosition = pos + 1;
+
+            sprintf( path, "QualifyResultsInfo:Results:Position:{%d}FastestTime:", pos );
+            legacyParseYamlFloat( sessionYaml, path, &ir_session.cars[carIdx].qualTime );
+        }
+    }
+
+    // Session info
+    for( int session=0; ; ++session )
+    {
+        std::string sessionNameStr;
+        sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionName:", session );
+        if( !legacyParseYamlStr( sessionYaml, path, sessionNameStr ) )
+            break;
+
+        std::string str;
+        sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionTime:", session );
+        legacyParseYamlStr( sessionYaml, path, str );
+        ir_session.isUnlimitedTime = int( str=="unlimited" );
+
+        sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}SessionLaps:", session );
+        legacyParseYamlStr( sessionYaml, path, str );
+        ir_session.isUnlimitedLaps = int( str=="unlimited" );
+
+        for( int pos=1; pos<IR_MAX_CARS+1; ++pos )
+        {
+            int carIdx = -1;
+            sprintf( path, "SessionInfo:Sessions:SessionNum:{%d}ResultsPositions:Position:{%d}CarIdx:", session, pos );
+            if( legacyParseYamlInt( sessionYaml, path, &carIdx ) )
+            {
+                if( sessionNameStr == "PRACTICE" )
+                    ir_session.cars[carIdx].practicePosition = pos;
+                else if( sessionNameStr == "QUALIFY" )
+                    ir_session.cars[carIdx].qualPosition = pos;
+                else if( sessionNameStr == "RACE" )
+                    ir_session.cars[carIdx].racePosition = pos;
+            }
+        }
+    }
+
+    computeSof( ir_session );
+}
+
+//
+// Document path: the legacy lookups against the node index
+//
+
+static void documentUpdate( const char* sessionYaml, int sessionNum, Session& session, yamlDocument& doc )
+{
+    doc.parse( sessionYaml );
+    g_bytesScanned += doc.getDataLen();
+
+    g_lookupDoc = &doc;
+    legacyUpdate( sessionYaml, sessionNum, session );
+    g_lookupDoc = nullptr;
+}
+
+//
+// Current path: what SessionParser does with every update
+//
+
+static void indexedUpdate( const char* sessionYaml, int sessionNum, Session& session, SessionParseState& state, SessionParseStats& stats )
+{
+    parseSessionStr( sessionYaml, sessionNum, session, state, stats );
+
+    // The one tokenizer pass, hashing the sections and drivers reads them once more
+    g_bytesScanned += state.doc.getDataLen();
+}
+
+//
+// Cross checks
+//
+
+static bool sameCar( const Car& a, const Car& b )
+{
+    return !strcmp(a.userName,b.userName) && a.carNumber == b.carNumber && !strcmp(a.carNumberStr,b.carNumberStr) &&
+           !strcmp(a.licenseStr,b.licenseStr) && a.licenseChar == b.licenseChar && a.licenseSR == b.licenseSR &&
+           !strcmp(a.licenseColStr,b.licenseColStr) && a.irating == b.irating && a.isSelf == b.isSelf &&
+           a.isPaceCar == b.isPaceCar && a.isSpectator == b.isSpectator && a.incidentCount == b.incidentCount &&
+           a.carClassEstLapTime == b.carClassEstLapTime && a.practicePosition == b.practicePosition &&
+           a.qualPosition == b.qualPosition && a.qualTime == b.qualTime && a.racePosition == b.racePosition &&
+           a.carId == b.carId && !memcmp( &a.licenseCol, &b.licenseCol, sizeof(a.licenseCol) );
+}
+
+// Returns the index of the first car that differs, IR_MAX_CARS if only the session fields differ, or -1 if equal
+static int compareSessions( const Session& a, const Session& b )
+{
+    for( int i=0; i<IR_MAX_CARS; ++i )
+        if( !sameCar( a.cars[i], b.cars[i] ) )
+            return i;
+
+    const bool same = a.sessionType == b.sessionType && a.driverCarIdx == b.driverCarIdx && a.sof == b.sof &&
+                      a.subsessionId == b.subsessionId && a.trackId == b.trackId && a.isFixedSetup == b.isFixedSetup &&
+                      a.isUnlimitedTime == b.isUnlimitedTime && a.isUnlimitedLaps == b.isUnlimitedLaps &&
+                      a.fuelMaxLtr == b.fuelMaxLtr && a.rpmIdle == b.rpmIdle && a.rpmRedline == b.rpmRedline &&
+                      a.rpmSLFirst == b.rpmSLFirst && a.rpmSLShift == b.rpmSLShift && a.rpmSLLast == b.rpmSLLast &&
+                      a.rpmSLBlink == b.rpmSLBlink && a.fuelKgPerLtr == b.fuelKgPerLtr && a.numSectors == b.numSectors &&
+                      !memcmp( a.sectorStartPct, b.sectorStartPct, sizeof(a.sectorStartPct) );
+    return same ? -1 : IR_MAX_CARS;
+}
+
+//
+// Corpus
+//
+
+static bool loadFile( const std::string& path, std::string& out )
+{
+    FILE* fp = fopen( path.c_str(), "rb" );
+    if( !fp )
+        return false;
+
+    char buf[65536];
+    size_t n;
+    out.clear();
+    while( (n = fread( buf, 1, sizeof(buf), fp )) > 0 )
+        out.append( buf, n );
+    fclose( fp );
+    return true;
+}
+
+static bool seekTo( FILE* fp, long long pos, int whence )
+{
+#ifdef _WIN32
+    return _fseeki64( fp, pos, whence ) == 0;
+#else
+    return fseeko( fp, (off_t)pos, whence ) == 0;
+#endif
+}
+
+static bool readAt( FILE* fp, long long pos, void* dest, size_t len )
+{
+    return seekTo( fp, pos, SEEK_SET ) && fread( dest, 1, len, fp ) == len;
+}
+
+// The session strings of an .ibt file, every version of it if it has a table of them at the end
+static bool loadIbtSessions( const std::string& path, std::vector<std::string>& strings )
+{
+    FILE* fp = fopen( path.c_str(), "rb" );
+    if( !fp )
+        return false;
+
+    strings.clear();
+    bool ok = false;
+
+    irsdk_header header;
+    irsdk_diskSessionVersions footer;
+    if( readAt( fp, 0, &header, sizeof(header) ) && header.sessionInfoLen > 0 &&
+        seekTo( fp, -(long long)sizeof(footer), SEEK_END ) && fread( &footer, 1, sizeof(footer), fp ) == sizeof(footer) &&
+        !memcmp( footer.magic, IRSDK_SESSIONVERSIONS_MAGIC, sizeof(footer.magic) ) && footer.count > 0 )
+    {
+        std::vector<irsdk_diskSessionVersion> table( footer.count );
+        ok = readAt( fp, footer.tableOffset, table.data(), table.size() * sizeof(irsdk_diskSessionVersion) );
+        for( size_t i=0; ok && i<table.size(); ++i )
+        {
+            std::string str( (size_t)std::max( 0, table[i].len ), '\0' );
+            ok = readAt( fp, table[i].offset, &str[0], str.size() );
+            strings.push_back( str );
+        }
+    }
+    else if( header.sessionInfoLen > 0 )
+    {
+        std::string str( (size_t)header.sessionInfoLen, '\0' );
+        ok = readAt( fp, header.sessionInfoOffset, &str[0], str.size() );
+        str.resize( strnlen( str.c_str(), str.size() ) );
+        strings.push_back( str );
+    }
+
+    fclose( fp );
+    return ok;
+}
+
+static bool isIbt( const std::string& path )
+{
+    return path.size() > 4 && !strcmp( path.c_str() + path.size() - 4, ".ibt" );
+}
+
+// Split a sessionYaml.txt dump into its session strings. A plain session string comes back as is.
+static std::vector<std::string> splitDump( const std::string& text )
+{
+    std::vector<std::string> strings;
+    const size_t sepLen = strlen( DumpSeparator );
+
+    size_t pos = 0;
+    while( pos <= text.size() )
+    {
+        size_t end = text.find( DumpSeparator, pos );
+        if( end == std::string::npos )
+            end = text.size();
+
+        if( end > pos )
+            strings.push_back( text.substr( pos, end-pos ) );
+
+        pos = end + sepLen;
+    }
+
+    return strings;
+}
+
+static void collectFiles( const std::string& path, std::vector<std::string>& files )
+{
+    std::vector<std::string> entries;
+#ifdef _WIN32
+    const DWORD attr = GetFileAttributesA( path.c_str() );
+    if( attr == INVALID_FILE_ATTRIBUTES )
+    {
+        fprintf( stderr, "can't open %s\n", path.c_str() );
+        return;
+    }
+
+    if( !(attr & FILE_ATTRIBUTE_DIRECTORY) )
+    {
+        files.push_back( path );
+        return;
+    }
+
+    WIN32_FIND_DATAA fd;
+    HANDLE find = FindFirstFileA( (path + "\\*").c_str(), &fd );
+    if( find != INVALID_HANDLE_VALUE )
+    {
+        do
+        {
+            if( fd.cFileName[0] != '.' )
+                entries.push_back( path + "\\" + fd.cFileName );
+        } while( FindNextFileA( find, &fd ) );
+        FindClose( find );
+    }
+#else
+    struct stat st;
+    if( stat( path.c_str(), &st ) )
+    {
+        fprintf( stderr, "can't open %s\n", path.c_str() );
+        return;
+    }
+
+    if( !S_ISDIR(st.st_mode) )
+    {
+        files.push_back( path );
+        return;
+    }
+
+    if( DIR* dir = opendir( path.c_str() ) )
+    {
+        while( dirent* ent = readdir( dir ) )
+        {
+            if( ent->d_name[0] != '.' )
+                entries.push_back( path + "/" + ent->d_name );
+        }
+        closedir( dir );
+    }
+#endif
+
+    std::sort( entries.begin(), entries.end() );
+    for( const std::string& e : entries )
+        collectFiles( e, files );
+}
+
+//
+// Synthetic corpus
+//
+
+struct SynthCar
+{
+    std::string name;
+    std::string team;
+    int         carClass = 0;
+    int         irating = 0;
+    int         incidents = 0;
+    bool        isPaceCar = false;
+};
+
+static const char* const SynthFirstNames[] = { "Alexander", "Bo", "Christopher-Jean", "Dana", "Eero", "Fernanda", "Giovanni", "Hiro" };
+static const char* const SynthClasses[] = { "GTP", "LMP2", "GT3", "GT4" };
+
+static void appendf( std::string& s, const char* fmt, ... )
+{
+    char buf[2048];
+    va_list args;
+    va_start( args, fmt );
+    const int len = vsnprintf( buf, sizeof(buf), fmt, args );
+    va_end( args );
+    s.append( buf, std::min( len, (int)sizeof(buf)-1 ) );
+}
+
+static std::string synthSessionStr( const std::vector<SynthCar>& cars, const std::vector<std::string>& sessionNames,
+                                    const std::vector<std::vector<int>>& order, bool teamEvent, int update )
+{
+    const int n = (int)cars.size();
+    std::string s;
+
+    appendf( s, "---\nWeekendInfo:\n TrackName: spa 2022 gp\n TrackID: 163\n TrackLength: 6.93 km\n SubSessionID: %d\n"
+                " WeekendOptions:\n  NumStarters: %d\n  IsFixedSetup: 0\n TelemetryOptions:\n  TelemetryDiskFile: \"\"\n\n",
+                50000000 + n, n );
+
+    s += "SessionInfo:\n Sessions:\n";
+    for( int sn=0; sn<(int)sessionNames.size(); ++sn )
+    {
+        const bool timed = sessionNames[sn] != "RACE" || teamEvent;
+        appendf( s, " - SessionNum: %d\n   SessionLaps: %s\n   SessionTime: %s\n   SessionType: %s\n   SessionName: %s\n   ResultsPositions:\n",
+                 sn, timed ? "unlimited" : "20", timed ? "3600.0000 sec" : "unlimited", sessionNames[sn].c_str(), sessionNames[sn].c_str() );
+        for( int pos=0; pos<(int)order[sn].size(); ++pos )
+        {
+            appendf( s, "   - Position: %d\n     ClassPosition: %d\n     CarIdx: %d\n     Lap: %d\n     Time: %.4f\n     FastestLap: 3\n"
+                        "     FastestTime: %.4f\n     LastTime: %.4f\n     LapsLed: 0\n     LapsComplete: %d\n     Incidents: %d\n"
+                        "     ReasonOutId: 0\n     ReasonOutStr: Running\n",
+                     pos+1, pos, order[sn][pos], update, 120.0+pos*0.3, 118.0+pos*0.05, 119.0+pos*0.07, update, cars[order[sn][pos]].incidents );
+        }
+        s += "   ResultsFastestLap:\n   - CarIdx: 1\n     FastestLap: 2\n     FastestTime: 118.0000\n";
+    }
+
+    s += "\nQualifyResultsInfo:\n Results:\n";
+    for( int pos=0; pos<n-1; ++pos )
+        appendf( s, " - Position: %d\n   ClassPosition: %d\n   CarIdx: %d\n   FastestLap: 2\n   FastestTime: %.4f\n", pos, pos, pos+1, 130.0+pos*0.1 );
+
+    s += "\nCameraInfo:\n Groups:\n - GroupNum: 1\n   GroupName: Nose\n   Cameras:\n   - CameraNum: 1\n     CameraName: CamNose\n\n"
+         "RadioInfo:\n SelectedRadioNum: 0\n\n";
+
+    appendf( s, "DriverInfo:\n DriverCarIdx: 5\n DriverUserID: 1005\n PaceCarIdx: 0\n DriverCarIdleRPM: 900.000\n DriverCarRedLine: 8500.000\n"
+                " DriverCarFuelMaxLtr: 110.000\n DriverCarSLFirstRPM: 6000.000\n DriverCarSLShiftRPM: 7600.000\n DriverCarSLLastRPM: 7300.000\n"
+                " DriverCarSLBlinkRPM: 7800.000\n Drivers:\n" );
+    for( int c=0; c<n; ++c )
+    {
+        const SynthCar& car = cars[c];
+        appendf( s, " - CarIdx: %d\n   UserName: %s\n   AbbrevName: \"\"\n   Initials: \"\"\n   UserID: %d\n   TeamID: %d\n   TeamName: %s\n"
+                    "   CarNumber: \"%d\"\n   CarNumberRaw: %d\n   CarPath: car%d\n   CarClassID: %d\n   CarID: %d\n   CarIsPaceCar: %d\n"
+                    "   CarIsAI: 0\n   CarScreenName: Car %d\n   CarClassShortName: %s\n   CarClassRelSpeed: %d\n   CarClassEstLapTime: %.4f\n"
+                    "   IRating: %d\n   LicLevel: 18\n   LicSubLevel: 349\n   LicString: A %.2f\n   LicColor: 0x0153db\n   IsSpectator: 0\n"
+                    "   CarDesignStr: 1,ff0000,00ff00,0000ff\n   HelmetDesignStr: 1,000000,000000,000000\n   CurDriverIncidentCount: %d\n"
+                    "   TeamIncidentCount: %d\n",
+                 c, car.name.c_str(), 1000+c, teamEvent ? 9000+c : 0, car.team.c_str(), c, c, car.carClass, 4000+car.carClass,
+                 100+car.carClass, int(car.isPaceCar), car.carClass, SynthClasses[car.carClass], 100-car.carClass*10,
+                 110.0+car.carClass*8, car.irating, 1.0+(c%40)*0.1, car.incidents, car.incidents );
+    }
+
+    s += "\nSplitTimeInfo:\n Sectors:\n - SectorNum: 0\n   SectorStartPct: 0.000000\n - SectorNum: 1\n   SectorStartPct: 0.333000\n"
+         " - SectorNum: 2\n   SectorStartPct: 0.666000\n\nCarSetup:\n UpdateCount: 1\n Tires:\n  LeftFront:\n   StartingPressure: 172.4 kPa\n\n...\n";
+    return s;
+}
+
+// Writes a file that looks like a sessionYaml.txt dump of 'updates' session string updates. Every
+// update changes a few incident counts and swaps some positions; team events also swap drivers.
+static bool writeSynthFile( const std::string& path, int numCars, int numClasses, const std::vector<std::string>& sessionNames,
+                            bool teamEvent, int updates, unsigned seed )
+{
+    srand( seed );
+
+    std::vector<SynthCar> cars( numCars );
+    for( int c=0; c<numCars; ++c )
+    {
+        SynthCar& car = cars[c];
+        car.isPaceCar = c == 0;
+        car.carClass = car.isPaceCar ? 0 : (c-1) % numClasses;
+        car.irating = 800 + rand() % 4000;
+        if( car.isPaceCar )
+            car.name = "Pace Car";
+        else
+            car.name = std::string(SynthFirstNames[rand() % 8]) + " Driver" + std::to_string(c);
+        car.team = teamEvent ? "Team " + std::to_string(c) + " Racing" : car.name;
+    }
+
+    std::vector<std::vector<int>> order( sessionNames.size() );
+    for( std::vector<int>& o : order )
+    {
+        for( int c=1; c<numCars; ++c )
+            o.push_back( c );
+    }
+
+    std::string text;
+    for( int u=0; u<updates; ++u )
+    {
+        if( u > 0 )
+        {
+            text += DumpSeparator;
+
+            std::vector<int>& o = order.back();
+            for( int k=0; k<3 && o.size()>1; ++k )
+            {
+                const int i = rand() % int(o.size()-1);
+                std::swap( o[i], o[i+1] );
+            }
+            cars[1 + rand() % (numCars-1)].incidents += 2;
+
+            if( teamEvent && u % 2 == 0 )
+            {
+                SynthCar& car = cars[1 + rand() % (numCars-1)];
+                car.name = std::string(SynthFirstNames[rand() % 8]) + " Relief" + std::to_string(u);
+                car.irating = 800 + rand() % 4000;
+            }
+        }
+
+        text += synthSessionStr( cars, sessionNames, order, teamEvent, u );
+    }
+
+    FILE* fp = fopen( path.c_str(), "wb" );
+    if( !fp )
+    {
+        fprintf( stderr, "can't write %s\n", path.c_str() );
+        return false;
+    }
+    fwrite( text.data(), 1, text.size(), fp );
+    fclose( fp );
+    printf( "wrote %s (%d updates, %d bytes)\n", path.c_str(), updates, (int)text.size() );
+    return true;
+}
+
+static int synth( const std::string& dir )
+{
+#ifdef _WIN32
+    _mkdir( dir.c_str() );
+#else
+    mkdir( dir.c_str(), 0755 );
+#endif
+
+    bool ok = true;
+    ok &= writeSynthFile( dir + "/practice.txt", 12, 1, {"PRACTICE"}, false, 20, 1 );
+    ok &= writeSynthFile( dir + "/race60_multiclass.txt", 61, 4, {"PRACTICE","QUALIFY","RACE"}, false, 40, 2 );
+    ok &= writeSynthFile( dir + "/team_race.txt", 41, 2, {"PRACTICE","QUALIFY","RACE"}, true, 40, 3 );
+    return ok ? 0 : 1;
+}
+
+//
+// Benchmark
+//
+
+struct Result
+{
+    double  nsPerUpdate = 0;
+    double  bytesPerUpdate = 0;
+    double  allocsPerUpdate = 0;    // last pass
+    double  firstAllocsPerUpdate = 0;
+};
+
+typedef std::chrono::steady_clock Clock;
+
+template<typename F>
+static Result measure( const std::vector<std::string>& updates, int iterations, F replay )
+{
+    Result res;
+    double best = 1e30;
+
+    for( int it=0; it<iterations; ++it )
+    {
+        g_bytesScanned = 0;
+        const size_t allocs = g_allocCount;
+        const Clock::time_point t0 = Clock::now();
+
+        replay();
+
+        const double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>( Clock::now() - t0 ).count();
+        if( ns < best )
+        {
+            best = ns;
+            res.nsPerUpdate = ns / updates.size();
+        }
+
+        // The first runs may still be growing buffers that are reused later on
+        res.bytesPerUpdate = double(g_bytesScanned) / updates.size();
+        res.allocsPerUpdate = double(g_allocCount - allocs) / updates.size();
+        if( it == 0 )
+            res.firstAllocsPerUpdate = res.allocsPerUpdate;
+    }
+
+    return res;
+}
+
+static bool benchFile( const std::string& path, int iterations, int sessionNum )
+{
+    std::vector<std::string> updates;
+    std::string text;
+    if( isIbt( path ) ? !loadIbtSessions( path, updates ) : !loadFile( path, text ) )
+    {
+        fprintf( stderr, "can't read %s\n", path.c_str() );
+        return false;
+    }
+
+    if( !isIbt( path ) )
+        updates = splitDump( text );
+    if( updates.empty() )
+        return true;
+
+    size_t totalBytes = 0;
+    for( const std::string& s : updates )
+        totalBytes += s.size();
+
+    // All paths must agree after every update
+    bool ok = true;
+    {
+        Session* legacy = new Session;
+        Session* document = new Session;
+        Session* indexed = new Session;
+        SessionParseState* state = new SessionParseState;
+        SessionParseStats stats;
+        yamlDocument doc;
+
+        for( size_t u=0; u<updates.size(); ++u )
+        {
+            legacyUpdate( updates[u].c_str(), sessionNum, *legacy );
+            documentUpdate( updates[u].c_str(), sessionNum, *document, doc );
+            indexedUpdate( updates[u].c_str(), sessionNum, *indexed, *state, stats );
+
+            const Session* other[] = { document, indexed };
+            const char* const otherName[] = { "document", "indexed" };
+            for( int k=0; k<2; ++k )
+            {
+                const int diff = compareSessions( *legacy, *other[k] );
+                if( diff >= 0 )
+                {
+                    if( diff < IR_MAX_CARS )
+                        printf( "  MISMATCH update %d: car %d differs in %s\n", (int)u, diff, otherName[k] );
+                    else
+                        printf( "  MISMATCH update %d: session fields differ in %s\n", (int)u, otherName[k] );
+                    ok = false;
+                }
+            }
+        }
+
+        delete legacy;
+        delete document;
+        delete indexed;
+        delete state;
+    }
+
+    Session* session = new Session;
+    SessionParseState* state = new SessionParseState;
+    SessionParseStats stats;
+
+    const Result legacy = measure( updates, iterations, [&]() {
+        *session = Session();
+        for( const std::string& s : updates )
+            legacyUpdate( s.c_str(), sessionNum, *session );
+    });
+
+    yamlDocument doc;
+    const Result document = measure( updates, iterations, [&]() {
+        *session = Session();
+        for( const std::string& s : updates )
+            documentUpdate( s.c_str(), sessionNum, *session, doc );
+    });
+
+    // Keep the state (and its buffers) between runs, the same way ir_tick() keeps it around
+    const Result indexed = measure( updates, iterations, [&]() {
+        *session = Session();
+        memset( state->haveSection, 0, sizeof(state->haveSection) );
+        memset( state->haveDriver, 0, sizeof(state->haveDriver) );
+        for( const std::string& s : updates )
+            indexedUpdate( s.c_str(), sessionNum, *session, *state, stats );
+    });
+
+    delete session;
+    delete state;
+
+    // What iRon actually runs, from the string to the snapshot the overlays read. The session number
+    // and status stay the same, so only what changed gets reparsed, like ir_tick() within a connection.
+    SessionParser* parser = new SessionParser();
+    const Result parseNow = measure( updates, iterations, [&]() {
+        for( const std::string& s : updates )
+        {
+            parser->parseNow( s.c_str(), sessionNum, 1 );
+            parser->fetch();
+        }
+    });
+    delete parser;
+
+    parser = new SessionParser();
+    const Result request = measure( updates, iterations, [&]() {
+        for( const std::string& s : updates )
+        {
+            parser->request( s.c_str(), sessionNum, 1 );
+            while( !parser->fetch() )
+                std::this_thread::yield();
+        }
+    });
+    delete parser;
+
+    printf( "%s: %d updates, %.0f bytes/update%s\n", path.c_str(), (int)updates.size(), double(totalBytes)/updates.size(), ok ? "" : "  ** MISMATCH **" );
+    printf( "  %-8s %12.0f ns/update %12.0f bytes scanned/update %8.1f allocs/update, %.1f on the first pass\n", "legacy", legacy.nsPerUpdate, legacy.bytesPerUpdate, legacy.allocsPerUpdate, legacy.firstAllocsPerUpdate );
+    printf( "  %-8s %12.0f ns/update %12.0f bytes scanned/update %8.1f allocs/update, %.1f on the first pass\n", "document", document.nsPerUpdate, document.bytesPerUpdate, document.allocsPerUpdate, document.firstAllocsPerUpdate );
+    printf( "  %-8s %12.0f ns/update %12.0f bytes scanned/update %8.1f allocs/update, %.1f on the first pass\n", "indexed", indexed.nsPerUpdate, indexed.bytesPerUpdate, indexed.allocsPerUpdate, indexed.firstAllocsPerUpdate );
+    printf( "  speedup over legacy: document %.1fx, indexed %.1fx\n", document.nsPerUpdate > 0 ? legacy.nsPerUpdate / document.nsPerUpdate : 0.0,
+            indexed.nsPerUpdate > 0 ? legacy.nsPerUpdate / indexed.nsPerUpdate : 0.0 );
+    printf( "  SessionParser::parseNow()        %12.0f ns/update %8.1f allocs/update, %.1f on the first pass\n", parseNow.nsPerUpdate, parseNow.allocsPerUpdate, parseNow.firstAllocsPerUpdate );
+    printf( "  SessionParser::request()/fetch() %12.0f ns/update %8.1f allocs/update, %.1f on the first pass\n", request.nsPerUpdate, request.allocsPerUpdate, request.firstAllocsPerUpdate );
+
+    return ok;
+}
+
+int main( int argc, char** argv )
+{
+    int iterations = 5;
+    int sessionNum = 0;
+    std::vector<std::string> files;
+
+    for( int i=1; i<argc; ++i )
+    {
+        if( !strcmp( argv[i], "--synth" ) && i+1 < argc )
+            return synth( argv[++i] );
+        else if( !strcmp( argv[i], "--iterations" ) && i+1 < argc )
+            iterations = std::max( 1, atoi( argv[++i] ) );
+        else if( !strcmp( argv[i], "--session" ) && i+1 < argc )
+            sessionNum = atoi( argv[++i] );
+        else
+            collectFiles( argv[i], files );
+    }
+
+    if( files.empty() )
+    {
+        printf( "usage: yamlbench [--iterations N] [--session N] <dir or file>...\n"
+                "       yamlbench --synth <dir>\n" );
+        return 1;
+    }
+
+    bool ok = true;
+    for( const std::string& f : files )
+        ok &= benchFile( f, iterations, sessionNum );
+
+    return ok ? 0 : 1;
+}
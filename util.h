@@ -34,6 +34,7 @@ SOFTWARE.
 #include <dwrite.h>
 #include <unordered_map>
 #include <ctype.h>
+#include "base.h"
 
 #define HRCHECK( x_ ) do{ \
     HRESULT hr_ = x_; \
@@ -42,32 +43,6 @@ SOFTWARE.
         exit(1); \
     } } while(0)
 
-struct float2
-{
-    union { float r; float x; };
-    union { float g; float y; };
-    float2() = default;
-    float2( float _x, float _y ) : x(_x), y(_y) {}
-    float2( const D2D1_POINT_2F& p ) : x(p.x), y(p.y) {}
-    operator D2D1_POINT_2F() const { return {x,y}; }
-    float* operator&() { return &x; }
-    const float* operator&() const { return &x; }
-};
-
-struct float4
-{
-    union { float r; float x; };
-    union { float g; float y; };
-    union { float b; float z; };
-    union { float a; float w; };
-    float4() = default;
-    float4( float _x, float _y, float _z, float _w ) : x(_x), y(_y), z(_z), w(_w) {}
-    float4( const D2D1_COLOR_F& c ) : r(c.r), g(c.g), b(c.b), a(c.a) {}
-    operator D2D1_COLOR_F() const { return {r,g,b,a}; }
-    float* operator&() { return &x; }
-    const float* operator&() const { return &x; }
-};
-
 inline bool loadFile( const std::string& fname, std::string& output )
 {
     FILE* fp = fopen( fname.c_str(), "rb" );
@@ -199,73 +174,6 @@ class ColumnLayout
         std::vector<Column>     m_columns;
 };
 
-//-----------------------------------------------------------------------------
-// MurmurHash2, by Austin Appleby
-
-// Note - This code makes a few assumptions about how your machine behaves -
-
-// 1. We can read a 4-byte value from any address without crashing
-// 2. sizeof(int) == 4
-
-// And it has a few limitations -
-
-// 1. It will not work incrementally.
-// 2. It will not produce the same results on little-endian and big-endian
-//    machines.
-
-inline unsigned int MurmurHash2 ( const void * key, int len, unsigned int seed )
-{
-    // 'm' and 'r' are mixing constants generated offline.
-    // They're not really 'magic', they just happen to work well.
-
-    const unsigned int m = 0x5bd1e995;
-    const int r = 24;
-
-    // Initialize the hash to a 'random' value
-
-    unsigned int h = seed ^ len;
-
-    // Mix 4 bytes at a time into the hash
-
-    const unsigned char * data = (const unsigned char *)key;
-
-    while(len >= 4)
-    {
-        unsigned int k = *(unsigned int *)data;
-
-        k *= m; 
-        k ^= k >> r; 
-        k *= m; 
-
-        h *= m; 
-        h ^= k;
-
-        data += 4;
-        len -= 4;
-    }
-
-    // Handle the last few bytes of the input array
-
-    switch(len)
-    {
-    case 3: h ^= data[2] << 16;
-    case 2: h ^= data[1] << 8;
-    case 1: h ^= data[0];
-        h *= m;
-    };
-
-    // Do a few final mixes of the hash to ensure the last few
-    // bytes are well-incorporated.
-
-    h ^= h >> 13;
-    h *= m;
-    h ^= h >> 15;
-
-    return h;
-} 
-// End MurmurHash2
-//-----------------------------------------------------------------------------
-
 class TextCache
 {
     public: